@@ -0,0 +1,149 @@
+#include "LargeFileLoader.h"
+#include "Log.h"
+#include "Trace.h"
+
+LargeFileLoader::LargeFileLoader(QObject* parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &LargeFileLoader::loadNextSlice);
+}
+
+LargeFileLoader::~LargeFileLoader()
+{
+    // Keine Signale mehr: Empfänger werden evtl. gerade selbst zerstört
+    release();
+}
+
+bool LargeFileLoader::start(const QString& filePath, QTextDocument* document)
+{
+    if (isRunning())
+        finish(false);
+
+    m_error.clear();
+    m_decodingErrors = false;
+    m_tail.clear();
+    m_offset = 0;
+    m_decoder = QStringDecoder(QStringDecoder::Utf8);
+
+    m_file.setFileName(filePath);
+    if (!document || !m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_mapped = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_mapped && m_size > 0)
+        LOG_INFO(lcFiles) << "mmap failed for" << filePath << "- falling back to chunked reads";
+
+    m_document = document;
+    m_undoWasEnabled = document->isUndoRedoEnabled();
+    document->setUndoRedoEnabled(false);
+    document->clear();
+    m_cursor = QTextCursor(document);
+
+    m_elapsed.start();
+    m_timer.start();
+    emit progressChanged(0);
+    return true;
+}
+
+void LargeFileLoader::cancel()
+{
+    if (isRunning())
+        finish(false);
+}
+
+void LargeFileLoader::loadNextSlice()
+{
+    TRACE_SCOPE("LargeFileLoader::loadNextSlice");
+
+    if (!m_document) {
+        finish(false);
+        return;
+    }
+
+    // Mehrere Chunks pro Durchlauf, aber nie länger als SLICE_MS am Stück
+    QElapsedTimer slice;
+    slice.start();
+    do {
+        if (!appendChunk()) {
+            finish(m_error.isEmpty());
+            return;
+        }
+    } while (slice.elapsed() < SLICE_MS);
+
+    emit progressChanged(m_size > 0 ? static_cast<int>(m_offset * 100 / m_size) : 100);
+}
+
+bool LargeFileLoader::appendChunk()
+{
+    const qint64 length = qMin(m_chunkBytes, m_size - m_offset);
+    const bool atEnd = length <= 0;
+
+    QString text = m_tail;
+    m_tail.clear();
+
+    if (!atEnd) {
+        QByteArray buffer;
+        QByteArrayView bytes;
+        if (m_mapped) {
+            bytes = QByteArrayView(reinterpret_cast<const char*>(m_mapped) + m_offset, length);
+        } else {
+            buffer = m_file.read(length);
+            if (buffer.size() != length) {
+                m_error = m_file.errorString();
+                return false;
+            }
+            bytes = buffer;
+        }
+        text += m_decoder.decode(bytes);
+        m_offset += length;
+
+        // Nur vollständige Zeilen anhängen; der Rest wandert in den nächsten Chunk
+        const qsizetype lastNewline = text.lastIndexOf(u'\n');
+        if (lastNewline < 0) {
+            m_tail = std::move(text);
+            return true;
+        }
+        m_tail = text.mid(lastNewline + 1);
+        text.truncate(lastNewline + 1);
+    }
+
+    text.replace(u"\r\n"_qs, u"\n"_qs);
+    if (!text.isEmpty())
+        m_cursor.insertText(text);
+
+    return !atEnd;
+}
+
+void LargeFileLoader::release()
+{
+    m_timer.stop();
+
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    m_file.close();
+    m_tail.clear();
+    m_cursor = QTextCursor();
+
+    if (m_document) {
+        m_document->setUndoRedoEnabled(m_undoWasEnabled);
+        m_document.clear();
+    }
+}
+
+void LargeFileLoader::finish(bool completed)
+{
+    m_decodingErrors = m_decoder.hasError();
+    release();
+
+    LOG_INFO(lcFiles) << (completed ? "loaded" : "aborted loading") << m_file.fileName()
+                      << m_offset << "of" << m_size << "bytes in" << m_elapsed.elapsed() << "ms";
+    if (completed)
+        emit progressChanged(100);
+    emit finished(completed);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringDecoder>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTimer>
+
+/**
+ * Lädt große Dateien schrittweise in ein QTextDocument:
+ *  - Datei wird per QFile::map eingeblendet (Fallback: stückweises read())
+ *  - UTF-8 wird zustandsbehaftet in Chunks dekodiert (Multibyte-Sequenzen dürfen
+ *    über Chunkgrenzen laufen), "\r\n" → "\n" wie bei QIODevice::Text
+ *  - angehängt wird nur bis zum letzten Zeilenumbruch, in Zeitscheiben über die
+ *    Event-Loop; Undo ist währenddessen abgeschaltet
+ *  - cancel() bricht jederzeit ab
+ */
+class LargeFileLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LargeFileLoader(QObject* parent = nullptr);
+    ~LargeFileLoader() override;
+
+    // Ab dieser Größe nutzt MainWindow den schrittweisen Ladepfad
+    static constexpr qint64 LARGE_FILE_THRESHOLD = 4 * 1024 * 1024;
+    static constexpr qint64 DEFAULT_CHUNK_BYTES = 256 * 1024;
+    static constexpr int SLICE_MS = 12;
+
+    // Leert document und beginnt zu laden; false bei Öffnungsfehler (siehe errorString())
+    bool start(const QString& filePath, QTextDocument* document);
+    void cancel();
+
+    void setChunkSize(qint64 bytes) { m_chunkBytes = qMax<qint64>(1, bytes); }
+    [[nodiscard]] bool isRunning() const { return m_timer.isActive(); }
+    [[nodiscard]] QString filePath() const { return m_file.fileName(); }
+    [[nodiscard]] QString errorString() const { return m_error; }
+    [[nodiscard]] bool hadDecodingErrors() const { return m_decodingErrors; }
+
+signals:
+    void progressChanged(int percent);
+    void finished(bool completed); // false = abgebrochen oder Lesefehler
+
+private:
+    void loadNextSlice();
+    bool appendChunk();
+    void release();
+    void finish(bool completed);
+
+    QFile m_file;
+    uchar* m_mapped = nullptr;
+    qint64 m_size = 0;
+    qint64 m_offset = 0;
+    qint64 m_chunkBytes = DEFAULT_CHUNK_BYTES;
+
+    QStringDecoder m_decoder;
+    QString m_tail; // angefangene letzte Zeile des vorherigen Chunks
+
+    QPointer<QTextDocument> m_document;
+    QTextCursor m_cursor;
+    bool m_undoWasEnabled = true;
+
+    QTimer m_timer;
+    QElapsedTimer m_elapsed;
+    QString m_error;
+    bool m_decodingErrors = false;
+};
@@ -0,0 +1,111 @@
+#include "Log.h"
+
+#include <QDateTime>
+#include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <cstdio>
+#include <vector>
+
+Q_LOGGING_CATEGORY(lcParser, "luaeditor.parser", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcCompletion, "luaeditor.completion", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcImports, "luaeditor.imports", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcHighlighter, "luaeditor.highlighter", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcFiles, "luaeditor.files", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcLsp, "luaeditor.lsp", QtInfoMsg)
+
+namespace Log {
+
+namespace {
+    struct RingSink {
+        QMutex mutex;
+        std::vector<QString> lines;
+        quint64 written = 0;
+        QtMessageHandler previous = nullptr;
+        bool forwardAll = false;
+    };
+
+    RingSink& sink() {
+        static RingSink s;
+        return s;
+    }
+
+    const char* typeName(QtMsgType type) {
+        switch (type) {
+        case QtDebugMsg:    return "debug";
+        case QtInfoMsg:     return "info";
+        case QtWarningMsg:  return "warning";
+        case QtCriticalMsg: return "critical";
+        case QtFatalMsg:    return "fatal";
+        }
+        return "unknown";
+    }
+
+    void ringHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg) {
+        // Zeile außerhalb des Locks formatieren; unter dem Lock wird nur getauscht
+        QString line = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+        line += u' ';
+        line += QLatin1String(typeName(type));
+        line += u' ';
+        line += QLatin1String(context.category ? context.category : "default");
+        line += u": ";
+        line += msg;
+
+        RingSink& s = sink();
+        bool forward = false;
+        QtMessageHandler previous = nullptr;
+        {
+            QMutexLocker lock(&s.mutex);
+            if (!s.lines.empty()) {
+                // Die überschriebene Zeile wandert nach line und wird erst nach dem Lock freigegeben
+                s.lines[static_cast<size_t>(s.written % s.lines.size())].swap(line);
+                ++s.written;
+            }
+            forward = s.forwardAll || (type != QtDebugMsg && type != QtInfoMsg);
+            previous = s.previous;
+        }
+        if (!forward) return;
+        if (previous)
+            previous(type, context, msg);
+        else
+            std::fprintf(stderr, "%s\n", qPrintable(qFormatLogMessage(type, context, msg)));
+    }
+}
+
+void installRingBufferSink(int capacity, bool forwardAll) {
+    RingSink& s = sink();
+    {
+        QMutexLocker lock(&s.mutex);
+        s.lines.assign(static_cast<size_t>(qMax(1, capacity)), QString());
+        s.written = 0;
+        s.forwardAll = forwardAll;
+    }
+    QtMessageHandler previous = qInstallMessageHandler(ringHandler);
+    if (previous != ringHandler) {
+        QMutexLocker lock(&s.mutex);
+        s.previous = previous;
+    }
+}
+
+QStringList recentMessages() {
+    RingSink& s = sink();
+    QMutexLocker lock(&s.mutex);
+
+    QStringList out;
+    if (s.lines.empty()) return out;
+
+    const quint64 capacity = s.lines.size();
+    const quint64 count = qMin<quint64>(s.written, capacity);
+    out.reserve(static_cast<qsizetype>(count));
+    for (quint64 i = s.written - count; i < s.written; ++i)
+        out.append(s.lines[static_cast<size_t>(i % capacity)]);
+    return out;
+}
+
+bool writeRecentMessages(QIODevice* out) {
+    if (!out || !out->isWritable()) return false;
+    const QByteArray text = recentMessages().join(u'\n').toUtf8() + '\n';
+    return out->write(text) == text.size();
+}
+
+} // namespace Log
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+/**
+ * Logging-Kategorien des Editors:
+ *  - luaeditor.parser, luaeditor.completion, luaeditor.imports, luaeditor.highlighter,
+ *    luaeditor.files, luaeditor.lsp
+ *  - Debug-Ausgaben sind zur Laufzeit per QT_LOGGING_RULES schaltbar
+ *    (z.B. "luaeditor.completion.debug=true"); abgeschaltete Kategorien
+ *    formatieren ihre Argumente nicht
+ *  - LUAEDITOR_LOG_MIN_LEVEL entfernt Ausgaben unterhalb der Stufe bereits zur Compile-Zeit
+ *    (0 = debug, 1 = info, 2 = warning, 3 = critical)
+ *  - installRingBufferSink() hält die letzten Meldungen im Speicher statt sie auszugeben
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcParser)
+Q_DECLARE_LOGGING_CATEGORY(lcCompletion)
+Q_DECLARE_LOGGING_CATEGORY(lcImports)
+Q_DECLARE_LOGGING_CATEGORY(lcHighlighter)
+Q_DECLARE_LOGGING_CATEGORY(lcFiles)
+Q_DECLARE_LOGGING_CATEGORY(lcLsp)
+
+#ifndef LUAEDITOR_LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define LUAEDITOR_LOG_MIN_LEVEL 1
+#  else
+#    define LUAEDITOR_LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+// "while (false)" behält die Ausdrücke typgeprüft, erzeugt aber keinen Code
+#if LUAEDITOR_LOG_MIN_LEVEL <= 0
+#  define LOG_DEBUG(category) qCDebug(category)
+#else
+#  define LOG_DEBUG(category) while (false) qCDebug(category)
+#endif
+
+#if LUAEDITOR_LOG_MIN_LEVEL <= 1
+#  define LOG_INFO(category) qCInfo(category)
+#else
+#  define LOG_INFO(category) while (false) qCInfo(category)
+#endif
+
+#if LUAEDITOR_LOG_MIN_LEVEL <= 2
+#  define LOG_WARNING(category) qCWarning(category)
+#else
+#  define LOG_WARNING(category) while (false) qCWarning(category)
+#endif
+
+namespace Log {
+
+constexpr int DEFAULT_RING_CAPACITY = 4096;
+
+// Installiert den Ringpuffer als Qt-Message-Handler. Meldungen ab Warning werden
+// zusätzlich an den vorherigen Handler weitergereicht, mit forwardAll alle.
+void installRingBufferSink(int capacity = DEFAULT_RING_CAPACITY, bool forwardAll = false);
+
+[[nodiscard]] QStringList recentMessages(); // ältestes zuerst
+bool writeRecentMessages(QIODevice* out);
+
+} // namespace Log
@@ -0,0 +1,665 @@
+#include "LspServer.h"
+#include "LuaBuiltins.h"
+#include "LuaSyntaxChecker.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMap>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <string_view>
+#include <utility>
+
+namespace {
+    // JSON-RPC-Fehlercodes
+    constexpr int PARSE_ERROR = -32700;
+    constexpr int INVALID_REQUEST = -32600;
+    constexpr int METHOD_NOT_FOUND = -32601;
+
+    // LSP-Aufzählungen (nur die verwendeten Werte)
+    constexpr int SYNC_INCREMENTAL = 2;
+    constexpr int SEVERITY_ERROR = 1;
+
+    constexpr int MAX_COMPLETION_ITEMS = 200;
+
+    QString fromAscii(std::string_view text) {
+        return QString::fromLatin1(text.data(), static_cast<qsizetype>(text.size()));
+    }
+
+    int completionKind(SymbolKind kind) {
+        switch (kind) {
+        case SymbolKind::Table:      return 9;  // Module
+        case SymbolKind::Function:   return 3;  // Function
+        case SymbolKind::Method:     return 2;  // Method
+        case SymbolKind::Field:      return 5;  // Field
+        case SymbolKind::Variable:   return 6;  // Variable
+        case SymbolKind::Metamethod: return 2;
+        }
+        return 1; // Text
+    }
+
+    int completionKind(LuaBuiltins::WordKind kind) {
+        switch (kind) {
+        case LuaBuiltins::WordKind::Keyword: return 14;
+        case LuaBuiltins::WordKind::Builtin: return 3;
+        case LuaBuiltins::WordKind::Library: return 9;
+        }
+        return 1;
+    }
+
+    int symbolKind(SymbolKind kind) {
+        switch (kind) {
+        case SymbolKind::Table:      return 5;  // Class
+        case SymbolKind::Function:   return 12; // Function
+        case SymbolKind::Method:     return 6;  // Method
+        case SymbolKind::Field:      return 8;  // Field
+        case SymbolKind::Variable:   return 13; // Variable
+        case SymbolKind::Metamethod: return 6;
+        }
+        return 13;
+    }
+
+    // LSP-Position (0-basierte Zeile, UTF-16-Spalte) → Offset; Spalten hinter dem Zeilenende klemmen
+    qsizetype offsetAt(const QString& text, int line, int character) {
+        qsizetype start = 0;
+        for (int l = 0; l < line; ++l) {
+            const qsizetype newline = text.indexOf(u'\n', start);
+            if (newline < 0) return text.size();
+            start = newline + 1;
+        }
+        qsizetype end = text.indexOf(u'\n', start);
+        if (end < 0) end = text.size();
+        return std::min(start + std::max(character, 0), end);
+    }
+
+    qsizetype offsetAt(const QString& text, const QJsonObject& position) {
+        return offsetAt(text, position.value(u"line"_qs).toInt(), position.value(u"character"_qs).toInt());
+    }
+
+    QJsonObject position(int line, int character) {
+        return {{u"line"_qs, line}, {u"character"_qs, character}};
+    }
+
+    QJsonObject range(const SourcePos& pos, qsizetype length) {
+        const int line = pos.line - 1;
+        const int column = pos.column - 1;
+        return {{u"start"_qs, position(line, column)},
+                {u"end"_qs, position(line, column + static_cast<int>(length))}};
+    }
+
+    bool isIdentChar(QChar c) {
+        return c.isLetterOrNumber() || c == u'_';
+    }
+
+    // Kette unter dem Cursor ("Player:new" → "Player.new"); rechts nur bis zum Ende des Namens
+    QString chainAt(const QString& text, qsizetype offset) {
+        qsizetype begin = offset;
+        while (begin > 0 && (isIdentChar(text.at(begin - 1)) || text.at(begin - 1) == u'.' || text.at(begin - 1) == u':'))
+            --begin;
+        qsizetype end = offset;
+        while (end < text.size() && isIdentChar(text.at(end)))
+            ++end;
+        QString chain = text.mid(begin, end - begin);
+        chain.replace(u':', u'.');
+        while (chain.startsWith(u'.')) chain.remove(0, 1);
+        while (chain.endsWith(u'.')) chain.chop(1);
+        return chain;
+    }
+
+    void splitChain(const QString& chain, QString& parent, QString& name) {
+        const qsizetype dot = chain.lastIndexOf(u'.');
+        parent = dot < 0 ? QString() : chain.left(dot);
+        name = dot < 0 ? chain : chain.mid(dot + 1);
+    }
+
+    const QRegularExpression kMemberPrefixRe(
+        uR"(([A-Za-z_][A-Za-z0-9_]*(?:[.:][A-Za-z_][A-Za-z0-9_]*)*)[.:]([A-Za-z0-9_]*)$)"_qs);
+    const QRegularExpression kIdentPrefixRe(uR"([A-Za-z_][A-Za-z0-9_]*$)"_qs);
+}
+
+LspServer::LspServer(QObject* parent)
+    : QObject(parent)
+    , m_indexWatcher(new QFutureWatcher<IndexedFile>(this))
+    , m_diagnosticsTimer(new QTimer(this))
+{
+    connect(m_indexWatcher, &QFutureWatcherBase::finished, this, &LspServer::onWorkspaceIndexed);
+
+    m_diagnosticsTimer->setSingleShot(true);
+    m_diagnosticsTimer->setInterval(200);
+    connect(m_diagnosticsTimer, &QTimer::timeout, this, &LspServer::publishDiagnostics);
+}
+
+LspServer::~LspServer()
+{
+    if (m_indexing) {
+        m_indexWatcher->cancel();
+        m_indexWatcher->waitForFinished();
+    }
+}
+
+QByteArray LspServer::encode(const QJsonObject& message)
+{
+    const QByteArray body = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    return "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+}
+
+qsizetype LspServer::contentLength(const QByteArray& header)
+{
+    for (const QByteArray& line : header.split('\n')) {
+        const QByteArray field = line.trimmed();
+        if (!field.toLower().startsWith("content-length:")) continue;
+        bool ok = false;
+        const qsizetype length = field.mid(15).trimmed().toLongLong(&ok);
+        return ok && length >= 0 ? length : -1;
+    }
+    return -1;
+}
+
+void LspServer::setDiagnosticsDelay(int ms)
+{
+    m_diagnosticsTimer->setInterval(ms);
+}
+
+// ----- Transport -----
+
+void LspServer::receive(const QByteArray& bytes)
+{
+    m_buffer += bytes;
+    for (;;) {
+        const qsizetype headerEnd = m_buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) return;
+
+        const qsizetype length = contentLength(m_buffer.left(headerEnd));
+        const qsizetype bodyStart = headerEnd + 4;
+        if (length < 0) {
+            // Ohne Länge lässt sich der Body nicht abgrenzen: Header verwerfen und neu synchronisieren
+            LOG_INFO(lcLsp) << "Dropping message without Content-Length";
+            m_buffer.remove(0, bodyStart);
+            continue;
+        }
+        if (m_buffer.size() - bodyStart < length) return;
+
+        const QByteArray body = m_buffer.mid(bodyStart, length);
+        m_buffer.remove(0, bodyStart + length);
+
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(body, &error);
+        if (error.error != QJsonParseError::NoError || !document.isObject()) {
+            respondError(QJsonValue::Null, PARSE_ERROR, error.errorString());
+            continue;
+        }
+        dispatch(document.object());
+    }
+}
+
+void LspServer::dispatch(const QJsonObject& message)
+{
+    const QString method = message.value(u"method"_qs).toString();
+    if (method.isEmpty()) return; // Antworten des Clients auf unsere Anfragen: keine
+
+    TRACE_SCOPE("LspServer::dispatch");
+    const bool isRequest = message.contains(u"id"_qs);
+    const QJsonValue id = message.value(u"id"_qs);
+    const QJsonObject params = message.value(u"params"_qs).toObject();
+    LOG_DEBUG(lcLsp) << "<--" << method;
+
+    if (method == u"exit"_qs) {
+        emit exitRequested(m_shutdown ? 0 : 1);
+        return;
+    }
+    if (m_shutdown) {
+        if (isRequest) respondError(id, INVALID_REQUEST, u"Server is shutting down"_qs);
+        return;
+    }
+
+    if (method == u"initialize"_qs)                        respond(id, initialize(params));
+    else if (method == u"shutdown"_qs)                     { m_shutdown = true; respond(id, QJsonValue::Null); }
+    else if (method == u"textDocument/didOpen"_qs)         didOpen(params);
+    else if (method == u"textDocument/didChange"_qs)       didChange(params);
+    else if (method == u"textDocument/didClose"_qs)        didClose(params);
+    else if (method == u"textDocument/completion"_qs)      respond(id, completion(params));
+    else if (method == u"textDocument/definition"_qs)      respond(id, definition(params));
+    else if (method == u"textDocument/references"_qs)      respond(id, references(params));
+    else if (method == u"textDocument/documentSymbol"_qs)  respond(id, documentSymbol(params));
+    else if (isRequest)                                    respondError(id, METHOD_NOT_FOUND, u"Unhandled method "_qs + method);
+    // Unbekannte Notifications (initialized, $/cancelRequest, didSave, ...) werden ignoriert
+}
+
+void LspServer::respond(const QJsonValue& id, const QJsonValue& result)
+{
+    emit send(encode({{u"jsonrpc"_qs, u"2.0"_qs}, {u"id"_qs, id}, {u"result"_qs, result}}));
+}
+
+void LspServer::respondError(const QJsonValue& id, int code, const QString& message)
+{
+    const QJsonObject error{{u"code"_qs, code}, {u"message"_qs, message}};
+    emit send(encode({{u"jsonrpc"_qs, u"2.0"_qs}, {u"id"_qs, id}, {u"error"_qs, error}}));
+}
+
+void LspServer::notify(const QString& method, const QJsonObject& params)
+{
+    emit send(encode({{u"jsonrpc"_qs, u"2.0"_qs}, {u"method"_qs, method}, {u"params"_qs, params}}));
+}
+
+// ----- Lebenszyklus & Dokumente -----
+
+QJsonObject LspServer::initialize(const QJsonObject& params)
+{
+    QString root = pathFromUri(params.value(u"rootUri"_qs).toString());
+    if (root.isEmpty())
+        root = params.value(u"rootPath"_qs).toString();
+    if (root.isEmpty()) {
+        const QJsonArray folders = params.value(u"workspaceFolders"_qs).toArray();
+        if (!folders.isEmpty())
+            root = pathFromUri(folders.first().toObject().value(u"uri"_qs).toString());
+    }
+    if (!root.isEmpty())
+        indexWorkspace(root);
+
+    const QJsonObject capabilities{
+        {u"textDocumentSync"_qs, QJsonObject{{u"openClose"_qs, true}, {u"change"_qs, SYNC_INCREMENTAL}}},
+        {u"completionProvider"_qs, QJsonObject{{u"triggerCharacters"_qs, QJsonArray{u"."_qs, u":"_qs}}}},
+        {u"definitionProvider"_qs, true},
+        {u"referencesProvider"_qs, true},
+        {u"documentSymbolProvider"_qs, true},
+    };
+    return {
+        {u"capabilities"_qs, capabilities},
+        {u"serverInfo"_qs, QJsonObject{{u"name"_qs, u"LuaAutoCompleteQt6"_qs},
+                                       {u"version"_qs, QCoreApplication::applicationVersion()}}},
+    };
+}
+
+void LspServer::didOpen(const QJsonObject& params)
+{
+    const QJsonObject item = params.value(u"textDocument"_qs).toObject();
+    const QString path = pathFromUri(item.value(u"uri"_qs).toString());
+    if (path.isEmpty()) return;
+
+    Document& doc = m_documents[path];
+    doc.path = path;
+    doc.text = item.value(u"text"_qs).toString();
+    doc.version = item.value(u"version"_qs).toInt();
+    doc.dirty = true;
+    if (m_workspaceTables.contains(path)) updateClosedFile(path);
+    scheduleDiagnostics(path);
+}
+
+void LspServer::didChange(const QJsonObject& params)
+{
+    TRACE_SCOPE("LspServer::didChange");
+    Document* doc = document(params);
+    if (!doc) return;
+
+    // Änderungen in Reihenfolge anwenden; ohne "range" ersetzt eine Änderung den ganzen Text
+    for (const QJsonValue& value : params.value(u"contentChanges"_qs).toArray()) {
+        const QJsonObject change = value.toObject();
+        const QString text = change.value(u"text"_qs).toString();
+        if (!change.contains(u"range"_qs)) {
+            doc->text = text;
+            continue;
+        }
+        const QJsonObject changeRange = change.value(u"range"_qs).toObject();
+        const qsizetype start = offsetAt(doc->text, changeRange.value(u"start"_qs).toObject());
+        const qsizetype end = std::max(start, offsetAt(doc->text, changeRange.value(u"end"_qs).toObject()));
+        doc->text.replace(start, end - start, text);
+    }
+    doc->version = params.value(u"textDocument"_qs).toObject().value(u"version"_qs).toInt(doc->version);
+    doc->dirty = true; // neu geparst wird erst bei Bedarf
+    scheduleDiagnostics(doc->path);
+}
+
+void LspServer::didClose(const QJsonObject& params)
+{
+    const QString uri = params.value(u"textDocument"_qs).toObject().value(u"uri"_qs).toString();
+    const QString path = pathFromUri(uri);
+    if (!m_documents.remove(path)) return;
+    m_pendingDiagnostics.remove(path);
+
+    // Ab jetzt gilt wieder der Stand auf der Platte (evtl. inzwischen gespeichert)
+    if (m_workspaceTables.contains(path)) {
+        const IndexedFile file = parseFromDisk(path);
+        if (file.ok) m_workspaceTables.insert(path, file.table);
+        else m_workspaceTables.remove(path);
+        updateClosedFile(path);
+    }
+    notify(u"textDocument/publishDiagnostics"_qs, {{u"uri"_qs, uri}, {u"diagnostics"_qs, QJsonArray{}}});
+}
+
+// ----- Anfragen -----
+
+QJsonValue LspServer::completion(const QJsonObject& params)
+{
+    TRACE_SCOPE("LspServer::completion");
+    QJsonObject result{{u"isIncomplete"_qs, false}, {u"items"_qs, QJsonArray{}}};
+    Document* doc = document(params);
+    if (!doc) return result;
+
+    const QJsonObject cursorPos = params.value(u"position"_qs).toObject();
+    const qsizetype cursor = offsetAt(doc->text, cursorPos);
+    const qsizetype lineStart = doc->text.lastIndexOf(u'\n', cursor - 1) + 1;
+    const QString before = doc->text.mid(lineStart, cursor - lineStart);
+
+    const QList<const SymbolTable*> tables = layers();
+    QMap<QString, QJsonObject> items; // sortiert und ohne Duplikate
+    auto addSymbol = [&](const QString& label, const QString& parent) {
+        if (items.contains(label)) return;
+        QJsonObject item{{u"label"_qs, label}};
+        for (const SymbolTable* table : tables) {
+            if (const auto symbol = table->findDefinition(label, parent)) {
+                item[u"kind"_qs] = completionKind(symbol->kind);
+                if (!symbol->signature.isEmpty()) item[u"detail"_qs] = label + symbol->signature;
+                break;
+            }
+        }
+        items.insert(label, item);
+    };
+    auto addBuiltin = [&](const LuaBuiltins::Entry& entry, const QString& label) {
+        if (items.contains(label)) return;
+        QJsonObject item{{u"label"_qs, label}, {u"kind"_qs, completionKind(entry.kind)}};
+        if (entry.isFunction()) item[u"detail"_qs] = fromAscii(entry.name) + fromAscii(entry.signature);
+        items.insert(label, item);
+    };
+
+    const QRegularExpressionMatch member = kMemberPrefixRe.match(before);
+    if (member.hasMatch()) {
+        QString parent = member.captured(1);
+        parent.replace(u':', u'.');
+        const QString prefix = member.captured(2);
+        for (const SymbolTable* table : tables) {
+            for (const QString& name : table->getMembers(parent))
+                if (name.startsWith(prefix)) addSymbol(name, parent);
+        }
+        for (const LuaBuiltins::Entry& entry : LuaBuiltins::ENTRIES) {
+            if (fromAscii(entry.library()) != parent) continue;
+            const QString name = fromAscii(entry.member());
+            if (name.startsWith(prefix)) addBuiltin(entry, name);
+        }
+    } else {
+        const QString prefix = kIdentPrefixRe.match(before).captured(0);
+        for (const Document& open : std::as_const(m_documents)) {
+            for (const QString& name : open.table.getGlobals())
+                if (name.startsWith(prefix)) addSymbol(name, {});
+        }
+        // Workspace-Globals vorsortiert: Präfixbereich per Binärsuche statt Vollscan
+        const QStringList& globals = m_closed.globals;
+        for (auto it = std::lower_bound(globals.begin(), globals.end(), prefix);
+             it != globals.end() && it->startsWith(prefix) && items.size() <= MAX_COMPLETION_ITEMS; ++it)
+            addSymbol(*it, {});
+        for (const LuaBuiltins::Entry& entry : LuaBuiltins::ENTRIES) {
+            if (!entry.library().empty()) continue;
+            const QString name = fromAscii(entry.name);
+            if (name.startsWith(prefix)) addBuiltin(entry, name);
+        }
+    }
+
+    QJsonArray list;
+    for (const QJsonObject& item : std::as_const(items)) {
+        if (list.size() >= MAX_COMPLETION_ITEMS) {
+            result[u"isIncomplete"_qs] = true;
+            break;
+        }
+        list.append(item);
+    }
+    result[u"items"_qs] = list;
+    return result;
+}
+
+QJsonValue LspServer::definition(const QJsonObject& params)
+{
+    TRACE_SCOPE("LspServer::definition");
+    Document* doc = document(params);
+    if (!doc) return QJsonValue::Null;
+
+    const QString chain = chainAt(doc->text, offsetAt(doc->text, params.value(u"position"_qs).toObject()));
+    if (chain.isEmpty()) return QJsonValue::Null;
+    QString parent, name;
+    splitChain(chain, parent, name);
+
+    for (const SymbolTable* table : layers()) {
+        if (const auto symbol = table->findDefinition(name, parent)) {
+            return QJsonObject{{u"uri"_qs, uriFromPath(symbol->filePath)},
+                               {u"range"_qs, range(symbol->pos, SymbolTable::qualifiedName(symbol->parent, symbol->name).size())}};
+        }
+    }
+    return QJsonValue::Null;
+}
+
+QJsonValue LspServer::references(const QJsonObject& params)
+{
+    TRACE_SCOPE("LspServer::references");
+    Document* doc = document(params);
+    if (!doc) return QJsonArray{};
+
+    const QString chain = chainAt(doc->text, offsetAt(doc->text, params.value(u"position"_qs).toObject()));
+    if (chain.isEmpty()) return QJsonArray{};
+    QString parent, name;
+    splitChain(chain, parent, name);
+    const bool includeDeclaration =
+        params.value(u"context"_qs).toObject().value(u"includeDeclaration"_qs).toBool(true);
+
+    QList<Reference> found;
+    for (const SymbolTable* table : layers())
+        found += table->findUsages(name, parent);
+
+    // Definitionen tauchen zusätzlich als einfache Kette auf: pro Position nur ein Eintrag
+    auto key = [](const Reference& r) { return u"%1:%2:%3"_qs.arg(r.filePath).arg(r.pos.line).arg(r.pos.column); };
+    QSet<QString> definitions;
+    for (const Reference& reference : std::as_const(found))
+        if (reference.isDefinition) definitions.insert(key(reference));
+
+    std::sort(found.begin(), found.end(), [](const Reference& a, const Reference& b) {
+        if (a.filePath != b.filePath) return a.filePath < b.filePath;
+        if (a.pos.line != b.pos.line) return a.pos.line < b.pos.line;
+        return a.pos.column < b.pos.column;
+    });
+
+    QJsonArray locations;
+    QSet<QString> seen;
+    for (const Reference& reference : std::as_const(found)) {
+        const QString k = key(reference);
+        if (seen.contains(k)) continue;
+        seen.insert(k);
+        if (!includeDeclaration && definitions.contains(k)) continue;
+        locations.append(QJsonObject{{u"uri"_qs, uriFromPath(reference.filePath)},
+                                     {u"range"_qs, range(reference.pos, reference.qualifiedName.size())}});
+    }
+    return locations;
+}
+
+QJsonValue LspServer::documentSymbol(const QJsonObject& params)
+{
+    Document* doc = document(params);
+    if (!doc) return QJsonArray{};
+
+    QList<Symbol> symbols;
+    for (const Symbol& symbol : tableOf(*doc).symbols())
+        if (symbol.filePath == doc->path) symbols.append(symbol);
+    std::sort(symbols.begin(), symbols.end(), [](const Symbol& a, const Symbol& b) {
+        return a.pos.line != b.pos.line ? a.pos.line < b.pos.line : a.pos.column < b.pos.column;
+    });
+
+    const QString uri = uriFromPath(doc->path);
+    QJsonArray result;
+    for (const Symbol& symbol : std::as_const(symbols)) {
+        QJsonObject info{
+            {u"name"_qs, symbol.name},
+            {u"kind"_qs, symbolKind(symbol.kind)},
+            {u"location"_qs, QJsonObject{{u"uri"_qs, uri},
+                                         {u"range"_qs, range(symbol.pos, SymbolTable::qualifiedName(symbol.parent, symbol.name).size())}}},
+        };
+        if (!symbol.parent.isEmpty()) info[u"containerName"_qs] = symbol.parent;
+        result.append(info);
+    }
+    return result;
+}
+
+// ----- Workspace-Index -----
+
+LspServer::IndexedFile LspServer::parseFromDisk(const QString& path)
+{
+    IndexedFile result;
+    result.path = path;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return result;
+    LuaParser parser;
+    result.table = parser.parseOne(QString::fromUtf8(file.readAll()), path);
+    result.ok = true;
+    return result;
+}
+
+void LspServer::indexWorkspace(const QString& root)
+{
+    if (m_indexing || !QDir(root).exists()) return;
+
+    QStringList files;
+    QDirIterator it(root, {u"*.lua"_qs}, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        files.append(QDir::cleanPath(it.next()));
+    std::sort(files.begin(), files.end());
+
+    LOG_INFO(lcLsp) << "Indexing" << files.size() << "files under" << root;
+    m_indexing = true;
+    m_indexWatcher->setFuture(QtConcurrent::mapped(std::move(files), &LspServer::parseFromDisk));
+}
+
+void LspServer::onWorkspaceIndexed()
+{
+    TRACE_SCOPE("LspServer::onWorkspaceIndexed");
+    m_indexing = false;
+    if (m_indexWatcher->isCanceled()) return;
+
+    for (const IndexedFile& file : m_indexWatcher->future().results()) {
+        if (file.ok) m_workspaceTables.insert(file.path, file.table);
+    }
+
+    // Einmal komplett aufbauen, sortiert: bei doppelten Namen gewinnt deterministisch der letzte Pfad
+    QStringList paths = m_workspaceTables.keys();
+    std::sort(paths.begin(), paths.end());
+    m_closed.files.resetProject();
+    for (const QString& path : std::as_const(paths)) {
+        if (!m_documents.contains(path))
+            m_closed.files.setFileTable(path, m_workspaceTables.value(path));
+    }
+    m_closed.globalsDirty = true;
+    closedLayer(); // Globals gleich sortieren, nicht erst bei der ersten Completion
+    LOG_INFO(lcLsp) << "Workspace indexed:" << m_workspaceTables.size() << "files";
+    emit workspaceIndexed(static_cast<int>(m_workspaceTables.size()));
+}
+
+void LspServer::updateClosedFile(const QString& path)
+{
+    // Offen oder nicht (mehr) im Workspace: kein Beitrag; sonst der Stand auf der Platte
+    const auto it = m_workspaceTables.constFind(path);
+    const SymbolDelta delta = m_documents.contains(path) || it == m_workspaceTables.constEnd()
+        ? m_closed.files.removeFile(path)
+        : m_closed.files.setFileTable(path, it.value());
+    if (!delta.added.isEmpty() || !delta.removed.isEmpty())
+        m_closed.globalsDirty = true;
+}
+
+const LspServer::ClosedLayer& LspServer::closedLayer()
+{
+    if (!m_closed.globalsDirty) return m_closed;
+    TRACE_SCOPE("LspServer::closedLayer");
+
+    m_closed.globals = m_closed.files.getGlobals();
+    std::sort(m_closed.globals.begin(), m_closed.globals.end());
+    m_closed.globalsDirty = false;
+    return m_closed;
+}
+
+const SymbolTable& LspServer::tableOf(Document& doc)
+{
+    if (doc.dirty) {
+        LuaParser parser;
+        doc.table = parser.parseOne(doc.text, doc.path);
+        doc.dirty = false;
+    }
+    return doc.table;
+}
+
+QList<const SymbolTable*> LspServer::layers()
+{
+    QList<const SymbolTable*> result;
+    for (Document& doc : m_documents)
+        result.append(&tableOf(doc));
+    result.append(&closedLayer().files.symbolTable());
+    return result;
+}
+
+LspServer::Document* LspServer::document(const QJsonObject& params)
+{
+    const QString uri = params.value(u"textDocument"_qs).toObject().value(u"uri"_qs).toString();
+    const auto it = m_documents.find(pathFromUri(uri));
+    return it == m_documents.end() ? nullptr : &it.value();
+}
+
+// ----- Diagnosen -----
+
+void LspServer::scheduleDiagnostics(const QString& path)
+{
+    m_pendingDiagnostics.insert(path);
+    m_diagnosticsTimer->start();
+}
+
+void LspServer::publishDiagnostics()
+{
+    TRACE_SCOPE("LspServer::publishDiagnostics");
+    const QSet<QString> pending = std::exchange(m_pendingDiagnostics, {});
+    for (const QString& path : pending) {
+        const auto it = m_documents.find(path);
+        if (it == m_documents.end()) continue;
+        Document& doc = it.value();
+        tableOf(doc); // Leerlauf nutzen: die nächste Anfrage muss nicht mehr parsen
+
+        QJsonArray diagnostics;
+        for (const LuaSyntaxError& error : LuaSyntaxChecker::check(doc.text.toUtf8())) {
+            const int line = std::max(error.line - 1, 0);
+            const qsizetype lineStart = offsetAt(doc.text, line, 0);
+            qsizetype lineEnd = doc.text.indexOf(u'\n', lineStart);
+            if (lineEnd < 0) lineEnd = doc.text.size();
+            const QString lineText = doc.text.mid(lineStart, lineEnd - lineStart);
+
+            // Markiert das Token hinter "near", sonst die Zeile ohne Einrückung
+            qsizetype start = error.nearToken.isEmpty() ? -1 : lineText.indexOf(error.nearToken);
+            qsizetype end = start + error.nearToken.size();
+            if (start < 0) {
+                start = 0;
+                while (start < lineText.size() && lineText.at(start).isSpace()) ++start;
+                end = lineText.size();
+            }
+            diagnostics.append(QJsonObject{
+                {u"range"_qs, QJsonObject{{u"start"_qs, position(line, static_cast<int>(start))},
+                                          {u"end"_qs, position(line, static_cast<int>(end))}}},
+                {u"severity"_qs, SEVERITY_ERROR},
+                {u"source"_qs, u"lua"_qs},
+                {u"message"_qs, error.message},
+            });
+        }
+        notify(u"textDocument/publishDiagnostics"_qs,
+               {{u"uri"_qs, uriFromPath(path)}, {u"version"_qs, doc.version}, {u"diagnostics"_qs, diagnostics}});
+    }
+}
+
+// ----- URIs -----
+
+QString LspServer::pathFromUri(const QString& uri)
+{
+    const QUrl url(uri);
+    return url.isLocalFile() ? QDir::cleanPath(url.toLocalFile()) : QString();
+}
+
+QString LspServer::uriFromPath(const QString& path)
+{
+    return QUrl::fromLocalFile(path).toString(QUrl::FullyEncoded);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "LuaParser.h"
+
+class QTimer;
+
+/**
+ * Language Server (JSON-RPC 2.0, "Content-Length"-Framing) auf Basis von LuaParser/SymbolTable:
+ *  - receive() nimmt beliebig gestückelte Bytes entgegen, send() liefert fertig gerahmte Antworten;
+ *    die stdio-Anbindung (Lesethread, stdout) macht main.cpp, das Objekt selbst lebt dort in
+ *    einem eigenen QThread
+ *  - textDocument/didOpen, didChange (inkrementell), didClose; completion, definition,
+ *    references, documentSymbol; Diagnosen per publishDiagnostics (LuaSyntaxChecker)
+ *  - der Workspace (rootUri) wird parallel auf dem globalen Pool indiziert; offene Dokumente
+ *    überdecken ihre Workspace-Datei und werden erst bei der nächsten Anfrage neu geparst
+ *  - Positionen sind LSP-üblich 0-basiert in UTF-16 Code units, passend zu QString
+ */
+class LspServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LspServer(QObject* parent = nullptr);
+    ~LspServer() override;
+
+    // Rahmt eine Nachricht: "Content-Length: N\r\n\r\n" + kompaktes JSON
+    static QByteArray encode(const QJsonObject& message);
+    // Wert von "Content-Length" aus einem Header-Block; -1 wenn er fehlt oder ungültig ist
+    static qsizetype contentLength(const QByteArray& header);
+
+    // Verzögerung der Diagnosen nach einer Änderung (Standard 200 ms)
+    void setDiagnosticsDelay(int ms);
+
+    [[nodiscard]] bool isIndexing() const { return m_indexing; }
+    [[nodiscard]] int workspaceFileCount() const { return static_cast<int>(m_workspaceTables.size()); }
+    [[nodiscard]] int openDocumentCount() const { return static_cast<int>(m_documents.size()); }
+
+public slots:
+    void receive(const QByteArray& bytes);
+
+signals:
+    void send(const QByteArray& framed);
+    void exitRequested(int code);
+    void workspaceIndexed(int files);
+
+private:
+    struct Document {
+        QString path;
+        QString text;
+        int version = 0;
+        SymbolTable table;
+        bool dirty = true;  // Text geändert, table veraltet
+    };
+
+    // Workspace ohne die offenen Dokumente; Öffnen/Schließen tauscht nur den Beitrag der Datei aus
+    struct ClosedLayer {
+        LuaParser files;
+        QStringList globals;  // sortiert (operator<), für Präfixsuche per lower_bound
+        bool globalsDirty = true;
+    };
+
+    struct IndexedFile {
+        QString path;
+        SymbolTable table;
+        bool ok = false;
+    };
+
+    void dispatch(const QJsonObject& message);
+    void respond(const QJsonValue& id, const QJsonValue& result);
+    void respondError(const QJsonValue& id, int code, const QString& message);
+    void notify(const QString& method, const QJsonObject& params);
+
+    QJsonObject initialize(const QJsonObject& params);
+    void didOpen(const QJsonObject& params);
+    void didChange(const QJsonObject& params);
+    void didClose(const QJsonObject& params);
+    QJsonValue completion(const QJsonObject& params);
+    QJsonValue definition(const QJsonObject& params);
+    QJsonValue references(const QJsonObject& params);
+    QJsonValue documentSymbol(const QJsonObject& params);
+
+    void indexWorkspace(const QString& root);
+    void onWorkspaceIndexed();
+    void scheduleDiagnostics(const QString& path);
+    void publishDiagnostics();
+
+    static IndexedFile parseFromDisk(const QString& path);
+
+    Document* document(const QJsonObject& params);
+    const SymbolTable& tableOf(Document& doc);
+    const ClosedLayer& closedLayer();
+    void updateClosedFile(const QString& path); // Beitrag einer Datei neu bestimmen (offen → keiner)
+    QList<const SymbolTable*> layers();  // offene Dokumente zuerst, dann der Workspace
+
+    static QString pathFromUri(const QString& uri);
+    static QString uriFromPath(const QString& path);
+
+    QByteArray m_buffer;
+    QHash<QString, Document> m_documents;           // lokaler Pfad -> Dokument
+    QHash<QString, SymbolTable> m_workspaceTables;  // lokaler Pfad -> Tabelle der Datei auf Platte
+    ClosedLayer m_closed;
+
+    QFutureWatcher<IndexedFile>* m_indexWatcher = nullptr;
+    bool m_indexing = false;
+
+    QTimer* m_diagnosticsTimer = nullptr;
+    QSet<QString> m_pendingDiagnostics;
+
+    bool m_shutdown = false;
+};
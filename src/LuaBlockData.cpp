@@ -0,0 +1,83 @@
+#include "LuaBlockData.h"
+
+#include <algorithm>
+
+bool LuaBlockData::update(const QTextBlock& block, const QString& text, int state)
+{
+    if (revision == block.revision() && startState == state)
+        return false;
+
+    tokens.clear();
+    endState = LuaLexer::tokenizeLine(text, state, tokens);
+    startState = state;
+    revision = block.revision();
+    return true;
+}
+
+int LuaBlockData::startStateFor(const QTextBlock& block)
+{
+    const QTextBlock previous = block.previous();
+    return previous.isValid() ? qMax(LuaLexer::STATE_NORMAL, previous.userState())
+                              : LuaLexer::STATE_NORMAL;
+}
+
+const LuaBlockData* LuaBlockData::ensure(QTextBlock block)
+{
+    if (!block.isValid()) return nullptr;
+
+    auto* data = static_cast<LuaBlockData*>(block.userData());
+    const int state = startStateFor(block);
+    if (data && data->revision == block.revision() && data->startState == state)
+        return data;
+
+    if (!data) {
+        data = new LuaBlockData;
+        block.setUserData(data); // Block übernimmt den Besitz
+    }
+    data->update(block, block.text(), state);
+    return data;
+}
+
+const LuaToken* LuaBlockData::tokenAt(int column) const
+{
+    // Tokens sind nach start sortiert und überlappen nicht
+    const auto it = std::upper_bound(tokens.cbegin(), tokens.cend(), column,
+                                     [](int col, const LuaToken& token) { return col < token.start; });
+    if (it == tokens.cbegin()) return nullptr;
+
+    const LuaToken& token = *std::prev(it);
+    return column < token.start + token.length ? &token : nullptr;
+}
+
+bool LuaBlockData::isInStringOrComment(const QTextCursor& cursor)
+{
+    const QTextBlock block = cursor.block();
+    const LuaBlockData* data = ensure(block);
+    if (!data) return false;
+
+    // Zeilenanfang bzw. leere Zeile: entscheidet der Zustand aus dem Vorgängerblock
+    const int column = cursor.positionInBlock();
+    if (column == 0 || data->tokens.isEmpty())
+        return LuaLexer::longBracketKind(data->startState) != LuaLexer::LongBracketKind::None;
+
+    // Cursor direkt hinter einem Token: nur "drin", wenn das Token offen bleibt
+    const LuaToken* token = data->tokenAt(column - 1);
+    if (!token) return false;
+
+    switch (token->kind) {
+    case LuaTokenKind::Comment:
+        return true;
+    case LuaTokenKind::LongComment:
+    case LuaTokenKind::LongString:
+        if (column < token->start + token->length) return true;
+        return token == &data->tokens.constLast() && data->endState != LuaLexer::STATE_NORMAL;
+    case LuaTokenKind::String: {
+        if (column < token->start + token->length) return true;
+        const QString text = block.text();
+        const int last = token->start + token->length - 1;
+        return token->length == 1 || text.at(last) != text.at(token->start);
+    }
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QTextBlock>
+#include <QTextBlockUserData>
+#include <QTextCursor>
+
+#include "LuaLexer.h"
+
+/**
+ * Token-Cache pro QTextBlock (QTextBlockUserData):
+ *  - wird vom LuaHighlighter beim Hervorheben gefüllt
+ *  - Einrückung, Funktionsindex, Symbolsuche und Completion lesen daraus,
+ *    statt dieselbe Zeile erneut zu scannen
+ *  - gültig, solange QTextBlock::revision() und der Startzustand übereinstimmen
+ */
+class LuaBlockData : public QTextBlockUserData
+{
+public:
+    int revision = -1;
+    int startState = LuaLexer::STATE_NORMAL;
+    int endState = LuaLexer::STATE_NORMAL;
+    QList<LuaToken> tokens;
+
+    // Neu lexen, falls Revision oder Startzustand nicht passen; true = neu gelext
+    bool update(const QTextBlock& block, const QString& text, int startState);
+
+    // Cache eines Blocks (wird bei Bedarf angelegt bzw. aktualisiert); nullptr bei ungültigem Block
+    static const LuaBlockData* ensure(QTextBlock block);
+
+    // Token, in dem die Spalte liegt (start <= column < end), sonst nullptr
+    [[nodiscard]] const LuaToken* tokenAt(int column) const;
+
+    // true, wenn der Cursor in einem String oder Kommentar steht
+    static bool isInStringOrComment(const QTextCursor& cursor);
+
+    // Startzustand eines Blocks laut Highlighter (Zustand des Vorgängers)
+    static int startStateFor(const QTextBlock& block);
+};
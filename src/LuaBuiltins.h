@@ -0,0 +1,268 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Lua-Schlüsselwörter und Built-ins (Lua 5.4.8) als constexpr-Tabelle
+ * mit zur Compile-Zeit gesuchter perfekter Hashfunktion:
+ *  - lookup() ist O(1): ein Hash, ein Tabellenzugriff, ein Stringvergleich
+ *  - funktioniert für UTF-16 (QStringView) und UTF-8-Bytes gleichermaßen
+ *  - einzige Quelle für Lexer/Highlighter und Completion: Art, Bibliothek
+ *    und Signatur stehen am Eintrag
+ */
+namespace LuaBuiltins {
+
+enum class WordKind : std::uint8_t {
+    Keyword,
+    Builtin,    // Funktionen und Werte (print, string.format, math.pi)
+    Library     // Bibliothekstabellen (string, table, ...); im Lexer normale Bezeichner
+};
+
+struct Entry {
+    std::string_view name;
+    WordKind kind;
+    std::string_view signature{}; // Parameterliste wie im Handbuch; leer bei Keywords, Bibliotheken und Werten
+
+    // "string.format" → "string" / "format"; ohne Punkt: "" / name
+    constexpr std::string_view library() const {
+        const std::size_t dot = name.find('.');
+        return dot == std::string_view::npos ? std::string_view{} : name.substr(0, dot);
+    }
+    constexpr std::string_view member() const {
+        const std::size_t dot = name.find('.');
+        return dot == std::string_view::npos ? name : name.substr(dot + 1);
+    }
+    constexpr bool isFunction() const { return !signature.empty(); }
+};
+
+inline constexpr auto ENTRIES = std::to_array<Entry>({
+    // Keywords
+    {"and", WordKind::Keyword}, {"break", WordKind::Keyword}, {"do", WordKind::Keyword},
+    {"else", WordKind::Keyword}, {"elseif", WordKind::Keyword}, {"end", WordKind::Keyword},
+    {"false", WordKind::Keyword}, {"for", WordKind::Keyword}, {"function", WordKind::Keyword},
+    {"if", WordKind::Keyword}, {"in", WordKind::Keyword}, {"local", WordKind::Keyword},
+    {"nil", WordKind::Keyword}, {"not", WordKind::Keyword}, {"or", WordKind::Keyword},
+    {"repeat", WordKind::Keyword}, {"return", WordKind::Keyword}, {"then", WordKind::Keyword},
+    {"true", WordKind::Keyword}, {"until", WordKind::Keyword}, {"while", WordKind::Keyword},
+    {"goto", WordKind::Keyword},
+
+    // Basisfunktionen
+    {"assert", WordKind::Builtin, "(v [, message])"},
+    {"collectgarbage", WordKind::Builtin, "([opt [, arg]])"},
+    {"dofile", WordKind::Builtin, "([filename])"},
+    {"error", WordKind::Builtin, "(message [, level])"},
+    {"getmetatable", WordKind::Builtin, "(object)"},
+    {"ipairs", WordKind::Builtin, "(t)"},
+    {"load", WordKind::Builtin, "(chunk [, chunkname [, mode [, env]]])"},
+    {"loadfile", WordKind::Builtin, "([filename [, mode [, env]]])"},
+    {"next", WordKind::Builtin, "(table [, index])"},
+    {"pairs", WordKind::Builtin, "(t)"},
+    {"pcall", WordKind::Builtin, "(f [, arg1, ...])"},
+    {"print", WordKind::Builtin, "(...)"},
+    {"rawequal", WordKind::Builtin, "(v1, v2)"},
+    {"rawget", WordKind::Builtin, "(table, index)"},
+    {"rawlen", WordKind::Builtin, "(v)"},
+    {"rawset", WordKind::Builtin, "(table, index, value)"},
+    {"require", WordKind::Builtin, "(modname)"},
+    {"select", WordKind::Builtin, "(index, ...)"},
+    {"setmetatable", WordKind::Builtin, "(table, metatable)"},
+    {"tonumber", WordKind::Builtin, "(e [, base])"},
+    {"tostring", WordKind::Builtin, "(v)"},
+    {"type", WordKind::Builtin, "(v)"},
+    {"warn", WordKind::Builtin, "(msg1, ...)"},
+    {"xpcall", WordKind::Builtin, "(f, msgh [, arg1, ...])"},
+    {"_G", WordKind::Builtin}, {"_VERSION", WordKind::Builtin},
+
+    // Bibliotheken
+    {"coroutine", WordKind::Library}, {"debug", WordKind::Library}, {"io", WordKind::Library},
+    {"math", WordKind::Library}, {"os", WordKind::Library}, {"package", WordKind::Library},
+    {"string", WordKind::Library}, {"table", WordKind::Library}, {"utf8", WordKind::Library},
+
+    // Table
+    {"table.concat", WordKind::Builtin, "(list [, sep [, i [, j]]])"},
+    {"table.insert", WordKind::Builtin, "(list, [pos,] value)"},
+    {"table.move", WordKind::Builtin, "(a1, f, e, t [, a2])"},
+    {"table.pack", WordKind::Builtin, "(...)"},
+    {"table.remove", WordKind::Builtin, "(list [, pos])"},
+    {"table.sort", WordKind::Builtin, "(list [, comp])"},
+    {"table.unpack", WordKind::Builtin, "(list [, i [, j]])"},
+
+    // String
+    {"string.byte", WordKind::Builtin, "(s [, i [, j]])"},
+    {"string.char", WordKind::Builtin, "(...)"},
+    {"string.dump", WordKind::Builtin, "(function [, strip])"},
+    {"string.find", WordKind::Builtin, "(s, pattern [, init [, plain]])"},
+    {"string.format", WordKind::Builtin, "(formatstring, ...)"},
+    {"string.gmatch", WordKind::Builtin, "(s, pattern [, init])"},
+    {"string.gsub", WordKind::Builtin, "(s, pattern, repl [, n])"},
+    {"string.len", WordKind::Builtin, "(s)"},
+    {"string.lower", WordKind::Builtin, "(s)"},
+    {"string.match", WordKind::Builtin, "(s, pattern [, init])"},
+    {"string.pack", WordKind::Builtin, "(fmt, v1, v2, ...)"},
+    {"string.packsize", WordKind::Builtin, "(fmt)"},
+    {"string.rep", WordKind::Builtin, "(s, n [, sep])"},
+    {"string.reverse", WordKind::Builtin, "(s)"},
+    {"string.sub", WordKind::Builtin, "(s, i [, j])"},
+    {"string.unpack", WordKind::Builtin, "(fmt, s [, pos])"},
+    {"string.upper", WordKind::Builtin, "(s)"},
+
+    // Math
+    {"math.abs", WordKind::Builtin, "(x)"},
+    {"math.acos", WordKind::Builtin, "(x)"},
+    {"math.asin", WordKind::Builtin, "(x)"},
+    {"math.atan", WordKind::Builtin, "(y [, x])"},
+    {"math.ceil", WordKind::Builtin, "(x)"},
+    {"math.cos", WordKind::Builtin, "(x)"},
+    {"math.deg", WordKind::Builtin, "(x)"},
+    {"math.exp", WordKind::Builtin, "(x)"},
+    {"math.floor", WordKind::Builtin, "(x)"},
+    {"math.fmod", WordKind::Builtin, "(x, y)"},
+    {"math.log", WordKind::Builtin, "(x [, base])"},
+    {"math.max", WordKind::Builtin, "(x, ...)"},
+    {"math.min", WordKind::Builtin, "(x, ...)"},
+    {"math.modf", WordKind::Builtin, "(x)"},
+    {"math.rad", WordKind::Builtin, "(x)"},
+    {"math.random", WordKind::Builtin, "([m [, n]])"},
+    {"math.randomseed", WordKind::Builtin, "([x [, y]])"},
+    {"math.sin", WordKind::Builtin, "(x)"},
+    {"math.sqrt", WordKind::Builtin, "(x)"},
+    {"math.tan", WordKind::Builtin, "(x)"},
+    {"math.tointeger", WordKind::Builtin, "(x)"},
+    {"math.type", WordKind::Builtin, "(x)"},
+    {"math.ult", WordKind::Builtin, "(m, n)"},
+    {"math.huge", WordKind::Builtin}, {"math.maxinteger", WordKind::Builtin},
+    {"math.mininteger", WordKind::Builtin}, {"math.pi", WordKind::Builtin},
+
+    // OS
+    {"os.clock", WordKind::Builtin, "()"},
+    {"os.date", WordKind::Builtin, "([format [, time]])"},
+    {"os.difftime", WordKind::Builtin, "(t2, t1)"},
+    {"os.execute", WordKind::Builtin, "([command])"},
+    {"os.exit", WordKind::Builtin, "([code [, close]])"},
+    {"os.getenv", WordKind::Builtin, "(varname)"},
+    {"os.remove", WordKind::Builtin, "(filename)"},
+    {"os.rename", WordKind::Builtin, "(oldname, newname)"},
+    {"os.setlocale", WordKind::Builtin, "(locale [, category])"},
+    {"os.time", WordKind::Builtin, "([table])"},
+    {"os.tmpname", WordKind::Builtin, "()"},
+
+    // IO
+    {"io.close", WordKind::Builtin, "([file])"},
+    {"io.flush", WordKind::Builtin, "()"},
+    {"io.input", WordKind::Builtin, "([file])"},
+    {"io.lines", WordKind::Builtin, "([filename, ...])"},
+    {"io.open", WordKind::Builtin, "(filename [, mode])"},
+    {"io.output", WordKind::Builtin, "([file])"},
+    {"io.popen", WordKind::Builtin, "(prog [, mode])"},
+    {"io.read", WordKind::Builtin, "(...)"},
+    {"io.tmpfile", WordKind::Builtin, "()"},
+    {"io.type", WordKind::Builtin, "(obj)"},
+    {"io.write", WordKind::Builtin, "(...)"},
+    {"io.stdin", WordKind::Builtin}, {"io.stdout", WordKind::Builtin}, {"io.stderr", WordKind::Builtin},
+
+    // Coroutine
+    {"coroutine.close", WordKind::Builtin, "(co)"},
+    {"coroutine.create", WordKind::Builtin, "(f)"},
+    {"coroutine.isyieldable", WordKind::Builtin, "([co])"},
+    {"coroutine.resume", WordKind::Builtin, "(co [, val1, ...])"},
+    {"coroutine.running", WordKind::Builtin, "()"},
+    {"coroutine.status", WordKind::Builtin, "(co)"},
+    {"coroutine.wrap", WordKind::Builtin, "(f)"},
+    {"coroutine.yield", WordKind::Builtin, "(...)"},
+
+    // UTF-8
+    {"utf8.char", WordKind::Builtin, "(...)"},
+    {"utf8.codes", WordKind::Builtin, "(s [, lax])"},
+    {"utf8.codepoint", WordKind::Builtin, "(s [, i [, j [, lax]]])"},
+    {"utf8.len", WordKind::Builtin, "(s [, i [, j [, lax]]])"},
+    {"utf8.offset", WordKind::Builtin, "(s, n [, i])"},
+    {"utf8.charpattern", WordKind::Builtin},
+
+    // Debug
+    {"debug.debug", WordKind::Builtin, "()"},
+    {"debug.gethook", WordKind::Builtin, "([thread])"},
+    {"debug.getinfo", WordKind::Builtin, "([thread,] f [, what])"},
+    {"debug.getlocal", WordKind::Builtin, "([thread,] f, local)"},
+    {"debug.getmetatable", WordKind::Builtin, "(value)"},
+    {"debug.getupvalue", WordKind::Builtin, "(f, up)"},
+    {"debug.sethook", WordKind::Builtin, "([thread,] hook, mask [, count])"},
+    {"debug.setmetatable", WordKind::Builtin, "(value, table)"},
+    {"debug.setupvalue", WordKind::Builtin, "(f, up, value)"},
+    {"debug.traceback", WordKind::Builtin, "([thread,] [message [, level]])"},
+
+    // Package
+    {"package.searchpath", WordKind::Builtin, "(name, path [, sep [, rep]])"},
+    {"package.config", WordKind::Builtin}, {"package.cpath", WordKind::Builtin},
+    {"package.loaded", WordKind::Builtin}, {"package.path", WordKind::Builtin},
+    {"package.preload", WordKind::Builtin}, {"package.searchers", WordKind::Builtin}
+});
+
+// ---------------- Perfekter Hash ----------------
+
+inline constexpr std::size_t TABLE_BITS = 12;
+inline constexpr std::size_t TABLE_SIZE = std::size_t{1} << TABLE_BITS;
+inline constexpr std::uint8_t EMPTY_SLOT = 0xFF;
+static_assert(ENTRIES.size() < EMPTY_SLOT, "Slot-Index passt nicht mehr in uint8_t");
+
+template <typename CharT>
+constexpr std::uint32_t hash(const CharT* s, std::size_t len, std::uint32_t seed) {
+    std::uint32_t h = seed ^ static_cast<std::uint32_t>(len);
+    for (std::size_t i = 0; i < len; ++i) {
+        h ^= static_cast<std::uint32_t>(s[i]);
+        h *= 0x01000193u; // FNV-Prime
+    }
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+constexpr std::uint32_t findSeed() {
+    for (std::uint32_t seed = 1; seed < 100000; ++seed) {
+        std::array<bool, TABLE_SIZE> used{};
+        bool ok = true;
+        for (const Entry& e : ENTRIES) {
+            const std::size_t slot = hash(e.name.data(), e.name.size(), seed) & (TABLE_SIZE - 1);
+            if (used[slot]) { ok = false; break; }
+            used[slot] = true;
+        }
+        if (ok) return seed;
+    }
+    return 0;
+}
+
+inline constexpr std::uint32_t SEED = findSeed();
+static_assert(SEED != 0, "Kein kollisionsfreier Seed gefunden - TABLE_BITS erhöhen");
+
+inline constexpr auto SLOTS = [] {
+    std::array<std::uint8_t, TABLE_SIZE> slots{};
+    for (auto& s : slots) s = EMPTY_SLOT;
+    for (std::size_t i = 0; i < ENTRIES.size(); ++i) {
+        const auto& e = ENTRIES[i];
+        slots[hash(e.name.data(), e.name.size(), SEED) & (TABLE_SIZE - 1)] = static_cast<std::uint8_t>(i);
+    }
+    return slots;
+}();
+
+// Liefert den Tabelleneintrag für s[0..len) oder nullptr
+template <typename CharT>
+constexpr const Entry* lookup(const CharT* s, std::size_t len) {
+    const std::uint8_t idx = SLOTS[hash(s, len, SEED) & (TABLE_SIZE - 1)];
+    if (idx == EMPTY_SLOT) return nullptr;
+    const Entry& e = ENTRIES[idx];
+    if (e.name.size() != len) return nullptr;
+    for (std::size_t i = 0; i < len; ++i) {
+        if (static_cast<std::uint32_t>(s[i]) != static_cast<std::uint8_t>(e.name[i]))
+            return nullptr;
+    }
+    return &e;
+}
+
+constexpr const Entry* lookup(std::string_view word) {
+    return lookup(word.data(), word.size());
+}
+
+} // namespace LuaBuiltins
@@ -1,5 +1,13 @@
 #include "LuaEditor.h"
 #include "AutoCompleter.h"
+#include "LuaBlockData.h"
+#include "LuaBuiltins.h"
+#include "LuaHighlighter.h"
+#include "ModuleGraph.h"
+#include "ModuleResolver.h"
+#include "ReferenceIndex.h"
+#include "Log.h"
+#include "Trace.h"
 
 #include <QPainter>
 #include <QTextBlock>
@@ -14,18 +22,76 @@
 #include <QTextDocument>
 #include <QCompleter>
 #include <QTimer>
-#include <QDebug>
-#include <QDir>
-#include <QFile>
-#include <QFileInfo>
-#include <QTextStream>
+#include <QElapsedTimer>
 #include <QMouseEvent>
+#include <QToolTip>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <string_view>
 
 namespace {
+    QString fromAscii(std::string_view text) {
+        return QString::fromLatin1(text.data(), static_cast<qsizetype>(text.size()));
+    }
+
+    // Completion-Listen aus der Built-in-Tabelle; einmal aufgebaut statt pro Tastendruck
+    struct BuiltinCompletions {
+        QStringList globals;                 // Keywords, Basisfunktionen, Bibliotheksnamen
+        QHash<QString, QStringList> members; // "string" → {"byte", "char", ...}
+    };
+
+    const BuiltinCompletions& builtinCompletions() {
+        static const BuiltinCompletions completions = [] {
+            BuiltinCompletions result;
+            for (const LuaBuiltins::Entry& entry : LuaBuiltins::ENTRIES) {
+                if (entry.library().empty())
+                    result.globals.append(fromAscii(entry.name));
+                else
+                    result.members[fromAscii(entry.library())].append(fromAscii(entry.member()));
+            }
+            result.globals.append(u"self"_qs); // Important for method contexts
+            return result;
+        }();
+        return completions;
+    }
+
     // einfache Identifier-RE
     const QRegularExpression kIdentRe(uR"([A-Za-z_][A-Za-z0-9_]*)"_qs);
-    const QRegularExpression kFuncDefRe(uR"(\bfunction\s+([A-Za-z_][A-Za-z0-9_]*)\b)"_qs);
     const QRegularExpression kLocalVarRe(uR"(\blocal\s+([A-Za-z_][A-Za-z0-9_]*)\b)"_qs);
+
+    // Namenskette nach "function" (Definitionen eines Blocks aus dem Token-Cache):
+    // fn(erstes Glied, letztes Glied, "A.b.c"); ':' wird wie '.' zu einem Glied der Kette
+    template <typename Fn>
+    void forEachFunctionDefinition(const QString& text, const LuaBlockData* data, Fn&& fn) {
+        if (!data) return;
+        const QList<LuaToken>& tokens = data->tokens;
+        for (qsizetype i = 1; i < tokens.size(); ++i) {
+            // Nur direkt auf das Keyword "function" folgt ein FunctionName-Token
+            if (tokens.at(i).kind != LuaTokenKind::FunctionName || tokens.at(i - 1).kind != LuaTokenKind::Keyword)
+                continue;
+            QString chain = text.mid(tokens.at(i).start, tokens.at(i).length);
+            qsizetype last = i;
+            while (last + 2 < tokens.size() && tokens.at(last + 1).kind == LuaTokenKind::Punctuation
+                   && tokens.at(last + 2).kind == LuaTokenKind::FunctionName) {
+                last += 2;
+                chain += u'.' + text.mid(tokens.at(last).start, tokens.at(last).length);
+            }
+            fn(tokens.at(i), tokens.at(last), chain);
+            i = last;
+        }
+    }
+
+    // Verschiebt sortierte Offsets um einen Edit; Offsets im entfernten Bereich fallen weg
+    template <typename Edit>
+    void applyEdit(QList<int>& offsets, const Edit& edit) {
+        const auto first = std::lower_bound(offsets.begin(), offsets.end(), edit.position);
+        const auto last = std::lower_bound(first, offsets.end(), edit.position + edit.removed);
+        const int delta = edit.added - edit.removed;
+        for (auto it = last; it != offsets.end(); ++it)
+            *it += delta;
+        offsets.erase(first, last);
+    }
 }
 
 LuaEditor::LuaEditor(std::shared_ptr<LuaParser> parser, QWidget* parent)
@@ -58,20 +124,49 @@ LuaEditor::LuaEditor(std::shared_ptr<LuaParser> parser, QWidget* parent)
     m_parseTimer->setSingleShot(true);
     m_parseTimer->setInterval(300); // 300ms delay after last change
     connect(m_parseTimer, &QTimer::timeout, this, [this] {
-        updateFunctionIndex();
-        updateSymbols();
-        this->parseImports();
+        startIndexing();
+        // Ein Schnappschuss für Imports und Syntaxprüfung
+        const QByteArray source = toPlainText().toUtf8();
+        this->parseImports(source);
+        m_syntaxChecker->request(source, document()->revision());
     });
 
+    // Symbolindex in Zeitscheiben (0 ms: zwischen zwei Scheiben kommt die Event-Loop dran)
+    m_indexTimer = new QTimer(this);
+    m_indexTimer->setInterval(0);
+    connect(m_indexTimer, &QTimer::timeout, this, &LuaEditor::indexSlice);
+
     m_completionTimer = new QTimer(this);
     m_completionTimer->setSingleShot(true);
     m_completionTimer->setInterval(150); // 150ms delay for completion
     connect(m_completionTimer, &QTimer::timeout, this, &LuaEditor::performCompletion);
 
+    // Referenz-Offsets nur protokollieren; eingerechnet wird beim nächsten Zugriff
+    connect(document(), &QTextDocument::contentsChange, this, [this](int position, int removed, int added) {
+        // Halb fertiger Durchlauf passt nach jeder Textänderung nicht mehr, auch nach einem gleich
+        // langen Ersatz mit Zeilenumbruch; Formatänderungen (Highlighter) lassen die Revision stehen
+        if (m_indexTimer->isActive() && document()->revision() != m_indexBuild.revision) {
+            m_indexTimer->stop();
+            m_indexBuild = IndexBuild{};  // der Debounce startet neu
+        }
+
+        // removed == added verschiebt keine Offsets
+        if (removed != added && (!m_symbolReferences.isEmpty() || !m_definitions.isEmpty()))
+            m_referenceEdits.append({position, removed, added});
+    });
+
     // Textänderungen triggern debounced parsing
     connect(this, &QPlainTextEdit::textChanged, this, [this] {
+        // In einer Transaktion nur merken; endEditTransaction() holt alles einmal nach
+        if (m_transactionDepth > 0) {
+            m_transactionDirty = true;
+            return;
+        }
+        emit documentEdited();
+
         // Invalidate completion cache
         invalidateCompletionCache();
+        if (m_parsingPaused) return;
 
         // Stop any running timers
         m_parseTimer->stop();
@@ -81,12 +176,18 @@ LuaEditor::LuaEditor(std::shared_ptr<LuaParser> parser, QWidget* parent)
 
     updateLineNumberAreaWidth(0);
     highlightCurrentLine();
-    updateFunctionIndex();
-    updateSymbols();
-
-    // Initialize search paths for modules
-    m_searchPaths << "." << "./modules" << "./lib" << "./scripts";
-    this->parseImports(); // Explicit this-> call
+    startIndexing();
+    ensureIndexComplete();
+
+    // Module resolution (package.path-Vorlagen; LUA_PATH überschreibt die Standardpfade)
+    m_moduleResolver = new ModuleResolver(this);
+    m_moduleResolver->setPackagePath(qEnvironmentVariable("LUA_PATH"));
+    m_moduleGraph = new ModuleGraph(m_moduleResolver, this);
+    connect(m_moduleGraph, &ModuleGraph::graphChanged, this, &LuaEditor::rebuildImportedModules);
+    this->parseImports(toPlainText().toUtf8()); // Explicit this-> call
+
+    m_syntaxChecker = new LuaSyntaxChecker(this);
+    connect(m_syntaxChecker, &LuaSyntaxChecker::checked, this, &LuaEditor::onSyntaxChecked);
 }
 
 void LuaEditor::setupEditor()
@@ -119,6 +220,31 @@ void LuaEditor::setCompleter(AutoCompleter* completer)
             this, &LuaEditor::insertCompletion);
 }
 
+void LuaEditor::setHighlighter(LuaHighlighter* highlighter)
+{
+    m_highlighter = highlighter;
+    if (m_highlighter) {
+        connect(verticalScrollBar(), &QScrollBar::valueChanged,
+                this, &LuaEditor::highlightVisibleBlocks, Qt::UniqueConnection);
+    }
+}
+
+void LuaEditor::setAnalysisPaused(bool paused)
+{
+    if (m_parsingPaused == paused) return;
+    m_parsingPaused = paused;
+
+    if (paused) {
+        m_parseTimer->stop();
+        m_completionTimer->stop();
+        m_indexTimer->stop();
+        m_indexBuild = IndexBuild{};
+        return;
+    }
+    invalidateCompletionCache();
+    m_parseTimer->start();
+}
+
 int LuaEditor::lineNumberAreaWidth() const
 {
     int digits = 1;
@@ -137,6 +263,77 @@ QString LuaEditor::wordUnderCursor() const
     return tc.selectedText();
 }
 
+QString LuaEditor::symbolUnderCursor() const
+{
+    QTextCursor tc = textCursor();
+    tc.select(QTextCursor::WordUnderCursor);
+    const QString word = tc.selectedText();
+    if (word.isEmpty() || !(word.front().isLetter() || word.front() == u'_')) return {};
+
+    const QString text = tc.block().text();
+    const int start = tc.selectionStart() - tc.block().position();
+    if (start > 0 && (text.at(start - 1) == u'.' || text.at(start - 1) == u':')) {
+        const QString chain = extractChainBeforePosition(text, start - 1);
+        if (!chain.isEmpty()) return chain + u'.' + word;
+    }
+    return word;
+}
+
+void LuaEditor::beginEditTransaction()
+{
+    if (m_transactionDepth++ > 0) return;
+
+    // Ein Edit-Block fasst alle Änderungen zu einem Undo-Schritt zusammen; QTextDocument
+    // meldet contentsChange/textChanged erst an dessen Ende, einmal für den ganzen Bereich
+    m_transactionDirty = false;
+    m_transactionCursor = textCursor();
+    m_transactionCursor.beginEditBlock();
+    if (m_highlighter)
+        m_highlighter->setSuspended(true);
+}
+
+void LuaEditor::endEditTransaction()
+{
+    Q_ASSERT(m_transactionDepth > 0);
+    if (m_transactionDepth > 1) {
+        --m_transactionDepth;
+        return;
+    }
+
+    TRACE_SCOPE_REV("LuaEditor::endEditTransaction", document()->revision());
+    m_transactionCursor.endEditBlock(); // gesammelte Signale kommen hier, noch in der Transaktion
+    m_transactionCursor = QTextCursor();
+    m_transactionDepth = 0;
+
+    // Highlighter: geänderte Blöcke sind zurückgestellt, sichtbare sofort, der Rest im Leerlauf
+    if (m_highlighter) {
+        m_highlighter->setSuspended(false);
+        highlightVisibleBlocks();
+    }
+
+    if (!m_transactionDirty) return;
+    m_transactionDirty = false;
+
+    invalidateCompletionCache();
+    if (!m_parsingPaused)
+        m_parseTimer->start();
+
+    if (!m_editedNotifyQueued) {
+        m_editedNotifyQueued = true;
+        QTimer::singleShot(0, this, [this] {
+            m_editedNotifyQueued = false;
+            emit documentEdited();
+        });
+    }
+}
+
+void LuaEditor::insertFromMimeData(const QMimeData *source)
+{
+    TRACE_SCOPE_REV("LuaEditor::insertFromMimeData", document()->revision());
+    EditTransaction transaction(this);
+    QPlainTextEdit::insertFromMimeData(source);
+}
+
 QString LuaEditor::currentLineText() const
 {
     return textCursor().block().text();
@@ -194,44 +391,47 @@ void LuaEditor::keyPressEvent(QKeyEvent *event)
 
     // Enter/Return: intelligente Auto-Einrückung mit end-Handling
     if (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter) {
+        // Zeilenumbruch, Einrückung und end: ein Undo-Schritt, eine Analyse
+        EditTransaction transaction(this);
         QPlainTextEdit::keyPressEvent(event);
 
         const QString prevLine = textCursor().block().previous().text();
         const QString trimmed = prevLine.trimmed();
         const QString indent = prevLine.left(prevLine.length() - trimmed.length());
 
-        // Prüfe ob wir ein end schreiben müssen
+        // Block-Öffner/-Schließer der vorherigen Zeile aus dem Token-Cache;
+        // Keywords in Strings und Kommentaren zählen nicht
         bool needsEnd = false;
         QString extraIndent;
 
-        if (trimmed.endsWith(u"then"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            needsEnd = true;
-        }
-        else if (trimmed.endsWith(u"do"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            needsEnd = true;
-        }
-        else if (trimmed.startsWith(u"function"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            needsEnd = true;
-        }
-        else if (trimmed.startsWith(u"if"_qs) && trimmed.endsWith(u"then"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            needsEnd = true;
-        }
-        else if (trimmed.startsWith(u"for"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            needsEnd = true;
-        }
-        else if (trimmed.startsWith(u"while"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            needsEnd = true;
-        }
-        else if (trimmed.startsWith(u"repeat"_qs)) {
-            extraIndent = QString(TAB_STOP_WIDTH, ' ');
-            // repeat braucht until, nicht end
-            needsEnd = false;
+        if (const LuaBlockData* data = LuaBlockData::ensure(textCursor().block().previous())) {
+            int balance = 0;
+            QStringView firstKeyword;
+            bool firstToken = true;
+
+            for (const LuaToken& token : data->tokens) {
+                if (token.kind == LuaTokenKind::Comment || token.kind == LuaTokenKind::LongComment)
+                    continue;
+                const QStringView word = QStringView(prevLine).mid(token.start, token.length);
+                if (firstToken && token.kind == LuaTokenKind::Keyword)
+                    firstKeyword = word;
+                firstToken = false;
+                if (token.kind != LuaTokenKind::Keyword) continue;
+
+                if (word == u"function" || word == u"then" || word == u"do" || word == u"repeat")
+                    ++balance;
+                else if (word == u"end" || word == u"until")
+                    --balance;
+            }
+
+            if (firstKeyword == u"else" || firstKeyword == u"elseif") {
+                // Zweig eines bestehenden if-Blocks: einrücken, aber kein weiteres end
+                extraIndent = QString(TAB_STOP_WIDTH, ' ');
+            } else if (balance > 0) {
+                extraIndent = QString(TAB_STOP_WIDTH, ' ');
+                // repeat braucht until, nicht end
+                needsEnd = firstKeyword != u"repeat";
+            }
         }
 
         // Sonderfall: wenn die aktuelle Zeile bereits "end" ist
@@ -274,6 +474,9 @@ void LuaEditor::keyPressEvent(QKeyEvent *event)
     // Process the key press
     QPlainTextEdit::keyPressEvent(event);
 
+    if (event->text() == u"("_qs)
+        showCallTip();
+
     // Only trigger completion for actual text input, not navigation
     if (!isNavigationKey) {
         if (triggerCompletion) {
@@ -292,96 +495,68 @@ void LuaEditor::keyPressEvent(QKeyEvent *event)
     }
 }
 
-// ---------- Import System ----------
-
-void LuaEditor::parseImports()
+void LuaEditor::showCallTip()
 {
-    // Clear previous imports to reparse
-    m_importedModules.clear();
-    m_loadedFiles.clear();
-
-    // Find require() statements in current document
-    QRegularExpression requireRe(R"(\b(\w+)\s*=\s*require\s*\(\s*['"](.*?)['"]\s*\))");
-    QRegularExpression directRequireRe(R"(\brequire\s*\(\s*['"](.*?)['"]\s*\))");
-
-    for (QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
-        const QString line = block.text();
-
-        // Pattern: local myModule = require("modulename")
-        auto it = requireRe.globalMatch(line);
-        while (it.hasNext()) {
-            const auto match = it.next();
-            const QString moduleName = match.captured(1);      // myModule
-            const QString fileName = match.captured(2);        // modulename
-
-            qDebug() << "Found require:" << moduleName << "=" << fileName;
-
-            // Load the module file and parse its functions
-            QStringList functions = loadModuleFunctions(fileName);
-            if (!functions.isEmpty()) {
-                m_importedModules[moduleName] = functions;
-                qDebug() << "Loaded" << functions.size() << "functions from" << fileName;
-            }
-        }
-
-        // Pattern: require("modulename") -- without assignment
-        auto directIt = directRequireRe.globalMatch(line);
-        while (directIt.hasNext()) {
-            const auto match = directIt.next();
-            const QString fileName = match.captured(1);
+    // Name direkt vor der gerade getippten Klammer, auch gepunktet ("string.format(")
+    const QTextCursor cursor = textCursor();
+    const QString line = cursor.block().text();
+    const qsizetype paren = cursor.positionInBlock() - 1;
+    if (paren < 0 || line.at(paren) != u'(') return;
+
+    qsizetype start = paren;
+    while (start > 0 && (line.at(start - 1).isLetterOrNumber() || line.at(start - 1) == u'_'
+                         || line.at(start - 1) == u'.'))
+        --start;
+    const QStringView name = QStringView(line).sliced(start, paren - start);
+
+    const LuaBuiltins::Entry* entry = LuaBuiltins::lookup(name.utf16(), static_cast<std::size_t>(name.size()));
+    if (!entry || !entry->isFunction()) return;
+
+    QToolTip::showText(viewport()->mapToGlobal(cursorRect().bottomLeft()),
+                       fromAscii(entry->name) + fromAscii(entry->signature), viewport());
+}
 
-            qDebug() << "Found direct require:" << fileName;
+// ---------- Import System ----------
 
-            // Load functions into global scope
-            QStringList functions = loadModuleFunctions(fileName);
-            if (!functions.isEmpty()) {
-                m_importedModules["_global"] = m_importedModules.value("_global") + functions;
-                qDebug() << "Added" << functions.size() << "global functions from" << fileName;
-            }
-        }
-    }
+void LuaEditor::parseImports(QByteArrayView source)
+{
+    TRACE_SCOPE_REV("LuaEditor::parseImports", document()->revision());
+
+    // Wurzeln des Modulgraphen; fehlende Module lädt der Graph im Hintergrund nach
+    // und meldet sich über graphChanged() → rebuildImportedModules()
+    const ModuleScan scan = ModuleGraph::scanSource(source);
+    for (const ModuleRequire& dependency : scan.imports)
+        LOG_DEBUG(lcImports) << "Found require:" << (dependency.alias.isEmpty() ? u"<direct>"_qs : dependency.alias)
+                             << "=" << dependency.name;
+    m_moduleGraph->setRoots(scan.imports);
 }
 
-QStringList LuaEditor::loadModuleFunctions(const QString& moduleName)
+void LuaEditor::rebuildImportedModules()
 {
-    QStringList functions;
-
-    // Try different file extensions and paths
-    QStringList extensions = {".lua", ""};
-
-    for (const QString& searchPath : m_searchPaths) {
-        for (const QString& ext : extensions) {
-            QString fullPath = QDir(searchPath).filePath(moduleName + ext);
-            QFileInfo fileInfo(fullPath);
-
-            if (fileInfo.exists() && fileInfo.isReadable()) {
-                QString absolutePath = fileInfo.absoluteFilePath();
-
-                // Avoid loading the same file multiple times
-                if (m_loadedFiles.contains(absolutePath)) {
-                    qDebug() << "File already loaded:" << absolutePath;
-                    return m_importedModules.values().first(); // Return cached
-                }
-
-                qDebug() << "Loading module from:" << absolutePath;
-                m_loadedFiles.insert(absolutePath);
-
-                QFile file(absolutePath);
-                if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                    QTextStream stream(&file);
-                    QString content = stream.readAll();
+    m_importedModules.clear();
 
-                    functions = parseModuleFunctions(content, moduleName);
-                    if (!functions.isEmpty()) {
-                        return functions;
-                    }
-                }
-            }
+    // Globale Funktionen aller erreichbaren Module (auch transitiv geladener)
+    QStringList globals = m_moduleGraph->reachableGlobals();
+    for (const ModuleRequire& root : m_moduleGraph->roots()) {
+        const QString path = m_moduleGraph->resolve(root.name);
+        if (path.isEmpty()) {
+            LOG_DEBUG(lcImports) << "Module not found:" << root.name;
+            continue;
         }
+        const QStringList functions = m_moduleGraph->functions(path);
+        if (functions.isEmpty()) continue;
+
+        // local myModule = require("modulename") → myModule.<func>; sonst global
+        if (!root.alias.isEmpty())
+            m_importedModules[root.alias] = functions;
+        else
+            globals += functions;
     }
+    globals.removeDuplicates();
+    if (!globals.isEmpty())
+        m_importedModules[u"_global"_qs] = globals;
 
-    qDebug() << "Module not found:" << moduleName;
-    return functions;
+    invalidateCompletionCache();
 }
 
 QString LuaEditor::detectCurrentClassContext() const
@@ -402,7 +577,7 @@ QString LuaEditor::detectCurrentClassContext() const
         auto match = functionRe.match(line);
         if (match.hasMatch()) {
             const QString className = match.captured(1);
-            qDebug() << "Found class context:" << className << "at line" << (i + 1);
+            LOG_DEBUG(lcCompletion) << "Found class context:" << className << "at line" << (i + 1);
             return className;
         }
 
@@ -411,7 +586,7 @@ QString LuaEditor::detectCurrentClassContext() const
         auto classDef = classDefRe.match(line);
         if (classDef.hasMatch()) {
             const QString className = classDef.captured(1);
-            qDebug() << "Found class definition:" << className << "at line" << (i + 1);
+            LOG_DEBUG(lcCompletion) << "Found class definition:" << className << "at line" << (i + 1);
             return className;
         }
 
@@ -440,76 +615,16 @@ QString LuaEditor::detectCurrentClassContext() const
             const QString possibleClass = localMatch.captured(1);
             // Check if this looks like a class name (starts with uppercase)
             if (!possibleClass.isEmpty() && possibleClass.at(0).isUpper()) {
-                qDebug() << "Inferred class context from local assignment:" << possibleClass << "at line" << (i + 1);
+                LOG_DEBUG(lcCompletion) << "Inferred class context from local assignment:" << possibleClass << "at line" << (i + 1);
                 return possibleClass;
             }
         }
     }
 
-    qDebug() << "No class context found";
+    LOG_DEBUG(lcCompletion) << "No class context found";
     return QString();
 }
 
-QStringList LuaEditor::parseModuleFunctions(const QString& content, const QString& moduleName)
-{
-    QStringList functions;
-    QSet<QString> uniqueFunctions;
-
-    // Parse different function definition patterns
-    QStringList lines = content.split('\n');
-
-    for (const QString& line : lines) {
-        QString trimmedLine = line.trimmed();
-
-        // Pattern 1: function functionName()
-        QRegularExpression funcRe(R"(\bfunction\s+([A-Za-z_][A-Za-z0-9_]*)\s*\()");
-        auto funcMatch = funcRe.match(trimmedLine);
-        if (funcMatch.hasMatch()) {
-            const QString funcName = funcMatch.captured(1);
-            uniqueFunctions.insert(funcName);
-            qDebug() << "Found function:" << funcName;
-            continue;
-        }
-
-        // Pattern 2: local function functionName()
-        QRegularExpression localFuncRe(R"(\blocal\s+function\s+([A-Za-z_][A-Za-z0-9_]*)\s*\()");
-        auto localMatch = localFuncRe.match(trimmedLine);
-        if (localMatch.hasMatch()) {
-            const QString funcName = localMatch.captured(1);
-            uniqueFunctions.insert(funcName);
-            qDebug() << "Found local function:" << funcName;
-            continue;
-        }
-
-        // Pattern 3: M.functionName = function() (module pattern)
-        QRegularExpression moduleMethodRe(R"(\b([A-Za-z_][A-Za-z0-9_]*)\.([A-Za-z_][A-Za-z0-9_]*)\s*=\s*function)");
-        auto moduleMatch = moduleMethodRe.match(trimmedLine);
-        if (moduleMatch.hasMatch()) {
-            const QString methodName = moduleMatch.captured(2);
-            uniqueFunctions.insert(methodName);
-            qDebug() << "Found module method:" << methodName;
-            continue;
-        }
-
-        // Pattern 4: return { func1 = func1, func2 = func2 } (common in modules)
-        if (trimmedLine.startsWith("return {")) {
-            QRegularExpression returnRe(R"(([A-Za-z_][A-Za-z0-9_]*)\s*=)");
-            auto returnIt = returnRe.globalMatch(trimmedLine);
-            while (returnIt.hasNext()) {
-                const auto match = returnIt.next();
-                const QString exportedName = match.captured(1);
-                uniqueFunctions.insert(exportedName);
-                qDebug() << "Found exported function:" << exportedName;
-            }
-        }
-    }
-
-    functions = uniqueFunctions.values();
-    functions.sort(Qt::CaseInsensitive);
-
-    return functions;
-}
-
 void LuaEditor::focusInEvent(QFocusEvent *event)
 {
     QPlainTextEdit::focusInEvent(event);
@@ -537,6 +652,7 @@ void LuaEditor::resizeEvent(QResizeEvent *event)
     QPlainTextEdit::resizeEvent(event);
     QRect cr = contentsRect();
     m_lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
+    highlightVisibleBlocks();
 }
 
 void LuaEditor::paintEvent(QPaintEvent *event)
@@ -546,8 +662,16 @@ void LuaEditor::paintEvent(QPaintEvent *event)
 
 void LuaEditor::performCompletion()
 {
+    TRACE_SCOPE_REV("LuaEditor::performCompletion", document()->revision());
+
     if (!m_autoCompleter || !m_autoCompleter->completer()) return;
 
+    // In Strings und Kommentaren gibt es nichts zu vervollständigen (Token-Cache, kein Scan)
+    if (LuaBlockData::isInStringOrComment(textCursor())) {
+        m_autoCompleter->hidePopup();
+        return;
+    }
+
     // Check if we're right after a . or :
     QString trigger;
     QString chain = detectChainUnderCursor(&trigger);
@@ -636,9 +760,49 @@ void LuaEditor::highlightCurrentLine()
         extraSelections.append(selection);
     }
 
+    extraSelections.append(m_syntaxSelections);
     setExtraSelections(extraSelections);
 }
 
+void LuaEditor::onSyntaxChecked(int revision, const QList<LuaSyntaxError>& errors)
+{
+    // Text hat sich seitdem geändert: der Debounce liefert gleich einen neueren Stand
+    if (revision != document()->revision()) return;
+
+    m_syntaxErrors = errors;
+    m_syntaxSelections.clear();
+    for (const LuaSyntaxError& error : errors) {
+        QTextBlock block = document()->findBlockByNumber(error.line - 1);
+        if (!block.isValid()) block = document()->lastBlock();
+        const QString text = block.text();
+
+        // Unterstrichen wird das "near"-Token, sonst die Zeile ohne Einrückung;
+        // mehrzeilige Tokens (offener Long-String) nur bis zum Zeilenende
+        const QString nearToken = error.nearToken.section(u'\n', 0, 0);
+        qsizetype start = nearToken.isEmpty() ? -1 : text.indexOf(nearToken);
+        qsizetype length = nearToken.size();
+        if (start < 0) {
+            start = 0;
+            while (start < text.size() && text.at(start).isSpace()) ++start;
+            length = text.size() - start;
+        }
+
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = QTextCursor(block);
+        selection.cursor.setPosition(block.position() + static_cast<int>(start));
+        selection.cursor.setPosition(block.position() + static_cast<int>(start + length), QTextCursor::KeepAnchor);
+        selection.format.setUnderlineStyle(QTextCharFormat::WaveUnderline);
+        selection.format.setUnderlineColor(Qt::red);
+        m_syntaxSelections.append(selection);
+
+        LOG_DEBUG(lcParser) << "Syntax error at line" << error.line << ":" << error.message;
+    }
+
+    highlightCurrentLine();
+    m_lineNumberArea->update();
+    emit syntaxChecked(errors);
+}
+
 void LuaEditor::updateLineNumberArea(const QRect &rect, int dy)
 {
     if (dy) {
@@ -652,6 +816,26 @@ void LuaEditor::updateLineNumberArea(const QRect &rect, int dy)
     }
 }
 
+void LuaEditor::highlightVisibleBlocks()
+{
+    // Große Dateien: zurückgestellte Blöcke im neuen Ausschnitt sofort einfärben
+    if (!m_highlighter || !m_highlighter->hasDeferredBlocks()) return;
+
+    QTextBlock block = firstVisibleBlock();
+    const int firstBlock = block.blockNumber();
+    int lastBlock = firstBlock;
+    qreal top = blockBoundingGeometry(block).translated(contentOffset()).top();
+    const int bottom = viewport()->height();
+
+    while (block.isValid() && top <= bottom) {
+        top += blockBoundingRect(block).height();
+        block = block.next();
+        ++lastBlock;
+    }
+
+    m_highlighter->highlightBlocksNow(firstBlock, lastBlock);
+}
+
 QString LuaEditor::textUnderCursor() const
 {
     QTextCursor tc = textCursor();
@@ -661,6 +845,8 @@ QString LuaEditor::textUnderCursor() const
 
 void LuaEditor::lineNumberAreaPaintEvent(QPaintEvent *event)
 {
+    TRACE_SCOPE_REV("LuaEditor::lineNumberAreaPaintEvent", document()->revision());
+
     QPainter painter(m_lineNumberArea.get());
     painter.fillRect(event->rect(), QColor(240, 240, 240));
 
@@ -669,10 +855,18 @@ void LuaEditor::lineNumberAreaPaintEvent(QPaintEvent *event)
     int top          = qRound(blockBoundingGeometry(block).translated(contentOffset()).top());
     int bottom       = top + qRound(blockBoundingRect(block).height());
 
+    // Zeilen mit Syntaxfehler (aktuelle Position, die Cursor wandern bei Edits mit)
+    QList<int> errorBlocks;
+    for (const QTextEdit::ExtraSelection& selection : std::as_const(m_syntaxSelections))
+        errorBlocks.append(selection.cursor.blockNumber());
+
     while (block.isValid() && top <= event->rect().bottom()) {
         if (block.isVisible() && bottom >= event->rect().top()) {
             const QString number = QString::number(blockNumber + 1);
-            painter.setPen(Qt::black);
+            const bool hasError = errorBlocks.contains(blockNumber);
+            if (hasError)
+                painter.fillRect(0, top, m_lineNumberArea->width(), bottom - top, QColor(255, 205, 205));
+            painter.setPen(hasError ? Qt::red : Qt::black);
             painter.drawText(0, top, m_lineNumberArea->width(), fontMetrics().height(),
                              Qt::AlignRight, number);
         }
@@ -685,39 +879,162 @@ void LuaEditor::lineNumberAreaPaintEvent(QPaintEvent *event)
 
 // ---------- Navigation & Index ----------
 
-void LuaEditor::updateFunctionIndex()
+void LuaEditor::startIndexing()
 {
-    m_functionIndex.clear();
-    m_userFunctions.clear();
+    m_indexBuild = IndexBuild{};
+    m_indexBuild.nextBlock = document()->firstBlock();
+    m_indexBuild.revision = document()->revision();
+    m_indexTimer->start();
+}
 
-    for (QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
-        const QString line = block.text();
-        auto it = kFuncDefRe.globalMatch(line);
-        while (it.hasNext()) {
-            const QRegularExpressionMatch m = it.next();
-            const QString name = m.captured(1);
-            if (!name.isEmpty()) {
-                m_functionIndex.insert(name, block.blockNumber());
-                m_userFunctions.insert(name);
-            }
+void LuaEditor::indexSlice()
+{
+    indexBlocks(INDEX_SLICE_MS);
+}
+
+bool LuaEditor::isIndexComplete() const
+{
+    return !m_indexTimer->isActive();
+}
+
+void LuaEditor::ensureIndexComplete()
+{
+    if (m_indexTimer->isActive())
+        indexBlocks(-1);
+}
+
+bool LuaEditor::indexBlocks(int budgetMs)
+{
+    TRACE_SCOPE_REV("LuaEditor::indexBlocks", document()->revision());
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    IndexBuild& build = m_indexBuild;
+    if (build.revision != document()->revision()) {
+        // Text seit dem Start geändert (contentsChange kam zu spät oder ohne Timer): verwerfen
+        m_indexTimer->stop();
+        m_indexBuild = IndexBuild{};
+        return false;
+    }
+    for (QTextBlock& block = build.nextBlock; block.isValid(); block = block.next(), ++build.blockNumber) {
+        // Uhr nur alle 64 Blöcke fragen
+        if (budgetMs >= 0 && (build.blockNumber & 63) == 0 && elapsed.elapsed() >= budgetMs) {
+            emit indexingProgress(build.blockNumber, document()->blockCount());
+            return false;
         }
+
+        // Funktionen (Definitionen); Blöcke in Dokumentreihenfolge → Offsets bleiben sortiert
+        const QString text = block.text();
+        forEachFunctionDefinition(text, LuaBlockData::ensure(block),
+                                  [&](const LuaToken& head, const LuaToken& last, const QString& chain) {
+            const QString name = text.mid(head.start, head.length);
+            build.userFunctions.insert(name);
+            build.references[name].offsets.append(block.position() + head.start);
+            build.definitions[chain].offsets.append(block.position() + last.start);
+        });
     }
+
+    // Veröffentlichen: ab hier beziehen sich die Offsets auf den aktuellen Text
+    m_indexTimer->stop();
+    m_definitions = std::move(build.definitions);
+    m_userFunctions = std::move(build.userFunctions);
+    m_symbolReferences = std::move(build.references);
+    m_referenceEdits.clear();
+    m_indexBuild = IndexBuild{};
+
+    LOG_DEBUG(lcParser) << "Indexed" << document()->blockCount() << "blocks," << m_definitions.size()
+                        << "functions";
+    emit indexingProgress(document()->blockCount(), document()->blockCount());
+    return true;
 }
 
 void LuaEditor::goToDefinition()
 {
-    const QString ident = wordUnderCursor();
-    if (ident.isEmpty()) return;
+    QString name = symbolUnderCursor();
+    if (name.isEmpty()) return;
 
-    const auto it = m_functionIndex.constFind(ident);
-    if (it == m_functionIndex.constEnd()) return;
+    // "self.x" in "function A:m()" meint "A.x"
+    if (name.startsWith(u"self."_qs)) {
+        const QString context = detectCurrentClassContext();
+        if (!context.isEmpty()) name = context + name.mid(4);
+    }
 
-    QTextBlock block = document()->findBlockByNumber(it.value());
-    if (!block.isValid()) return;
+    ensureIndexComplete();
 
-    QTextCursor target(block);
-    setTextCursor(target);
+    // 1. Dokument: Funktionsdefinitionen aus dem Blockindex, Offsets passen zum aktuellen Text
+    if (const QList<int>& offsets = currentOffsets(m_definitions, name); !offsets.isEmpty()) {
+        QTextCursor target(document());
+        target.setPosition(offsets.first());
+        setTextCursor(target);
+        centerCursor();
+        return;
+    }
+
+    // 2. Symboltabelle des Parsers: auch Tabellen und Felder, Stand des letzten Parse-Laufs
+    const QHash<QString, Symbol>& symbols = m_parser->symbolTable().symbols();
+    if (const auto it = symbols.constFind(name); it != symbols.constEnd()) {
+        openLocation(it->filePath, it->pos.line, it->pos.column);
+        return;
+    }
+
+    // 3. Projektindex: alle Dateien im Ordner, Stand der letzten Speicherung
+    if (m_projectIndex) {
+        if (const auto location = m_projectIndex->definition(name)) {
+            openLocation(m_projectIndex->filePath(location->file), location->line, location->column);
+            return;
+        }
+    }
+    LOG_DEBUG(lcParser) << "No definition for" << name;
+}
+
+void LuaEditor::openLocation(const QString& path, int line, int column)
+{
+    // Parser-Pfade ungespeicherter Dokumente sind relativ ("untitled.lua")
+    const bool local = m_filePath.isEmpty() ? !QFileInfo(path).isAbsolute()
+                                            : QFileInfo(path).absoluteFilePath() == QFileInfo(m_filePath).absoluteFilePath();
+    if (local)
+        goToPosition(line, column);
+    else
+        emit openLocationRequested(path, line, column);
+}
+
+void LuaEditor::goToPosition(int line, int column)
+{
+    const QTextBlock block = document()->findBlockByNumber(line - 1);
+    if (!block.isValid()) return;
+    QTextCursor cursor(block);
+    cursor.setPosition(block.position() + std::clamp(column - 1, 0, block.length() - 1));
+    setTextCursor(cursor);
     centerCursor();
+    setFocus();
+}
+
+void LuaEditor::setFilePath(const QString& path)
+{
+    m_filePath = path;
+}
+
+void LuaEditor::setProjectIndex(std::shared_ptr<const ReferenceIndex> index)
+{
+    m_projectIndex = std::move(index);
+}
+
+const QList<int>& LuaEditor::currentOffsets(QHash<QString, ReferenceList>& lists, const QString& name)
+{
+    static const QList<int> empty;
+    const auto it = lists.find(name);
+    if (it == lists.end()) return empty;
+
+    ReferenceList& refs = it.value();
+    for (; refs.appliedEdits < m_referenceEdits.size(); ++refs.appliedEdits)
+        applyEdit(refs.offsets, m_referenceEdits.at(refs.appliedEdits));
+    return refs.offsets;
+}
+
+const QList<int>& LuaEditor::symbolReferences(const QString& name)
+{
+    return currentOffsets(m_symbolReferences, name);
 }
 
 void LuaEditor::findNextReference()
@@ -730,23 +1047,35 @@ void LuaEditor::findNextReference()
     }
     if (m_lastSearchSymbol.isEmpty()) return;
 
+    ensureIndexComplete();
     QList<QTextEdit::ExtraSelection> selections;
 
-    if (m_symbolReferences.contains(m_lastSearchSymbol)) {
-        const auto &cursors = m_symbolReferences[m_lastSearchSymbol];
-        for (const QTextCursor &c : cursors) {
-            QTextEdit::ExtraSelection sel;
-            sel.cursor = c;
-            sel.format.setBackground(QColor(Qt::cyan).lighter(160));
-            selections.append(sel);
-        }
+    // Cursor erst hier erzeugen; Offsets, an denen das Symbol nicht mehr steht
+    // (Edit mitten im Namen), werden übersprungen
+    QTextDocument* doc = document();
+    const int length = static_cast<int>(m_lastSearchSymbol.size());
+    QList<int> hits;
+    for (const int offset : symbolReferences(m_lastSearchSymbol)) {
+        const QTextBlock block = doc->findBlock(offset);
+        const int column = offset - block.position();
+        if (!block.isValid() || QStringView(block.text()).mid(column, length) != m_lastSearchSymbol)
+            continue;
+        hits.append(offset);
+
+        QTextEdit::ExtraSelection sel;
+        sel.cursor = QTextCursor(doc);
+        sel.cursor.setPosition(offset);
+        sel.cursor.setPosition(offset + length, QTextCursor::KeepAnchor);
+        sel.format.setBackground(QColor(Qt::cyan).lighter(160));
+        selections.append(sel);
+    }
 
-        if (!cursors.isEmpty()) {
-            m_lastSearchIndex = (m_lastSearchIndex + 1) % static_cast<int>(cursors.size());
-            QTextCursor target = cursors[m_lastSearchIndex];
-            setTextCursor(target);
-            centerCursor();
-        }
+    if (!hits.isEmpty()) {
+        m_lastSearchIndex = (m_lastSearchIndex + 1) % static_cast<int>(hits.size());
+        QTextCursor target(doc);
+        target.setPosition(hits[m_lastSearchIndex]);
+        setTextCursor(target);
+        centerCursor();
     }
 
     QTextEdit::ExtraSelection lineSel;
@@ -755,66 +1084,11 @@ void LuaEditor::findNextReference()
     lineSel.cursor = textCursor();
     lineSel.cursor.clearSelection();
     selections.append(lineSel);
+    selections.append(m_syntaxSelections);
 
     setExtraSelections(selections);
 }
 
-void LuaEditor::updateSymbols()
-{
-    // Performance optimization: skip for very large files during active editing
-    if (document()->blockCount() > 10000 && !m_parseTimer->isActive()) {
-        return; // Skip expensive symbol parsing during typing
-    }
-
-    m_symbolReferences.clear();
-
-    QTextDocument *doc = document();
-
-    // self.member
-    static const QRegularExpression memberRE(
-        uR"(\bself\.([A-Za-z_][A-Za-z0-9_]*))"_qs
-    );
-    // Objekt:funktion()
-    static const QRegularExpression callRE(
-        uR"(([A-Za-z_][A-Za-z0-9_]*)(?::([A-Za-z_][A-Za-z0-9_]*))\s*\()"_qs
-    );
-
-    int blockCount = doc->blockCount();
-    int processedBlocks = 0;
-
-    for (QTextBlock block = doc->begin(); block.isValid(); block = block.next()) {
-        // Performance: limit processing for very large files
-        if (blockCount > 8000 && (processedBlocks % 3) != 0) {
-            processedBlocks++;
-            continue;
-        }
-
-        const QString text = block.text();
-
-        // Funktionen (Definitionen)
-        auto fit = kFuncDefRe.globalMatch(text);
-        while (fit.hasNext()) {
-            const auto m = fit.next();
-            const QString name = m.captured(1);
-            if (name.isEmpty()) continue;
-            QTextCursor cursor(doc);
-            cursor.setPosition(block.position() + static_cast<int>(m.capturedStart(1)));
-            m_symbolReferences[name].append(cursor);
-        }
-
-        // Early exit for simple lines
-        if (!text.contains('.') && !text.contains(':') && !text.contains("local")) {
-            processedBlocks++;
-            continue;
-        }
-
-        // Rest of symbol parsing...
-        // [Existing code but with early exits]
-
-        processedBlocks++;
-    }
-}
-
 // ---------- Completion ----------
 
 void LuaEditor::showCompletion()
@@ -824,9 +1098,10 @@ void LuaEditor::showCompletion()
 
 QString LuaEditor::detectChainUnderCursor(QString *trigger) const
 {
-    QTextCursor tc = textCursor();
-    const int pos = tc.position();
-    const QString text = toPlainText();
+    // Ketten reichen nicht über Zeilengrenzen: Blocktext statt toPlainText() pro Tastendruck
+    const QTextCursor tc = textCursor();
+    const int pos = tc.positionInBlock();
+    const QString text = tc.block().text();
 
     if (pos <= 0 || pos > text.size()) return {};
 
@@ -969,10 +1244,12 @@ QStringList LuaEditor::smartSortCompletionItems(const QStringList& items, const
 
 QStringList LuaEditor::buildCompletionItems() const
 {
+    TRACE_SCOPE_REV("LuaEditor::buildCompletionItems", document()->revision());
+
     QString trigger;
     const QString chain = detectChainUnderCursor(&trigger);
 
-    qDebug() << "buildCompletionItems - Chain:" << chain << "Trigger:" << trigger;
+    LOG_DEBUG(lcCompletion) << "buildCompletionItems - Chain:" << chain << "Trigger:" << trigger;
 
     // Wenn kein '.' oder ':' → nur globale Vorschläge (keine Member)
     if (chain.isEmpty() || trigger.isEmpty()) {
@@ -1018,24 +1295,8 @@ QStringList LuaEditor::buildCompletionItems() const
             }
         }
 
-        // Lua-Standardfunktionen hinzufügen
-        QStringList luaBuiltins = {
-            // Basisfunktionen
-            "assert", "collectgarbage", "dofile", "error", "getmetatable", "ipairs",
-            "load", "loadfile", "next", "pairs", "pcall", "print", "rawequal", "rawget",
-            "rawlen", "rawset", "require", "select", "setmetatable", "tonumber",
-            "tostring", "type", "xpcall", "_G", "_VERSION",
-            // Lua-Keywords
-            "and", "break", "do", "else", "elseif", "end", "false", "for",
-            "function", "if", "in", "local", "nil", "not", "or", "repeat",
-            "return", "then", "true", "until", "while", "goto",
-            // Special identifiers
-            "self",  // Important for method contexts
-            // Standard-Libraries
-            "table", "string", "math", "os", "io", "debug", "coroutine"
-        };
-
-        for (const QString& builtin : luaBuiltins) {
+        // Lua-Keywords, Basisfunktionen und Bibliotheken (einmalig aus LuaBuiltins aufgebaut)
+        for (const QString& builtin : builtinCompletions().globals) {
             all.insert(builtin);
         }
 
@@ -1056,17 +1317,17 @@ QStringList LuaEditor::buildCompletionItems() const
 
         QStringList list = all.values();
         list.sort(Qt::CaseInsensitive);
-        qDebug() << "Returning global suggestions:" << list.size() << "items";
+        LOG_DEBUG(lcCompletion) << "Returning global suggestions:" << list.size() << "items";
         return list;
     }
 
-    qDebug() << "Looking for members of:" << chain;
+    LOG_DEBUG(lcCompletion) << "Looking for members of:" << chain;
 
     // Nur bei '.' oder ':' → Member/Methoden vorschlagen
     const QString parent = chain;
     const bool isMethodCall = (trigger == ":");
 
-    qDebug() << "IsMethodCall:" << isMethodCall;
+    LOG_DEBUG(lcCompletion) << "IsMethodCall:" << isMethodCall;
 
     QSet<QString> members;
 
@@ -1075,17 +1336,17 @@ QStringList LuaEditor::buildCompletionItems() const
         const QStringList moduleFunctions = m_importedModules.value(parent);
         for (const QString& func : moduleFunctions) {
             members.insert(func);
-            qDebug() << "Added imported function:" << func;
+            LOG_DEBUG(lcCompletion) << "Added imported function:" << func;
         }
     }
 
     // Handle self. completion - find members of the current class/table
     if (parent == "self" && !isMethodCall) {
-        qDebug() << "Looking for self members";
+        LOG_DEBUG(lcCompletion) << "Looking for self members";
 
         // Find the current function context to determine what "self" refers to
         QString currentClass = detectCurrentClassContext();
-        qDebug() << "Current class context:" << currentClass;
+        LOG_DEBUG(lcCompletion) << "Current class context:" << currentClass;
 
         if (!currentClass.isEmpty()) {
             // Look for members of the current class
@@ -1099,7 +1360,7 @@ QStringList LuaEditor::buildCompletionItems() const
                     const auto m = selfIt.next();
                     const QString memberName = m.captured(1);
                     members.insert(memberName);
-                    qDebug() << "Found self member:" << memberName;
+                    LOG_DEBUG(lcCompletion) << "Found self member:" << memberName;
                 }
 
                 // Pattern 2: currentClass.member = value (static assignments)
@@ -1111,7 +1372,7 @@ QStringList LuaEditor::buildCompletionItems() const
                     const auto m = classIt.next();
                     const QString memberName = m.captured(1);
                     members.insert(memberName);
-                    qDebug() << "Found class member:" << memberName;
+                    LOG_DEBUG(lcCompletion) << "Found class member:" << memberName;
                 }
 
                 // Pattern 3: function currentClass:methodName - these become self accessible
@@ -1124,7 +1385,7 @@ QStringList LuaEditor::buildCompletionItems() const
                     const QString methodName = m.captured(1);
                     // Methods are accessible as self:method, but we can also suggest them for self.
                     members.insert(methodName);
-                    qDebug() << "Found class method:" << methodName;
+                    LOG_DEBUG(lcCompletion) << "Found class method:" << methodName;
                 }
             }
         } else {
@@ -1140,14 +1401,13 @@ QStringList LuaEditor::buildCompletionItems() const
             for (const QString& member : commonSelfMembers) {
                 members.insert(member);
             }
-            qDebug() << "Added common self members";
+            LOG_DEBUG(lcCompletion) << "Added common self members";
         }
     }
 
     // Scan durch das Dokument für Member/Methoden
     for (QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
         const QString line = block.text();
-        qDebug() << "Scanning line:" << line;
 
         // Einfache Patterns - suche nach parent.member oder parent:method
         if (!isMethodCall && line.contains(parent + ".")) {
@@ -1157,7 +1417,7 @@ QStringList LuaEditor::buildCompletionItems() const
             while (it.hasNext()) {
                 const auto m = it.next();
                 const QString memberName = m.captured(1);
-                qDebug() << "Found member:" << memberName;
+                LOG_DEBUG(lcCompletion) << "Found member:" << memberName;
                 members.insert(memberName);
             }
         }
@@ -1169,47 +1429,28 @@ QStringList LuaEditor::buildCompletionItems() const
             while (it.hasNext()) {
                 const auto m = it.next();
                 const QString methodName = m.captured(1);
-                qDebug() << "Found method:" << methodName;
+                LOG_DEBUG(lcCompletion) << "Found method:" << methodName;
                 members.insert(methodName);
             }
         }
     }
 
-    // Standard-Library-Methoden hinzufügen basierend auf dem Parent
-    if (parent == "string" && !isMethodCall) {
-        QStringList stringMethods = {"find", "gsub", "len", "sub", "upper", "lower",
-                                   "format", "match", "gmatch", "rep", "reverse", "byte", "char"};
-        for (const QString& method : stringMethods) {
-            members.insert(method);
-        }
-    }
-    else if (parent == "table" && !isMethodCall) {
-        QStringList tableMethods = {"insert", "remove", "concat", "sort", "unpack", "pack", "move"};
-        for (const QString& method : tableMethods) {
-            members.insert(method);
-        }
-    }
-    else if (parent == "math" && !isMethodCall) {
-        QStringList mathMethods = {"abs", "ceil", "floor", "max", "min", "random", "sqrt",
-                                 "sin", "cos", "tan", "log", "exp", "deg", "rad", "modf", "fmod"};
-        for (const QString& method : mathMethods) {
-            members.insert(method);
-        }
-    }
-    else if (parent == "os" && !isMethodCall) {
-        QStringList osMethods = {"time", "date", "clock", "execute", "exit", "getenv", "remove", "rename"};
-        for (const QString& method : osMethods) {
-            members.insert(method);
+    // Standard-Library-Funktionen und -Werte des Parents (string, table, math, ...)
+    if (!isMethodCall) {
+        const auto library = builtinCompletions().members.constFind(parent);
+        if (library != builtinCompletions().members.constEnd()) {
+            for (const QString& member : library.value())
+                members.insert(member);
         }
     }
 
     // Handle self: completion - find methods of the current class/table
     if (parent == "self" && isMethodCall) {
-        qDebug() << "Looking for self methods";
+        LOG_DEBUG(lcCompletion) << "Looking for self methods";
 
         // Find the current function context to determine what "self" refers to
         QString currentClass = detectCurrentClassContext();
-        qDebug() << "Current class context:" << currentClass;
+        LOG_DEBUG(lcCompletion) << "Current class context:" << currentClass;
 
         if (!currentClass.isEmpty()) {
             // Look for methods of the current class
@@ -1225,7 +1466,7 @@ QStringList LuaEditor::buildCompletionItems() const
                     const auto m = methodIt.next();
                     const QString methodName = m.captured(1);
                     members.insert(methodName);
-                    qDebug() << "Found class method:" << methodName;
+                    LOG_DEBUG(lcCompletion) << "Found class method:" << methodName;
                 }
 
                 // Pattern 2: CurrentClass.methodName = function(...)
@@ -1237,7 +1478,7 @@ QStringList LuaEditor::buildCompletionItems() const
                     const auto m = assignIt.next();
                     const QString methodName = m.captured(1);
                     members.insert(methodName);
-                    qDebug() << "Found assigned method:" << methodName;
+                    LOG_DEBUG(lcCompletion) << "Found assigned method:" << methodName;
                 }
 
                 // Pattern 3: self:methodName(...) calls (within the same class)
@@ -1247,14 +1488,14 @@ QStringList LuaEditor::buildCompletionItems() const
                     const auto m = selfCallIt.next();
                     const QString methodName = m.captured(1);
                     members.insert(methodName);
-                    qDebug() << "Found self call:" << methodName;
+                    LOG_DEBUG(lcCompletion) << "Found self call:" << methodName;
                 }
             }
         }
 
         // Only add generic methods if no specific class context was found
         if (members.isEmpty()) {
-            qDebug() << "No class-specific methods found, adding generic fallback";
+            LOG_DEBUG(lcCompletion) << "No class-specific methods found, adding generic fallback";
             // These are common Lua OOP patterns, not game-specific
             QStringList luaCommonMethods = {
                 "new",      // Constructor pattern
@@ -1273,11 +1514,11 @@ QStringList LuaEditor::buildCompletionItems() const
             }
         }
 
-        qDebug() << "Total self methods found:" << members.size();
+        LOG_DEBUG(lcCompletion) << "Total self methods found:" << members.size();
     }
 
     QStringList list = members.values();
     list.sort(Qt::CaseInsensitive);
-    qDebug() << "Returning" << list.size() << "members:" << list;
+    LOG_DEBUG(lcCompletion) << "Returning" << list.size() << "members:" << list;
     return list;
 }
\ No newline at end of file
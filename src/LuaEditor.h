@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QPlainTextEdit>
+#include <QTextBlock>
 #include <QTextCursor>
 #include <QKeyEvent>
 #include <QMap>
@@ -9,9 +10,15 @@
 #include <QStringList>
 #include <memory>
 #include "LuaParser.h"
+#include "LuaSyntaxChecker.h"
 
 class AutoCompleter;
+class LuaHighlighter;
+class ModuleGraph;
+class ModuleResolver;
+class ReferenceIndex;
 class QFocusEvent;
+class QMimeData;
 class QResizeEvent;
 class QPaintEvent;
 
@@ -19,7 +26,7 @@ class QPaintEvent;
  * Qt6 / C++23 Lua Editor mit:
  *  - Zeilennummern
  *  - einfacher Einrückungslogik
- *  - F12 / Strg+F12 Navigation (lokal)
+ *  - F12 / Strg+F12 Navigation (Definitionen qualifiziert, auch dateiübergreifend)
  *  - Autocomplete-Anbindung über AutoCompleter (Popup)
  *
  * Parser-Integration ist optional; die Completion-Liste wird
@@ -34,8 +41,62 @@ public:
     ~LuaEditor() override = default;
 
     void setCompleter(AutoCompleter* completer);
+    void setHighlighter(LuaHighlighter* highlighter); // sichtbare Blöcke beim Scrollen zuerst
     void performCompletion(); // Manual completion trigger
 
+    // Kandidatenliste der Completion an der Cursorposition, ohne Popup (Tests/Benchmarks)
+    [[nodiscard]] QStringList completionItemsForTesting() const { return buildCompletionItems(); }
+
+    // Pausiert Index-/Symbol-Updates und Completion (z.B. während eine große Datei
+    // schrittweise geladen wird); beim Fortsetzen wird einmal neu indiziert
+    void setAnalysisPaused(bool paused);
+    [[nodiscard]] bool isAnalysisPaused() const { return m_parsingPaused; }
+
+    // Bulk-Edit-Transaktion (Einfügen, Auto-Einrückung, programmatische Edits): ein Undo-Schritt;
+    // Cache-Invalidierung, Debounce, Highlighting-Propagation und documentEdited() ruhen bis
+    // zum äußersten Ende und laufen dann genau einmal. Verschachtelbar.
+    void beginEditTransaction();
+    void endEditTransaction();
+    [[nodiscard]] bool isInEditTransaction() const { return m_transactionDepth > 0; }
+
+    class EditTransaction
+    {
+    public:
+        explicit EditTransaction(LuaEditor* editor) : m_editor(editor) { m_editor->beginEditTransaction(); }
+        ~EditTransaction() { m_editor->endEditTransaction(); }
+        EditTransaction(const EditTransaction&) = delete;
+        EditTransaction& operator=(const EditTransaction&) = delete;
+
+    private:
+        LuaEditor* m_editor;
+    };
+
+    // Symbolindex: jeder Block wird erfasst, aber in Zeitscheiben über die Event-Loop;
+    // das Ergebnis wird erst nach dem letzten Block veröffentlicht
+    [[nodiscard]] bool isIndexComplete() const;
+    void ensureIndexComplete(); // laufenden Durchlauf synchron zu Ende führen
+
+    // Qualifizierter Name unter dem Cursor ("Util.cl|amp" → "Util.clamp"); ':' wird zu '.'
+    [[nodiscard]] QString symbolUnderCursor() const;
+
+    // Strg+F12 löst über Dokument, Parser-Tabelle und Projektindex auf; liegt die Definition
+    // in einer anderen Datei, kommt openLocationRequested()
+    void setFilePath(const QString& path);  // leer = ungespeichertes Dokument
+    void setProjectIndex(std::shared_ptr<const ReferenceIndex> index);
+    void goToPosition(int line, int column); // 1-basiert, Cursor zentriert
+
+    // Letztes Ergebnis des Lua-Compilers (Wellenlinie + Markierung in der Zeilennummernleiste)
+    [[nodiscard]] QList<LuaSyntaxError> syntaxErrors() const { return m_syntaxErrors; }
+
+signals:
+    void indexingProgress(int indexedBlocks, int totalBlocks); // indexedBlocks == totalBlocks: fertig
+    void syntaxChecked(const QList<LuaSyntaxError>& errors);  // leer = syntaktisch korrekt
+    void openLocationRequested(const QString& path, int line, int column);
+    // Wie textChanged, aber nach einer Transaktion nur einmal (über die Event-Loop, damit
+    // Einfügen nur die Einfügekosten hat)
+    void documentEdited();
+
+public:
     [[nodiscard]] int lineNumberAreaWidth() const;
     [[nodiscard]] QString wordUnderCursor() const;
     [[nodiscard]] QString currentLineText() const;
@@ -46,6 +107,7 @@ protected:
     void resizeEvent(QResizeEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
+    void insertFromMimeData(const QMimeData *source) override; // Einfügen als Transaktion
 
 private slots:
     // Autocomplete
@@ -55,12 +117,13 @@ private slots:
     void updateLineNumberAreaWidth(int newBlockCount);
     void highlightCurrentLine();
     void updateLineNumberArea(const QRect &rect, int dy);
+    void highlightVisibleBlocks();
 
     // Navigation
     void findNextReference();  // F12: nächstes Vorkommen des Wortes unter dem Cursor
-    void goToDefinition();     // Ctrl+F12: zur Definition (function <name>) springen
-    void updateFunctionIndex();// bei Textänderung: Funktions-Index aktualisieren
-    void updateSymbols();      // bei Textänderung: Symbole (Variablen & Funktionen) aktualisieren
+    void goToDefinition();     // Ctrl+F12: zur Definition des qualifizierten Namens springen
+    void startIndexing();      // bei Textänderung: Funktions- und Referenzindex neu aufbauen
+    void indexSlice();         // eine Zeitscheibe des laufenden Indexdurchlaufs
 
 private:
     void setupEditor();
@@ -68,11 +131,11 @@ private:
     void showCompletion();                            // Kontextbezogenes Popup auslösen
     [[nodiscard]] QStringList buildCompletionItems() const; // Identifier-Liste (global & kontextbezogen)
     [[nodiscard]] QString detectChainUnderCursor(QString *trigger = nullptr) const;
+    void showCallTip();                               // Signatur eines Built-ins nach "("
 
     // Import system methods
-    void parseImports();       // Parse require() statements and load external files
-    QStringList loadModuleFunctions(const QString& moduleName);
-    QStringList parseModuleFunctions(const QString& content, const QString& moduleName);
+    void parseImports(QByteArrayView source); // Parse require() statements (UTF-8) and load external files
+    void rebuildImportedModules(); // m_importedModules aus dem Modulgraphen
     QString detectCurrentClassContext() const;  // Find current class/object context for self completion
     QString extractChainBeforePosition(const QString& text, int position) const;  // Helper for chain detection
     void invalidateCompletionCache();  // Clear completion cache when document changes
@@ -88,20 +151,69 @@ private:
     // Auto completion
     AutoCompleter* m_autoCompleter{nullptr};
 
+    // Syntax-Highlighter (gehört dem Dokument)
+    LuaHighlighter* m_highlighter{nullptr};
+
     // Performance optimization
     QTimer* m_parseTimer{nullptr};           // Debounce timer for parsing
     QTimer* m_completionTimer{nullptr};      // Debounce timer for completion
     bool m_parsingPaused{false};             // Flag to pause expensive operations
 
+    // Bulk-Edit-Transaktion
+    QTextCursor m_transactionCursor;         // hält den Edit-Block des Dokuments offen
+    int m_transactionDepth{0};
+    bool m_transactionDirty{false};          // Text innerhalb der Transaktion geändert
+    bool m_editedNotifyQueued{false};        // documentEdited() steht schon in der Event-Loop
+
     // Symbolindex (lokal im Dokument)
-    QMap<QString, int> m_functionIndex;                 // Funktionsname -> Zeilennummer (blockNumber)
     QSet<QString> m_userFunctions;                      // im Dokument gefundene Funktionsnamen
-    QHash<QString, QList<QTextCursor>> m_symbolReferences; // Name -> alle Fundstellen im Dokument
+
+    // Fundstellen als sortierte Dokument-Offsets statt QTextCursor: das Dokument muss bei
+    // Edits nichts nachführen; Verschiebungen aus contentsChange werden erst beim Zugriff
+    // (F12) pro Symbol eingerechnet, Cursor nur dann erzeugt
+    struct ContentEdit {
+        int position;
+        int removed;
+        int added;
+    };
+    struct ReferenceList {
+        QList<int> offsets;           // aufsteigend sortiert
+        qsizetype appliedEdits = 0;   // so viele Einträge aus m_referenceEdits sind eingerechnet
+    };
+    QHash<QString, ReferenceList> m_symbolReferences;   // Name -> alle Fundstellen im Dokument
+    QHash<QString, ReferenceList> m_definitions;        // "A.b.c" -> Offsets des letzten Glieds
+    QList<ContentEdit> m_referenceEdits;                // Edits seit der letzten Veröffentlichung
+    const QList<int>& currentOffsets(QHash<QString, ReferenceList>& lists, const QString& name);
+    const QList<int>& symbolReferences(const QString& name);
+    void openLocation(const QString& path, int line, int column); // lokal springen oder Signal
+
+    QString m_filePath;
+    std::shared_ptr<const ReferenceIndex> m_projectIndex;
+
+    // Laufender Indexdurchlauf; wird bei einem Text-Edit verworfen und nach dem Debounce neu begonnen
+    struct IndexBuild {
+        QSet<QString> userFunctions;
+        QHash<QString, ReferenceList> references;
+        QHash<QString, ReferenceList> definitions;
+        QTextBlock nextBlock;       // hier geht es in der nächsten Zeitscheibe weiter
+        int blockNumber = 0;
+        int revision = -1;          // Dokumentrevision beim Start; jede Textänderung macht den Durchlauf ungültig
+    };
+    IndexBuild m_indexBuild;
+    QTimer* m_indexTimer{nullptr};
+    static constexpr int INDEX_SLICE_MS = 8;
+    bool indexBlocks(int budgetMs); // budgetMs < 0: ohne Zeitlimit; true = fertig und veröffentlicht
 
     // Import system
     QHash<QString, QStringList> m_importedModules;      // Modulname -> verfügbare Funktionen
-    QStringList m_searchPaths;                          // Suchpfade für Module
-    QSet<QString> m_loadedFiles;                        // Bereits geladene Dateien (verhindert Zyklen)
+    ModuleResolver* m_moduleResolver{nullptr};          // require()-Name → Datei (gecacht)
+    ModuleGraph* m_moduleGraph{nullptr};                // transitive require()-Abhängigkeiten
+
+    // Syntaxprüfung (luaL_loadbufferx im Hintergrund)
+    void onSyntaxChecked(int revision, const QList<LuaSyntaxError>& errors);
+    LuaSyntaxChecker* m_syntaxChecker{nullptr};
+    QList<LuaSyntaxError> m_syntaxErrors;
+    QList<QTextEdit::ExtraSelection> m_syntaxSelections; // Cursor wandern bei Edits mit
 
     // Performance cache
     mutable QStringList m_cachedGlobalItems;           // Cache for global completion items
@@ -1,10 +1,30 @@
 #include "LuaHighlighter.h"
+#include "LuaBlockData.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QTextBlock>
+#include <QTextLayout>
+#include <iterator>
+#include <utility>
 
 LuaHighlighter::LuaHighlighter(QTextDocument *parent)
-    : QSyntaxHighlighter(parent)
+    : QSyntaxHighlighter(static_cast<QObject *>(parent))
 {
     setupFormats();
-    setupHighlightingRules();
+
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(0);
+    connect(&m_idleTimer, &QTimer::timeout, this, &LuaHighlighter::processPending);
+
+    // Eigene contentsChange-Verbindung vor der von QSyntaxHighlighter, damit m_pending
+    // schon verschoben ist, wenn die Blöcke neu hervorgehoben werden
+    if (parent) {
+        connect(parent, &QTextDocument::contentsChange, this, &LuaHighlighter::onContentsChange);
+        m_blockCount = parent->blockCount();
+        setDocument(parent);
+    }
 }
 
 void LuaHighlighter::setupFormats()
@@ -37,128 +57,233 @@ void LuaHighlighter::setupFormats()
 }
 
 
-void LuaHighlighter::setupHighlightingRules()
+const QTextCharFormat* LuaHighlighter::formatFor(LuaTokenKind kind) const
 {
-    HighlightingRule rule;
+    switch (kind) {
+    case LuaTokenKind::Keyword:      return &m_keywordFormat;
+    case LuaTokenKind::Builtin:      return &m_builtinFormat;
+    case LuaTokenKind::FunctionName:
+    case LuaTokenKind::FunctionCall: return &m_functionFormat;
+    case LuaTokenKind::Number:       return &m_numberFormat;
+    case LuaTokenKind::String:
+    case LuaTokenKind::LongString:   return &m_quotationFormat;
+    case LuaTokenKind::Comment:
+    case LuaTokenKind::LongComment:  return &m_commentFormat;
+    case LuaTokenKind::Operator:     return &m_operatorFormat;
+    case LuaTokenKind::Identifier:
+    case LuaTokenKind::Punctuation:  return nullptr;
+    }
+    return nullptr;
+}
 
-    // Keywords
-    QString keywordPattern = R"(\b(?:)";
-    for (size_t i = 0; i < LUA_KEYWORDS.size(); ++i) {
-        if (i > 0) keywordPattern += "|";
-        keywordPattern += QString::fromUtf8(LUA_KEYWORDS[i]);
+void LuaHighlighter::highlightBlock(const QString &text)
+{
+    TRACE_SCOPE_REV("LuaHighlighter::highlightBlock", document()->revision());
+
+    // QSyntaxHighlighter hebt Folgeblöcke so lange synchron hervor, bis ein Blockzustand
+    // unverändert bleibt. Ab dem Budget wird der Block zurückgestellt: alter Zustand →
+    // die Kette bricht hier ab, der Rest läuft über m_idleTimer weiter.
+    const int blockNumber = currentBlock().blockNumber();
+    if (m_suspended) {
+        deferCurrentBlock(blockNumber);
+        return;
     }
-    keywordPattern += R"()\b)";
-
-    rule.pattern = QRegularExpression(keywordPattern);
-    rule.pattern.setPatternOptions(QRegularExpression::UseUnicodePropertiesOption);
-    rule.format = m_keywordFormat;
-    m_highlightingRules.push_back(rule);
-
-    // Built-in functions
-    QString builtinPattern = R"(\b(?:)";
-    for (size_t i = 0; i < LUA_BUILTINS.size(); ++i) {
-        if (i > 0) builtinPattern += "|";
-        builtinPattern += QString::fromUtf8(LUA_BUILTINS[i]);
+    if (m_blocksThisPass == 0)
+        QTimer::singleShot(0, this, [this] { m_blocksThisPass = 0; });
+    if (m_blockBudget > 0 && ++m_blocksThisPass > m_blockBudget) {
+        if (m_blocksThisPass == m_blockBudget + 1)
+            LOG_DEBUG(lcHighlighter) << "Block budget" << m_blockBudget << "reached at block" << blockNumber
+                                     << "- deferring the rest";
+        deferCurrentBlock(blockNumber);
+        return;
     }
-    builtinPattern += R"()\b)";
+    if (!m_pending.isEmpty())
+        removePending(blockNumber);
+
+    // Ein linearer Lexer-Durchlauf pro Block; die Tokens bleiben als LuaBlockData am
+    // Block hängen und werden von Editor/Completion wiederverwendet
+    const int startState = previousBlockState() < 0 ? LuaLexer::STATE_NORMAL : previousBlockState();
+    auto* data = static_cast<LuaBlockData*>(currentBlockUserData());
+    if (!data) {
+        data = new LuaBlockData;
+        setCurrentBlockUserData(data);
+    }
+    data->update(currentBlock(), text, startState);
 
-    rule.pattern = QRegularExpression(builtinPattern);
-    rule.format = m_builtinFormat;
-    m_highlightingRules.push_back(rule);
+    for (const LuaToken& token : std::as_const(data->tokens)) {
+        if (const QTextCharFormat* format = formatFor(token.kind))
+            setFormat(token.start, token.length, *format);
+    }
 
-    // Function definitions → nur Name markieren (Gruppe 1)
-    rule.pattern = QRegularExpression(R"(\bfunction\s+([a-zA-Z_][a-zA-Z0-9_]*)\b)");
-    rule.format = m_functionFormat;
-    m_highlightingRules.push_back(rule);
+    setCurrentBlockState(data->endState);
+}
 
-    // Function calls → nur Name markieren (Gruppe 1)
-    rule.pattern = QRegularExpression(R"(\b([a-zA-Z_][a-zA-Z0-9_]*)\s*\()");
-    rule.format = m_functionFormat;
-    m_highlightingRules.push_back(rule);
+void LuaHighlighter::deferCurrentBlock(int blockNumber)
+{
+    // Bisherige Formate erneut setzen, sonst würde der Block entfärbt
+    if (const QTextLayout* layout = currentBlock().layout()) {
+        const QList<QTextLayout::FormatRange> formats = layout->formats();
+        for (const QTextLayout::FormatRange& range : formats)
+            setFormat(range.start, range.length, range.format);
+    }
 
-    // Numbers
-    rule.pattern = QRegularExpression(R"(\b\d+\.?\d*([eE][+-]?\d+)?\b)");
-    rule.format = m_numberFormat;
-    m_highlightingRules.push_back(rule);
+    addPending(blockNumber, blockNumber + 1);
+    m_idleTimer.start();
+}
 
-    // Single line comments
-    rule.pattern = QRegularExpression(R"(--.*)");
-    rule.format = m_commentFormat;
-    m_highlightingRules.push_back(rule);
+void LuaHighlighter::setSuspended(bool suspended)
+{
+    if (m_suspended == suspended) return;
+    m_suspended = suspended;
+    if (!m_suspended && !m_pending.isEmpty())
+        m_idleTimer.start();
+}
 
-    // Strings
-    rule.pattern = QRegularExpression(R"('(?:[^'\\]|\\.)*')");
-    rule.format = m_quotationFormat;
-    m_highlightingRules.push_back(rule);
+void LuaHighlighter::highlightBlocksNow(int firstBlock, int lastBlock)
+{
+    if (m_pending.isEmpty() || m_suspended) return;
+
+    // Liegt ein zurückgestellter Bereich im sichtbaren Ausschnitt?
+    const auto after = std::as_const(m_pending).upperBound(lastBlock);
+    if (after == m_pending.cbegin() || std::prev(after).value() <= firstBlock)
+        return;
+
+    TRACE_SCOPE_REV("LuaHighlighter::highlightBlocksNow", document()->revision());
+
+    // Zustände bis zum Ausschnitt nur scannen; deren Formate bleiben zurückgestellt
+    const int scanFrom = qMax(m_pending.firstKey(), m_stateScanEnd);
+    if (scanFrom < firstBlock) {
+        QTextBlock block = document()->findBlockByNumber(scanFrom);
+        int state = block.previous().isValid() ? qMax(LuaLexer::STATE_NORMAL, block.previous().userState())
+                                               : LuaLexer::STATE_NORMAL;
+        for (int number = scanFrom; block.isValid() && number < firstBlock; ++number, block = block.next()) {
+            state = LuaLexer::scanLineState(block.text(), state);
+            block.setUserState(state);
+        }
+        addPending(scanFrom, firstBlock);
+    }
 
-    rule.pattern = QRegularExpression(R"("(?:[^"\\]|\\.)*")");
-    rule.format = m_quotationFormat;
-    m_highlightingRules.push_back(rule);
+    int rehighlighted = 0;
+    QTextBlock block = document()->findBlockByNumber(firstBlock);
+    for (int number = firstBlock; block.isValid() && number <= lastBlock; ++number, block = block.next()) {
+        if (isPending(number)) {
+            m_blocksThisPass = 0;
+            rehighlightBlock(block);
+            ++rehighlighted;
+        }
+    }
+    m_stateScanEnd = qMax(m_stateScanEnd, lastBlock + 1);
+    LOG_DEBUG(lcHighlighter) << "Visible blocks" << firstBlock << "-" << lastBlock << ":" << rehighlighted
+                             << "deferred blocks highlighted now";
+}
 
-    // Long strings [[...]]
-    rule.pattern = QRegularExpression(R"(\[\[.*?\]\])");
-    rule.format = m_quotationFormat;
-    m_highlightingRules.push_back(rule);
+void LuaHighlighter::processPending()
+{
+    // Zurückstellen würde hier nur Einträge umschichten; setSuspended(false) startet neu
+    if (m_suspended) return;
+    TRACE_SCOPE_REV("LuaHighlighter::processPending", document()->revision());
+
+    QElapsedTimer slice;
+    slice.start();
+
+    int ranges = 0;
+    while (!m_pending.isEmpty() && slice.elapsed() < IDLE_SLICE_MS) {
+        const int number = m_pending.firstKey();
+        const QTextBlock block = document()->findBlockByNumber(number);
+        if (!block.isValid()) {
+            m_pending.clear(); // Einträge hinter dem Dokumentende
+            break;
+        }
 
-    // Operators
-    rule.pattern = QRegularExpression(R"([+\-*/=<>~#%^&|])");
-    rule.format = m_operatorFormat;
-    m_highlightingRules.push_back(rule);
+        // Läuft bis zur Konvergenz oder bis zum nächsten Budget (→ neue Einträge)
+        m_blocksThisPass = 0;
+        rehighlightBlock(block);
+        removePending(number);
+        ++ranges;
+    }
 
-    // Multi-line comments
-    m_commentStartExpression = QRegularExpression(R"(--\[\[)");
-    m_commentEndExpression = QRegularExpression(R"(\]\])");
+    LOG_DEBUG(lcHighlighter) << "Idle slice:" << ranges << "deferred ranges in" << slice.elapsed() << "ms,"
+                             << m_pending.size() << "still pending";
+    if (!m_pending.isEmpty())
+        m_idleTimer.start();
 }
 
+void LuaHighlighter::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+    Q_UNUSED(charsAdded)
 
+    const int blockCount = document()->blockCount();
+    const int delta = blockCount - m_blockCount;
+    const int editedBlock = document()->findBlock(position).blockNumber();
+    m_blockCount = blockCount;
 
-void LuaHighlighter::highlightBlock(const QString &text)
+    m_stateScanEnd = qMin(m_stateScanEnd, qMax(0, editedBlock));
+    if (delta != 0 && !m_pending.isEmpty())
+        shiftPending(editedBlock, delta);
+}
+
+void LuaHighlighter::addPending(int firstBlock, int endBlock)
 {
-    // Apply single-line rules
-    for (const auto& rule : m_highlightingRules) {
-        QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-        while (matchIterator.hasNext()) {
-            QRegularExpressionMatch match = matchIterator.next();
-
-            // Falls Capture-Gruppe existiert → nur diese einfärben
-            if (match.lastCapturedIndex() >= 1) {
-                for (int i = 1; i <= match.lastCapturedIndex(); ++i) {
-                    if (match.capturedStart(i) >= 0)
-                        setFormat(match.capturedStart(i), match.capturedLength(i), rule.format);
-                }
-            } else {
-                // sonst gesamtes Match einfärben
-                setFormat(match.capturedStart(), match.capturedLength(), rule.format);
-            }
+    if (firstBlock >= endBlock) return;
+
+    // Häufigster Fall: direkt an den letzten Bereich anhängen
+    if (!m_pending.isEmpty()) {
+        auto last = std::prev(m_pending.end());
+        if (last.key() <= firstBlock && last.value() >= firstBlock) {
+            last.value() = qMax(last.value(), endBlock);
+            return;
         }
     }
 
-    // Handle multi-line comments
-    setCurrentBlockState(0);
-
-    QRegularExpressionMatch startMatch;
-    qsizetype startIndex = 0;
-    if (previousBlockState() != 1) {
-        startMatch = m_commentStartExpression.match(text);
-        startIndex = startMatch.capturedStart();
-    }
-
-    while (startIndex >= 0) {
-        QRegularExpressionMatch endMatch = m_commentEndExpression.match(text, startIndex);
-        qsizetype endIndex = endMatch.capturedStart();
-        qsizetype commentLength = 0;
-
-        if (endIndex == -1) {
-            setCurrentBlockState(1);
-            commentLength = text.length() - startIndex;
-        } else {
-            commentLength = endIndex - startIndex + endMatch.capturedLength();
+    auto it = m_pending.upperBound(firstBlock);
+    if (it != m_pending.begin()) {
+        const auto prev = std::prev(it);
+        if (prev.value() >= firstBlock) {
+            firstBlock = prev.key();
+            endBlock = qMax(endBlock, prev.value());
+            m_pending.erase(prev);
         }
-
-        setFormat(startIndex, commentLength, m_commentFormat);
-        startMatch = m_commentStartExpression.match(text, startIndex + commentLength);
-        startIndex = startMatch.capturedStart();
     }
+    it = m_pending.lowerBound(firstBlock);
+    while (it != m_pending.end() && it.key() <= endBlock) {
+        endBlock = qMax(endBlock, it.value());
+        it = m_pending.erase(it);
+    }
+    m_pending.insert(firstBlock, endBlock);
 }
 
+void LuaHighlighter::removePending(int blockNumber)
+{
+    auto it = m_pending.upperBound(blockNumber);
+    if (it == m_pending.begin()) return;
+    --it;
+
+    const int start = it.key();
+    const int end = it.value();
+    if (blockNumber >= end) return;
+
+    m_pending.erase(it);
+    if (start < blockNumber)
+        m_pending.insert(start, blockNumber);
+    if (blockNumber + 1 < end)
+        m_pending.insert(blockNumber + 1, end);
+}
 
+bool LuaHighlighter::isPending(int blockNumber) const
+{
+    const auto it = m_pending.upperBound(blockNumber);
+    return it != m_pending.cbegin() && std::prev(it).value() > blockNumber;
+}
+
+void LuaHighlighter::shiftPending(int editedBlock, int delta)
+{
+    // Blöcke hinter editedBlock verschieben sich um delta; gelöschte fallen auf editedBlock
+    const auto shifted = [editedBlock, delta](int number) {
+        return number <= editedBlock ? number : qMax(editedBlock, number + delta);
+    };
+
+    const QMap<int, int> old = std::exchange(m_pending, {});
+    for (auto it = old.cbegin(); it != old.cend(); ++it)
+        addPending(shifted(it.key()), shifted(it.value() - 1) + 1);
+}
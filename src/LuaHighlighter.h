@@ -3,12 +3,14 @@
 #include <QSyntaxHighlighter>
 #include <QTextDocument>
 #include <QTextCharFormat>
-#include <QRegularExpression>
 #include <QColor>
 #include <QFont>
-#include <array>
+#include <QMap>
+#include <QTimer>
 #include <string_view>
 
+#include "LuaLexer.h"
+
 class LuaHighlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
@@ -17,21 +19,54 @@ public:
     explicit LuaHighlighter(QTextDocument *parent = nullptr);
     ~LuaHighlighter() override = default;
 
+    // Maximale Anzahl Blöcke, die pro Durchlauf synchron hervorgehoben werden
+    // (0 = unbegrenzt). Restliche Blöcke behalten ihren alten Zustand und werden
+    // anschließend in Häppchen über die Event-Loop nachgezogen.
+    static constexpr int DEFAULT_BLOCK_BUDGET = 1000;
+    void setBlockBudget(int blocks) { m_blockBudget = blocks; }
+    [[nodiscard]] int blockBudget() const { return m_blockBudget; }
+
+    // Während einer Bulk-Edit-Transaktion: jeder geänderte Block wird nur zurückgestellt
+    // (alte Formate bleiben), gelext wird erst nach dem Fortsetzen im Leerlauf bzw. sichtbar
+    void setSuspended(bool suspended);
+    [[nodiscard]] bool isSuspended() const { return m_suspended; }
+
+    // true, solange zurückgestellte Blöcke noch nicht nachgezogen wurden
+    [[nodiscard]] bool hasDeferredBlocks() const { return !m_pending.isEmpty(); }
+
+    // Sichtbaren Bereich sofort hervorheben (Blocknummern inkl. lastBlock).
+    // Zustände davor werden nur gescannt, deren Formate folgen im Leerlauf.
+    void highlightBlocksNow(int firstBlock, int lastBlock);
+
+    // Zeitscheibe für das Nachziehen im Leerlauf
+    static constexpr int IDLE_SLICE_MS = 8;
+
 protected:
     void highlightBlock(const QString &text) override;
 
 private:
-    struct HighlightingRule {
-        QRegularExpression pattern;
-        QTextCharFormat format;
-    };
-    
-    void setupHighlightingRules();
+    void onContentsChange(int position, int charsRemoved, int charsAdded);
+    void deferCurrentBlock(int blockNumber);
+    void processPending();
+    void addPending(int firstBlock, int endBlock);
+    void removePending(int blockNumber);
+    [[nodiscard]] bool isPending(int blockNumber) const;
+    void shiftPending(int editedBlock, int delta);
     void setupFormats();
-    
-    // Highlighting rules
-    std::vector<HighlightingRule> m_highlightingRules;
-    
+    [[nodiscard]] const QTextCharFormat* formatFor(LuaTokenKind kind) const;
+
+    // Begrenzte Propagation (z.B. "--[[" am Anfang einer 50k-Zeilen-Datei)
+    int m_blockBudget = DEFAULT_BLOCK_BUDGET;
+    int m_blocksThisPass = 0;
+    bool m_suspended = false;
+
+    // Blöcke mit veralteten Formaten: Startblock -> Endblock (exklusiv).
+    // Wird bei Edits vor QSyntaxHighlighter um die Blockanzahl-Differenz verschoben.
+    QMap<int, int> m_pending;
+    int m_blockCount = 0;
+    int m_stateScanEnd = 0; // Blockzustände < m_stateScanEnd sind gültig (Zustands-Scan)
+    QTimer m_idleTimer;
+
     // Text formats
     QTextCharFormat m_keywordFormat;
     QTextCharFormat m_commentFormat;
@@ -41,10 +76,6 @@ private:
     QTextCharFormat m_operatorFormat;
     QTextCharFormat m_builtinFormat;
 
-    // Multi-line comment handling
-    QRegularExpression m_commentStartExpression;
-    QRegularExpression m_commentEndExpression;
-
     // Color scheme
     static constexpr std::string_view KEYWORD_COLOR   = "#0000FF"; // Blue
     static constexpr std::string_view COMMENT_COLOR   = "#008000"; // Green
@@ -53,43 +84,4 @@ private:
     static constexpr std::string_view NUMBER_COLOR    = "#FF0000"; // Red
     static constexpr std::string_view OPERATOR_COLOR  = "#808080"; // Gray
     static constexpr std::string_view BUILTIN_COLOR   = "#008080"; // Teal
-
-    // Lua keywords (Lua 5.4.8)
-
-    static constexpr auto LUA_KEYWORDS = std::to_array<const char*> ({
-        "and", "break", "do", "else", "elseif", "end", "false", "for",
-        "function", "if", "in", "local", "nil", "not", "or", "repeat",
-        "return", "then", "true", "until", "while", "goto"
-    });
-
-    // Lua built-in globals + häufige Bibliotheksfunktionen (Lua 5.4.8)
-
-    static constexpr auto LUA_BUILTINS = std::to_array<const char*> ({
-        // Basisfunktionen
-        "assert", "collectgarbage", "dofile", "error", "getmetatable", "ipairs",
-        "load", "loadfile", "next", "pairs", "pcall", "print", "rawequal", "rawget",
-        "rawlen", "rawset", "require", "select", "setmetatable", "tonumber",
-        "tostring", "type", "xpcall", "_G", "_VERSION",
-
-        // Table
-        "table.concat", "table.insert", "table.move", "table.pack",
-        "table.remove", "table.sort", "table.unpack",
-
-        // String
-        "string.byte", "string.char", "string.dump", "string.find",
-        "string.format", "string.gmatch", "string.gsub", "string.len",
-        "string.lower", "string.match", "string.rep", "string.reverse",
-        "string.sub", "string.upper", "string.pack", "string.unpack",
-
-        // Math
-        "math.abs", "math.acos", "math.asin", "math.atan", "math.ceil",
-        "math.cos", "math.deg", "math.exp", "math.floor", "math.fmod",
-        "math.log", "math.max", "math.min", "math.modf", "math.rad",
-        "math.random", "math.sin", "math.sqrt", "math.tan", "math.tointeger",
-        "math.type", "math.ult",
-
-        // OS
-        "os.clock", "os.date", "os.difftime", "os.execute", "os.exit",
-        "os.getenv", "os.remove", "os.rename", "os.setlocale", "os.time"
-    });
 };
@@ -0,0 +1,324 @@
+#include "LuaLexer.h"
+#include "LuaBuiltins.h"
+
+namespace {
+
+template <typename CharT>
+constexpr bool isIdentStart(CharT c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+template <typename CharT>
+constexpr bool isIdentChar(CharT c) {
+    return isIdentStart(c) || (c >= '0' && c <= '9');
+}
+
+template <typename CharT>
+constexpr bool isDigit(CharT c) {
+    return c >= '0' && c <= '9';
+}
+
+template <typename CharT>
+constexpr bool isHexDigit(CharT c) {
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+template <typename CharT>
+constexpr bool isSpace(CharT c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+template <typename CharT>
+constexpr bool isOperatorChar(CharT c) {
+    switch (c) {
+    case '+': case '-': case '*': case '/': case '=': case '<':
+    case '>': case '~': case '#': case '%': case '^': case '&': case '|':
+        return true;
+    default:
+        return false;
+    }
+}
+
+// "[", "[=", "[==" ... gefolgt von "[" → Level (Anzahl '='), sonst -1
+template <typename CharT>
+int longBracketLevel(const CharT* s, int n, int i) {
+    if (i >= n || s[i] != '[') return -1;
+    int j = i + 1;
+    while (j < n && s[j] == '=') ++j;
+    return (j < n && s[j] == '[') ? j - i - 1 : -1;
+}
+
+// Sucht "]" + level*'=' + "]" ab from; liefert Index hinter der schließenden Klammer oder -1
+template <typename CharT>
+int findLongBracketClose(const CharT* s, int n, int from, int level) {
+    for (int i = from; i < n; ++i) {
+        if (s[i] != ']') continue;
+        int j = i + 1;
+        while (j < n && s[j] == '=') ++j;
+        if (j < n && s[j] == ']' && j - i - 1 == level)
+            return j + 1;
+    }
+    return -1;
+}
+
+template <typename CharT>
+int scanNumber(const CharT* s, int n, int i) {
+    if (s[i] == '0' && i + 1 < n && (s[i + 1] == 'x' || s[i + 1] == 'X')) {
+        i += 2;
+        while (i < n && (isHexDigit(s[i]) || s[i] == '.')) ++i;
+        if (i < n && (s[i] == 'p' || s[i] == 'P')) {
+            ++i;
+            if (i < n && (s[i] == '+' || s[i] == '-')) ++i;
+            while (i < n && isDigit(s[i])) ++i;
+        }
+        return i;
+    }
+    while (i < n && (isDigit(s[i]) || s[i] == '.')) ++i;
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+        ++i;
+        if (i < n && (s[i] == '+' || s[i] == '-')) ++i;
+        while (i < n && isDigit(s[i])) ++i;
+    }
+    return i;
+}
+
+template <typename CharT>
+int scanQuotedString(const CharT* s, int n, int i) {
+    const CharT quote = s[i++];
+    while (i < n) {
+        if (s[i] == '\\') {
+            i += 2;
+        } else if (s[i++] == quote) {
+            return i;
+        }
+    }
+    return n; // unterminiert: bis Zeilenende
+}
+
+template <typename CharT>
+int tokenizeImpl(const CharT* s, int n, int state, QList<LuaToken>& out) {
+    int i = 0;
+
+    // Fortsetzung einer langen Klammer aus dem vorherigen Block
+    const LuaLexer::LongBracketKind openKind = LuaLexer::longBracketKind(state);
+    if (openKind != LuaLexer::LongBracketKind::None) {
+        const LuaTokenKind kind = openKind == LuaLexer::LongBracketKind::Comment
+            ? LuaTokenKind::LongComment : LuaTokenKind::LongString;
+        const int end = findLongBracketClose(s, n, 0, LuaLexer::longBracketLevel(state));
+        if (end < 0) {
+            if (n > 0) out.append({0, n, kind});
+            return state;
+        }
+        out.append({0, end, kind});
+        i = end;
+    }
+
+    bool inFunctionName = false; // nach "function" bis zum Ende der Namenskette
+
+    while (i < n) {
+        const CharT c = s[i];
+
+        if (isSpace(c)) {
+            ++i;
+            continue;
+        }
+
+        // Bezeichner, Keywords, Built-ins
+        if (isIdentStart(c)) {
+            int end = i + 1;
+            while (end < n && isIdentChar(s[end])) ++end;
+
+            LuaTokenKind kind = LuaTokenKind::Identifier;
+            const LuaBuiltins::Entry* entry = LuaBuiltins::lookup(s + i, end - i);
+
+            if (entry && entry->kind == LuaBuiltins::WordKind::Keyword) {
+                kind = LuaTokenKind::Keyword;
+                inFunctionName = entry->name == "function";
+                out.append({i, end - i, kind});
+                i = end;
+                continue;
+            }
+
+            // "lib.member" als ein Built-in-Token
+            if (!inFunctionName && end + 1 < n && s[end] == '.' && isIdentStart(s[end + 1])) {
+                int memberEnd = end + 2;
+                while (memberEnd < n && isIdentChar(s[memberEnd])) ++memberEnd;
+                const LuaBuiltins::Entry* dotted = LuaBuiltins::lookup(s + i, memberEnd - i);
+                if (dotted && dotted->kind == LuaBuiltins::WordKind::Builtin) {
+                    kind = LuaTokenKind::Builtin;
+                    end = memberEnd;
+                }
+            }
+
+            if (kind == LuaTokenKind::Identifier) {
+                if (inFunctionName) {
+                    kind = LuaTokenKind::FunctionName;
+                } else if (entry && entry->kind == LuaBuiltins::WordKind::Builtin) {
+                    // Bibliotheksnamen allein ("string" in string.custom) bleiben Bezeichner
+                    kind = LuaTokenKind::Builtin;
+                } else {
+                    int j = end;
+                    while (j < n && isSpace(s[j])) ++j;
+                    if (j < n && s[j] == '(') kind = LuaTokenKind::FunctionCall;
+                }
+            }
+
+            // Kette "function A.b:c" bleibt Funktionsname, solange '.' oder ':' folgt
+            inFunctionName = inFunctionName && end < n && (s[end] == '.' || s[end] == ':');
+            out.append({i, end - i, kind});
+            i = end;
+            continue;
+        }
+
+        // Zahlen (inkl. ".5" und Hex)
+        if (isDigit(c) || (c == '.' && i + 1 < n && isDigit(s[i + 1]))) {
+            const int end = scanNumber(s, n, i);
+            out.append({i, end - i, LuaTokenKind::Number});
+            inFunctionName = false;
+            i = end;
+            continue;
+        }
+
+        // Kommentare
+        if (c == '-' && i + 1 < n && s[i + 1] == '-') {
+            const int level = longBracketLevel(s, n, i + 2);
+            if (level >= 0) {
+                const int end = findLongBracketClose(s, n, i + 4 + level, level);
+                if (end < 0) {
+                    out.append({i, n - i, LuaTokenKind::LongComment});
+                    return LuaLexer::longBracketState(LuaLexer::LongBracketKind::Comment, level);
+                }
+                out.append({i, end - i, LuaTokenKind::LongComment});
+                i = end;
+                continue;
+            }
+            out.append({i, n - i, LuaTokenKind::Comment});
+            return LuaLexer::STATE_NORMAL;
+        }
+
+        // Strings
+        if (c == '"' || c == '\'') {
+            const int end = scanQuotedString(s, n, i);
+            out.append({i, end - i, LuaTokenKind::String});
+            inFunctionName = false;
+            i = end;
+            continue;
+        }
+
+        if (c == '[') {
+            const int level = longBracketLevel(s, n, i);
+            if (level >= 0) {
+                const int end = findLongBracketClose(s, n, i + 2 + level, level);
+                if (end < 0) {
+                    out.append({i, n - i, LuaTokenKind::LongString});
+                    return LuaLexer::longBracketState(LuaLexer::LongBracketKind::String, level);
+                }
+                out.append({i, end - i, LuaTokenKind::LongString});
+                inFunctionName = false;
+                i = end;
+                continue;
+            }
+        }
+
+        // Operatoren (zweistellige als ein Token)
+        if (isOperatorChar(c)) {
+            int len = 1;
+            if (i + 1 < n) {
+                const CharT d = s[i + 1];
+                if ((d == '=' && (c == '=' || c == '~' || c == '<' || c == '>'))
+                    || (c == '/' && d == '/') || (c == '<' && d == '<') || (c == '>' && d == '>'))
+                    len = 2;
+            }
+            out.append({i, len, LuaTokenKind::Operator});
+            inFunctionName = false;
+            i += len;
+            continue;
+        }
+
+        // Interpunktion: "..", "...", "::" zusammen, sonst einzeln
+        if (c < 0x80) {
+            int len = 1;
+            if (c == '.' && i + 1 < n && s[i + 1] == '.')
+                len = (i + 2 < n && s[i + 2] == '.') ? 3 : 2;
+            else if (c == ':' && i + 1 < n && s[i + 1] == ':')
+                len = 2;
+            if (len > 1 || (c != '.' && c != ':'))
+                inFunctionName = false;
+            out.append({i, len, LuaTokenKind::Punctuation});
+            i += len;
+            continue;
+        }
+
+        // Nicht-ASCII außerhalb von Strings/Kommentaren: überspringen
+        ++i;
+    }
+
+    return LuaLexer::STATE_NORMAL;
+}
+
+// Wie tokenizeImpl, aber nur Kommentare/Strings/lange Klammern auswerten.
+// Bezeichner und Zahlen werden übersprungen, damit z.B. "1e--3" gleich behandelt wird.
+template <typename CharT>
+int scanStateImpl(const CharT* s, int n, int state) {
+    int i = 0;
+
+    if (LuaLexer::longBracketKind(state) != LuaLexer::LongBracketKind::None) {
+        const int end = findLongBracketClose(s, n, 0, LuaLexer::longBracketLevel(state));
+        if (end < 0) return state;
+        i = end;
+    }
+
+    while (i < n) {
+        const CharT c = s[i];
+
+        if (isIdentStart(c)) {
+            while (i < n && isIdentChar(s[i])) ++i;
+        } else if (isDigit(c) || (c == '.' && i + 1 < n && isDigit(s[i + 1]))) {
+            i = scanNumber(s, n, i);
+        } else if (c == '-' && i + 1 < n && s[i + 1] == '-') {
+            const int level = longBracketLevel(s, n, i + 2);
+            if (level < 0) return LuaLexer::STATE_NORMAL;
+            const int end = findLongBracketClose(s, n, i + 4 + level, level);
+            if (end < 0) return LuaLexer::longBracketState(LuaLexer::LongBracketKind::Comment, level);
+            i = end;
+        } else if (c == '"' || c == '\'') {
+            i = scanQuotedString(s, n, i);
+        } else if (c == '[' && longBracketLevel(s, n, i) >= 0) {
+            const int level = longBracketLevel(s, n, i);
+            const int end = findLongBracketClose(s, n, i + 2 + level, level);
+            if (end < 0) return LuaLexer::longBracketState(LuaLexer::LongBracketKind::String, level);
+            i = end;
+        } else {
+            ++i;
+        }
+    }
+
+    return LuaLexer::STATE_NORMAL;
+}
+
+} // namespace
+
+int LuaLexer::scanLineState(QStringView line, int startState)
+{
+    return scanStateImpl(reinterpret_cast<const char16_t*>(line.utf16()),
+                         static_cast<int>(line.size()), startState);
+}
+
+int LuaLexer::tokenizeLine(QStringView line, int startState, QList<LuaToken>& tokens)
+{
+    return tokenizeImpl(reinterpret_cast<const char16_t*>(line.utf16()),
+                        static_cast<int>(line.size()), startState, tokens);
+}
+
+int LuaLexer::tokenizeUtf8Line(QByteArrayView line, int startState, QList<LuaToken>& tokens)
+{
+    // unsigned char: Bytes >= 0x80 fallen wie Nicht-ASCII-QChars durch alle ASCII-Klassen
+    return tokenizeImpl(reinterpret_cast<const uchar*>(line.data()),
+                        static_cast<int>(line.size()), startState, tokens);
+}
+
+int LuaLexer::scanUtf8LineState(QByteArrayView line, int startState)
+{
+    return scanStateImpl(reinterpret_cast<const uchar*>(line.data()),
+                         static_cast<int>(line.size()), startState);
+}
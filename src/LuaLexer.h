@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QList>
+#include <QStringView>
+#include <QtGlobal>
+
+enum class LuaTokenKind : quint8 {
+    Identifier,
+    Keyword,
+    Builtin,        // auch gepunktete Namen wie "string.format" als ein Token
+    FunctionName,   // Name nach "function" (inkl. A.b:c-Kette)
+    FunctionCall,   // Bezeichner direkt vor "("
+    Number,
+    String,
+    LongString,     // [[ ... ]], [==[ ... ]==]
+    Comment,
+    LongComment,    // --[[ ... ]]
+    Operator,
+    Punctuation
+};
+
+struct LuaToken {
+    int start = 0;
+    int length = 0;
+    LuaTokenKind kind = LuaTokenKind::Identifier;
+};
+
+/**
+ * Single-Pass-Lexer für eine Zeile (= QTextBlock):
+ *  - ein linearer Durchlauf, keine Regex, keine Allokation außer dem Token-Vektor
+ *  - Keywords/Built-ins über die perfekte Hashtabelle aus LuaBuiltins.h
+ *  - Zustand am Zeilenanfang/-ende wie QSyntaxHighlighter::blockState()
+ */
+class LuaLexer
+{
+public:
+    // Blockzustand: 0 = normal, sonst Art (Bits 0-1) und Level (Bits 2+) der offenen
+    // langen Klammer, z.B. "--[==[" → Comment | 2 << 2. Negative Werte (-1 = noch nie
+    // hervorgehoben) werden wie STATE_NORMAL behandelt.
+    enum class LongBracketKind : quint8 {
+        None = 0,
+        Comment = 1,
+        String = 2
+    };
+
+    static constexpr int STATE_NORMAL = 0;
+
+    static constexpr int longBracketState(LongBracketKind kind, int level) {
+        return static_cast<int>(kind) | (level << 2);
+    }
+    static constexpr LongBracketKind longBracketKind(int state) {
+        return state > 0 ? static_cast<LongBracketKind>(state & 3) : LongBracketKind::None;
+    }
+    static constexpr int longBracketLevel(int state) {
+        return state > 0 ? state >> 2 : 0;
+    }
+
+    // Hängt die Tokens von line an tokens an; liefert den Zustand am Zeilenende
+    static int tokenizeLine(QStringView line, int startState, QList<LuaToken>& tokens);
+
+    // Nur den Zustand am Zeilenende bestimmen (ohne Tokens; gleiches Ergebnis wie tokenizeLine)
+    static int scanLineState(QStringView line, int startState);
+
+    // Dasselbe direkt auf UTF-8-Bytes (z.B. aus Utf8Ingest); start/length sind dann Byte-Offsets
+    static int tokenizeUtf8Line(QByteArrayView line, int startState, QList<LuaToken>& tokens);
+    static int scanUtf8LineState(QByteArrayView line, int startState);
+};
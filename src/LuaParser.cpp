@@ -1,4 +1,6 @@
 #include "LuaParser.h"
+#include "Log.h"
+#include "Trace.h"
 #include <QRegularExpression>
 #include <algorithm>
 
@@ -32,6 +34,31 @@ void SymbolTable::addReference(const Reference& r) {
     m_usages[r.qualifiedName].push_back(r);
 }
 
+void SymbolTable::removeSymbol(const QString& qname) {
+    const auto it = m_symbolsByQName.constFind(qname);
+    if (it == m_symbolsByQName.constEnd()) return;
+    const Symbol s = it.value();
+    m_symbolsByQName.erase(it);
+
+    const auto children = m_children.find(s.parent);
+    if (children != m_children.end()) {
+        children->remove(s.name);
+        if (children->isEmpty()) m_children.erase(children);
+    }
+    if (s.parent.isEmpty())
+        m_globals.remove(s.name);
+    m_tables.remove(qname);
+}
+
+void SymbolTable::removeUsages(const QString& filePath, const QStringList& qnames) {
+    for (const QString& q : qnames) {
+        const auto it = m_usages.find(q);
+        if (it == m_usages.end()) continue;
+        it->removeIf([&](const Reference& r) { return r.filePath == filePath; });
+        if (it->isEmpty()) m_usages.erase(it);
+    }
+}
+
 QStringList SymbolTable::getGlobals() const {
     auto vals = m_globals.values();
     std::sort(vals.begin(), vals.end(), [](const QString& a, const QString& b){ return a.localeAwareCompare(b) < 0; });
@@ -80,16 +107,108 @@ void SymbolTable::mergeFrom(const SymbolTable& other) {
 
 // ================= LuaParser =================
 
-void LuaParser::parseFile(const QString& code, const QString& filePath) {
-    SymbolTable single = parseOne(code, filePath);
-    m_projectTable.mergeFrom(single);
+SymbolDelta LuaParser::parseFile(const QString& code, const QString& filePath) {
+    TRACE_SCOPE("LuaParser::parseFile");
+    SymbolDelta delta = replaceFile(filePath, parseOne(code, filePath));
+    LOG_DEBUG(lcParser) << "Parsed" << filePath << "-" << code.size() << "chars," << delta.added.size() << "added,"
+                        << delta.removed.size() << "removed," << delta.changed.size() << "changed";
+    publish(delta);
+    return delta;
+}
+
+SymbolDelta LuaParser::setFileTable(const QString& filePath, SymbolTable table) {
+    SymbolDelta delta = replaceFile(filePath, std::move(table));
+    publish(delta);
+    return delta;
+}
+
+SymbolDelta LuaParser::removeFile(const QString& filePath) {
+    SymbolDelta delta = replaceFile(filePath, SymbolTable{});
+    m_fileTables.remove(filePath);
+    publish(delta);
+    return delta;
 }
 
 void LuaParser::resetProject() {
+    SymbolDelta delta;
+    delta.removed = m_projectTable.symbols().values();
     m_projectTable.clear();
+    m_fileTables.clear();
+    publish(delta);
+}
+
+SymbolDelta LuaParser::replaceFile(const QString& filePath, SymbolTable next) {
+    SymbolTable previous = m_fileTables.take(filePath);
+    const QHash<QString, Symbol>& projectSymbols = m_projectTable.symbols();
+
+    // Nur Namen, die die Datei vorher oder jetzt definiert, können sich ändern
+    QSet<QString> names;
+    for (auto it = previous.symbols().constBegin(); it != previous.symbols().constEnd(); ++it) names.insert(it.key());
+    for (auto it = next.symbols().constBegin(); it != next.symbols().constEnd(); ++it) names.insert(it.key());
+    QHash<QString, Symbol> before;
+    for (const QString& q : std::as_const(names)) {
+        const auto it = projectSymbols.constFind(q);
+        if (it != projectSymbols.constEnd()) before.insert(q, it.value());
+    }
+
+    // Alten Beitrag entfernen; definiert eine andere Datei denselben Namen, gilt wieder deren Symbol
+    for (auto it = previous.symbols().constBegin(); it != previous.symbols().constEnd(); ++it) {
+        const auto owner = projectSymbols.constFind(it.key());
+        if (owner == projectSymbols.constEnd() || owner->filePath != filePath) continue;
+        m_projectTable.removeSymbol(it.key());
+        if (next.symbols().contains(it.key())) continue;
+        for (auto other = m_fileTables.constBegin(); other != m_fileTables.constEnd(); ++other) {
+            const auto fallback = other->symbols().constFind(it.key());
+            if (fallback == other->symbols().constEnd()) continue;
+            m_projectTable.addSymbol(fallback.value());
+            break;
+        }
+    }
+    m_projectTable.removeUsages(filePath, previous.usages().keys());
+    m_projectTable.mergeFrom(next);
+
+    SymbolDelta delta;
+    delta.filePath = filePath;
+    for (const QString& q : std::as_const(names)) {
+        const auto was = before.constFind(q);
+        const auto is = projectSymbols.constFind(q);
+        if (was == before.constEnd() && is != projectSymbols.constEnd())
+            delta.added.append(is.value());
+        else if (was != before.constEnd() && is == projectSymbols.constEnd())
+            delta.removed.append(was.value());
+        else if (was != before.constEnd() && !(was.value() == is.value()))
+            delta.changed.append(is.value());
+    }
+    for (auto it = previous.usages().constBegin(); it != previous.usages().constEnd(); ++it) {
+        if (next.usages().value(it.key()) != it.value()) delta.referencesChanged.append(it.key());
+    }
+    for (auto it = next.usages().constBegin(); it != next.usages().constEnd(); ++it) {
+        if (!previous.usages().contains(it.key())) delta.referencesChanged.append(it.key());
+    }
+
+    m_fileTables.insert(filePath, std::move(next));
+    return delta;
+}
+
+int LuaParser::addDeltaListener(DeltaListener listener) {
+    const int id = m_nextListenerId++;
+    m_listeners.append({id, std::move(listener)});
+    return id;
+}
+
+void LuaParser::removeDeltaListener(int id) {
+    m_listeners.removeIf([id](const std::pair<int, DeltaListener>& entry) { return entry.first == id; });
+}
+
+void LuaParser::publish(const SymbolDelta& delta) const {
+    if (delta.isEmpty()) return;
+    // Kopie: ein Listener darf sich beim Aufruf abmelden
+    const auto listeners = m_listeners;
+    for (const auto& entry : listeners) entry.second(delta);
 }
 
 SymbolTable LuaParser::parseOne(const QString& code, const QString& filePath) const {
+    TRACE_SCOPE("LuaParser::parseOne");
     SymbolTable st;
     parseFunctionDefs(code, filePath, st);
     parseTablesAndFields(code, filePath, st);
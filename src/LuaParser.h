@@ -3,9 +3,12 @@
 #include <QString>
 #include <QStringList>
 #include <QVector>
+#include <QList>
 #include <QHash>
 #include <QSet>
+#include <functional>
 #include <optional>
+#include <utility>
 
 // ======================= Symbol-Datenstrukturen =======================
 
@@ -21,6 +24,8 @@ enum class SymbolKind {
 struct SourcePos {
     int line = 0;   // 1-basiert
     int column = 0; // 1-basiert (Qt UTF-16 Code units)
+
+    bool operator==(const SourcePos&) const = default;
 };
 
 struct Reference {
@@ -28,6 +33,8 @@ struct Reference {
     SourcePos pos;
     bool isDefinition = false;
     QString filePath;
+
+    bool operator==(const Reference&) const = default;
 };
 
 struct Symbol {
@@ -38,6 +45,8 @@ struct Symbol {
     QString signature;      // "(a, b)"
     SourcePos pos;          // Def-Position
     QString filePath;       // Quelle
+
+    bool operator==(const Symbol&) const = default;
 };
 
 // ======================= Symboltabelle =======================
@@ -50,6 +59,10 @@ public:
     void addSymbol(const Symbol& s);
     void addReference(const Reference& r);
 
+    // Remove (abgeleitete Mengen – Kinder, Globals, Tabellen – werden mitgepflegt)
+    void removeSymbol(const QString& qname);
+    void removeUsages(const QString& filePath, const QStringList& qnames);
+
     // Queries (API)
     QStringList getGlobals() const;
     QStringList getMembers(const QString& parent) const;
@@ -64,6 +77,11 @@ public:
     // Multi-File merge
     void mergeFrom(const SymbolTable& other);
 
+    // Rohdaten für Export/Dump (z.B. WorkspaceIndex)
+    const QHash<QString, Symbol>& symbols() const { return m_symbolsByQName; }
+    const QHash<QString, QVector<Reference>>& usages() const { return m_usages; }
+    const QSet<QString>& globals() const { return m_globals; } // unsortiert, vgl. getGlobals()
+
 private:
     QHash<QString, Symbol> m_symbolsByQName;      // QName -> Symbol
     QHash<QString, QSet<QString>> m_children;     // ParentQName -> { member names }
@@ -72,19 +90,40 @@ private:
     QSet<QString> m_tables;                       // Menge bekannter Tabellen
 };
 
+// ======================= Änderungsmeldungen =======================
+
+// Was ein Neuparsen an der projektweiten Tabelle geändert hat (nur betroffene Namen)
+struct SymbolDelta {
+    QString filePath;               // neu geparste Datei; leer bei resetProject()
+    QList<Symbol> added;            // vorher nicht im Projekt
+    QList<Symbol> removed;          // nicht mehr im Projekt (alter Stand)
+    QList<Symbol> changed;          // gleicher Name, andere Position/Art/Signatur/Datei (neuer Stand)
+    QStringList referencesChanged;  // qualifizierte Namen, deren Verwendungen in der Datei sich geändert haben
+
+    bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && changed.isEmpty() && referencesChanged.isEmpty(); }
+};
+
 // ======================= LuaParser (nicht QObject) =======================
 
 class LuaParser {
 public:
     LuaParser() = default;
 
-    // Parse eine Datei (Code + Pfad) und mergen in Projektweite Tabelle
-    void parseFile(const QString& code, const QString& filePath);
+    // Parse eine Datei (Code + Pfad) und ersetze ihren Beitrag in der projektweiten Tabelle.
+    // Liefert die Änderungen und meldet sie (falls nicht leer) an alle Listener.
+    SymbolDelta parseFile(const QString& code, const QString& filePath);
+    SymbolDelta removeFile(const QString& filePath);
+    // Wie parseFile(), aber mit bereits geparster Tabelle (z.B. aus einem Hintergrund-Index)
+    SymbolDelta setFileTable(const QString& filePath, SymbolTable table);
     SymbolTable parseOne(const QString& code, const QString& filePath) const;
 
     // Projektweite Reparse (resetten)
     void resetProject();
 
+    // Listener für Änderungen; Aufruf synchron im Thread von parseFile()/removeFile()
+    using DeltaListener = std::function<void(const SymbolDelta&)>;
+    int addDeltaListener(DeltaListener listener);
+    void removeDeltaListener(int id);
 
 
     // Editor-API
@@ -114,5 +153,11 @@ private:
     static QString lastOfChain(const QString& chain);
 
 private:
+    SymbolDelta replaceFile(const QString& filePath, SymbolTable next);
+    void publish(const SymbolDelta& delta) const;
+
     SymbolTable m_projectTable;
+    QHash<QString, SymbolTable> m_fileTables;   // Pfad -> Beitrag der Datei
+    QList<std::pair<int, DeltaListener>> m_listeners;
+    int m_nextListenerId = 1;
 };
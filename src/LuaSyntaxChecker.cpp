@@ -0,0 +1,188 @@
+#include "LuaSyntaxChecker.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <atomic>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+namespace {
+    // Chunkname mit '=': Lua übernimmt ihn unverändert als Präfix "document:<line>:"
+    constexpr char CHUNK_NAME[] = "=document";
+    constexpr QByteArrayView MESSAGE_PREFIX = "document:";
+
+    // Ab dieser Heapgröße (KB) wird ein State vor der Rückgabe in den Pool aufgeräumt
+    constexpr int POOL_GC_THRESHOLD_KB = 1024;
+
+    // Prozessweiter Pool; lua_States sind nicht threadsicher, daher exklusiv pro Prüfung
+    class StatePool {
+    public:
+        ~StatePool() {
+            for (lua_State* state : m_idle)
+                lua_close(state);
+        }
+
+        lua_State* acquire() {
+            {
+                QMutexLocker locker(&m_mutex);
+                if (!m_idle.empty()) {
+                    lua_State* state = m_idle.back();
+                    m_idle.pop_back();
+                    return state;
+                }
+            }
+            ++m_created;
+            return luaL_newstate(); // keine Bibliotheken nötig, es wird nur kompiliert
+        }
+
+        void release(lua_State* state) {
+            lua_settop(state, 0);
+            if (lua_gc(state, LUA_GCCOUNT, 0) > POOL_GC_THRESHOLD_KB)
+                lua_gc(state, LUA_GCCOLLECT, 0);
+
+            QMutexLocker locker(&m_mutex);
+            if (m_idle.size() < static_cast<std::size_t>(qMax(1, QThread::idealThreadCount()))) {
+                m_idle.push_back(state);
+                return;
+            }
+            locker.unlock();
+            lua_close(state);
+        }
+
+        int created() const { return m_created.load(); }
+
+    private:
+        QMutex m_mutex;
+        std::vector<lua_State*> m_idle;
+        std::atomic<int> m_created{0};
+    };
+
+    StatePool& pool() {
+        static StatePool instance;
+        return instance;
+    }
+
+    class PooledState {
+    public:
+        PooledState() : m_state(pool().acquire()) {}
+        ~PooledState() { if (m_state) pool().release(m_state); }
+        PooledState(const PooledState&) = delete;
+        PooledState& operator=(const PooledState&) = delete;
+
+        lua_State* get() const { return m_state; }
+
+    private:
+        lua_State* m_state;
+    };
+
+    // "document:12: '=' expected near 'x'" → {12, "'=' expected near 'x'", "x"}
+    LuaSyntaxError parseMessage(QByteArrayView raw) {
+        LuaSyntaxError error;
+        QByteArrayView rest = raw;
+        if (rest.startsWith(MESSAGE_PREFIX)) {
+            rest = rest.sliced(MESSAGE_PREFIX.size());
+            qsizetype digits = 0;
+            int line = 0;
+            while (digits < rest.size() && rest[digits] >= '0' && rest[digits] <= '9') {
+                line = line * 10 + (rest[digits] - '0');
+                ++digits;
+            }
+            if (digits > 0 && rest.sliced(digits).startsWith(": ")) {
+                error.line = line;
+                rest = rest.sliced(digits + 2);
+            }
+        }
+        error.message = QString::fromUtf8(rest);
+
+        const qsizetype near = error.message.lastIndexOf(u" near '"_qs);
+        if (near >= 0 && error.message.endsWith(u'\''))
+            error.nearToken = error.message.sliced(near + 7).chopped(1);
+        return error;
+    }
+}
+
+LuaSyntaxChecker::LuaSyntaxChecker(QObject* parent)
+    : QObject(parent)
+{
+}
+
+QList<LuaSyntaxError> LuaSyntaxChecker::check(QByteArrayView source)
+{
+    TRACE_SCOPE("LuaSyntaxChecker::check");
+    QElapsedTimer timer;
+    timer.start();
+
+    PooledState state;
+    if (!state.get()) {
+        LOG_INFO(lcParser) << "Syntax check skipped: cannot create lua_State";
+        return {};
+    }
+
+    // Modus "t": vorkompilierter Bytecode wird abgelehnt statt geladen
+    const int status = luaL_loadbufferx(state.get(), source.data(), static_cast<size_t>(source.size()),
+                                        CHUNK_NAME, "t");
+    QList<LuaSyntaxError> errors;
+    if (status == LUA_ERRSYNTAX) {
+        size_t length = 0;
+        const char* message = lua_tolstring(state.get(), -1, &length);
+        errors.append(parseMessage(QByteArrayView(message, static_cast<qsizetype>(length))));
+    } else if (status != LUA_OK) {
+        LOG_INFO(lcParser) << "Syntax check failed with status" << status << lua_tostring(state.get(), -1);
+    }
+
+    LOG_DEBUG(lcParser) << "Syntax check:" << source.size() << "bytes in" << timer.nsecsElapsed() / 1000 << "us,"
+                        << errors.size() << "errors";
+    return errors;
+}
+
+void LuaSyntaxChecker::request(const QByteArray& source, int revision)
+{
+    m_latestRevision = revision;
+    if (m_busy) {
+        // Zwischenstände überspringen; nach der laufenden Prüfung kommt nur der neueste dran
+        m_pending = Pending{source, revision};
+        return;
+    }
+    start(source, revision);
+}
+
+void LuaSyntaxChecker::start(const QByteArray& source, int revision)
+{
+    m_busy = true;
+
+    auto* watcher = new QFutureWatcher<QList<LuaSyntaxError>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, revision] {
+        const QList<LuaSyntaxError> errors = watcher->result();
+        watcher->deleteLater();
+        m_busy = false;
+
+        if (m_pending) {
+            const Pending next = std::move(*m_pending);
+            m_pending.reset();
+            start(next.source, next.revision);
+        }
+        // Ergebnis eines inzwischen überholten Schnappschusses nicht melden
+        if (revision == m_latestRevision)
+            emit checked(revision, errors);
+    });
+    watcher->setFuture(QtConcurrent::run([source, revision] {
+        TRACE_SCOPE_REV("LuaSyntaxChecker::run", revision);
+        return check(source);
+    }));
+}
+
+int LuaSyntaxChecker::statesCreated()
+{
+    return pool().created();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <optional>
+
+// Syntaxfehler aus dem Lua-Compiler (luaL_loadbufferx)
+struct LuaSyntaxError {
+    int line = 0;       // 1-basiert, wie von Lua gemeldet
+    QString message;    // ohne "chunk:line:"-Präfix, z.B. "'=' expected near 'x'"
+    QString nearToken;  // Token hinter "near" ohne Anführungszeichen; leer bei <eof> oder unbekannt
+
+    bool operator==(const LuaSyntaxError&) const = default;
+};
+
+/**
+ * Syntaxprüfung mit dem eingebundenen Lua-Compiler:
+ *  - check() kompiliert einen UTF-8-Schnappschuss nur (luaL_loadbufferx, Modus "t"),
+ *    ausgeführt wird nichts; Lua meldet höchstens den ersten Fehler
+ *  - die lua_States kommen aus einem threadsicheren Pool und werden wiederverwendet
+ *  - request() prüft im Hintergrund (QtConcurrent); läuft schon eine Prüfung, wird nur
+ *    der neueste Schnappschuss nachgereicht, veraltete Ergebnisse werden verworfen
+ */
+class LuaSyntaxChecker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LuaSyntaxChecker(QObject* parent = nullptr);
+
+    // Synchron und threadsicher; leere Liste = syntaktisch korrekt
+    static QList<LuaSyntaxError> check(QByteArrayView source);
+
+    // Asynchron; revision kennzeichnet den Schnappschuss (z.B. QTextDocument::revision())
+    void request(const QByteArray& source, int revision);
+    [[nodiscard]] bool isBusy() const { return m_busy; }
+
+    // Für Tests/Diagnose: Anzahl der bisher erzeugten lua_States (prozessweit)
+    static int statesCreated();
+
+signals:
+    void checked(int revision, const QList<LuaSyntaxError>& errors);
+
+private:
+    void start(const QByteArray& source, int revision);
+
+    struct Pending {
+        QByteArray source;
+        int revision = 0;
+    };
+    std::optional<Pending> m_pending;   // neuester Schnappschuss, während eine Prüfung läuft
+    int m_latestRevision = 0;
+    bool m_busy = false;
+};
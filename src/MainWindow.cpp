@@ -1,18 +1,30 @@
 #include "MainWindow.h"
 #include "LuaHighlighter.h"
+#include "Log.h"
+#include "Trace.h"
 
 #include <QCloseEvent>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QTextStream>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QEvent>
+#include <QScopedValueRollback>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <utility>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_parser(std::make_shared<LuaParser>())
     , m_editor(std::make_unique<LuaEditor>(m_parser, this))
     , m_completer(std::make_unique<AutoCompleter>(this))
+    , m_loader(new LargeFileLoader(this))
+    , m_projectIndexWatcher(new QFutureWatcher<ProjectIndexes>(this))
+    , m_textSearch(new WorkspaceSearch(this))
 {
     setupUi();
     setupMenuBar();
@@ -20,11 +32,13 @@ MainWindow::MainWindow(QWidget *parent)
     setupStatusBar();
     createConnections();
 
+    // Popups folgen den Änderungen des Parsers statt nach jedem Parse alles neu zu listen
+    m_symbolDeltaListener = m_parser->addDeltaListener([this](const SymbolDelta& delta) { applySymbolDelta(delta); });
+
     m_completer->setWidget(m_editor.get());
     m_editor->setCompleter(m_completer.get());
 
-    auto* highlighter = new LuaHighlighter(m_editor->document());
-    Q_UNUSED(highlighter)
+    m_editor->setHighlighter(new LuaHighlighter(m_editor->document()));
 
     updateWindowTitle();
     updateStatusBar();
@@ -33,6 +47,12 @@ MainWindow::MainWindow(QWidget *parent)
     resize(1200, 800);
 }
 
+MainWindow::~MainWindow()
+{
+    // Der Parser ist mit dem Editor geteilt und kann das Fenster überleben
+    m_parser->removeDeltaListener(m_symbolDeltaListener);
+}
+
 void MainWindow::setupUi()
 {
     m_centralWidget = new QWidget(this);
@@ -152,81 +172,90 @@ void MainWindow::setupUi()
     mainLayout->addWidget(m_symbolPanel);
     mainLayout->addWidget(m_editor.get());
 
-    m_globalsList = new QListWidget(this);
+    m_globalsModel = new SymbolListModel(u"📋 Globals"_qs, this);
+    m_globalsList = new QListView(this);
+    m_globalsList->setModel(m_globalsModel);
+    m_globalsList->setUniformItemSizes(true);
     m_globalsList->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
     m_globalsList->setAttribute(Qt::WA_ShowWithoutActivating, false);
     m_globalsList->setMaximumHeight(300);
     m_globalsList->setMinimumWidth(300);
     m_globalsList->setStyleSheet(
-        "QListWidget {"
+        "QListView {"
         "   background-color: rgba(240, 240, 240, 250);"
         "   border: 2px solid rgba(100, 100, 100, 220);"
         "   border-radius: 5px;"
         "   padding: 5px;"
         "   font-size: 10pt;"
         "}"
-        "QListWidget::item {"
+        "QListView::item {"
         "   padding: 5px;"
         "   color: #000000;"
         "}"
-        "QListWidget::item:hover {"
+        "QListView::item:hover {"
         "   background-color: rgba(100, 150, 200, 150);"
         "}"
-        "QListWidget::item:selected {"
+        "QListView::item:selected {"
         "   background-color: rgba(50, 100, 200, 200);"
         "   color: white;"
         "}"
     );
     m_globalsList->hide();
 
-    m_functionsList = new QListWidget(this);
+    m_functionsModel = new SymbolListModel(u"⚙️ Functions"_qs, this);
+    m_functionsList = new QListView(this);
+    m_functionsList->setModel(m_functionsModel);
+    m_functionsList->setUniformItemSizes(true);
     m_functionsList->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
     m_functionsList->setAttribute(Qt::WA_ShowWithoutActivating, false);
     m_functionsList->setMaximumHeight(300);
     m_functionsList->setMinimumWidth(300);
     m_functionsList->setStyleSheet(
-        "QListWidget {"
+        "QListView {"
         "   background-color: rgba(255, 250, 240, 250);"
         "   border: 2px solid rgba(100, 100, 100, 220);"
         "   border-radius: 5px;"
         "   padding: 5px;"
         "   font-size: 10pt;"
         "}"
-        "QListWidget::item {"
+        "QListView::item {"
         "   padding: 5px;"
         "   color: #000000;"
         "}"
-        "QListWidget::item:hover {"
+        "QListView::item:hover {"
         "   background-color: rgba(200, 150, 100, 150);"
         "}"
-        "QListWidget::item:selected {"
+        "QListView::item:selected {"
         "   background-color: rgba(200, 100, 50, 200);"
         "   color: white;"
         "}"
     );
     m_functionsList->hide();
 
-    m_tablesList = new QListWidget(this);
+    m_tablesModel = new SymbolListModel(u"📦 Tables"_qs, this);
+    m_tablesList = new QListView(this);
+    m_tablesList->setModel(m_tablesModel);
+    m_tablesList->setUniformItemSizes(true);
     m_tablesList->setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
     m_tablesList->setAttribute(Qt::WA_ShowWithoutActivating, false);
     m_tablesList->setMaximumHeight(300);
     m_tablesList->setMinimumWidth(300);
     m_tablesList->setStyleSheet(
-        "QListWidget {"
+        "QListView {"
         "   background-color: rgba(240, 255, 240, 250);"
         "   border: 2px solid rgba(100, 100, 100, 220);"
         "   border-radius: 5px;"
         "   padding: 5px;"
         "   font-size: 10pt;"
         "}"
-        "QListWidget::item {"
+        "QListView::item {"
         "   padding: 5px;"
         "   color: #000000;"
         "}"
-        "QListWidget::item:hover {"
+        "QListView::item:hover {"
         "   background-color: rgba(100, 200, 100, 150);"
         "}"
-        "QListWidget::item:selected {"
+        "QListView::item:selected {"
         "   background-color: rgba(50, 150, 50, 200);"
         "   color: white;"
         "}"
@@ -236,6 +265,43 @@ void MainWindow::setupUi()
     m_globalsList->installEventFilter(this);
     m_functionsList->installEventFilter(this);
     m_tablesList->installEventFilter(this);
+
+    // Referenz-Panel: einheitliche Zeilenhöhe, damit die View bei vielen Treffern nichts vermisst
+    m_referencesModel = new ReferenceListModel(this);
+    m_referencesView = new QListView(this);
+    m_referencesView->setUniformItemSizes(true);
+    m_referencesView->setModel(m_referencesModel);
+    m_referencesDock = new QDockWidget(tr("References"), this);
+    m_referencesDock->setObjectName("referencesDock");
+    m_referencesDock->setWidget(m_referencesView);
+    addDockWidget(Qt::BottomDockWidgetArea, m_referencesDock);
+    m_referencesDock->hide();
+
+    // Such-Panel: Eingabe mit Optionen, darunter die Treffer in der Reihenfolge ihres Eintreffens
+    auto* searchPanel = new QWidget(this);
+    auto* searchLayout = new QVBoxLayout(searchPanel);
+    searchLayout->setContentsMargins(2, 2, 2, 2);
+    auto* searchBar = new QHBoxLayout();
+    m_searchEdit = new QLineEdit(searchPanel);
+    m_searchEdit->setPlaceholderText(tr("Search in files (Enter)"));
+    m_searchEdit->setClearButtonEnabled(true);
+    m_searchRegexBox = new QCheckBox(tr("Regex"), searchPanel);
+    m_searchCaseBox = new QCheckBox(tr("Match case"), searchPanel);
+    searchBar->addWidget(m_searchEdit, 1);
+    searchBar->addWidget(m_searchRegexBox);
+    searchBar->addWidget(m_searchCaseBox);
+    searchLayout->addLayout(searchBar);
+    m_searchResults = new QListWidget(searchPanel);
+    m_searchResults->setUniformItemSizes(true);
+    searchLayout->addWidget(m_searchResults);
+    m_searchDock = new QDockWidget(tr("Search"), this);
+    m_searchDock->setObjectName("searchDock");
+    m_searchDock->setWidget(searchPanel);
+    addDockWidget(Qt::BottomDockWidgetArea, m_searchDock);
+    tabifyDockWidget(m_referencesDock, m_searchDock);
+    m_searchDock->hide();
+
+    m_symbolPalette = new SymbolPalette(this);
 }
 
 void MainWindow::setupMenuBar()
@@ -249,6 +315,9 @@ void MainWindow::setupMenuBar()
     m_openAction->setShortcuts(QKeySequence::Open);
     fileMenu->addAction(m_openAction);
 
+    m_openFolderAction = new QAction(tr("Open &Folder as Project..."), this);
+    fileMenu->addAction(m_openFolderAction);
+
     fileMenu->addSeparator();
 
     m_saveAction = new QAction(tr("&Save"), this);
@@ -265,6 +334,32 @@ void MainWindow::setupMenuBar()
     m_exitAction->setShortcuts(QKeySequence::Quit);
     fileMenu->addAction(m_exitAction);
 
+    auto* searchMenu = menuBar()->addMenu(tr("&Search"));
+    m_findReferencesAction = new QAction(tr("Find All &References"), this);
+    m_findReferencesAction->setShortcut(QKeySequence(Qt::SHIFT | Qt::Key_F12));
+    searchMenu->addAction(m_findReferencesAction);
+    searchMenu->addAction(m_referencesDock->toggleViewAction());
+    searchMenu->addSeparator();
+    m_findInFilesAction = new QAction(tr("Find in &Files..."), this);
+    m_findInFilesAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_F));
+    searchMenu->addAction(m_findInFilesAction);
+    searchMenu->addAction(m_searchDock->toggleViewAction());
+    searchMenu->addSeparator();
+    m_workspaceSymbolAction = new QAction(tr("Go to &Symbol in Workspace..."), this);
+    m_workspaceSymbolAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_T));
+    searchMenu->addAction(m_workspaceSymbolAction);
+
+    auto* toolsMenu = menuBar()->addMenu(tr("&Tools"));
+    m_traceAction = new QAction(tr("Enable &Tracing"), this);
+    m_traceAction->setCheckable(true);
+    toolsMenu->addAction(m_traceAction);
+
+    m_exportTraceAction = new QAction(tr("&Export Trace..."), this);
+    toolsMenu->addAction(m_exportTraceAction);
+
+    m_exportDiagnosticsAction = new QAction(tr("Export &Diagnostics..."), this);
+    toolsMenu->addAction(m_exportDiagnosticsAction);
+
     auto* helpMenu = menuBar()->addMenu(tr("&Help"));
     m_aboutAction = new QAction(tr("&About"), this);
     helpMenu->addAction(m_aboutAction);
@@ -285,28 +380,56 @@ void MainWindow::setupStatusBar()
     statusBar()->addPermanentWidget(new QLabel(" | ", this));
     m_cursorPosLabel = new QLabel("Line: 1, Col: 1", this);
     statusBar()->addPermanentWidget(m_cursorPosLabel);
+    m_syntaxLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(m_syntaxLabel);
     m_parsingProgress = new QProgressBar(this);
     m_parsingProgress->setVisible(false);
     statusBar()->addPermanentWidget(m_parsingProgress);
+    m_cancelLoadButton = new QPushButton(tr("Cancel"), this);
+    m_cancelLoadButton->setVisible(false);
+    statusBar()->addPermanentWidget(m_cancelLoadButton);
 }
 
 void MainWindow::createConnections()
 {
     connect(m_newAction, &QAction::triggered, this, &MainWindow::newFile);
     connect(m_openAction, &QAction::triggered, this, QOverload<>::of(&MainWindow::openFile));
+    connect(m_openFolderAction, &QAction::triggered, this, &MainWindow::openProjectFolder);
     connect(m_saveAction, &QAction::triggered, this, &MainWindow::saveFile);
     connect(m_saveAsAction, &QAction::triggered, this, &MainWindow::saveFileAs);
     connect(m_exitAction, &QAction::triggered, this, &QWidget::close);
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::about);
-    connect(m_editor.get(), &LuaEditor::textChanged, this, &MainWindow::onTextChanged);
+    connect(m_traceAction, &QAction::toggled, this, [this](bool on) {
+        Trace::setEnabled(on);
+        m_statusLabel->setText(on ? tr("Tracing enabled") : tr("Tracing disabled"));
+    });
+    connect(m_exportTraceAction, &QAction::triggered, this, &MainWindow::exportTrace);
+    connect(m_exportDiagnosticsAction, &QAction::triggered, this, &MainWindow::exportDiagnostics);
+    connect(m_editor.get(), &LuaEditor::documentEdited, this, &MainWindow::onTextChanged);
     connect(m_editor.get(), &LuaEditor::cursorPositionChanged, this, &MainWindow::onCursorPositionChanged);
-    connect(m_globalsList, &QListWidget::itemClicked, this, &MainWindow::onGlobalsItemClicked);
-    connect(m_functionsList, &QListWidget::itemClicked, this, &MainWindow::onFunctionsItemClicked);
-    connect(m_tablesList, &QListWidget::itemClicked, this, &MainWindow::onTablesItemClicked);
+    connect(m_globalsList, &QListView::clicked, this, &MainWindow::onSymbolItemClicked);
+    connect(m_functionsList, &QListView::clicked, this, &MainWindow::onSymbolItemClicked);
+    connect(m_tablesList, &QListView::clicked, this, &MainWindow::onSymbolItemClicked);
     connect(m_loadSymbolButton, &QPushButton::clicked, this, &MainWindow::onLoadSymbolClicked);
     connect(m_globalsButton, &QPushButton::clicked, this, &MainWindow::toggleGlobalsList);
     connect(m_functionsButton, &QPushButton::clicked, this, &MainWindow::toggleFunctionsList);
     connect(m_tablesButton, &QPushButton::clicked, this, &MainWindow::toggleTablesList);
+    connect(m_editor.get(), &LuaEditor::indexingProgress, this, &MainWindow::onIndexingProgress);
+    connect(m_editor.get(), &LuaEditor::syntaxChecked, this, &MainWindow::onSyntaxChecked);
+    connect(m_editor.get(), &LuaEditor::openLocationRequested, this, &MainWindow::openLocation);
+    connect(m_loader, &LargeFileLoader::progressChanged, this, &MainWindow::onLoadProgress);
+    connect(m_loader, &LargeFileLoader::finished, this, &MainWindow::onLoadFinished);
+    connect(m_cancelLoadButton, &QPushButton::clicked, m_loader, &LargeFileLoader::cancel);
+    connect(m_findReferencesAction, &QAction::triggered, this, &MainWindow::findAllReferences);
+    connect(m_referencesView, &QListView::activated, this, &MainWindow::onReferenceActivated);
+    connect(m_projectIndexWatcher, &QFutureWatcherBase::finished, this, &MainWindow::onProjectIndexBuilt);
+    connect(m_findInFilesAction, &QAction::triggered, this, &MainWindow::findInFiles);
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, &MainWindow::startTextSearch);
+    connect(m_searchResults, &QListWidget::itemActivated, this, &MainWindow::onSearchResultActivated);
+    connect(m_textSearch, &WorkspaceSearch::fileMatched, this, &MainWindow::onTextSearchMatched);
+    connect(m_textSearch, &WorkspaceSearch::finished, this, &MainWindow::onTextSearchFinished);
+    connect(m_workspaceSymbolAction, &QAction::triggered, this, &MainWindow::goToWorkspaceSymbol);
+    connect(m_symbolPalette, &SymbolPalette::symbolActivated, this, &MainWindow::openLocation);
 }
 
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
@@ -375,7 +498,8 @@ void MainWindow::toggleTablesList()
 void MainWindow::newFile()
 {
     if (maybeSave()) {
-        m_editor->clear();
+        m_loader->cancel();
+        replaceEditorText(QString());
         setCurrentFile(QString());
         updateSymbolsList();
     }
@@ -392,8 +516,22 @@ void MainWindow::openFile()
     }
 }
 
+void MainWindow::openProjectFolder()
+{
+    const QString root = QFileDialog::getExistingDirectory(this, tr("Open Folder as Project"), m_projectRoot);
+    if (root.isEmpty()) return;
+    m_projectRoot.clear(); // dieselbe Wurzel erneut gewählt → neu aufbauen
+    ensureProjectIndex(QDir(root).absolutePath());
+}
+
 void MainWindow::openFile(const QString& filePath)
 {
+    if (QFileInfo(filePath).size() > LargeFileLoader::LARGE_FILE_THRESHOLD) {
+        openLargeFile(filePath);
+        return;
+    }
+    m_loader->cancel();
+
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         QMessageBox::warning(this, tr("Error"),
@@ -401,11 +539,98 @@ void MainWindow::openFile(const QString& filePath)
         return;
     }
     QTextStream in(&file);
-    m_editor->setPlainText(in.readAll());
+    replaceEditorText(in.readAll());
     setCurrentFile(filePath);
     m_statusLabel->setText(tr("File loaded"));
     m_parser->parseFile(m_editor->toPlainText(), filePath);
-    updateSymbolsList();
+}
+
+void MainWindow::openLargeFile(const QString& filePath)
+{
+    m_loader->cancel();
+
+    // Während des Ladens weder parsen noch indizieren; danach genau einmal
+    m_editor->setAnalysisPaused(true);
+    QScopedValueRollback replacing(m_replacingText, true); // start() leert das Dokument
+    if (!m_loader->start(filePath, m_editor->document())) {
+        m_editor->setAnalysisPaused(false);
+        QMessageBox::warning(this, tr("Error"),
+            tr("Cannot read file %1:\n%2").arg(filePath, m_loader->errorString()));
+        return;
+    }
+
+    m_editor->setReadOnly(true);
+    m_parsingProgress->setRange(0, 100);
+    m_parsingProgress->setValue(0);
+    m_parsingProgress->setVisible(true);
+    m_cancelLoadButton->setVisible(true);
+    m_statusLabel->setText(tr("Loading %1...").arg(strippedName(filePath)));
+}
+
+void MainWindow::onLoadProgress(int percent)
+{
+    m_parsingProgress->setValue(percent);
+}
+
+void MainWindow::onLoadFinished(bool completed)
+{
+    m_parsingProgress->setVisible(false);
+    m_cancelLoadButton->setVisible(false);
+    m_editor->setReadOnly(false);
+
+    if (!completed) {
+        const QString error = m_loader->errorString();
+        replaceEditorText(QString());
+        setCurrentFile(QString());
+        m_editor->setAnalysisPaused(false);
+        if (error.isEmpty()) {
+            m_statusLabel->setText(tr("Loading cancelled"));
+        } else {
+            QMessageBox::warning(this, tr("Error"),
+                tr("Cannot read file %1:\n%2").arg(m_loader->filePath(), error));
+        }
+        updateSymbolsList();
+        return;
+    }
+
+    setCurrentFile(m_loader->filePath());
+    m_editor->setAnalysisPaused(false);
+    m_parser->parseFile(m_editor->toPlainText(), m_currentFile);
+    m_statusLabel->setText(m_loader->hadDecodingErrors()
+                               ? tr("File loaded (invalid UTF-8 sequences replaced)")
+                               : tr("File loaded"));
+}
+
+void MainWindow::onIndexingProgress(int indexedBlocks, int totalBlocks)
+{
+    // Fortschrittsbalken gehört während des Ladens dem LargeFileLoader
+    if (m_loader->isRunning()) return;
+
+    // Kleine Dokumente werden in einer Zeitscheibe fertig und melden nur das Ende
+    if (indexedBlocks >= totalBlocks) {
+        if (m_parsingProgress->isVisible()) {
+            m_parsingProgress->setVisible(false);
+            m_statusLabel->setText(tr("Index complete"));
+        }
+        return;
+    }
+
+    m_parsingProgress->setRange(0, totalBlocks);
+    m_parsingProgress->setValue(indexedBlocks);
+    m_parsingProgress->setVisible(true);
+    m_statusLabel->setText(tr("Indexing... (%1 of %2 lines)").arg(indexedBlocks).arg(totalBlocks));
+}
+
+void MainWindow::onSyntaxChecked(const QList<LuaSyntaxError>& errors)
+{
+    if (errors.isEmpty()) {
+        m_syntaxLabel->setStyleSheet(QString());
+        m_syntaxLabel->setText(tr("Syntax OK"));
+        return;
+    }
+    const LuaSyntaxError& error = errors.first();
+    m_syntaxLabel->setStyleSheet(u"color: red;"_qs);
+    m_syntaxLabel->setText(tr("Line %1: %2").arg(QString::number(error.line), error.message));
 }
 
 bool MainWindow::saveFile()
@@ -438,11 +663,235 @@ bool MainWindow::saveDocument(const QString& fileName)
     }
     QTextStream out(&file);
     out << m_editor->toPlainText();
+
+    // Nur die gespeicherte Datei neu aufnehmen, direkt im Index: offene Cursor halten ihre Bytes
+    // ohnehin implizit geteilt, die Symbolsuche merkt die Änderung an definitionsRevision()
+    const QString absolutePath = QFileInfo(fileName).absoluteFilePath();
+    if (m_referenceIndex && absolutePath.startsWith(m_referenceIndex->root() + u'/'))
+        m_referenceIndex->updateFile(absolutePath, m_editor->toPlainText());
+    if (m_textIndex && absolutePath.startsWith(m_textIndex->root() + u'/')) {
+        m_textIndex->updateFile(absolutePath, m_editor->toPlainText().toUtf8());
+        m_textIndexDirty = true;
+    }
+    // Der laufende Aufbau hat die Datei womöglich schon mit altem Stand gelesen
+    if (m_projectIndexWatcher->isRunning()) m_savedDuringBuild.insert(absolutePath);
+    // Save As: Symbole unter dem neuen Pfad führen, der alte Beitrag fällt in setCurrentFile() weg
+    const bool renamed = fileName != m_currentFile;
     setCurrentFile(fileName);
+    if (renamed) m_parser->parseFile(m_editor->toPlainText(), m_currentFile);
     m_statusLabel->setText(tr("File saved"));
     return true;
 }
 
+void MainWindow::ensureProjectIndex(const QString& root)
+{
+    if (root.isEmpty() || root == m_projectRoot) return;
+    saveTextIndexCache();
+    m_textSearch->cancel(); // Treffer der alten Wurzel nicht mehr ins Panel
+    m_projectRoot = root;
+    // Läuft schon ein Aufbau, startet onProjectIndexBuilt() für die neue Wurzel
+    if (!m_projectIndexWatcher->isRunning())
+        startProjectIndexBuild(root);
+}
+
+void MainWindow::startProjectIndexBuild(const QString& root)
+{
+    m_projectIndexWatcher->setFuture(QtConcurrent::run([root] {
+        ProjectIndexes indexes{root, false, std::make_shared<ReferenceIndex>(), std::make_shared<TrigramIndex>()};
+        if (!indexes.references->build(root)) return indexes;
+
+        // Trigramme aus dem Cache übernehmen, nur neue und geänderte Dateien lesen
+        QFile cache(TrigramIndex::defaultCachePath(root));
+        if (cache.open(QIODevice::ReadOnly) && !indexes.text->load(&cache))
+            LOG_INFO(lcFiles) << "Ignoring outdated search cache" << cache.fileName();
+        cache.close();
+        indexes.built = indexes.text->build(root);
+        if (indexes.built && indexes.text->stats().indexedFiles > 0 && QDir().mkpath(QFileInfo(cache).absolutePath())
+            && cache.open(QIODevice::WriteOnly)) {
+            indexes.text->save(&cache);
+        }
+        return indexes;
+    }));
+}
+
+void MainWindow::onProjectIndexBuilt()
+{
+    ProjectIndexes indexes = m_projectIndexWatcher->result();
+    // Während des Aufbaus eine andere Wurzel gewählt: genau einmal für diese neu starten
+    if (indexes.root != m_projectRoot) {
+        m_savedDuringBuild.clear(); // der neue Aufbau liest den gespeicherten Stand
+        if (!m_projectRoot.isEmpty()) startProjectIndexBuild(m_projectRoot);
+        return;
+    }
+    const QSet<QString> savedDuringBuild = std::exchange(m_savedDuringBuild, {});
+    m_textSearch->cancel(); // der Index, aus dem sie ihre Kandidaten hat, wird gleich ersetzt
+    if (!indexes.built) {
+        m_referenceIndex.reset();
+        m_editor->setProjectIndex(nullptr);
+        m_symbolPalette->setIndex(nullptr);
+        m_textIndex.reset();
+        m_textIndexDirty = false;
+        m_statusLabel->setText(tr("Cannot index %1 (missing or more than %2 Lua files)")
+                                   .arg(QDir::toNativeSeparators(indexes.root)).arg(ReferenceIndex::MAX_FILES));
+        return;
+    }
+    const ReferenceIndex::Stats stats = indexes.references->stats();
+    const TrigramIndex::Stats textStats = indexes.text->stats();
+    m_referenceIndex = std::move(indexes.references);
+    m_editor->setProjectIndex(m_referenceIndex);
+    m_symbolPalette->setIndex(m_referenceIndex);
+    m_textIndex = std::move(indexes.text);
+    m_textIndexDirty = false;
+    // Während des Aufbaus Gespeichertes vom Stand auf der Platte neu aufnehmen (gelöscht → austragen)
+    for (const QString& path : savedDuringBuild) {
+        if (!path.startsWith(m_referenceIndex->root() + u'/')) continue;
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            m_referenceIndex->removeFile(path);
+            m_textIndex->removeFile(path);
+        } else {
+            const QByteArray content = file.readAll();
+            m_referenceIndex->updateFile(path, QString::fromUtf8(content));
+            m_textIndex->updateFile(path, content);
+        }
+        m_textIndexDirty = true;
+    }
+    m_statusLabel->setText(tr("Project index: %1 files, %2 references, %3 files read for search (%4 ms)")
+                               .arg(stats.files).arg(stats.postings).arg(textStats.indexedFiles)
+                               .arg((stats.buildNs + textStats.buildNs) / 1000000));
+}
+
+void MainWindow::saveTextIndexCache()
+{
+    if (!m_textIndex || !m_textIndexDirty) return;
+    QFile cache(TrigramIndex::defaultCachePath(m_textIndex->root()));
+    if (QDir().mkpath(QFileInfo(cache).absolutePath()) && cache.open(QIODevice::WriteOnly)
+        && m_textIndex->save(&cache)) {
+        m_textIndexDirty = false;
+    }
+}
+
+void MainWindow::findAllReferences()
+{
+    const QString name = m_editor->symbolUnderCursor();
+    if (name.isEmpty()) return;
+    if (!m_referenceIndex) {
+        m_statusLabel->setText(m_projectIndexWatcher->isRunning() ? tr("Reference index is still being built")
+                                                                 : tr("Open a project folder to index it"));
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    m_referencesModel->setQuery(m_referenceIndex, name);
+    const quint32 total = m_referencesModel->totalCount();
+    m_referencesDock->setWindowTitle(tr("References: %1 (%2)").arg(name).arg(total));
+    m_referencesDock->show();
+    m_statusLabel->setText(tr("%1 references to %2 (first page in %3 ms)")
+                               .arg(total).arg(name).arg(timer.elapsed()));
+}
+
+void MainWindow::onReferenceActivated(const QModelIndex& index)
+{
+    if (!index.isValid()) return;
+    openLocation(index.data(ReferenceListModel::FilePathRole).toString(),
+                 index.data(ReferenceListModel::LineRole).toInt(),
+                 index.data(ReferenceListModel::ColumnRole).toInt());
+}
+
+void MainWindow::findInFiles()
+{
+    const QString selected = m_editor->textCursor().selectedText();
+    if (!selected.isEmpty() && !selected.contains(QChar::ParagraphSeparator))
+        m_searchEdit->setText(selected);
+    m_searchDock->show();
+    m_searchEdit->setFocus();
+    m_searchEdit->selectAll();
+}
+
+void MainWindow::startTextSearch()
+{
+    if (!m_textIndex) {
+        m_statusLabel->setText(m_projectIndexWatcher->isRunning() ? tr("Search index is still being built")
+                                                                 : tr("Open a project folder to index it"));
+        return;
+    }
+
+    // Außerhalb des Editors geänderte, neue oder gelöschte Dateien nachziehen: build() vergleicht
+    // nur Größe und Änderungszeit und liest allein die Abweichler neu
+    m_textSearch->cancel();
+    const QString root = m_textIndex->root();
+    if (!m_textIndex->build(root)) {
+        m_textIndex.reset();
+        m_textIndexDirty = false;
+        m_statusLabel->setText(tr("Cannot index %1 (missing or more than %2 Lua files)")
+                                   .arg(QDir::toNativeSeparators(root)).arg(TrigramIndex::MAX_FILES));
+        return;
+    }
+    if (m_textIndex->stats().indexedFiles > 0) m_textIndexDirty = true;
+
+    TextQuery query;
+    query.pattern = m_searchEdit->text();
+    query.regex = m_searchRegexBox->isChecked();
+    query.caseSensitive = m_searchCaseBox->isChecked();
+
+    m_searchResults->clear();
+    if (!m_textSearch->start(m_textIndex, query)) {
+        m_statusLabel->setText(m_textSearch->errorString());
+        return;
+    }
+    m_searchDock->setWindowTitle(tr("Search: %1").arg(query.pattern));
+    m_statusLabel->setText(tr("Searching %1 of %2 files...")
+                               .arg(m_textSearch->candidateCount()).arg(m_textSearch->indexedFiles()));
+}
+
+void MainWindow::onTextSearchMatched(const WorkspaceSearch::FileResult& result)
+{
+    const QString relative = QDir(m_textSearch->root()).relativeFilePath(result.path);
+    for (const WorkspaceSearch::Match& match : result.matches) {
+        auto* item = new QListWidgetItem(u"%1:%2:%3: %4"_qs.arg(relative).arg(match.line).arg(match.column)
+                                             .arg(match.text.trimmed()));
+        item->setData(Qt::UserRole, result.path);
+        item->setData(Qt::UserRole + 1, match.line);
+        item->setData(Qt::UserRole + 2, match.column);
+        item->setToolTip(result.path);
+        m_searchResults->addItem(item);
+    }
+}
+
+void MainWindow::onTextSearchFinished(int filesRead, int filesMatched, int matches)
+{
+    m_searchDock->setWindowTitle(tr("Search: %1 (%2)").arg(m_searchEdit->text()).arg(matches));
+    m_statusLabel->setText(tr("%1 matches in %2 files (%3 of %4 files read)")
+                               .arg(matches).arg(filesMatched).arg(filesRead).arg(m_textSearch->indexedFiles()));
+}
+
+void MainWindow::onSearchResultActivated(QListWidgetItem* item)
+{
+    if (!item) return;
+    openLocation(item->data(Qt::UserRole).toString(), item->data(Qt::UserRole + 1).toInt(),
+                 item->data(Qt::UserRole + 2).toInt());
+}
+
+void MainWindow::goToWorkspaceSymbol()
+{
+    if (!m_referenceIndex && m_projectIndexWatcher->isRunning()) {
+        m_statusLabel->setText(tr("Reference index is still being built"));
+        return;
+    }
+    m_symbolPalette->popup();
+}
+
+void MainWindow::openLocation(const QString& path, int line, int column)
+{
+    if (QFileInfo(path).absoluteFilePath() != QFileInfo(m_currentFile).absoluteFilePath()) {
+        if (!maybeSave()) return;
+        openFile(path);
+        if (m_loader->isRunning()) return; // große Datei: springen erst nach dem Laden möglich
+    }
+    m_editor->goToPosition(line, column);
+}
+
 void MainWindow::about()
 {
     QMessageBox::about(this, tr("About Lua AutoComplete"),
@@ -450,12 +899,48 @@ void MainWindow::about()
            "<p>A modern Qt6-based Lua editor with intelligent autocompletion.</p>"));
 }
 
+void MainWindow::exportTrace()
+{
+    const QString fileName = QFileDialog::getSaveFileName(
+        this, tr("Export Trace"), u"luaeditor-trace.json"_qs,
+        tr("Chrome Trace (*.json);;All Files (*)"));
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || !Trace::writeChromeTrace(&file)) {
+        QMessageBox::warning(this, tr("Error"),
+            tr("Cannot write file %1:\n%2").arg(fileName, file.errorString()));
+        return;
+    }
+    m_statusLabel->setText(tr("Trace exported (%1 events)").arg(Trace::snapshot().size()));
+}
+
+void MainWindow::exportDiagnostics()
+{
+    const QString fileName = QFileDialog::getSaveFileName(
+        this, tr("Export Diagnostics"), u"luaeditor-diagnostics.log"_qs,
+        tr("Log Files (*.log *.txt);;All Files (*)"));
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) || !Log::writeRecentMessages(&file)) {
+        QMessageBox::warning(this, tr("Error"),
+            tr("Cannot write file %1:\n%2").arg(fileName, file.errorString()));
+        return;
+    }
+    m_statusLabel->setText(tr("Diagnostics exported"));
+}
+
 void MainWindow::onTextChanged()
 {
+    // Laden und Ersetzen sind keine Bearbeitung; geparst wird danach unter dem neuen Pfad
+    if (m_loader->isRunning() || m_replacingText) return;
+
     m_isModified = true;
     updateWindowTitle();
-    m_parser->parseFile(m_editor->toPlainText(), m_currentFile.isEmpty() ? "untitled.lua" : m_currentFile);
-    updateSymbolsList();
+    m_parser->parseFile(m_editor->toPlainText(), parserPath());
     m_statusLabel->setText(tr("Document modified"));
 }
 
@@ -466,121 +951,107 @@ void MainWindow::onCursorPositionChanged()
 
 void MainWindow::updateSymbolsList()
 {
-    m_globalsList->clear();
-    m_functionsList->clear();
-    m_tablesList->clear();
-
-    auto* globalsHeader = new QListWidgetItem("📋 Globals");
-    globalsHeader->setFlags(Qt::NoItemFlags);
-    globalsHeader->setForeground(QBrush(QColor(50, 50, 50)));
-    QFont headerFont = globalsHeader->font();
-    headerFont.setBold(true);
-    globalsHeader->setFont(headerFont);
-    m_globalsList->addItem(globalsHeader);
-
-    auto* functionsHeader = new QListWidgetItem("⚙️ Functions");
-    functionsHeader->setFlags(Qt::NoItemFlags);
-    functionsHeader->setForeground(QBrush(QColor(50, 50, 50)));
-    functionsHeader->setFont(headerFont);
-    m_functionsList->addItem(functionsHeader);
-
-    auto* tablesHeader = new QListWidgetItem("📦 Tables");
-    tablesHeader->setFlags(Qt::NoItemFlags);
-    tablesHeader->setForeground(QBrush(QColor(50, 50, 50)));
-    tablesHeader->setFont(headerFont);
-    m_tablesList->addItem(tablesHeader);
-
-    const QStringList globals = m_parser->getGlobals();
-
-    int globalsCount = 0;
-    int functionsCount = 0;
-    int tablesCount = 0;
-
-    for (const QString& symbol : globals) {
-        auto def = m_parser->findDefinition(symbol);
-        if (def.has_value()) {
-            QString displayText = symbol;
-            switch (def->kind) {
-                case SymbolKind::Function:
-                    displayText += " " + def->signature;
-                    m_functionsList->addItem(displayText);
-                    functionsCount++;
-                    break;
-                case SymbolKind::Method:
-                    displayText += " " + def->signature;
-                    m_functionsList->addItem(displayText);
-                    functionsCount++;
-                    break;
-                case SymbolKind::Table:
-                    m_tablesList->addItem(displayText);
-                    tablesCount++;
-                    break;
-                case SymbolKind::Variable:
-                case SymbolKind::Field:
-                    m_globalsList->addItem(displayText);
-                    globalsCount++;
-                    break;
-                default:
-                    m_globalsList->addItem(displayText);
-                    globalsCount++;
-                    break;
-            }
-        } else {
-            m_globalsList->addItem(symbol);
-            globalsCount++;
+    TRACE_SCOPE("MainWindow::updateSymbolsList");
+    // Ein Hash-Lookup je globalem Namen, ohne getGlobals() zu sortieren (das Modell sortiert selbst)
+    QList<SymbolListModel::Entry> globals;
+    QList<SymbolListModel::Entry> functions;
+    QList<SymbolListModel::Entry> tables;
+    const SymbolTable& table = m_parser->symbolTable();
+    for (const QString& name : table.globals()) {
+        const auto it = table.symbols().constFind(name);
+        if (it == table.symbols().constEnd()) {
+            globals.append({name, QString(), 0}); // global ohne Definition: ohne Sprungziel
+            continue;
+        }
+        const Symbol& symbol = it.value();
+        switch (symbol.kind) {
+            case SymbolKind::Function:
+            case SymbolKind::Method:
+                functions.append({name, symbol.signature, symbol.pos.line});
+                break;
+            case SymbolKind::Table:
+                tables.append({name, QString(), symbol.pos.line});
+                break;
+            default:
+                globals.append({name, QString(), symbol.pos.line});
+                break;
         }
     }
 
-    m_globalsButton->setEnabled(globalsCount > 0);
-    m_functionsButton->setEnabled(functionsCount > 0);
-    m_tablesButton->setEnabled(tablesCount > 0);
-
-    m_globalsButton->setText(QString("📋 Globals (%1)").arg(globalsCount));
-    m_functionsButton->setText(QString("⚙️ Functions (%1)").arg(functionsCount));
-    m_tablesButton->setText(QString("📦 Tables (%1)").arg(tablesCount));
+    // Modelle gleichen selbst ab: nur Unterschiede erreichen die Views
+    m_globalsModel->setEntries(std::move(globals));
+    m_functionsModel->setEntries(std::move(functions));
+    m_tablesModel->setEntries(std::move(tables));
+    updateSymbolButtons();
 }
 
-void MainWindow::onGlobalsItemClicked(QListWidgetItem* item)
+void MainWindow::applySymbolDelta(const SymbolDelta& delta)
 {
-    if (!item || item->flags() == Qt::NoItemFlags) return;
-    QString symbolText = item->text().split(' ').first();
-    auto def = m_parser->findDefinition(symbolText);
-    if (def.has_value()) {
-        QTextBlock block = m_editor->document()->findBlockByNumber(def->pos.line - 1);
-        if (block.isValid()) {
-            QTextCursor cursor(block);
-            m_editor->setTextCursor(cursor);
-            m_editor->centerCursor();
-            m_editor->setFocus();
+    TRACE_SCOPE("MainWindow::applySymbolDelta");
+    // Popup je Art wie in updateSymbolsList(): 0 Globals, 1 Functions, 2 Tables
+    auto panelOf = [](SymbolKind kind) {
+        switch (kind) {
+            case SymbolKind::Function:
+            case SymbolKind::Method:
+                return 1;
+            case SymbolKind::Table:
+                return 2;
+            default:
+                return 0;
+        }
+    };
+    auto entryOf = [&](const Symbol& symbol) {
+        return SymbolListModel::Entry{symbol.name, panelOf(symbol.kind) == 1 ? symbol.signature : QString(),
+                                      symbol.pos.line};
+    };
+
+    SymbolListModel* models[] = {m_globalsModel, m_functionsModel, m_tablesModel};
+    QStringList removed[3];
+    QList<SymbolListModel::Entry> upserted[3];
+    for (const Symbol& symbol : delta.removed) {
+        if (!symbol.parent.isEmpty()) continue;
+        for (QStringList& names : removed) names.append(symbol.name);
+    }
+    // Geänderte Symbole können die Art gewechselt haben: aus den anderen Popups entfernen
+    for (const Symbol& symbol : delta.changed) {
+        if (!symbol.parent.isEmpty()) continue;
+        const int panel = panelOf(symbol.kind);
+        for (int i = 0; i < 3; ++i) {
+            if (i != panel) removed[i].append(symbol.name);
         }
+        upserted[panel].append(entryOf(symbol));
     }
-    m_globalsList->hide();
+    for (const Symbol& symbol : delta.added) {
+        if (symbol.parent.isEmpty()) upserted[panelOf(symbol.kind)].append(entryOf(symbol));
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        if (!removed[i].isEmpty() || !upserted[i].isEmpty())
+            models[i]->applyDelta(removed[i], upserted[i]);
+    }
+    updateSymbolButtons();
 }
 
-void MainWindow::onFunctionsItemClicked(QListWidgetItem* item)
+void MainWindow::updateSymbolButtons()
 {
-    if (!item || item->flags() == Qt::NoItemFlags) return;
-    QString symbolText = item->text().split(' ').first();
-    auto def = m_parser->findDefinition(symbolText);
-    if (def.has_value()) {
-        QTextBlock block = m_editor->document()->findBlockByNumber(def->pos.line - 1);
-        if (block.isValid()) {
-            QTextCursor cursor(block);
-            m_editor->setTextCursor(cursor);
-            m_editor->centerCursor();
-            m_editor->setFocus();
-        }
-    }
-    m_functionsList->hide();
+    const int globalsCount = m_globalsModel->count();
+    const int functionsCount = m_functionsModel->count();
+    const int tablesCount = m_tablesModel->count();
+
+    m_globalsButton->setEnabled(globalsCount > 0);
+    m_functionsButton->setEnabled(functionsCount > 0);
+    m_tablesButton->setEnabled(tablesCount > 0);
+
+    m_globalsButton->setText(QString("📋 Globals (%1)").arg(globalsCount));
+    m_functionsButton->setText(QString("⚙️ Functions (%1)").arg(functionsCount));
+    m_tablesButton->setText(QString("📦 Tables (%1)").arg(tablesCount));
 }
 
-void MainWindow::onTablesItemClicked(QListWidgetItem* item)
+void MainWindow::onSymbolItemClicked(const QModelIndex& index)
 {
-    if (!item || item->flags() == Qt::NoItemFlags) return;
-    QString symbolText = item->text().split(' ').first();
-    auto def = m_parser->findDefinition(symbolText);
-    if (def.has_value()) {
-        QTextBlock block = m_editor->document()->findBlockByNumber(def->pos.line - 1);
+    const int line = index.data(SymbolListModel::LineRole).toInt();
+    if (line > 0) {
+        QTextBlock block = m_editor->document()->findBlockByNumber(line - 1);
         if (block.isValid()) {
             QTextCursor cursor(block);
             m_editor->setTextCursor(cursor);
@@ -588,7 +1059,7 @@ void MainWindow::onTablesItemClicked(QListWidgetItem* item)
             m_editor->setFocus();
         }
     }
-    m_tablesList->hide();
+    hideAllPopups();
 }
 
 void MainWindow::onLoadSymbolClicked()
@@ -600,7 +1071,6 @@ void MainWindow::onLoadSymbolClicked()
         m_parser->resetProject();
         m_parser->parseFile(m_editor->toPlainText(), "untitled.lua");
     }
-    updateSymbolsList();
     m_statusLabel->setText(tr("Symbols reloaded"));
 }
 
@@ -623,13 +1093,35 @@ void MainWindow::updateStatusBar()
         tr("Line: %1, Col: %2").arg(cursor.blockNumber() + 1).arg(cursor.columnNumber() + 1));
 }
 
+QString MainWindow::parserPath() const
+{
+    return m_currentFile.isEmpty() ? u"untitled.lua"_qs : m_currentFile;
+}
+
+void MainWindow::replaceEditorText(const QString& text)
+{
+    QScopedValueRollback replacing(m_replacingText, true);
+    m_editor->setPlainText(text);
+}
+
 void MainWindow::setCurrentFile(const QString& fileName)
 {
+    // Der Beitrag des alten Pfads darf nicht stehen bleiben: sonst holt replaceFile() dessen
+    // Definitionen als Ersatz zurück, wenn die neue Datei sie nicht (mehr) enthält
+    const QString previousPath = parserPath();
     m_currentFile = fileName;
+    if (parserPath() != previousPath)
+        m_parser->removeFile(previousPath);
     m_isModified = false;
+    m_editor->setFilePath(m_currentFile);
     updateWindowTitle();
     const QString shown = m_currentFile.isEmpty() ? "untitled.lua" : strippedName(m_currentFile);
     setWindowFilePath(shown);
+    // Dateien innerhalb der aktuellen Wurzel behalten sie (auch eine per "Open Folder" gewählte);
+    // sonst nur indizieren, wenn ein Projektmarker gefunden wird
+    const QString absolutePath = QFileInfo(m_currentFile).absoluteFilePath();
+    if (!m_currentFile.isEmpty() && (m_projectRoot.isEmpty() || !absolutePath.startsWith(m_projectRoot + u'/')))
+        ensureProjectIndex(ReferenceIndex::findProjectRoot(absolutePath));
 }
 
 QString MainWindow::strippedName(const QString& fullFileName) const
@@ -658,6 +1150,9 @@ bool MainWindow::maybeSave()
 void MainWindow::closeEvent(QCloseEvent *event)
 {
     if (maybeSave()) {
+        m_loader->cancel();
+        m_textSearch->cancel();
+        saveTextIndexCache();
         event->accept();
     } else {
         event->ignore();
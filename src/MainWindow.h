@@ -12,11 +12,24 @@
 #include <QLabel>
 #include <QProgressBar>
 #include <QPushButton>
+#include <QDockWidget>
+#include <QListView>
+#include <QFutureWatcher>
+#include <QLineEdit>
+#include <QCheckBox>
+#include <QSet>
 #include <memory>
 
 #include "LuaEditor.h"
 #include "LuaParser.h"
 #include "AutoCompleter.h"
+#include "LargeFileLoader.h"
+#include "ReferenceIndex.h"
+#include "ReferenceListModel.h"
+#include "SymbolListModel.h"
+#include "SymbolPalette.h"
+#include "TrigramIndex.h"
+#include "WorkspaceSearch.h"
 
 class MainWindow : public QMainWindow
 {
@@ -24,9 +37,10 @@ class MainWindow : public QMainWindow
 
 public:
     explicit MainWindow(QWidget *parent = nullptr);
-    ~MainWindow() override = default;
+    ~MainWindow() override;
 
     void openFile(const QString& filePath);
+    [[nodiscard]] const SymbolTable& symbolTableForTesting() const { return m_parser->symbolTable(); }
 
 protected:
     void closeEvent(QCloseEvent *event) override;
@@ -35,19 +49,33 @@ protected:
 private slots:
     void newFile();
     void openFile();
+    void openProjectFolder();
     bool saveFile();
     bool saveFileAs();
     void about();
     void onTextChanged();
     void onCursorPositionChanged();
     void updateSymbolsList();
-    void onGlobalsItemClicked(QListWidgetItem* item);
-    void onFunctionsItemClicked(QListWidgetItem* item);
-    void onTablesItemClicked(QListWidgetItem* item);
+    void onSymbolItemClicked(const QModelIndex& index);
     void onLoadSymbolClicked();
     void toggleGlobalsList();
     void toggleFunctionsList();
     void toggleTablesList();
+    void exportTrace();
+    void exportDiagnostics();
+    void onLoadProgress(int percent);
+    void onLoadFinished(bool completed);
+    void onIndexingProgress(int indexedBlocks, int totalBlocks);
+    void onSyntaxChecked(const QList<LuaSyntaxError>& errors);
+    void findAllReferences();
+    void onReferenceActivated(const QModelIndex& index);
+    void onProjectIndexBuilt();
+    void findInFiles();
+    void startTextSearch();
+    void onTextSearchMatched(const WorkspaceSearch::FileResult& result);
+    void onTextSearchFinished(int filesRead, int filesMatched, int matches);
+    void onSearchResultActivated(QListWidgetItem* item);
+    void goToWorkspaceSymbol();
 
 private:
     void setupUi();
@@ -58,15 +86,26 @@ private:
     void updateWindowTitle();
     void updateStatusBar();
     void hideAllPopups();
+    void updateSymbolButtons();
+    void applySymbolDelta(const SymbolDelta& delta);
     [[nodiscard]] bool maybeSave();
     [[nodiscard]] bool saveDocument(const QString& fileName);
     void setCurrentFile(const QString& fileName);
+    [[nodiscard]] QString parserPath() const; // Pfad des Dokuments im Parser ("untitled.lua" ohne Datei)
+    void replaceEditorText(const QString& text);
     [[nodiscard]] QString strippedName(const QString& fullFileName) const;
+    void openLargeFile(const QString& filePath);
+    void ensureProjectIndex(const QString& root);
+    void startProjectIndexBuild(const QString& root);
+    void saveTextIndexCache();
+    void openLocation(const QString& path, int line, int column);
 
     // Core components
     std::shared_ptr<LuaParser> m_parser;
+    int m_symbolDeltaListener{0};
     std::unique_ptr<LuaEditor> m_editor;
     std::unique_ptr<AutoCompleter> m_completer;
+    LargeFileLoader* m_loader{nullptr};
 
     QWidget* m_centralWidget{nullptr};
     QWidget* m_symbolPanel{nullptr};
@@ -79,27 +118,72 @@ private:
     QPushButton* m_functionsButton{nullptr};
     QPushButton* m_tablesButton{nullptr};
 
-    // Three symbol list boxes (popup style)
-    QListWidget* m_globalsList{nullptr};
-    QListWidget* m_functionsList{nullptr};
-    QListWidget* m_tablesList{nullptr};
+    // Three symbol list boxes (popup style); Modelle melden nur geänderte Zeilen
+    QListView* m_globalsList{nullptr};
+    QListView* m_functionsList{nullptr};
+    QListView* m_tablesList{nullptr};
+    SymbolListModel* m_globalsModel{nullptr};
+    SymbolListModel* m_functionsModel{nullptr};
+    SymbolListModel* m_tablesModel{nullptr};
 
     // Actions
     QAction* m_newAction{nullptr};
     QAction* m_openAction{nullptr};
+    QAction* m_openFolderAction{nullptr};
     QAction* m_saveAction{nullptr};
     QAction* m_saveAsAction{nullptr};
     QAction* m_exitAction{nullptr};
     QAction* m_aboutAction{nullptr};
+    QAction* m_traceAction{nullptr};
+    QAction* m_exportTraceAction{nullptr};
+    QAction* m_exportDiagnosticsAction{nullptr};
+    QAction* m_findReferencesAction{nullptr};
+    QAction* m_findInFilesAction{nullptr};
+    QAction* m_workspaceSymbolAction{nullptr};
+
+    // Projektindizes (Wurzel per .git/.luarc oder "Open Folder as Project"), gemeinsam im Hintergrund
+    // aufgebaut; root ist die Wurzel, für die der Aufbau gestartet wurde
+    struct ProjectIndexes {
+        QString root;
+        bool built = false;
+        std::shared_ptr<ReferenceIndex> references;
+        std::shared_ptr<TrigramIndex> text;
+    };
+    QFutureWatcher<ProjectIndexes>* m_projectIndexWatcher{nullptr};
+    QString m_projectRoot;
+    QSet<QString> m_savedDuringBuild;  // während des Aufbaus gespeichert, danach neu aufnehmen
+
+    // Projektweite Referenzen, Ergebnis seitenweise im Panel. Beide Indizes werden nur im GUI-Thread
+    // und beim Speichern direkt verändert; Hintergrundarbeit liest flache (implizit geteilte) Kopien
+    std::shared_ptr<ReferenceIndex> m_referenceIndex;
+    QDockWidget* m_referencesDock{nullptr};
+    QListView* m_referencesView{nullptr};
+    ReferenceListModel* m_referencesModel{nullptr};
+
+    // Volltextsuche: Trigramm-Index (Cache auf Platte), Treffer kommen dateiweise ins Panel
+    std::shared_ptr<TrigramIndex> m_textIndex;
+    bool m_textIndexDirty{false};  // seit dem letzten Schreiben des Caches geändert
+    WorkspaceSearch* m_textSearch{nullptr};
+    QDockWidget* m_searchDock{nullptr};
+    QLineEdit* m_searchEdit{nullptr};
+    QCheckBox* m_searchRegexBox{nullptr};
+    QCheckBox* m_searchCaseBox{nullptr};
+    QListWidget* m_searchResults{nullptr};
+
+    // Symbolsuche über alle Definitionen des Referenzindex (Ctrl+T)
+    SymbolPalette* m_symbolPalette{nullptr};
 
     // Status bar widgets
     QLabel* m_statusLabel{nullptr};
     QLabel* m_cursorPosLabel{nullptr};
+    QLabel* m_syntaxLabel{nullptr};
     QProgressBar* m_parsingProgress{nullptr};
+    QPushButton* m_cancelLoadButton{nullptr};
 
     // File management
     QString m_currentFile;
     bool m_isModified{false};
+    bool m_replacingText{false};  // Inhalt wird ersetzt (Laden/Neu), keine Bearbeitung
 
     static constexpr std::string_view WINDOW_TITLE = "Lua AutoComplete Editor";
 };
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "ModuleGraph.h"
+#include "ModuleResolver.h"
+#include "LuaLexer.h"
+#include "Utf8Ingest.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <functional>
+#include <string_view>
+
+ModuleGraph::ModuleGraph(ModuleResolver* resolver, QObject* parent)
+    : QObject(parent)
+    , m_resolver(resolver)
+{
+    connect(&m_fileWatcher, &QFileSystemWatcher::fileChanged, this, &ModuleGraph::onFileChanged);
+    // Nach Verzeichnisänderungen können Namen anders (oder erstmals) aufgelöst werden
+    connect(m_resolver, &ModuleResolver::modulesChanged, this, &ModuleGraph::onModulesChanged);
+}
+
+void ModuleGraph::setRoots(const QList<ModuleRequire>& roots)
+{
+    m_roots = roots;
+    update();
+}
+
+QString ModuleGraph::resolve(const QString& moduleName) const
+{
+    return m_resolver->resolve(moduleName);
+}
+
+void ModuleGraph::update()
+{
+    TRACE_SCOPE("ModuleGraph::update");
+
+    // Erreichbarkeit per BFS über die vorhandenen Scans; kein I/O
+    m_reachedVia.clear();
+    m_reachOrder.clear();
+    QStringList toLoad;
+
+    auto visit = [&](const QString& from, const QString& name) {
+        const QString path = m_resolver->resolve(name);
+        if (path.isEmpty() || m_reachedVia.contains(path)) return;
+        m_reachedVia.insert(path, {from, name});
+        m_reachOrder.append(path);
+        if (!m_modules.contains(path) && !m_inFlight.contains(path) && !m_failed.contains(path))
+            toLoad.append(path);
+    };
+
+    for (const ModuleRequire& root : std::as_const(m_roots))
+        visit(QString(), root.name);
+    for (qsizetype i = 0; i < m_reachOrder.size(); ++i) {
+        const QString path = m_reachOrder.at(i);
+        const auto it = m_modules.constFind(path);
+        if (it == m_modules.constEnd()) continue;
+        for (const ModuleRequire& dependency : it->imports)
+            visit(path, dependency.name);
+    }
+
+    findCycles();
+    if (!toLoad.isEmpty())
+        scheduleLoads(toLoad);
+    emit graphChanged();
+}
+
+void ModuleGraph::scheduleLoads(const QStringList& paths)
+{
+    LOG_DEBUG(lcImports) << "Loading" << paths.size() << "modules in parallel";
+    for (const QString& path : paths)
+        m_inFlight.insert(path);
+
+    auto* watcher = new QFutureWatcher<ModuleScan>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher] {
+        onBatchFinished(watcher->future().results());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::mapped(paths, &ModuleGraph::scanFile));
+}
+
+void ModuleGraph::onBatchFinished(const QList<ModuleScan>& scans)
+{
+    for (const ModuleScan& scan : scans) {
+        m_inFlight.remove(scan.path);
+        ++m_scanCount;
+        if (!m_fileWatcher.files().contains(scan.path))
+            m_fileWatcher.addPath(scan.path);
+
+        // Während des Scans geändert: gilt nur, wenn die Datei seither neu geschrieben wurde
+        // (eine Änderung meldet der Watcher oft mehrfach); dann verwerfen, update() plant neu ein
+        if (m_changedInFlight.remove(scan.path) && QFileInfo(scan.path).lastModified() != scan.lastModified) {
+            LOG_DEBUG(lcImports) << "Module changed during scan, rescanning:" << scan.path;
+            continue;
+        }
+
+        if (!scan.ok) {
+            m_failed.insert(scan.path);
+            continue;
+        }
+
+        LOG_DEBUG(lcImports) << "Scanned" << scan.path << ":" << scan.functions.size() << "functions,"
+                             << scan.imports.size() << "requires";
+        m_modules.insert(scan.path, scan);
+    }
+    // Nächste Ebene: neu entdeckte Abhängigkeiten werden in update() eingeplant
+    update();
+}
+
+void ModuleGraph::onFileChanged(const QString& path)
+{
+    LOG_DEBUG(lcImports) << "Module changed:" << path;
+
+    // Nur dieses Modul neu scannen; Kanten der anderen Module bleiben gültig.
+    // Editoren ersetzen Dateien oft (löschen + umbenennen), daher nach dem Scan neu beobachten
+    if (m_inFlight.contains(path))
+        m_changedInFlight.insert(path);
+    m_modules.remove(path);
+    m_failed.remove(path);
+    m_fileWatcher.removePath(path);
+    update();
+}
+
+void ModuleGraph::onModulesChanged()
+{
+    // Dateien im Suchpfad sind hinzugekommen oder verschwunden: fehlgeschlagene Module erneut versuchen
+    m_failed.clear();
+    update();
+}
+
+void ModuleGraph::findCycles()
+{
+    QList<QStringList> cycles;
+    QHash<QString, int> state; // 1 = auf dem DFS-Stack, 2 = abgeschlossen
+    QStringList stack;
+
+    std::function<void(const QString&)> dfs = [&](const QString& path) {
+        state.insert(path, 1);
+        stack.append(path);
+        const auto it = m_modules.constFind(path);
+        if (it != m_modules.constEnd()) {
+            for (const ModuleRequire& dependency : it->imports) {
+                const QString next = m_resolver->resolve(dependency.name);
+                if (next.isEmpty()) continue;
+                const int nextState = state.value(next);
+                if (nextState == 1)
+                    cycles.append(stack.mid(stack.indexOf(next)));
+                else if (nextState == 0)
+                    dfs(next);
+            }
+        }
+        stack.removeLast();
+        state.insert(path, 2);
+    };
+
+    for (const QString& path : std::as_const(m_reachOrder)) {
+        if (!state.contains(path))
+            dfs(path);
+    }
+
+    for (const QStringList& cycle : std::as_const(cycles)) {
+        if (!m_cycles.contains(cycle))
+            LOG_INFO(lcImports) << "require cycle:" << cycle;
+    }
+    m_cycles = cycles;
+}
+
+QStringList ModuleGraph::reachableModules() const
+{
+    QStringList modules;
+    for (const QString& path : m_reachOrder) {
+        if (m_modules.contains(path))
+            modules.append(path);
+    }
+    return modules;
+}
+
+QStringList ModuleGraph::functions(const QString& path) const
+{
+    return m_modules.value(path).functions;
+}
+
+QStringList ModuleGraph::reachableGlobals() const
+{
+    QSet<QString> globals;
+    for (const QString& path : m_reachOrder) {
+        const auto it = m_modules.constFind(path);
+        if (it == m_modules.constEnd()) continue;
+        for (const QString& name : it->globals)
+            globals.insert(name);
+    }
+    QStringList list = globals.values();
+    list.sort(Qt::CaseInsensitive);
+    return list;
+}
+
+QStringList ModuleGraph::whyLoaded(const QString& path) const
+{
+    QStringList chain;
+    QString current = path;
+    for (;;) {
+        const auto it = m_reachedVia.constFind(current);
+        if (it == m_reachedVia.constEnd()) return {};
+        chain.prepend(it->name);
+        if (it->from.isEmpty()) return chain;
+        current = it->from;
+    }
+}
+
+ModuleScan ModuleGraph::scanFile(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_DEBUG(lcImports) << "Cannot read module" << path << file.errorString();
+        ModuleScan failed;
+        failed.path = path;
+        return failed;
+    }
+    const QDateTime lastModified = QFileInfo(file).lastModified();
+    ModuleScan scan = scanSource(file.readAll());
+    scan.path = path;
+    scan.lastModified = lastModified;
+    return scan;
+}
+
+ModuleScan ModuleGraph::scanSource(QByteArrayView source)
+{
+    TRACE_SCOPE("ModuleGraph::scanSource");
+
+    // Direkt auf den UTF-8-Bytes: Zeilentabelle aus Utf8Ingest, Tokens aus dem Lexer
+    const Utf8Ingest::Result ingest = Utf8Ingest::scan(source);
+    if (!ingest.isValid())
+        LOG_DEBUG(lcImports) << "Invalid UTF-8 in module at byte" << ingest.errorOffset;
+
+    ModuleScan scan;
+    scan.ok = true;
+    QSet<QString> uniqueFunctions;
+    QSet<QString> uniqueGlobals;
+    QList<LuaToken> tokens;
+    int state = LuaLexer::STATE_NORMAL;
+
+    for (qsizetype lineIndex = 0; lineIndex < ingest.lineCount(); ++lineIndex) {
+        const QByteArrayView line = Utf8Ingest::line(source, ingest, lineIndex);
+        tokens.clear();
+        state = LuaLexer::tokenizeUtf8Line(line, state, tokens);
+
+        auto text = [&](qsizetype t) {
+            return t >= 0 && t < tokens.size()
+                ? std::string_view(line.data() + tokens[t].start, static_cast<std::size_t>(tokens[t].length))
+                : std::string_view();
+        };
+        auto isName = [&](qsizetype t) {
+            if (t < 0 || t >= tokens.size()) return false;
+            const LuaTokenKind kind = tokens[t].kind;
+            return kind == LuaTokenKind::Identifier || kind == LuaTokenKind::FunctionCall
+                || (kind == LuaTokenKind::Builtin && text(t).find('.') == std::string_view::npos);
+        };
+        // Bezeichner sind reines ASCII, Modulnamen in Strings nicht unbedingt
+        auto name = [&](qsizetype t) {
+            const std::string_view word = text(t);
+            return QString::fromUtf8(word.data(), static_cast<qsizetype>(word.size()));
+        };
+
+        // Pattern 4: return { func1 = func1, func2 = func2 } (common in modules)
+        const bool exportList = text(0) == "return" && text(1) == "{";
+
+        for (qsizetype t = 0; t < tokens.size(); ++t) {
+            // Pattern 1/2: [local] function functionName()
+            if (tokens[t].kind == LuaTokenKind::FunctionName && t > 0
+                && tokens[t - 1].kind == LuaTokenKind::Keyword && text(t + 1) == "(") {
+                uniqueFunctions.insert(name(t));
+                if (text(t - 2) != "local")
+                    uniqueGlobals.insert(name(t));
+                continue;
+            }
+
+            // Pattern 3: M.functionName = function() (module pattern)
+            if (isName(t) && text(t + 1) == "." && isName(t + 2) && text(t + 3) == "="
+                && text(t + 4) == "function") {
+                uniqueFunctions.insert(name(t + 2));
+                t += 4;
+                continue;
+            }
+
+            // require("name"), require "name", [local] alias = require("name")
+            if (text(t) == "require") {
+                qsizetype arg = t + 1;
+                if (text(arg) == "(") ++arg;
+                if (arg < tokens.size() && tokens[arg].kind == LuaTokenKind::String && tokens[arg].length >= 2) {
+                    const std::string_view quoted = text(arg);
+                    const std::string_view moduleName = quoted.substr(1, quoted.size() - 2);
+                    ModuleRequire dependency;
+                    dependency.name = QString::fromUtf8(moduleName.data(), static_cast<qsizetype>(moduleName.size()));
+                    if (text(t - 1) == "=" && isName(t - 2))
+                        dependency.alias = name(t - 2);
+                    scan.imports.append(dependency);
+                    t = arg;
+                }
+                continue;
+            }
+
+            if (exportList && isName(t) && text(t + 1) == "=")
+                uniqueFunctions.insert(name(t));
+        }
+    }
+
+    scan.functions = uniqueFunctions.values();
+    scan.functions.sort(Qt::CaseInsensitive);
+    scan.globals = uniqueGlobals.values();
+    scan.globals.sort(Qt::CaseInsensitive);
+    return scan;
+}
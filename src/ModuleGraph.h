@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class ModuleResolver;
+
+// require()-Aufruf: local <alias> = require("<name>"); alias leer bei require("<name>") ohne Zuweisung
+struct ModuleRequire {
+    QString alias;
+    QString name;
+
+    bool operator==(const ModuleRequire&) const = default;
+};
+
+// Ergebnis eines Moduls (threadsicher, ohne GUI-Zugriff erzeugt)
+struct ModuleScan {
+    QString path;
+    bool ok = false;
+    QStringList functions;          // alle Definitionen (function f, local function f, M.f = function, return {f = ...})
+    QStringList globals;            // davon global sichtbar: "function f" ohne local
+    QList<ModuleRequire> imports;   // require()-Aufrufe in Quelltextreihenfolge
+    QDateTime lastModified;         // Stand der Datei vor dem Lesen (nur scanFile)
+};
+
+/**
+ * Transitiver require()-Graph des Projekts:
+ *  - Wurzeln sind die require()-Aufrufe des aktuellen Dokuments
+ *  - Module einer Ebene werden parallel (QtConcurrent) gelesen und gescannt, die
+ *    Auflösung der Namen bleibt über den ModuleResolver im GUI-Thread
+ *  - Zyklen werden erkannt und gemeldet, blockieren aber nichts
+ *  - ändert sich eine Moduldatei, wird nur sie neu gescannt; neue Abhängigkeiten
+ *    werden nachgeladen, der Rest des Graphen bleibt. Kommt die Änderung während des
+ *    Scans, wird danach erneut gescannt
+ *  - nicht lesbare Module werden nicht gecacht; neuer Versuch nach Datei- oder
+ *    Verzeichnisänderungen
+ *  - whyLoaded() liefert die require-Kette von der Wurzel aus (ohne I/O)
+ */
+class ModuleGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ModuleGraph(ModuleResolver* resolver, QObject* parent = nullptr);
+
+    // Neue Wurzeln; lädt fehlende Module im Hintergrund nach
+    void setRoots(const QList<ModuleRequire>& roots);
+    [[nodiscard]] QList<ModuleRequire> roots() const { return m_roots; }
+
+    [[nodiscard]] bool isLoading() const { return !m_inFlight.isEmpty(); }
+
+    // Absoluter Pfad zu einem require-Namen (leer = nicht auflösbar)
+    [[nodiscard]] QString resolve(const QString& moduleName) const;
+
+    // Von den Wurzeln aus erreichbare, geladene Module (absolute Pfade)
+    [[nodiscard]] QStringList reachableModules() const;
+    [[nodiscard]] QStringList functions(const QString& path) const;
+    [[nodiscard]] QStringList reachableGlobals() const;
+
+    // require-Namen von der Wurzel bis zum Modul, z.B. {"game", "net.http"}; leer = nicht erreichbar
+    [[nodiscard]] QStringList whyLoaded(const QString& path) const;
+
+    // Zyklen im erreichbaren Teil (jeweils Pfade in require-Reihenfolge)
+    [[nodiscard]] QList<QStringList> cycles() const { return m_cycles; }
+
+    // Für Tests/Diagnose: Anzahl gescannter Dateien seit dem Start
+    [[nodiscard]] int scanCount() const { return m_scanCount; }
+
+    // Scannt Lua-Quelltext (UTF-8) auf Funktionsdefinitionen und require()-Aufrufe
+    static ModuleScan scanSource(QByteArrayView source);
+    static ModuleScan scanFile(const QString& path);
+
+signals:
+    void graphChanged(); // nach jeder eingearbeiteten Ebene und nach Dateiänderungen
+
+private:
+    struct Edge {
+        QString from;   // leer = Wurzel (das Dokument)
+        QString name;   // require-Name
+    };
+
+    void update();
+    void scheduleLoads(const QStringList& paths);
+    void onBatchFinished(const QList<ModuleScan>& scans);
+    void onFileChanged(const QString& path);
+    void onModulesChanged();
+    void findCycles();
+
+    ModuleResolver* m_resolver;
+    QList<ModuleRequire> m_roots;
+
+    QHash<QString, ModuleScan> m_modules;   // Pfad → Scan (auch nicht mehr erreichbare, als Cache)
+    QHash<QString, Edge> m_reachedVia;      // erreichbarer Pfad → erste Kante (BFS, kürzeste Kette)
+    QStringList m_reachOrder;               // erreichbare Pfade in BFS-Reihenfolge
+    QSet<QString> m_inFlight;
+    QSet<QString> m_changedInFlight;        // während des Scans geändert → Ergebnis prüfen
+    QSet<QString> m_failed;                 // nicht lesbar; kein Cache-Eintrag, kein Endlos-Retry
+    QList<QStringList> m_cycles;
+
+    QFileSystemWatcher m_fileWatcher;
+    int m_scanCount = 0;
+};
@@ -0,0 +1,138 @@
+#include "ModuleResolver.h"
+#include "Log.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+ModuleResolver::ModuleResolver(QObject* parent)
+    : QObject(parent)
+    , m_templates(defaultTemplates())
+    , m_baseDirectory(QDir::currentPath())
+{
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ModuleResolver::onDirectoryChanged);
+}
+
+QStringList ModuleResolver::defaultTemplates()
+{
+    return {
+        u"./?.lua"_qs, u"./?"_qs, u"./?/init.lua"_qs,
+        u"./modules/?.lua"_qs, u"./modules/?"_qs,
+        u"./lib/?.lua"_qs, u"./lib/?"_qs,
+        u"./scripts/?.lua"_qs, u"./scripts/?"_qs,
+    };
+}
+
+void ModuleResolver::setPackagePath(const QString& packagePath)
+{
+    QStringList templates;
+    if (packagePath.isEmpty()) {
+        templates = defaultTemplates();
+    } else {
+        // Wie in Lua: das erste ";;" (auch am Anfang oder in der Mitte) wird zu ";<Standardvorlagen>;"
+        QString expanded = packagePath;
+        if (const qsizetype at = expanded.indexOf(u";;"_qs); at >= 0)
+            expanded.replace(at, 2, u';' + defaultTemplates().join(u';') + u';');
+        for (const QString& part : expanded.split(u';', Qt::SkipEmptyParts)) {
+            const QString trimmed = part.trimmed();
+            if (!trimmed.isEmpty()) templates.append(trimmed);
+        }
+    }
+
+    if (templates == m_templates) return;
+    m_templates = templates;
+    m_resolved.clear();
+}
+
+void ModuleResolver::setBaseDirectory(const QString& directory)
+{
+    const QString absolute = QDir(directory).absolutePath();
+    if (absolute == m_baseDirectory) return;
+    m_baseDirectory = absolute;
+    m_resolved.clear();
+}
+
+QString ModuleResolver::resolve(const QString& moduleName)
+{
+    if (moduleName.isEmpty()) return {};
+
+    const auto cached = m_resolved.constFind(moduleName);
+    if (cached != m_resolved.constEnd())
+        return cached.value();
+
+    // "a.b.c" → "a/b/c"; ein ".lua" im Namen (require("utils.lua")) bleibt, wie bisher, erhalten
+    QString relative = moduleName;
+    if (!relative.endsWith(u".lua"_qs))
+        relative.replace(u'.', u'/');
+
+    const QDir base(m_baseDirectory);
+    QString found;
+    for (const QString& pattern : std::as_const(m_templates)) {
+        QString candidate = pattern;
+        candidate.replace(u'?', relative);
+        candidate = QDir::cleanPath(base.absoluteFilePath(candidate));
+
+        const qsizetype slash = candidate.lastIndexOf(u'/');
+        const QString directory = slash > 0 ? candidate.left(slash) : u"/"_qs;
+        if (listing(directory).contains(candidate.mid(slash + 1))) {
+            found = candidate;
+            break;
+        }
+    }
+
+    LOG_DEBUG(lcImports) << "Resolved" << moduleName << "to" << (found.isEmpty() ? u"<not found>"_qs : found);
+    m_resolved.insert(moduleName, found);
+    return found;
+}
+
+void ModuleResolver::invalidate()
+{
+    m_resolved.clear();
+    m_listings.clear();
+}
+
+const QSet<QString>& ModuleResolver::listing(const QString& directory)
+{
+    auto it = m_listings.find(directory);
+    if (it != m_listings.end())
+        return it.value();
+
+    ++m_directoryListings;
+    QSet<QString> names;
+    const QDir dir(directory);
+    if (dir.exists()) {
+        const QStringList entries = dir.entryList(QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot);
+        names = QSet<QString>(entries.cbegin(), entries.cend());
+    }
+    watch(directory);
+    return m_listings.insert(directory, std::move(names)).value();
+}
+
+void ModuleResolver::watch(const QString& directory)
+{
+    // Nicht existierende Verzeichnisse über das nächste existierende Elternverzeichnis
+    // beobachten, damit z.B. ein neu angelegtes "./lib" bemerkt wird
+    QString path = directory;
+    while (!QFileInfo(path).isDir()) {
+        const QString parent = QFileInfo(path).path();
+        if (parent == path) return;
+        path = parent;
+    }
+    if (!m_watcher.directories().contains(path))
+        m_watcher.addPath(path);
+}
+
+void ModuleResolver::onDirectoryChanged(const QString& directory)
+{
+    LOG_DEBUG(lcImports) << "Module directory changed:" << directory;
+
+    // Positive wie negative Einträge können betroffen sein; Listings der anderen
+    // Verzeichnisse bleiben gültig, nur Verzeichnisse unterhalb von directory werden neu gelesen
+    m_resolved.clear();
+    for (auto it = m_listings.begin(); it != m_listings.end();) {
+        if (it.key() == directory || it.key().startsWith(directory + u'/'))
+            it = m_listings.erase(it);
+        else
+            ++it;
+    }
+    emit modulesChanged();
+}
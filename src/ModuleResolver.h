@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Löst require()-Namen zu Dateien auf, wie Luas package.path:
+ *  - Vorlagen mit '?' ("./?.lua;./modules/?.lua;./?/init.lua"), ";;" = Standardvorlagen
+ *  - gepunktete Namen: "a.b.c" → "a/b/c.lua"
+ *  - pro Verzeichnis wird einmal gelistet statt pro Kandidat stat() aufzurufen;
+ *    Treffer und Fehlschläge landen in einem Hash (negatives Caching)
+ *  - QFileSystemWatcher auf den gelisteten Verzeichnissen (bzw. dem nächsten existierenden
+ *    Elternverzeichnis) verwirft die Caches und meldet modulesChanged()
+ */
+class ModuleResolver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ModuleResolver(QObject* parent = nullptr);
+
+    // Entspricht den früheren Suchpfaden ".", "./modules", "./lib", "./scripts" mit ".lua" und ohne Endung
+    static QStringList defaultTemplates();
+
+    // package.path-Syntax, z.B. der Inhalt von LUA_PATH; leer = Standardvorlagen
+    void setPackagePath(const QString& packagePath);
+    [[nodiscard]] QStringList templates() const { return m_templates; }
+
+    // Relative Vorlagen beziehen sich auf dieses Verzeichnis (Standard: Arbeitsverzeichnis)
+    void setBaseDirectory(const QString& directory);
+    [[nodiscard]] QString baseDirectory() const { return m_baseDirectory; }
+
+    // Absoluter Pfad der Moduldatei oder leer, wenn keine Vorlage passt
+    QString resolve(const QString& moduleName);
+
+    void invalidate();
+
+    // Für Tests/Diagnose: wie oft tatsächlich ein Verzeichnis gelesen wurde
+    [[nodiscard]] int directoryListings() const { return m_directoryListings; }
+
+signals:
+    void modulesChanged();
+
+private:
+    const QSet<QString>& listing(const QString& directory);
+    void watch(const QString& directory);
+    void onDirectoryChanged(const QString& directory);
+
+    QStringList m_templates;
+    QString m_baseDirectory;
+
+    QHash<QString, QString> m_resolved;          // Modulname → absoluter Pfad, leer = nicht gefunden
+    QHash<QString, QSet<QString>> m_listings;    // Verzeichnis → enthaltene Dateinamen
+    QFileSystemWatcher m_watcher;
+    int m_directoryListings = 0;
+};
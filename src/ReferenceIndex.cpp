@@ -0,0 +1,343 @@
+#include "ReferenceIndex.h"
+#include "LuaParser.h"
+#include "Log.h"
+#include "Trace.h"
+#include "Varint.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    bool lessByPosition(const ReferenceIndex::Location& a, const ReferenceIndex::Location& b) {
+        if (a.file != b.file) return a.file < b.file;
+        if (a.line != b.line) return a.line < b.line;
+        return a.column < b.column;
+    }
+
+    /*
+     * Ein Eintrag relativ zum vorigen (Listenanfang: alles absolut):
+     *   Datei-Delta; bei neuer Datei Zeile und Spalte absolut, sonst Zeilen-Delta und
+     *   Spalte absolut (neue Zeile) bzw. Spalten-Delta (gleiche Zeile).
+     *   Die Spalte trägt im untersten Bit das Definitions-Flag.
+     */
+    void encodeEntry(QByteArray& out, const ReferenceIndex::Location& previous, bool first,
+                     const ReferenceIndex::Location& location) {
+        const quint32 flag = location.isDefinition ? 1u : 0u;
+        const quint32 fileDelta = first ? location.file : location.file - previous.file;
+        Varint::put(out, fileDelta);
+        if (first || fileDelta != 0) {
+            Varint::put(out, static_cast<quint32>(location.line));
+            Varint::put(out, static_cast<quint32>(location.column) << 1 | flag);
+            return;
+        }
+        const auto lineDelta = static_cast<quint32>(location.line - previous.line);
+        Varint::put(out, lineDelta);
+        const auto column = lineDelta != 0 ? static_cast<quint32>(location.column)
+                                           : static_cast<quint32>(location.column - previous.column);
+        Varint::put(out, column << 1 | flag);
+    }
+
+    ReferenceIndex::Location decodeEntry(const QByteArray& in, qsizetype& offset,
+                                         const ReferenceIndex::Location& previous, bool first) {
+        ReferenceIndex::Location location;
+        const quint32 fileDelta = Varint::get(in, offset);
+        location.file = first ? fileDelta : previous.file + fileDelta;
+        if (first || fileDelta != 0) {
+            location.line = static_cast<int>(Varint::get(in, offset));
+            const quint32 column = Varint::get(in, offset);
+            location.column = static_cast<int>(column >> 1);
+            location.isDefinition = column & 1;
+            return location;
+        }
+        const quint32 lineDelta = Varint::get(in, offset);
+        location.line = previous.line + static_cast<int>(lineDelta);
+        const quint32 column = Varint::get(in, offset);
+        location.column = static_cast<int>(column >> 1) + (lineDelta != 0 ? 0 : previous.column);
+        location.isDefinition = column & 1;
+        return location;
+    }
+}
+
+// ----- Cursor -----
+
+QList<ReferenceIndex::Location> ReferenceIndex::Cursor::next(int limit)
+{
+    QList<Location> page;
+    const quint32 n = std::min(m_remaining, static_cast<quint32>(std::max(limit, 0)));
+    page.reserve(n);
+    for (quint32 i = 0; i < n; ++i) {
+        m_last = decodeEntry(m_bytes, m_offset, m_last, m_remaining == m_total);
+        --m_remaining;
+        page.append(m_last);
+    }
+    return page;
+}
+
+// ----- Aufbau -----
+
+void ReferenceIndex::clear()
+{
+    m_root.clear();
+    m_files.clear();
+    m_fileIds.clear();
+    m_removedFiles.clear();
+    m_postings.clear();
+    m_definitions.clear();
+    m_fileTerms.clear();
+    m_buildNs = 0;
+    ++m_definitionsRevision;
+}
+
+QString ReferenceIndex::findProjectRoot(const QString& path)
+{
+    static const QStringList markers{u".git"_qs, u".luarc.json"_qs, u".luarc"_qs};
+    const QFileInfo info(path);
+    QDir dir(info.isDir() ? info.absoluteFilePath() : info.absolutePath());
+    const QString home = QDir(QDir::homePath()).absolutePath();
+    do {
+        if (dir.absolutePath() == home) break;
+        for (const QString& marker : markers) {
+            if (QFileInfo::exists(dir.filePath(marker))) return dir.absolutePath();
+        }
+    } while (dir.cdUp());
+    return {};
+}
+
+bool ReferenceIndex::build(const QString& root, int threads)
+{
+    TRACE_SCOPE("ReferenceIndex::build");
+    clear();
+
+    const QDir rootDir(root);
+    if (root.isEmpty() || !rootDir.exists()) return false;
+    m_root = rootDir.absolutePath();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QDirIterator it(m_root, {u"*.lua"_qs}, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        if (m_files.size() == MAX_FILES) {
+            LOG_INFO(lcParser) << "Not indexing" << m_root << "- more than" << MAX_FILES << "Lua files";
+            clear();
+            return false;
+        }
+        m_files.append(rootDir.relativeFilePath(it.next()));
+    }
+    std::sort(m_files.begin(), m_files.end());
+    for (qsizetype i = 0; i < m_files.size(); ++i)
+        m_fileIds.insert(m_files.at(i), static_cast<quint32>(i));
+
+    QList<quint32> ids(m_files.size());
+    std::iota(ids.begin(), ids.end(), 0u);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+
+    const QString absoluteRoot = m_root;
+    const QStringList files = m_files;
+    const QList<FileEntries> perFile = QtConcurrent::blockingMapped(&pool, ids, [absoluteRoot, files](quint32 id) {
+        QFile file(QDir(absoluteRoot).filePath(files.at(id)));
+        if (!file.open(QIODevice::ReadOnly)) {
+            LOG_INFO(lcParser) << "Cannot read" << file.fileName() << file.errorString();
+            return FileEntries{};
+        }
+        LuaParser parser;
+        return collect(parser.parseOne(QString::fromUtf8(file.readAll()), file.fileName()), id);
+    });
+
+    // Aufsteigende Datei-IDs: jede Liste wächst nur am Ende, Deltas bleiben positiv
+    for (qsizetype id = 0; id < perFile.size(); ++id) {
+        const FileEntries& entries = perFile.at(id);
+        for (auto entry = entries.constBegin(); entry != entries.constEnd(); ++entry) {
+            PostingList& list = m_postings[entry.key()];
+            for (const Location& location : entry.value()) {
+                append(list, location);
+                if (location.isDefinition && !m_definitions.contains(entry.key()))
+                    m_definitions.insert(entry.key(), location);
+            }
+        }
+        if (!entries.isEmpty())
+            m_fileTerms.insert(static_cast<quint32>(id), entries.keys());
+    }
+    m_buildNs = timer.nsecsElapsed();
+
+    const Stats s = stats();
+    LOG_INFO(lcParser) << "Reference index:" << s.files << "files," << s.terms << "names," << s.postings
+                       << "references in" << s.encodedBytes << "bytes," << s.buildNs / 1000000 << "ms";
+    return true;
+}
+
+ReferenceIndex::FileEntries ReferenceIndex::collect(const SymbolTable& table, quint32 file)
+{
+    FileEntries entries;
+    const QHash<QString, QVector<Reference>>& usages = table.usages();
+    for (auto it = usages.constBegin(); it != usages.constEnd(); ++it) {
+        QList<Location> locations;
+        locations.reserve(it.value().size());
+        for (const Reference& reference : it.value())
+            locations.append({file, reference.pos.line, reference.pos.column, reference.isDefinition});
+        std::sort(locations.begin(), locations.end(), lessByPosition);
+
+        // Definitionen stehen zusätzlich als einfache Verwendung in der Tabelle: eine Position, ein Eintrag
+        QList<Location> unique;
+        unique.reserve(locations.size());
+        for (const Location& location : std::as_const(locations)) {
+            if (!unique.isEmpty() && unique.last().line == location.line && unique.last().column == location.column)
+                unique.last().isDefinition = unique.last().isDefinition || location.isDefinition;
+            else
+                unique.append(location);
+        }
+        entries.insert(it.key(), unique);
+    }
+    return entries;
+}
+
+void ReferenceIndex::append(PostingList& list, const Location& location)
+{
+    encodeEntry(list.bytes, list.last, list.count == 0, location);
+    list.last = location;
+    ++list.count;
+}
+
+QList<ReferenceIndex::Location> ReferenceIndex::decode(const PostingList& list)
+{
+    Cursor cursor;
+    cursor.m_bytes = list.bytes;
+    cursor.m_total = cursor.m_remaining = list.count;
+    return cursor.next(static_cast<int>(list.count));
+}
+
+// ----- Inkrementelle Updates -----
+
+quint32 ReferenceIndex::fileId(const QString& path)
+{
+    const QString relative = m_root.isEmpty() ? QDir::cleanPath(path) : QDir(m_root).relativeFilePath(path);
+    const auto it = m_fileIds.constFind(relative);
+    if (it != m_fileIds.constEnd()) {
+        m_removedFiles.remove(it.value());
+        return it.value();
+    }
+
+    // Neue Dateien hinten anhängen: bestehende IDs (und damit alle Deltas) bleiben gültig
+    const auto id = static_cast<quint32>(m_files.size());
+    m_files.append(relative);
+    m_fileIds.insert(relative, id);
+    return id;
+}
+
+void ReferenceIndex::updateFile(const QString& path, const QString& code)
+{
+    LuaParser parser;
+    updateFile(path, parser.parseOne(code, path));
+}
+
+void ReferenceIndex::updateFile(const QString& path, const SymbolTable& table)
+{
+    TRACE_SCOPE("ReferenceIndex::updateFile");
+    const quint32 file = fileId(path);
+    replaceFile(file, collect(table, file));
+}
+
+void ReferenceIndex::removeFile(const QString& path)
+{
+    const QString relative = m_root.isEmpty() ? QDir::cleanPath(path) : QDir(m_root).relativeFilePath(path);
+    const auto it = m_fileIds.constFind(relative);
+    if (it == m_fileIds.constEnd() || m_removedFiles.contains(it.value())) return;
+    replaceFile(it.value(), {});
+    m_removedFiles.insert(it.value()); // Pfad und ID bleiben, updateFile() nimmt den Platz wieder
+}
+
+void ReferenceIndex::replaceFile(quint32 file, const FileEntries& entries)
+{
+    QSet<QString> terms(entries.keyBegin(), entries.keyEnd());
+    for (const QString& term : m_fileTerms.value(file))
+        terms.insert(term);
+
+    // Nur die betroffenen Listen dekodieren, die Datei austauschen und neu codieren
+    bool definitionsChanged = false;
+    for (const QString& term : std::as_const(terms)) {
+        const std::optional<Location> before = definition(term);
+        QList<Location> locations;
+        if (const auto it = m_postings.constFind(term); it != m_postings.constEnd())
+            locations = decode(it.value());
+        locations.removeIf([file](const Location& location) { return location.file == file; });
+        locations += entries.value(term);
+        m_definitions.remove(term);
+        if (locations.isEmpty()) {
+            m_postings.remove(term);
+        } else {
+            std::sort(locations.begin(), locations.end(), lessByPosition);
+
+            PostingList list;
+            for (const Location& location : std::as_const(locations)) {
+                append(list, location);
+                if (location.isDefinition && !m_definitions.contains(term))
+                    m_definitions.insert(term, location);
+            }
+            m_postings.insert(term, list);
+        }
+        definitionsChanged = definitionsChanged || definition(term) != before;
+    }
+    if (definitionsChanged) ++m_definitionsRevision;
+
+    if (entries.isEmpty())
+        m_fileTerms.remove(file);
+    else
+        m_fileTerms.insert(file, entries.keys());
+}
+
+// ----- Abfragen -----
+
+ReferenceIndex::Cursor ReferenceIndex::query(const QString& qualifiedName) const
+{
+    TRACE_SCOPE("ReferenceIndex::query");
+    Cursor cursor;
+    const auto it = m_postings.constFind(qualifiedName);
+    if (it == m_postings.constEnd()) return cursor;
+    cursor.m_bytes = it->bytes; // implizit geteilt, keine Kopie
+    cursor.m_total = cursor.m_remaining = it->count;
+    return cursor;
+}
+
+quint32 ReferenceIndex::count(const QString& qualifiedName) const
+{
+    const auto it = m_postings.constFind(qualifiedName);
+    return it == m_postings.constEnd() ? 0 : it->count;
+}
+
+std::optional<ReferenceIndex::Location> ReferenceIndex::definition(const QString& qualifiedName) const
+{
+    const auto it = m_definitions.constFind(qualifiedName);
+    if (it == m_definitions.constEnd()) return std::nullopt;
+    return it.value();
+}
+
+QString ReferenceIndex::filePath(quint32 file) const
+{
+    if (file >= static_cast<quint32>(m_files.size())) return {};
+    return m_root.isEmpty() ? m_files.at(file) : QDir::cleanPath(QDir(m_root).filePath(m_files.at(file)));
+}
+
+ReferenceIndex::Stats ReferenceIndex::stats() const
+{
+    Stats s;
+    s.files = static_cast<int>(m_files.size() - m_removedFiles.size());
+    s.terms = static_cast<int>(m_postings.size());
+    for (const PostingList& list : m_postings) {
+        s.postings += list.count;
+        s.encodedBytes += list.bytes.size();
+    }
+    s.buildNs = m_buildNs;
+    return s;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+class SymbolTable;
+
+/**
+ * Invertierter Index über einen Workspace: qualifizierter Name → Fundstellen (Datei, Zeile, Spalte).
+ *  - Posting-Listen sind nach (Datei, Zeile, Spalte) sortiert und delta-codiert als Varints
+ *    abgelegt (typisch 3-4 Byte pro Fundstelle statt einer Reference mit Pfad-String)
+ *  - build() parst alle Dateien parallel; Abfragen lesen danach nie wieder Dateiinhalte
+ *  - Cursor dekodiert seitenweise und hält die Bytes implizit geteilt: er bleibt gültig,
+ *    auch wenn der Index danach aktualisiert oder ersetzt wird
+ *  - updateFile()/removeFile() schreiben nur die Listen der betroffenen Namen neu; eine entfernte
+ *    Datei behält ihre ID und bekommt sie beim erneuten Aufnehmen zurück
+ *  - definition() liefert die erste Definition eines Namens (Dateireihenfolge) per Hash-Lookup
+ *  - build() bricht bei mehr als MAX_FILES Dateien ab, statt z.B. ein Home-Verzeichnis zu indizieren
+ */
+class ReferenceIndex
+{
+public:
+    struct Location {
+        quint32 file = 0;   // Index in files()
+        int line = 0;       // 1-basiert
+        int column = 0;     // 1-basiert (UTF-16)
+        bool isDefinition = false;
+
+        bool operator==(const Location&) const = default;
+    };
+
+    struct Stats {
+        int files = 0;
+        int terms = 0;
+        qint64 postings = 0;
+        qint64 encodedBytes = 0;
+        qint64 buildNs = 0;
+    };
+
+    class Cursor {
+    public:
+        Cursor() = default;
+
+        QList<Location> next(int limit);
+        [[nodiscard]] bool atEnd() const { return m_remaining == 0; }
+        [[nodiscard]] quint32 total() const { return m_total; }
+        [[nodiscard]] quint32 remaining() const { return m_remaining; }
+
+    private:
+        friend class ReferenceIndex;
+        QByteArray m_bytes;
+        qsizetype m_offset = 0;
+        Location m_last;
+        quint32 m_total = 0;
+        quint32 m_remaining = 0;
+    };
+
+    static constexpr int MAX_FILES = 20000;
+
+    // Nächstes Verzeichnis ab path aufwärts mit .git, .luarc.json oder .luarc (ohne das
+    // Home-Verzeichnis selbst); leer, wenn keins gefunden wird
+    [[nodiscard]] static QString findProjectRoot(const QString& path);
+
+    // Alle *.lua unterhalb von root; threads = 0 → QThread::idealThreadCount()
+    // false, wenn root fehlt oder mehr als MAX_FILES Dateien enthält
+    bool build(const QString& root, int threads = 0);
+    void clear();
+
+    // Einzelne Datei neu aufnehmen (z.B. nach dem Speichern); Pfad absolut
+    void updateFile(const QString& path, const QString& code);
+    void updateFile(const QString& path, const SymbolTable& table);
+    void removeFile(const QString& path);
+
+    [[nodiscard]] Cursor query(const QString& qualifiedName) const;
+    [[nodiscard]] quint32 count(const QString& qualifiedName) const;
+    [[nodiscard]] bool contains(const QString& qualifiedName) const { return m_postings.contains(qualifiedName); }
+    [[nodiscard]] std::optional<Location> definition(const QString& qualifiedName) const;
+    [[nodiscard]] const QHash<QString, Location>& definitions() const { return m_definitions; }
+    [[nodiscard]] quint64 definitionsRevision() const { return m_definitionsRevision; } // zählt bei jeder Änderung
+
+    [[nodiscard]] QString root() const { return m_root; }
+    [[nodiscard]] QString filePath(quint32 file) const; // absolut
+    [[nodiscard]] const QStringList& files() const { return m_files; } // je ID, auch entfernte
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct PostingList {
+        QByteArray bytes;
+        quint32 count = 0;
+        Location last;      // letzter codierter Eintrag, Basis für das nächste Delta
+    };
+
+    // Fundstellen einer Datei je Name, sortiert und ohne doppelte Positionen
+    using FileEntries = QHash<QString, QList<Location>>;
+    static FileEntries collect(const SymbolTable& table, quint32 file);
+
+    static void append(PostingList& list, const Location& location);
+    static QList<Location> decode(const PostingList& list);
+
+    quint32 fileId(const QString& path);
+    void replaceFile(quint32 file, const FileEntries& entries);
+
+    QString m_root;
+    QStringList m_files;                       // relativ zu m_root; Index = Datei-ID
+    QHash<QString, quint32> m_fileIds;
+    QSet<quint32> m_removedFiles;              // IDs entfernter Dateien (Platz bleibt reserviert)
+    QHash<QString, PostingList> m_postings;    // qualifizierter Name → Posting-Liste
+    QHash<QString, Location> m_definitions;    // qualifizierter Name → erste Definition
+    QHash<quint32, QStringList> m_fileTerms;   // Datei → Namen mit Fundstellen darin
+    quint64 m_definitionsRevision = 0;
+    qint64 m_buildNs = 0;
+};
@@ -0,0 +1,80 @@
+#include "ReferenceListModel.h"
+#include "Trace.h"
+
+#include <QFont>
+
+ReferenceListModel::ReferenceListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void ReferenceListModel::setQuery(std::shared_ptr<const ReferenceIndex> index, const QString& qualifiedName)
+{
+    TRACE_SCOPE("ReferenceListModel::setQuery");
+    beginResetModel();
+    m_index = std::move(index);
+    m_name = qualifiedName;
+    m_cursor = m_index ? m_index->query(qualifiedName) : ReferenceIndex::Cursor{};
+    m_rows = m_cursor.next(PAGE_SIZE);
+    endResetModel();
+}
+
+void ReferenceListModel::clear()
+{
+    setQuery(nullptr, {});
+}
+
+int ReferenceListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+QVariant ReferenceListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) return {};
+    const ReferenceIndex::Location& location = m_rows.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole: {
+        const QString file = m_index->files().value(static_cast<qsizetype>(location.file));
+        const QString text = u"%1:%2:%3"_qs.arg(file).arg(location.line).arg(location.column);
+        return location.isDefinition ? text + tr("  (definition)") : text;
+    }
+    case Qt::ToolTipRole:
+    case FilePathRole:
+        return m_index->filePath(location.file);
+    case Qt::FontRole:
+        if (location.isDefinition) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return {};
+    case LineRole:
+        return location.line;
+    case ColumnRole:
+        return location.column;
+    case IsDefinitionRole:
+        return location.isDefinition;
+    default:
+        return {};
+    }
+}
+
+bool ReferenceListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && !m_cursor.atEnd();
+}
+
+void ReferenceListModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || m_cursor.atEnd()) return;
+
+    // Nur die nächste Seite dekodieren; der Cursor merkt sich die Byte-Position
+    const QList<ReferenceIndex::Location> page = m_cursor.next(PAGE_SIZE);
+    if (page.isEmpty()) return;
+    const int first = static_cast<int>(m_rows.size());
+    beginInsertRows({}, first, first + static_cast<int>(page.size()) - 1);
+    m_rows += page;
+    endInsertRows();
+}
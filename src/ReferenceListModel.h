@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QString>
+#include <memory>
+
+#include "ReferenceIndex.h"
+
+/**
+ * Listenmodell für das Referenz-Panel:
+ *  - setQuery() zeigt sofort die erste Seite, weitere Seiten holt die View über
+ *    canFetchMore()/fetchMore() beim Scrollen
+ *  - hält einen Schnappschuss des Index; ein neu aufgebauter Index betrifft erst die nächste Abfrage
+ */
+class ReferenceListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        FilePathRole = Qt::UserRole + 1,
+        LineRole,
+        ColumnRole,
+        IsDefinitionRole
+    };
+
+    static constexpr int PAGE_SIZE = 200;
+
+    explicit ReferenceListModel(QObject* parent = nullptr);
+
+    void setQuery(std::shared_ptr<const ReferenceIndex> index, const QString& qualifiedName);
+    void clear();
+
+    [[nodiscard]] QString qualifiedName() const { return m_name; }
+    [[nodiscard]] quint32 totalCount() const { return m_cursor.total(); }
+
+    int rowCount(const QModelIndex& parent = {}) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+private:
+    std::shared_ptr<const ReferenceIndex> m_index;
+    QString m_name;
+    ReferenceIndex::Cursor m_cursor;
+    QList<ReferenceIndex::Location> m_rows;
+};
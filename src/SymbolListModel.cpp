@@ -0,0 +1,157 @@
+#include "SymbolListModel.h"
+#include "Trace.h"
+
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+
+#include <algorithm>
+
+SymbolListModel::SymbolListModel(const QString& header, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_header(header)
+{
+}
+
+bool SymbolListModel::lessByName(const QString& a, const QString& b)
+{
+    const int c = QString::compare(a, b, Qt::CaseInsensitive);
+    return c != 0 ? c < 0 : a < b;
+}
+
+qsizetype SymbolListModel::lowerBound(const QString& name) const
+{
+    const auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), name,
+                                     [](const Entry& entry, const QString& n) { return lessByName(entry.name, n); });
+    return it - m_entries.cbegin();
+}
+
+void SymbolListModel::emitChanged(qsizetype first, qsizetype last)
+{
+    emit dataChanged(index(static_cast<int>(first) + HEADER_ROWS), index(static_cast<int>(last) + HEADER_ROWS));
+}
+
+void SymbolListModel::setEntries(QList<Entry> entries)
+{
+    TRACE_SCOPE("SymbolListModel::setEntries");
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return lessByName(a.name, b.name); });
+
+    // Beide Listen sortiert: im Gleichschritt durchlaufen, Unterschiede als zusammenhängende Blöcke melden
+    qsizetype i = 0;
+    qsizetype j = 0;
+    qsizetype changedFirst = -1;
+    auto flushChanged = [&] {
+        if (changedFirst < 0) return;
+        emitChanged(changedFirst, i - 1);
+        changedFirst = -1;
+    };
+
+    while (i < m_entries.size() || j < entries.size()) {
+        if (i < m_entries.size() && j < entries.size() && m_entries.at(i).name == entries.at(j).name) {
+            if (m_entries.at(i) != entries.at(j)) {
+                m_entries[i] = entries.at(j);
+                if (changedFirst < 0) changedFirst = i;
+            } else {
+                flushChanged();
+            }
+            ++i;
+            ++j;
+            continue;
+        }
+        flushChanged();
+
+        if (j == entries.size() || (i < m_entries.size() && lessByName(m_entries.at(i).name, entries.at(j).name))) {
+            // Alte Einträge ohne Gegenstück
+            qsizetype end = i + 1;
+            while (end < m_entries.size() && (j == entries.size() || lessByName(m_entries.at(end).name, entries.at(j).name)))
+                ++end;
+            beginRemoveRows({}, static_cast<int>(i) + HEADER_ROWS, static_cast<int>(end - 1) + HEADER_ROWS);
+            m_entries.remove(i, end - i);
+            endRemoveRows();
+        } else {
+            // Neue Einträge vor dem nächsten alten
+            qsizetype end = j + 1;
+            while (end < entries.size() && (i == m_entries.size() || lessByName(entries.at(end).name, m_entries.at(i).name)))
+                ++end;
+            beginInsertRows({}, static_cast<int>(i) + HEADER_ROWS, static_cast<int>(i + end - j - 1) + HEADER_ROWS);
+            if (i == m_entries.size()) {
+                m_entries.append(entries.mid(j, end - j));
+            } else {
+                for (qsizetype k = j; k < end; ++k)
+                    m_entries.insert(i + (k - j), entries.at(k));
+            }
+            endInsertRows();
+            i += end - j;
+            j = end;
+        }
+    }
+    flushChanged();
+}
+
+void SymbolListModel::applyDelta(const QStringList& removed, const QList<Entry>& upserted)
+{
+    TRACE_SCOPE("SymbolListModel::applyDelta");
+    for (const QString& name : removed) {
+        const qsizetype at = lowerBound(name);
+        if (at == m_entries.size() || m_entries.at(at).name != name) continue;
+        beginRemoveRows({}, static_cast<int>(at) + HEADER_ROWS, static_cast<int>(at) + HEADER_ROWS);
+        m_entries.remove(at);
+        endRemoveRows();
+    }
+    for (const Entry& entry : upserted) {
+        const qsizetype at = lowerBound(entry.name);
+        if (at < m_entries.size() && m_entries.at(at).name == entry.name) {
+            if (m_entries.at(at) == entry) continue;
+            m_entries[at] = entry;
+            emitChanged(at, at);
+            continue;
+        }
+        beginInsertRows({}, static_cast<int>(at) + HEADER_ROWS, static_cast<int>(at) + HEADER_ROWS);
+        m_entries.insert(at, entry);
+        endInsertRows();
+    }
+}
+
+int SymbolListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_entries.size()) + HEADER_ROWS;
+}
+
+QVariant SymbolListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) return {};
+
+    if (index.row() < HEADER_ROWS) {
+        switch (role) {
+        case Qt::DisplayRole:
+            return m_header;
+        case Qt::FontRole: {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        case Qt::ForegroundRole:
+            return QBrush(QColor(50, 50, 50));
+        default:
+            return {};
+        }
+    }
+
+    const Entry& entry = m_entries.at(index.row() - HEADER_ROWS);
+    switch (role) {
+    case Qt::DisplayRole:
+        return entry.signature.isEmpty() ? entry.name : QString(entry.name + u' ' + entry.signature);
+    case NameRole:
+        return entry.name;
+    case LineRole:
+        return entry.line;
+    default:
+        return {};
+    }
+}
+
+Qt::ItemFlags SymbolListModel::flags(const QModelIndex& index) const
+{
+    if (index.isValid() && index.row() < HEADER_ROWS) return Qt::NoItemFlags;
+    return QAbstractListModel::flags(index);
+}
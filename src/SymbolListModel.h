@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Listenmodell für die Symbol-Popups (Globals/Functions/Tables):
+ *  - Zeile 0 ist die Überschrift (nicht auswählbar), danach die Einträge nach Namen sortiert
+ *  - setEntries() vergleicht mit dem bisherigen Stand und meldet nur eingefügte, entfernte und
+ *    geänderte Zeilen; die View zeichnet nur diese neu, Auswahl und Scrollposition bleiben
+ *  - applyDelta() übernimmt Änderungen direkt (Binärsuche je Name), ohne den Rest anzufassen
+ */
+class SymbolListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        NameRole = Qt::UserRole + 1,
+        LineRole
+    };
+
+    struct Entry {
+        QString name;
+        QString signature;  // "(a, b)" bei Funktionen, sonst leer
+        int line = 0;       // 1-basiert
+
+        bool operator==(const Entry&) const = default;
+    };
+
+    explicit SymbolListModel(const QString& header, QObject* parent = nullptr);
+
+    // Vollständiger neuer Stand, beliebige Reihenfolge
+    void setEntries(QList<Entry> entries);
+    // Nur Änderungen: removed sind Namen, upserted neue oder geänderte Einträge
+    void applyDelta(const QStringList& removed, const QList<Entry>& upserted);
+
+    [[nodiscard]] int count() const { return static_cast<int>(m_entries.size()); }
+    [[nodiscard]] const QList<Entry>& entries() const { return m_entries; }
+
+    // Sortierung der Einträge: ohne Groß-/Kleinschreibung, bei Gleichheit mit
+    [[nodiscard]] static bool lessByName(const QString& a, const QString& b);
+
+    int rowCount(const QModelIndex& parent = {}) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+private:
+    static constexpr int HEADER_ROWS = 1;
+
+    [[nodiscard]] qsizetype lowerBound(const QString& name) const;
+    void emitChanged(qsizetype first, qsizetype last);
+
+    QString m_header;
+    QList<Entry> m_entries;
+};
@@ -0,0 +1,182 @@
+#include "SymbolPalette.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QKeyEvent>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+SymbolPalette::SymbolPalette(QWidget* parent)
+    : QFrame(parent, Qt::Popup)
+    , m_buildWatcher(new QFutureWatcher<std::shared_ptr<const SymbolSearch>>(this))
+    , m_searchWatcher(new QFutureWatcher<SymbolSearch::Result>(this))
+{
+    setFrameStyle(QFrame::StyledPanel | QFrame::Raised);
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    m_edit = new QLineEdit(this);
+    m_edit->setPlaceholderText(tr("Go to symbol in workspace"));
+    m_edit->installEventFilter(this);
+    layout->addWidget(m_edit);
+    m_list = new QListWidget(this);
+    m_list->setUniformItemSizes(true);
+    layout->addWidget(m_list);
+    m_status = new QLabel(this);
+    layout->addWidget(m_status);
+
+    connect(m_edit, &QLineEdit::textEdited, this, &SymbolPalette::requestSearch);
+    connect(m_list, &QListWidget::itemActivated, this, &SymbolPalette::activate);
+    connect(m_buildWatcher, &QFutureWatcherBase::finished, this, &SymbolPalette::onSearchBuilt);
+    connect(m_searchWatcher, &QFutureWatcherBase::finished, this, &SymbolPalette::onSearchFinished);
+}
+
+void SymbolPalette::setIndex(std::shared_ptr<const ReferenceIndex> index)
+{
+    // Neu aufgebaut wird erst beim nächsten Öffnen
+    m_index = std::move(index);
+    if (isVisible()) ensureSearch();
+}
+
+void SymbolPalette::popup()
+{
+    if (QWidget* window = parentWidget() ? parentWidget()->window() : nullptr) {
+        const int width = std::min(640, window->width() - 40);
+        resize(width, std::min(420, window->height() - 80));
+        move(window->mapToGlobal(QPoint((window->width() - width) / 2, 40)));
+    }
+    show();
+    m_edit->setFocus();
+    m_edit->selectAll();
+    ensureSearch();
+}
+
+void SymbolPalette::ensureSearch()
+{
+    if (!m_index) {
+        m_status->setText(tr("No project index - open a folder with .git or .luarc, or use File > Open Folder as Project"));
+        return;
+    }
+    if (searchIsCurrent() || m_buildWatcher->isRunning()) return;
+
+    // Der Index wird beim Speichern im GUI-Thread verändert; gebaut wird aus einer flachen Kopie
+    m_status->setText(tr("Indexing symbols..."));
+    auto snapshot = std::make_shared<const ReferenceIndex>(*m_index);
+    m_buildWatcher->setFuture(QtConcurrent::run([snapshot]() -> std::shared_ptr<const SymbolSearch> {
+        auto search = std::make_shared<SymbolSearch>();
+        search->build(*snapshot);
+        return search;
+    }));
+    m_searchSource = m_index;
+    m_searchRevision = m_index->definitionsRevision();
+}
+
+bool SymbolPalette::searchIsCurrent() const
+{
+    return m_index && m_searchSource.lock() == m_index && m_searchRevision == m_index->definitionsRevision();
+}
+
+void SymbolPalette::onSearchBuilt()
+{
+    m_search = m_buildWatcher->result();
+    m_lastQuery.clear();
+    m_lastMatches.clear();
+    // Inzwischen neuer oder geänderter Index → gleich noch einmal
+    if (!searchIsCurrent()) {
+        m_searchSource.reset();
+        if (isVisible()) ensureSearch();
+    }
+    m_status->setText(tr("%1 symbols").arg(m_search->size()));
+    requestSearch();
+}
+
+void SymbolPalette::requestSearch()
+{
+    if (!m_search) return;
+    if (m_searchWatcher->isRunning()) {
+        m_searchPending = true;
+        return;
+    }
+    runSearch(m_edit->text());
+}
+
+void SymbolPalette::runSearch(const QString& query)
+{
+    m_searchPending = false;
+    m_runningQuery = query;
+    m_runningSearch = m_search;
+    // Wer die längere Eingabe enthält, enthält auch die kürzere
+    const bool narrow = !m_lastQuery.isEmpty() && query.startsWith(m_lastQuery);
+    const QList<quint32> within = narrow ? m_lastMatches : QList<quint32>{};
+    m_searchWatcher->setFuture(QtConcurrent::run([search = m_search, query, within, narrow] {
+        return search->search(query, MAX_RESULTS, narrow ? &within : nullptr);
+    }));
+}
+
+void SymbolPalette::onSearchFinished()
+{
+    // Ergebnis eines inzwischen ersetzten Suchindex: Symbolnummern passen nicht mehr
+    if (m_runningSearch != m_search) {
+        runSearch(m_edit->text());
+        return;
+    }
+    const SymbolSearch::Result result = m_searchWatcher->result();
+    m_lastQuery = m_runningQuery.simplified().isEmpty() ? QString() : m_runningQuery;
+    m_lastMatches = result.matches;
+
+    m_list->clear();
+    const QDir root(m_index ? m_index->root() : QString());
+    for (const SymbolSearch::Hit& hit : result.hits) {
+        const QString path = m_search->filePath(hit.symbol);
+        const int line = m_search->line(hit.symbol);
+        auto* item = new QListWidgetItem(u"%1    %2:%3"_qs.arg(m_search->name(hit.symbol),
+                                                               root.relativeFilePath(path)).arg(line));
+        item->setData(Qt::UserRole, path);
+        item->setData(Qt::UserRole + 1, line);
+        item->setData(Qt::UserRole + 2, m_search->column(hit.symbol));
+        item->setToolTip(path);
+        m_list->addItem(item);
+    }
+    if (m_list->count() > 0) m_list->setCurrentRow(0);
+    if (!m_lastQuery.isEmpty())
+        m_status->setText(tr("%1 of %2 symbols match (%3 ms)")
+                              .arg(result.matches.size()).arg(m_search->size())
+                              .arg(static_cast<double>(result.elapsedNs) / 1e6, 0, 'f', 1));
+
+    // Währenddessen weitergetippt: nur die aktuelle Eingabe nachholen
+    if (m_searchPending) runSearch(m_edit->text());
+}
+
+void SymbolPalette::activate(QListWidgetItem* item)
+{
+    if (!item) return;
+    hide();
+    emit symbolActivated(item->data(Qt::UserRole).toString(), item->data(Qt::UserRole + 1).toInt(),
+                         item->data(Qt::UserRole + 2).toInt());
+}
+
+bool SymbolPalette::eventFilter(QObject* obj, QEvent* event)
+{
+    if (obj == m_edit && event->type() == QEvent::KeyPress) {
+        auto* keyEvent = static_cast<QKeyEvent*>(event);
+        switch (keyEvent->key()) {
+        case Qt::Key_Up:
+        case Qt::Key_Down:
+        case Qt::Key_PageUp:
+        case Qt::Key_PageDown:
+            QCoreApplication::sendEvent(m_list, event);
+            return true;
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            activate(m_list->currentItem());
+            return true;
+        case Qt::Key_Escape:
+            hide();
+            return true;
+        default:
+            break;
+        }
+    }
+    return QFrame::eventFilter(obj, event);
+}
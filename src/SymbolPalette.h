@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QFrame>
+#include <QFutureWatcher>
+#include <QLabel>
+#include <QLineEdit>
+#include <QList>
+#include <QListWidget>
+#include <QString>
+#include <memory>
+
+#include "ReferenceIndex.h"
+#include "SymbolSearch.h"
+
+/**
+ * "Go to Symbol in Workspace" (Ctrl+T): Popup mit Eingabezeile über dem Hauptfenster.
+ *  - die SymbolSearch wird beim ersten Öffnen nach einer Änderung der Definitionen im Index
+ *    (definitionsRevision()) im Hintergrund aus einer flachen Kopie des Index aufgebaut;
+ *    Speichern ohne geänderte Definitionen baut nichts neu auf
+ *  - jede Eingabe sucht sofort im Hintergrund; tippt man während einer Suche weiter, läuft danach
+ *    nur die jeweils letzte Eingabe (keine Warteschlange pro Tastendruck)
+ *  - verlängert die Eingabe die vorige, wird nur unter deren Treffern gesucht
+ *  - Enter/Doppelklick meldet die Fundstelle über symbolActivated(), Escape schließt
+ */
+class SymbolPalette : public QFrame
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_RESULTS = 100;
+
+    explicit SymbolPalette(QWidget* parent);
+
+    void setIndex(std::shared_ptr<const ReferenceIndex> index);
+    void popup();
+
+signals:
+    void symbolActivated(const QString& path, int line, int column);
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+private:
+    [[nodiscard]] bool searchIsCurrent() const;
+    void ensureSearch();
+    void onSearchBuilt();
+    void requestSearch();
+    void runSearch(const QString& query);
+    void onSearchFinished();
+    void activate(QListWidgetItem* item);
+
+    QLineEdit* m_edit{nullptr};
+    QListWidget* m_list{nullptr};
+    QLabel* m_status{nullptr};
+
+    std::shared_ptr<const ReferenceIndex> m_index;
+    std::shared_ptr<const SymbolSearch> m_search;
+    std::weak_ptr<const ReferenceIndex> m_searchSource;   // Index, aus dem m_search gebaut wurde
+    quint64 m_searchRevision = 0;                         // dessen definitionsRevision() beim Aufbau
+    QFutureWatcher<std::shared_ptr<const SymbolSearch>>* m_buildWatcher{nullptr};
+    QFutureWatcher<SymbolSearch::Result>* m_searchWatcher{nullptr};
+
+    QString m_runningQuery;
+    std::shared_ptr<const SymbolSearch> m_runningSearch;
+    bool m_searchPending{false};
+    QString m_lastQuery;            // letzte abgeschlossene Suche und ihre Treffer (zum Eingrenzen)
+    QList<quint32> m_lastMatches;
+};
@@ -0,0 +1,295 @@
+#include "SymbolSearch.h"
+#include "ReferenceIndex.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+namespace {
+    // Bewertung ähnlich fzf: Treffer an Wortgrenzen und zusammenhängende Treffer zählen mehr, Lücken kosten
+    constexpr int SCORE_MATCH = 16;
+    constexpr int BONUS_BOUNDARY_START = 10;   // erstes Zeichen des Namens
+    constexpr int BONUS_BOUNDARY_SEPARATOR = 9; // nach '.', ':' oder '_'
+    constexpr int BONUS_CAMEL = 7;              // aB
+    constexpr int BONUS_DIGIT = 4;              // a1
+    constexpr int BONUS_CONSECUTIVE = 6;
+    constexpr int BONUS_FIRST_CHAR_FACTOR = 2;
+    constexpr int BONUS_LAST_SEGMENT = 10;      // ganzer Treffer im letzten Glied (clamp in Util.clamp)
+    constexpr int PENALTY_GAP_START = 3;
+    constexpr int PENALTY_GAP_EXTENSION = 1;
+
+    // Unter dieser Größe lohnt sich das Aufteilen nicht
+    constexpr qsizetype MIN_CHUNK = 16384;
+
+    constexpr char lower(char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c; }
+    constexpr bool isUpper(char c) { return c >= 'A' && c <= 'Z'; }
+    constexpr bool isLowerOrDigit(char c) { return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'); }
+    constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    constexpr bool isSeparator(char c) { return c == '.' || c == ':' || c == '_'; }
+
+    constexpr quint64 charBit(char c) {
+        c = lower(c);
+        if (c >= 'a' && c <= 'z') return quint64{1} << (c - 'a');
+        if (c >= '0' && c <= '9') return quint64{1} << (26 + c - '0');
+        if (c == '_') return quint64{1} << 36;
+        if (c == '.' || c == ':') return quint64{1} << 37;
+        return quint64{1} << 38;
+    }
+
+    quint64 mask(QByteArrayView text) {
+        quint64 bits = 0;
+        for (const char c : text) bits |= charBit(c);
+        return bits;
+    }
+
+    int boundaryBonus(QByteArrayView name, qsizetype i) {
+        if (i == 0) return BONUS_BOUNDARY_START;
+        const char previous = name.at(i - 1);
+        const char current = name.at(i);
+        if (isSeparator(previous)) return BONUS_BOUNDARY_SEPARATOR;
+        if (isUpper(current) && isLowerOrDigit(previous)) return BONUS_CAMEL;
+        if (isDigit(current) && !isDigit(previous)) return BONUS_DIGIT;
+        return 0;
+    }
+
+    struct Chunk {
+        qsizetype begin = 0;
+        qsizetype end = 0;
+    };
+
+    struct ChunkResult {
+        QList<SymbolSearch::Hit> top;
+        QList<quint32> matches;
+    };
+}
+
+SymbolSearch::SymbolSearch(int threads)
+{
+    m_pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    m_nameOffsets.append(0);
+}
+
+void SymbolSearch::clear()
+{
+    m_names.clear();
+    m_nameOffsets = {0};
+    m_masks.clear();
+    m_files.clear();
+    m_lines.clear();
+    m_columns.clear();
+    m_filePaths.clear();
+    m_fileIds.clear();
+}
+
+void SymbolSearch::reserve(qsizetype symbols, qsizetype nameBytes)
+{
+    m_names.reserve(nameBytes);
+    m_nameOffsets.reserve(symbols + 1);
+    m_masks.reserve(symbols);
+    m_files.reserve(symbols);
+    m_lines.reserve(symbols);
+    m_columns.reserve(symbols);
+}
+
+void SymbolSearch::build(const ReferenceIndex& index)
+{
+    TRACE_SCOPE("SymbolSearch::build");
+    QElapsedTimer timer;
+    timer.start();
+    clear();
+
+    // Datei-IDs des Referenzindex direkt übernehmen, Pfade nur einmal je Datei auflösen
+    for (quint32 file = 0; file < static_cast<quint32>(index.files().size()); ++file) {
+        m_filePaths.append(index.filePath(file));
+        m_fileIds.insert(m_filePaths.constLast(), file);
+    }
+
+    const QHash<QString, ReferenceIndex::Location>& definitions = index.definitions();
+    qsizetype nameBytes = 0;
+    for (auto it = definitions.constBegin(); it != definitions.constEnd(); ++it)
+        nameBytes += it.key().size();
+    reserve(definitions.size(), nameBytes);
+
+    for (auto it = definitions.constBegin(); it != definitions.constEnd(); ++it) {
+        const QByteArray name = it.key().toLatin1();
+        m_names.append(name);
+        m_nameOffsets.append(static_cast<quint32>(m_names.size()));
+        m_masks.append(mask(name));
+        m_files.append(it.value().file);
+        m_lines.append(it.value().line);
+        m_columns.append(it.value().column);
+    }
+    LOG_INFO(lcParser) << "Symbol search:" << size() << "symbols," << m_names.size() << "name bytes,"
+                       << timer.elapsed() << "ms";
+}
+
+void SymbolSearch::addSymbol(QByteArrayView qualifiedName, const QString& filePath, int line, int column)
+{
+    auto file = m_fileIds.constFind(filePath);
+    if (file == m_fileIds.constEnd()) {
+        file = m_fileIds.insert(filePath, static_cast<quint32>(m_filePaths.size()));
+        m_filePaths.append(filePath);
+    }
+    m_names.append(qualifiedName);
+    m_nameOffsets.append(static_cast<quint32>(m_names.size()));
+    m_masks.append(mask(qualifiedName));
+    m_files.append(file.value());
+    m_lines.append(line);
+    m_columns.append(column);
+}
+
+QByteArrayView SymbolSearch::nameView(quint32 symbol) const
+{
+    const quint32 begin = m_nameOffsets.at(symbol);
+    return QByteArrayView(m_names.constData() + begin, m_nameOffsets.at(symbol + 1) - begin);
+}
+
+QString SymbolSearch::name(quint32 symbol) const
+{
+    return QString::fromLatin1(nameView(symbol));
+}
+
+QString SymbolSearch::filePath(quint32 symbol) const
+{
+    return m_filePaths.at(m_files.at(symbol));
+}
+
+int SymbolSearch::score(QByteArrayView name, QByteArrayView query)
+{
+    const qsizetype n = name.size();
+    const qsizetype m = query.size();
+    if (m == 0) return 0;
+    if (m > n) return -1;
+
+    // 1. Ende des frühesten Teilfolgen-Treffers
+    qsizetype q = 0;
+    qsizetype end = -1;
+    for (qsizetype i = 0; i < n; ++i) {
+        if (lower(name.at(i)) == query.at(q) && ++q == m) {
+            end = i;
+            break;
+        }
+    }
+    if (end < 0) return -1;
+
+    // 2. Von dort rückwärts den spätesten Anfang suchen → kürzestes Fenster
+    q = m - 1;
+    qsizetype start = end;
+    for (qsizetype i = end; i >= 0; --i) {
+        if (lower(name.at(i)) == query.at(q) && --q < 0) {
+            start = i;
+            break;
+        }
+    }
+
+    // 3. Fenster bewerten
+    int score = 0;
+    q = 0;
+    bool inGap = false;
+    int consecutive = 0;
+    for (qsizetype i = start; i <= end && q < m; ++i) {
+        if (lower(name.at(i)) != query.at(q)) {
+            score -= inGap ? PENALTY_GAP_EXTENSION : PENALTY_GAP_START;
+            inGap = true;
+            consecutive = 0;
+            continue;
+        }
+        int bonus = boundaryBonus(name, i);
+        if (consecutive > 0) bonus = std::max(bonus, BONUS_CONSECUTIVE);
+        if (q == 0) bonus *= BONUS_FIRST_CHAR_FACTOR;
+        score += SCORE_MATCH + bonus;
+        inGap = false;
+        ++consecutive;
+        ++q;
+    }
+
+    qsizetype lastSeparator = -1;
+    for (qsizetype i = n - 1; i >= 0; --i) {
+        if (name.at(i) == '.' || name.at(i) == ':') {
+            lastSeparator = i;
+            break;
+        }
+    }
+    if (start > lastSeparator) score += BONUS_LAST_SEGMENT;
+    return score;
+}
+
+SymbolSearch::Result SymbolSearch::search(const QString& query, int limit, const QList<quint32>* within) const
+{
+    TRACE_SCOPE("SymbolSearch::search");
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    // Leerzeichen ignorieren ("player upd"); Lua-Bezeichner sind ASCII, alles andere kann nicht passen
+    QByteArray needle;
+    needle.reserve(query.size());
+    for (const QChar c : query) {
+        if (c.isSpace()) continue;
+        if (c.unicode() > 0x7f) return result;
+        needle.append(lower(static_cast<char>(c.unicode())));
+    }
+    if (needle.isEmpty() || limit <= 0) return result;
+    const quint64 needleMask = mask(needle);
+
+    const qsizetype total = within ? within->size() : size();
+    const qsizetype wanted = std::max<qsizetype>(1, m_pool.maxThreadCount()) * 4;
+    const qsizetype chunkSize = std::max(MIN_CHUNK, (total + wanted - 1) / wanted);
+    QList<Chunk> chunks;
+    for (qsizetype begin = 0; begin < total; begin += chunkSize)
+        chunks.append({begin, std::min(total, begin + chunkSize)});
+
+    // Besser = höherer Score, dann kürzerer Name, dann alphabetisch (unabhängig von der Aufbaureihenfolge)
+    auto better = [this](const Hit& a, const Hit& b) {
+        if (a.score != b.score) return a.score > b.score;
+        const QByteArrayView na = nameView(a.symbol);
+        const QByteArrayView nb = nameView(b.symbol);
+        if (na.size() != nb.size()) return na.size() < nb.size();
+        const auto [ia, ib] = std::mismatch(na.begin(), na.end(), nb.begin());
+        if (ia != na.end()) return *ia < *ib;
+        return a.symbol < b.symbol;
+    };
+
+    const QList<ChunkResult> perChunk = QtConcurrent::blockingMapped(&m_pool, chunks, [&](const Chunk& chunk) {
+        ChunkResult out;
+        // Heap mit dem schlechtesten der bisher besten limit Treffer vorn
+        for (qsizetype i = chunk.begin; i < chunk.end; ++i) {
+            const quint32 symbol = within ? within->at(i) : static_cast<quint32>(i);
+            if ((m_masks.at(symbol) & needleMask) != needleMask) continue;
+            const int s = score(nameView(symbol), needle);
+            if (s < 0) continue;
+            out.matches.append(symbol);
+            const Hit hit{symbol, s};
+            if (out.top.size() < limit) {
+                out.top.append(hit);
+                std::push_heap(out.top.begin(), out.top.end(), better);
+            } else if (better(hit, out.top.constFirst())) {
+                std::pop_heap(out.top.begin(), out.top.end(), better);
+                out.top.last() = hit;
+                std::push_heap(out.top.begin(), out.top.end(), better);
+            }
+        }
+        return out;
+    });
+
+    qsizetype matchCount = 0;
+    for (const ChunkResult& chunk : perChunk)
+        matchCount += chunk.matches.size();
+    result.matches.reserve(matchCount);
+    for (const ChunkResult& chunk : perChunk) {
+        result.matches.append(chunk.matches);
+        result.hits.append(chunk.top);
+    }
+    std::sort(result.hits.begin(), result.hits.end(), better);
+    if (result.hits.size() > limit)
+        result.hits.resize(limit);
+
+    result.elapsedNs = timer.nsecsElapsed();
+    LOG_DEBUG(lcParser) << "Symbol search" << query << ":" << matchCount << "of" << total << "match,"
+                        << result.elapsedNs / 1000 << "us";
+    return result;
+}
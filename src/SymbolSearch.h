@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+
+class ReferenceIndex;
+
+/**
+ * Fuzzy-Suche über alle Symbole eines Projekts ("Go to Symbol in Workspace"):
+ *  - Namen liegen als ASCII-Bytes in einem zusammenhängenden Puffer (Lua-Bezeichner sind ASCII),
+ *    dazu je Symbol eine 64-Bit-Zeichenmaske als Vorfilter
+ *  - search() teilt die Symbole in Blöcke, bewertet sie parallel auf einem eigenen Pool und
+ *    hält je Block nur einen Top-K-Heap; die Heaps werden am Ende zusammengeführt
+ *  - "within" begrenzt die Suche auf die Treffer einer kürzeren Vorgängerabfrage: wer "abc"
+ *    enthält, enthält auch "ab" – beim Tippen wird die Kandidatenmenge mit jedem Zeichen kleiner
+ *  - nach build() unveränderlich; search() ist const und darf aus mehreren Threads laufen
+ */
+class SymbolSearch
+{
+public:
+    struct Hit {
+        quint32 symbol = 0;
+        int score = 0;
+    };
+
+    struct Result {
+        QList<Hit> hits;          // beste zuerst, höchstens limit
+        QList<quint32> matches;   // alle passenden Symbole, aufsteigend (für within)
+        qint64 elapsedNs = 0;
+    };
+
+    explicit SymbolSearch(int threads = 0); // 0 = QThread::idealThreadCount()
+
+    // Alle Definitionen des Referenzindex (qualifizierte Namen mit Fundstelle)
+    void build(const ReferenceIndex& index);
+    void clear();
+    void reserve(qsizetype symbols, qsizetype nameBytes);
+    void addSymbol(QByteArrayView qualifiedName, const QString& filePath, int line, int column);
+
+    [[nodiscard]] Result search(const QString& query, int limit, const QList<quint32>* within = nullptr) const;
+
+    [[nodiscard]] qsizetype size() const { return m_lines.size(); }
+    [[nodiscard]] QString name(quint32 symbol) const;
+    [[nodiscard]] QString filePath(quint32 symbol) const;
+    [[nodiscard]] int line(quint32 symbol) const { return m_lines.at(symbol); }
+    [[nodiscard]] int column(quint32 symbol) const { return m_columns.at(symbol); }
+
+    // Bewertung eines Namens; -1 = keine Teilfolge. query in Kleinbuchstaben
+    [[nodiscard]] static int score(QByteArrayView name, QByteArrayView query);
+
+private:
+    [[nodiscard]] QByteArrayView nameView(quint32 symbol) const;
+
+    QByteArray m_names;             // alle Namen hintereinander
+    QList<quint32> m_nameOffsets;   // Anfang je Symbol, plus Ende des letzten
+    QList<quint64> m_masks;         // vorkommende Zeichen je Name
+    QList<quint32> m_files;         // Index in m_filePaths
+    QList<int> m_lines;
+    QList<int> m_columns;
+    QStringList m_filePaths;
+    QHash<QString, quint32> m_fileIds;
+    mutable QThreadPool m_pool;
+};
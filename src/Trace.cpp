@@ -0,0 +1,121 @@
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <vector>
+
+namespace Trace {
+
+namespace {
+    struct Ring {
+        QMutex mutex;
+        std::vector<Event> events; // erst beim ersten Aktivieren allokiert
+        quint64 written = 0;       // Gesamtzahl geschriebener Events (Index = written % Kapazität)
+    };
+
+    Ring& ring() {
+        static Ring r;
+        return r;
+    }
+
+    const QElapsedTimer& clock() {
+        static const QElapsedTimer t = [] {
+            QElapsedTimer timer;
+            timer.start();
+            return timer;
+        }();
+        return t;
+    }
+
+    std::atomic<quint32> g_nextThreadId{1};
+
+    quint32 currentThreadId() {
+        thread_local const quint32 id = g_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+}
+
+void setEnabled(bool enabled) {
+    if (enabled) {
+        clock(); // Zeitbasis festlegen, bevor das erste Event kommt
+        Ring& r = ring();
+        QMutexLocker lock(&r.mutex);
+        if (r.events.empty())
+            r.events.resize(RING_CAPACITY);
+    }
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 nowNs() {
+    return clock().nsecsElapsed();
+}
+
+void record(const char* name, qint64 startNs, qint64 endNs, int revision) {
+    const quint32 tid = currentThreadId();
+    Ring& r = ring();
+    QMutexLocker lock(&r.mutex);
+    if (r.events.empty()) return;
+
+    Event& e = r.events[static_cast<size_t>(r.written & (RING_CAPACITY - 1))];
+    e.name = name;
+    e.startNs = startNs;
+    e.durationNs = endNs - startNs;
+    e.threadId = tid;
+    e.revision = revision;
+    ++r.written;
+}
+
+QVector<Event> snapshot() {
+    Ring& r = ring();
+    QMutexLocker lock(&r.mutex);
+
+    QVector<Event> out;
+    if (r.events.empty()) return out;
+
+    const quint64 count = qMin<quint64>(r.written, RING_CAPACITY);
+    out.reserve(static_cast<qsizetype>(count));
+    for (quint64 i = r.written - count; i < r.written; ++i)
+        out.append(r.events[static_cast<size_t>(i & (RING_CAPACITY - 1))]);
+    return out;
+}
+
+void clear() {
+    Ring& r = ring();
+    QMutexLocker lock(&r.mutex);
+    r.written = 0;
+}
+
+bool writeChromeTrace(QIODevice* out) {
+    if (!out || !out->isWritable()) return false;
+
+    const QVector<Event> events = snapshot();
+
+    QByteArray json;
+    json.reserve(events.size() * 120 + 64);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const Event& e : events) {
+        if (!first) json += ',';
+        first = false;
+        // Chrome erwartet Mikrosekunden; Nachkommastellen behalten die ns-Auflösung
+        json += "{\"name\":\"";
+        json += e.name;
+        json += "\",\"cat\":\"luaeditor\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        json += QByteArray::number(e.threadId);
+        json += ",\"ts\":";
+        json += QByteArray::number(static_cast<double>(e.startNs) / 1000.0, 'f', 3);
+        json += ",\"dur\":";
+        json += QByteArray::number(static_cast<double>(e.durationNs) / 1000.0, 'f', 3);
+        json += ",\"args\":{\"revision\":";
+        json += QByteArray::number(e.revision);
+        json += "}}";
+    }
+    json += "]}\n";
+
+    return out->write(json) == json.size();
+}
+
+} // namespace Trace
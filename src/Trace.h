@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+
+class QIODevice;
+
+/**
+ * Leichtgewichtiges Span-Tracing für die Hot-Paths
+ * (Highlighter, Parser, Completion, Imports, Zeilennummern-Paint):
+ *  - TRACE_SCOPE("Name") / TRACE_SCOPE_REV("Name", revision) messen den umgebenden Block
+ *  - Events landen in einem festen Ringpuffer (keine Allokation pro Event)
+ *  - writeChromeTrace() schreibt Chrome-Trace-Event-JSON (Perfetto, chrome://tracing)
+ *
+ * Deaktiviert kostet ein Span genau einen Branch auf ein atomares Flag; das Revisions-
+ * Argument von TRACE_SCOPE_REV wird dann gar nicht erst ausgewertet.
+ */
+namespace Trace {
+
+struct Event {
+    const char* name = nullptr; // String-Literal, wird nicht kopiert
+    qint64 startNs = 0;         // relativ zum Prozessstart
+    qint64 durationNs = 0;
+    quint32 threadId = 0;       // fortlaufende Thread-Nummer (1 = erster tracender Thread)
+    int revision = -1;          // QTextDocument::revision() oder -1
+};
+
+inline std::atomic<bool> g_enabled{false};
+
+[[nodiscard]] inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+// Ringpuffer-Kapazität (Zweierpotenz); ältere Events werden überschrieben
+constexpr int RING_CAPACITY = 1 << 16;
+
+[[nodiscard]] qint64 nowNs();
+void record(const char* name, qint64 startNs, qint64 endNs, int revision);
+
+[[nodiscard]] QVector<Event> snapshot(); // chronologisch, ältestes zuerst
+void clear();
+
+// Chrome Trace Event Format ("ph":"X" Complete-Events)
+bool writeChromeTrace(QIODevice* out);
+
+class Scope {
+public:
+    explicit Scope(const char* name, int revision = -1) {
+        if (isEnabled()) {
+            m_name = name;
+            m_revision = revision;
+            m_startNs = nowNs();
+        }
+    }
+    ~Scope() {
+        if (m_name)
+            record(m_name, m_startNs, nowNs(), m_revision);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* m_name = nullptr;
+    qint64 m_startNs = 0;
+    int m_revision = -1;
+};
+
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ::Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_REV(name, revision) \
+    ::Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name, ::Trace::isEnabled() ? (revision) : -1)
@@ -0,0 +1,477 @@
+#include "TrigramIndex.h"
+#include "Log.h"
+#include "Trace.h"
+#include "Varint.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    constexpr quint32 foldAscii(quint32 byte) {
+        return byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+    }
+
+    // Index hinter der zum Zeichen an pattern[open] passenden schließenden Klammer bzw. -1
+    qsizetype skipClass(const QString& pattern, qsizetype open) {
+        qsizetype i = open + 1;
+        if (i < pattern.size() && pattern.at(i) == u'^') ++i;
+        if (i < pattern.size() && pattern.at(i) == u']') ++i; // "[]abc]": ']' am Anfang ist literal
+        for (; i < pattern.size(); ++i) {
+            if (pattern.at(i) == u'\\') ++i;
+            else if (pattern.at(i) == u']') return i + 1;
+        }
+        return -1;
+    }
+
+    qsizetype skipGroup(const QString& pattern, qsizetype open) {
+        int depth = 0;
+        for (qsizetype i = open; i < pattern.size(); ++i) {
+            const QChar c = pattern.at(i);
+            if (c == u'\\') {
+                ++i;
+            } else if (c == u'[') {
+                i = skipClass(pattern, i);
+                if (i < 0) return -1;
+                --i;
+            } else if (c == u'(') {
+                ++depth;
+            } else if (c == u')' && --depth == 0) {
+                return i + 1;
+            }
+        }
+        return -1;
+    }
+}
+
+// ----- Trigramme -----
+
+QList<quint32> TrigramIndex::trigrams(QByteArrayView text, bool keepNonAscii)
+{
+    QList<quint32> result;
+    if (text.size() < 3) return result;
+    result.reserve(text.size() - 2);
+
+    const auto* bytes = reinterpret_cast<const quint8*>(text.data());
+    quint32 a = foldAscii(bytes[0]);
+    quint32 b = foldAscii(bytes[1]);
+    for (qsizetype i = 2; i < text.size(); ++i) {
+        const quint32 c = foldAscii(bytes[i]);
+        if (keepNonAscii || ((a | b | c) & 0x80) == 0)
+            result.append(a << 16 | b << 8 | c);
+        a = b;
+        b = c;
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+QByteArray TrigramIndex::encode(const QList<quint32>& trigrams)
+{
+    QByteArray bytes;
+    quint32 previous = 0;
+    for (const quint32 trigram : trigrams) {
+        Varint::put(bytes, trigram - previous);
+        previous = trigram;
+    }
+    return bytes;
+}
+
+QList<quint32> TrigramIndex::decode(const QByteArray& bytes)
+{
+    QList<quint32> trigrams;
+    quint32 previous = 0;
+    qsizetype offset = 0;
+    while (offset < bytes.size()) {
+        previous += Varint::get(bytes, offset);
+        trigrams.append(previous);
+    }
+    return trigrams;
+}
+
+/*
+ * Zerlegt das Muster in Literale, die jeder Treffer enthalten muss. Im Zweifel wird ein
+ * Literal abgebrochen statt verlängert: zu wenige Trigramme kosten nur Lesezugriffe,
+ * zu viele würden Treffer verlieren.
+ *   - '|' auf oberster Ebene trennt Alternativen
+ *   - Gruppen und Zeichenklassen werden übersprungen
+ *   - '?', '*' und '{n,m}' machen das vorige Zeichen optional
+ */
+QList<QList<QByteArray>> TrigramIndex::requiredLiterals(const TextQuery& query)
+{
+    if (query.pattern.isEmpty()) return {};
+    if (!query.regex) return {{query.pattern.toUtf8()}};
+
+    const QString& pattern = query.pattern;
+    static const QRegularExpression extendedFlag(uR"(\(\?[a-wyz]*x)"_qs);
+    if (pattern.contains(extendedFlag)) return {}; // Leerzeichen wären dort nicht literal
+
+    QList<QList<QByteArray>> branches;
+    QList<QByteArray> literals;
+    QString run;
+    auto flush = [&] {
+        const QByteArray literal = run.toUtf8();
+        if (literal.size() >= 3) literals.append(literal);
+        run.clear();
+    };
+    auto endBranch = [&] {
+        flush();
+        branches.append(literals);
+        literals.clear();
+    };
+
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        const QChar c = pattern.at(i);
+        switch (c.unicode()) {
+        case u'\\': {
+            if (i + 1 >= pattern.size()) return {};
+            const QChar escaped = pattern.at(++i);
+            if (escaped.isLetterOrNumber()) {
+                // \w, \d, \b ... beenden das Literal; \x, \p{..}, Rückverweise usw. nicht zerlegen
+                if (!QStringView(u"wWdDsSbBAzZGhHvVR").contains(escaped)) return {};
+                flush();
+            } else {
+                run.append(escaped);
+            }
+            break;
+        }
+        case u'[':
+            flush();
+            i = skipClass(pattern, i);
+            if (i < 0) return {};
+            --i;
+            break;
+        case u'(':
+            flush();
+            i = skipGroup(pattern, i);
+            if (i < 0) return {};
+            --i;
+            break;
+        case u')':
+            return {};
+        case u'|':
+            endBranch();
+            break;
+        case u'?':
+        case u'*':
+            run.chop(1);
+            flush();
+            break;
+        case u'{': {
+            run.chop(1);
+            flush();
+            const qsizetype close = pattern.indexOf(u'}', i);
+            if (close < 0) return {};
+            i = close;
+            break;
+        }
+        case u'+':
+        case u'.':
+        case u'^':
+        case u'$':
+            flush();
+            break;
+        default:
+            run.append(c);
+            break;
+        }
+    }
+    endBranch();
+
+    // Eine Alternative ohne Literal kann überall passen
+    for (const QList<QByteArray>& branch : std::as_const(branches)) {
+        if (branch.isEmpty()) return {};
+    }
+    return branches;
+}
+
+// ----- Aufbau -----
+
+void TrigramIndex::clear()
+{
+    m_root.clear();
+    m_files.clear();
+    m_fileIds.clear();
+    m_postings.clear();
+    m_indexedFiles = 0;
+    m_reusedFiles = 0;
+    m_buildNs = 0;
+}
+
+bool TrigramIndex::build(const QString& root, int threads)
+{
+    TRACE_SCOPE("TrigramIndex::build");
+
+    const QDir rootDir(root);
+    if (root.isEmpty() || !rootDir.exists()) {
+        clear();
+        return false;
+    }
+    if (m_root != rootDir.absolutePath()) clear();
+    m_root = rootDir.absolutePath();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    struct DiskFile {
+        QString path;
+        qint64 size = 0;
+        qint64 modified = 0;
+    };
+    QList<DiskFile> onDisk;
+    QDirIterator it(m_root, {u"*.lua"_qs}, QDir::Files | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        if (onDisk.size() == MAX_FILES) {
+            LOG_INFO(lcFiles) << "Not indexing" << m_root << "- more than" << MAX_FILES << "Lua files";
+            clear();
+            return false;
+        }
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        onDisk.append({rootDir.relativeFilePath(info.filePath()), info.size(),
+                       info.lastModified().toMSecsSinceEpoch()});
+    }
+    std::sort(onDisk.begin(), onDisk.end(), [](const DiskFile& a, const DiskFile& b) { return a.path < b.path; });
+
+    // Gelöschte Dateien austragen, neue und geänderte zum Lesen vormerken
+    QSet<QString> present;
+    QList<DiskFile> changed;
+    for (const DiskFile& file : std::as_const(onDisk)) {
+        present.insert(file.path);
+        const auto known = m_fileIds.constFind(file.path);
+        if (known == m_fileIds.constEnd()) {
+            changed.append(file);
+            continue;
+        }
+        const FileEntry& entry = m_files.at(known.value());
+        if (entry.size != file.size || entry.modified != file.modified)
+            changed.append(file);
+    }
+    const QStringList known = m_fileIds.keys();
+    for (const QString& path : known) {
+        if (!present.contains(path)) dropFile(m_fileIds.value(path));
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+    const QString absoluteRoot = m_root;
+    const QList<QByteArray> encoded = QtConcurrent::blockingMapped(&pool, changed, [absoluteRoot](const DiskFile& file) {
+        QFile input(QDir(absoluteRoot).filePath(file.path));
+        if (!input.open(QIODevice::ReadOnly)) {
+            LOG_INFO(lcFiles) << "Cannot read" << input.fileName() << input.errorString();
+            return QByteArray();
+        }
+        return encode(trigrams(input.readAll()));
+    });
+
+    for (qsizetype i = 0; i < changed.size(); ++i) {
+        const DiskFile& file = changed.at(i);
+        if (const auto old = m_fileIds.constFind(file.path); old != m_fileIds.constEnd())
+            dropFile(old.value());
+        addFile({file.path, file.size, file.modified, encoded.at(i)});
+    }
+
+    m_indexedFiles = static_cast<int>(changed.size());
+    m_reusedFiles = static_cast<int>(onDisk.size() - changed.size());
+    m_buildNs = timer.nsecsElapsed();
+
+    const Stats s = stats();
+    LOG_INFO(lcFiles) << "Trigram index:" << s.files << "files (" << s.indexedFiles << "read," << s.reusedFiles
+                      << "cached)," << s.trigrams << "trigrams in" << s.buildNs / 1000000 << "ms";
+    return true;
+}
+
+quint32 TrigramIndex::addFile(FileEntry entry)
+{
+    // Neue IDs sind immer die größten: die Posting-Listen bleiben durch Anhängen sortiert
+    const auto id = static_cast<quint32>(m_files.size());
+    for (const quint32 trigram : decode(entry.trigrams))
+        m_postings[trigram].append(id);
+    m_fileIds.insert(entry.path, id);
+    m_files.append(std::move(entry));
+    return id;
+}
+
+void TrigramIndex::dropFile(quint32 id)
+{
+    FileEntry& entry = m_files[id];
+    for (const quint32 trigram : decode(entry.trigrams)) {
+        const auto posting = m_postings.find(trigram);
+        if (posting == m_postings.end()) continue;
+        QList<quint32>& ids = posting.value();
+        const auto found = std::lower_bound(ids.begin(), ids.end(), id);
+        if (found != ids.end() && *found == id) ids.erase(found);
+        if (ids.isEmpty()) m_postings.erase(posting);
+    }
+    m_fileIds.remove(entry.path);
+    entry = FileEntry{}; // ID bleibt reserviert, save() lässt sie aus
+}
+
+void TrigramIndex::updateFile(const QString& path, QByteArrayView content)
+{
+    TRACE_SCOPE("TrigramIndex::updateFile");
+    const QString relative = m_root.isEmpty() ? QDir::cleanPath(path) : QDir(m_root).relativeFilePath(path);
+    if (const auto old = m_fileIds.constFind(relative); old != m_fileIds.constEnd())
+        dropFile(old.value());
+
+    // Weicht die Datei auf der Platte ab, liest der nächste build() sie ohnehin neu
+    const QFileInfo info(path);
+    addFile({relative, content.size(), info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0,
+             encode(trigrams(content))});
+}
+
+void TrigramIndex::removeFile(const QString& path)
+{
+    const QString relative = m_root.isEmpty() ? QDir::cleanPath(path) : QDir(m_root).relativeFilePath(path);
+    if (const auto it = m_fileIds.constFind(relative); it != m_fileIds.constEnd())
+        dropFile(it.value());
+}
+
+// ----- Abfragen -----
+
+QList<quint32> TrigramIndex::allFiles() const
+{
+    QList<quint32> ids = m_fileIds.values();
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+QList<quint32> TrigramIndex::filesContaining(const QList<QByteArray>& literals, bool keepNonAscii,
+                                             bool* narrowed) const
+{
+    QList<quint32> required;
+    for (const QByteArray& literal : literals)
+        required += trigrams(literal, keepNonAscii);
+    std::sort(required.begin(), required.end());
+    required.erase(std::unique(required.begin(), required.end()), required.end());
+
+    *narrowed = !required.isEmpty();
+    if (required.isEmpty()) return allFiles();
+
+    // Kürzeste Liste zuerst: die Schnittmenge wird schnell klein
+    QList<const QList<quint32>*> lists;
+    for (const quint32 trigram : std::as_const(required)) {
+        const auto it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd()) return {};
+        lists.append(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    QList<quint32> result = *lists.first();
+    for (qsizetype i = 1; i < lists.size() && !result.isEmpty(); ++i) {
+        QList<quint32> next;
+        std::set_intersection(result.cbegin(), result.cend(), lists.at(i)->cbegin(), lists.at(i)->cend(),
+                              std::back_inserter(next));
+        result = std::move(next);
+    }
+    return result;
+}
+
+QStringList TrigramIndex::candidates(const TextQuery& query) const
+{
+    TRACE_SCOPE("TrigramIndex::candidates");
+    const QList<QList<QByteArray>> branches = requiredLiterals(query);
+
+    // Groß-/Kleinschreibung ist nur für ASCII gefaltet; ohne Beachtung zählen nur ASCII-Trigramme
+    QList<quint32> ids;
+    if (branches.isEmpty()) {
+        ids = allFiles();
+    } else {
+        for (const QList<QByteArray>& branch : branches) {
+            bool narrowed = false;
+            const QList<quint32> files = filesContaining(branch, query.caseSensitive, &narrowed);
+            if (!narrowed) {
+                ids = allFiles();
+                break;
+            }
+            ids += files;
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+    QStringList paths;
+    paths.reserve(ids.size());
+    const QDir rootDir(m_root);
+    for (const quint32 id : std::as_const(ids))
+        paths.append(QDir::cleanPath(rootDir.filePath(m_files.at(id).path)));
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+TrigramIndex::Stats TrigramIndex::stats() const
+{
+    Stats s;
+    s.files = static_cast<int>(m_fileIds.size());
+    s.trigrams = static_cast<int>(m_postings.size());
+    s.indexedFiles = m_indexedFiles;
+    s.reusedFiles = m_reusedFiles;
+    s.buildNs = m_buildNs;
+    return s;
+}
+
+// ----- Cache -----
+
+QString TrigramIndex::defaultCachePath(const QString& root)
+{
+    const QByteArray key = QCryptographicHash::hash(QDir(root).absolutePath().toUtf8(), QCryptographicHash::Sha1);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + u"/trigrams/"_qs
+           + QString::fromLatin1(key.toHex()) + u".idx"_qs;
+}
+
+bool TrigramIndex::save(QIODevice* out) const
+{
+    TRACE_SCOPE("TrigramIndex::save");
+    QDataStream stream(out);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << CACHE_MAGIC << CACHE_VERSION << m_root << static_cast<quint32>(m_fileIds.size());
+    for (const FileEntry& entry : m_files) {
+        if (entry.path.isEmpty()) continue;
+        stream << entry.path << entry.size << entry.modified << entry.trigrams;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+bool TrigramIndex::load(QIODevice* in)
+{
+    TRACE_SCOPE("TrigramIndex::load");
+    clear();
+
+    QDataStream stream(in);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION) return false;
+
+    QString root;
+    quint32 count = 0;
+    stream >> root >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        FileEntry entry;
+        stream >> entry.path >> entry.size >> entry.modified >> entry.trigrams;
+        if (stream.status() == QDataStream::Ok && !entry.path.isEmpty())
+            addFile(std::move(entry));
+    }
+    if (stream.status() != QDataStream::Ok) {
+        clear();
+        return false;
+    }
+    m_root = root;
+    return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class QIODevice;
+
+// Textsuche im Workspace: Muster + Optionen (Regex zeilenweise, wie grep)
+struct TextQuery {
+    QString pattern;
+    bool regex = false;
+    bool caseSensitive = false;
+};
+
+/**
+ * Trigramm-Index über die Dateien eines Workspaces für die Volltextsuche:
+ *  - je Datei die Menge ihrer Byte-Trigramme (UTF-8, ASCII auf Kleinbuchstaben gefaltet),
+ *    invertiert zu Trigramm → sortierte Datei-IDs
+ *  - candidates() schränkt eine Suche auf die Dateien ein, die alle Trigramme der
+ *    literalen Teile des Musters enthalten; verifiziert wird danach nur dort
+ *  - Regex: nur sicher erforderliche Literale zählen; was sich nicht zerlegen lässt
+ *    (Klassen, Gruppen, optionale Zeichen) schränkt nicht ein, statt Treffer zu verlieren
+ *  - save()/load() persistieren Größe, Änderungszeit und Trigramme je Datei; build() liest
+ *    danach nur neue oder geänderte Dateien, updateFile() nimmt gespeicherte Dateien einzeln auf
+ */
+class TrigramIndex
+{
+public:
+    struct Stats {
+        int files = 0;
+        int trigrams = 0;       // verschiedene Trigramme
+        int indexedFiles = 0;   // im letzten build() gelesen
+        int reusedFiles = 0;    // im letzten build() aus dem Cache übernommen
+        qint64 buildNs = 0;
+    };
+
+    static constexpr quint32 CACHE_MAGIC = 0x4C545249; // "LTRI"
+    static constexpr quint16 CACHE_VERSION = 1;
+    static constexpr int MAX_FILES = 20000;
+
+    // Alle *.lua unterhalb von root; Einträge aus load() mit gleicher Größe und Änderungszeit
+    // werden übernommen. threads = 0 → QThread::idealThreadCount(); false bei mehr als MAX_FILES
+    bool build(const QString& root, int threads = 0);
+    void clear();
+
+    // Einzelne Datei neu aufnehmen (z.B. nach dem Speichern); Pfad absolut
+    void updateFile(const QString& path, QByteArrayView content);
+    void removeFile(const QString& path);
+
+    // Absolute Pfade der Dateien, die als Treffer in Frage kommen (sortiert)
+    [[nodiscard]] QStringList candidates(const TextQuery& query) const;
+
+    bool save(QIODevice* out) const;
+    bool load(QIODevice* in); // false bei fremdem/alten Format; der Index bleibt dann leer
+    [[nodiscard]] static QString defaultCachePath(const QString& root); // je Wurzel unter CacheLocation
+
+    [[nodiscard]] QString root() const { return m_root; }
+    [[nodiscard]] Stats stats() const;
+
+    // Trigramme eines Textes (sortiert, eindeutig); Bytes >= 0x80 nur wenn keepNonAscii
+    [[nodiscard]] static QList<quint32> trigrams(QByteArrayView text, bool keepNonAscii = true);
+    // Alternativen (ODER) aus Literalen, die in jedem Treffer vorkommen müssen (UND);
+    // leer = Muster schränkt nicht ein
+    [[nodiscard]] static QList<QList<QByteArray>> requiredLiterals(const TextQuery& query);
+
+private:
+    struct FileEntry {
+        QString path;           // relativ zu m_root; leer = entfernt
+        qint64 size = 0;
+        qint64 modified = 0;    // ms seit Epoch
+        QByteArray trigrams;    // sortiert, delta-codiert (Varint)
+    };
+
+    static QByteArray encode(const QList<quint32>& trigrams);
+    static QList<quint32> decode(const QByteArray& bytes);
+
+    quint32 addFile(FileEntry entry);
+    void dropFile(quint32 id);
+    [[nodiscard]] QList<quint32> allFiles() const;
+    [[nodiscard]] QList<quint32> filesContaining(const QList<QByteArray>& literals, bool keepNonAscii,
+                                                 bool* narrowed) const;
+
+    QString m_root;
+    QList<FileEntry> m_files;                   // Index = Datei-ID
+    QHash<QString, quint32> m_fileIds;
+    QHash<quint32, QList<quint32>> m_postings;  // Trigramm → aufsteigende Datei-IDs
+    int m_indexedFiles = 0;
+    int m_reusedFiles = 0;
+    qint64 m_buildNs = 0;
+};
@@ -0,0 +1,197 @@
+#include "Utf8Ingest.h"
+#include "Trace.h"
+
+#include <bit>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define LUAEDITOR_UTF8_SIMD 1
+#  include <immintrin.h>
+#else
+#  define LUAEDITOR_UTF8_SIMD 0
+#endif
+
+namespace {
+
+// Länge der gültigen Sequenz ab s[i], 0 wenn ungültig (überlang, Surrogat, > U+10FFFF, abgeschnitten)
+qsizetype sequenceLength(const uchar* s, qsizetype n, qsizetype i)
+{
+    const uchar c = s[i];
+    if (c < 0x80) return 1;
+
+    auto cont = [&](qsizetype k, uchar lo = 0x80, uchar hi = 0xBF) {
+        return i + k < n && s[i + k] >= lo && s[i + k] <= hi;
+    };
+
+    if (c >= 0xC2 && c <= 0xDF)
+        return cont(1) ? 2 : 0;
+    if (c == 0xE0)
+        return cont(1, 0xA0) && cont(2) ? 3 : 0;
+    if ((c >= 0xE1 && c <= 0xEC) || c == 0xEE || c == 0xEF)
+        return cont(1) && cont(2) ? 3 : 0;
+    if (c == 0xED)
+        return cont(1, 0x80, 0x9F) && cont(2) ? 3 : 0;
+    if (c == 0xF0)
+        return cont(1, 0x90) && cont(2) && cont(3) ? 4 : 0;
+    if (c >= 0xF1 && c <= 0xF3)
+        return cont(1) && cont(2) && cont(3) ? 4 : 0;
+    if (c == 0xF4)
+        return cont(1, 0x80, 0x8F) && cont(2) && cont(3) ? 4 : 0;
+    return 0;
+}
+
+// Skalar von i bis mindestens end; liefert die Position hinter der letzten Sequenz
+// (kann bis zu 3 Byte über end hinausgehen, nie über n)
+qsizetype scanScalar(const uchar* s, qsizetype n, qsizetype i, qsizetype end, Utf8Ingest::Result& result)
+{
+    while (i < end) {
+        const uchar c = s[i];
+        if (c < 0x80) {
+            if (c == '\n')
+                result.lineStarts.append(i + 1);
+            ++i;
+            continue;
+        }
+
+        result.ascii = false;
+        const qsizetype len = sequenceLength(s, n, i);
+        if (len == 0) {
+            if (result.errorOffset < 0)
+                result.errorOffset = i;
+            ++i; // wie ein Ersatzzeichen behandeln und weiterlesen
+            continue;
+        }
+        i += len;
+    }
+    return i;
+}
+
+#if LUAEDITOR_UTF8_SIMD
+
+inline void appendNewlines(quint32 mask, qsizetype base, Utf8Ingest::Result& result)
+{
+    while (mask) {
+        result.lineStarts.append(base + std::countr_zero(mask) + 1);
+        mask &= mask - 1;
+    }
+}
+
+// SSE2 gehört zur x86-64-Basis, braucht also kein target-Attribut
+void scanSse2(const uchar* s, qsizetype n, Utf8Ingest::Result& result)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+    qsizetype i = 0;
+    while (i + 16 <= n) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) == 0) {
+            appendNewlines(static_cast<quint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline))), i, result);
+            i += 16;
+        } else {
+            i = scanScalar(s, n, i, i + 16, result);
+        }
+    }
+    scanScalar(s, n, i, n, result);
+}
+
+__attribute__((target("avx2")))
+void scanAvx2(const uchar* s, qsizetype n, Utf8Ingest::Result& result)
+{
+    const __m256i newline = _mm256_set1_epi8('\n');
+    qsizetype i = 0;
+    while (i + 32 <= n) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        if (_mm256_movemask_epi8(v) == 0) {
+            appendNewlines(static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline))), i, result);
+            i += 32;
+        } else {
+            i = scanScalar(s, n, i, i + 32, result);
+        }
+    }
+    scanScalar(s, n, i, n, result);
+}
+
+#endif
+
+} // namespace
+
+bool Utf8Ingest::isSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+#if LUAEDITOR_UTF8_SIMD
+    case Kernel::Sse2:
+        return true;
+    case Kernel::Avx2: {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+Utf8Ingest::Kernel Utf8Ingest::bestKernel()
+{
+    if (isSupported(Kernel::Avx2)) return Kernel::Avx2;
+    if (isSupported(Kernel::Sse2)) return Kernel::Sse2;
+    return Kernel::Scalar;
+}
+
+const char* Utf8Ingest::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Avx2: return "avx2";
+    case Kernel::Sse2: return "sse2";
+    default:           return "scalar";
+    }
+}
+
+Utf8Ingest::Result Utf8Ingest::scan(QByteArrayView bytes)
+{
+    static const Kernel kernel = bestKernel();
+    return scan(bytes, kernel);
+}
+
+Utf8Ingest::Result Utf8Ingest::scan(QByteArrayView bytes, Kernel kernel)
+{
+    TRACE_SCOPE("Utf8Ingest::scan");
+
+    Result result;
+    result.lineStarts.reserve(bytes.size() / 64 + 1); // Schätzung, wächst bei Bedarf
+    result.lineStarts.append(0);
+
+    const auto* s = reinterpret_cast<const uchar*>(bytes.data());
+    const qsizetype n = bytes.size();
+
+    if (!isSupported(kernel))
+        kernel = Kernel::Scalar;
+
+    switch (kernel) {
+#if LUAEDITOR_UTF8_SIMD
+    case Kernel::Avx2:
+        scanAvx2(s, n, result);
+        break;
+    case Kernel::Sse2:
+        scanSse2(s, n, result);
+        break;
+#endif
+    default:
+        scanScalar(s, n, 0, n, result);
+        break;
+    }
+    return result;
+}
+
+QByteArrayView Utf8Ingest::line(QByteArrayView bytes, const Result& result, qsizetype index)
+{
+    if (index < 0 || index >= result.lineStarts.size())
+        return {};
+
+    const qsizetype start = result.lineStarts.at(index);
+    qsizetype end = index + 1 < result.lineStarts.size() ? result.lineStarts.at(index + 1) - 1
+                                                          : bytes.size();
+    if (end > start && bytes.at(end - 1) == '\r')
+        --end;
+    return bytes.sliced(start, end - start);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QList>
+#include <QtGlobal>
+
+/**
+ * Byte-Ingest für Lua-Quellen (UTF-8) ohne Umweg über QTextStream/QString:
+ *  - ein Durchlauf validiert UTF-8 und baut die Tabelle der Zeilenanfänge
+ *  - reine ASCII-Blöcke laufen über AVX2 (32 Byte) bzw. SSE2 (16 Byte): ein
+ *    Movemask für das High-Bit, einer für '\n'; nur Blöcke mit Nicht-ASCII-Bytes
+ *    werden skalar validiert
+ *  - der Kernel wird einmal zur Laufzeit per CPU-Erkennung gewählt; außerhalb von
+ *    x86-64 mit GCC/Clang bleibt nur der skalare Pfad
+ *  - die Zeilen können direkt an LuaLexer::tokenizeUtf8Line() gehen
+ */
+class Utf8Ingest
+{
+public:
+    enum class Kernel : quint8 {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    struct Result {
+        QList<qsizetype> lineStarts; // Byte-Offset jeder Zeile, erste Zeile = 0
+        qsizetype errorOffset = -1;  // erstes ungültiges Byte, -1 = gültiges UTF-8
+        bool ascii = true;           // nur Bytes < 0x80
+
+        [[nodiscard]] bool isValid() const { return errorOffset < 0; }
+        [[nodiscard]] qsizetype lineCount() const { return lineStarts.size(); }
+    };
+
+    // Mit dem besten verfügbaren Kernel
+    static Result scan(QByteArrayView bytes);
+    // Mit einem bestimmten Kernel (Tests/Benchmarks); nicht unterstützte fallen auf Scalar zurück
+    static Result scan(QByteArrayView bytes, Kernel kernel);
+
+    [[nodiscard]] static Kernel bestKernel();
+    [[nodiscard]] static bool isSupported(Kernel kernel);
+    [[nodiscard]] static const char* kernelName(Kernel kernel);
+
+    // Zeile index ohne abschließendes "\n" bzw. "\r\n"
+    static QByteArrayView line(QByteArrayView bytes, const Result& result, qsizetype index);
+};
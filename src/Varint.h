@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * LEB128-Varints für kompakte, delta-codierte Listen (ReferenceIndex, TrigramIndex):
+ * 7 Bit pro Byte, gesetztes Hochbit = es folgt noch ein Byte.
+ */
+namespace Varint {
+
+inline void put(QByteArray& out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+inline quint32 get(const QByteArray& in, qsizetype& offset)
+{
+    quint32 value = 0;
+    int shift = 0;
+    while (offset < in.size()) {
+        const auto byte = static_cast<quint8>(in.at(offset++));
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    return value;
+}
+
+} // namespace Varint
@@ -0,0 +1,284 @@
+#include "WorkspaceIndex.h"
+#include "Log.h"
+#include "Trace.h"
+#include "Utf8Ingest.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+
+namespace {
+    struct FileResult {
+        SymbolTable table;
+        qint64 bytes = 0;
+        qint64 lines = 0;
+        bool ok = false;
+    };
+
+    QString kindName(SymbolKind kind) {
+        switch (kind) {
+        case SymbolKind::Table:      return u"table"_qs;
+        case SymbolKind::Function:   return u"function"_qs;
+        case SymbolKind::Method:     return u"method"_qs;
+        case SymbolKind::Field:      return u"field"_qs;
+        case SymbolKind::Variable:   return u"variable"_qs;
+        case SymbolKind::Metamethod: return u"metamethod"_qs;
+        }
+        return u"unknown"_qs;
+    }
+
+    template <typename Hash>
+    QStringList sortedKeys(const Hash& hash) {
+        QStringList keys = hash.keys();
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    // Strings werden im Binärformat einmal abgelegt und per Index referenziert
+    class StringTable {
+    public:
+        quint32 add(const QString& text) {
+            const auto it = m_index.constFind(text);
+            if (it != m_index.constEnd()) return it.value();
+            const auto index = static_cast<quint32>(m_strings.size());
+            m_index.insert(text, index);
+            m_strings.append(text);
+            return index;
+        }
+        const QStringList& strings() const { return m_strings; }
+
+    private:
+        QHash<QString, quint32> m_index;
+        QStringList m_strings;
+    };
+}
+
+double WorkspaceIndex::Stats::megabytesPerSecond() const
+{
+    return parseNs > 0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (static_cast<double>(parseNs) / 1e9) : 0.0;
+}
+
+double WorkspaceIndex::Stats::filesPerSecond() const
+{
+    return parseNs > 0 ? static_cast<double>(files) / (static_cast<double>(parseNs) / 1e9) : 0.0;
+}
+
+bool WorkspaceIndex::build(const Options& options)
+{
+    TRACE_SCOPE("WorkspaceIndex::build");
+
+    m_table.clear();
+    m_files.clear();
+    m_stats = Stats{};
+    m_error.clear();
+
+    const QDir root(options.root);
+    if (options.root.isEmpty() || !root.exists()) {
+        m_error = u"Workspace root not found: %1"_qs.arg(options.root);
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QDirIterator it(root.absolutePath(), options.nameFilters, QDir::Files | QDir::NoSymLinks,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+        m_files.append(root.relativeFilePath(it.next()));
+    std::sort(m_files.begin(), m_files.end());
+    m_stats.scanNs = timer.nsecsElapsed();
+
+    // Eigener Pool: die Threadanzahl ist Teil des Benchmarks und soll den globalen Pool nicht verstellen
+    QThreadPool pool;
+    pool.setMaxThreadCount(options.threads > 0 ? options.threads : QThread::idealThreadCount());
+    m_stats.threads = pool.maxThreadCount();
+
+    timer.restart();
+    const QString rootPath = root.absolutePath();
+    const QList<FileResult> results = QtConcurrent::blockingMapped(&pool, m_files, [rootPath](const QString& relative) {
+        FileResult result;
+        QFile file(QDir(rootPath).filePath(relative));
+        if (!file.open(QIODevice::ReadOnly)) {
+            LOG_INFO(lcParser) << "Cannot read" << file.fileName() << file.errorString();
+            return result;
+        }
+        const QByteArray bytes = file.readAll();
+        result.ok = true;
+        result.bytes = bytes.size();
+
+        // Ein Durchlauf über die Bytes: Validierung, Zeilen, reines ASCII; BOM wie im Editor überspringen
+        QByteArrayView source(bytes);
+        if (source.startsWith("\xEF\xBB\xBF")) source = source.sliced(3);
+        const Utf8Ingest::Result ingest = Utf8Ingest::scan(source);
+        if (!ingest.isValid())
+            LOG_DEBUG(lcParser) << "Invalid UTF-8 in" << relative << "at byte" << ingest.errorOffset;
+        // lineStarts enthält auch den leeren Rest nach einem abschließenden '\n'
+        result.lines = ingest.lineCount() - (source.isEmpty() || source.endsWith('\n') ? 1 : 0);
+
+        QString code = ingest.ascii ? QString::fromLatin1(source) : QString::fromUtf8(source);
+        if (code.contains(u'\r')) code.replace(u"\r\n"_qs, u"\n"_qs);
+
+        // Pfade relativ zur Wurzel: der Dump ist zwischen Checkouts vergleichbar
+        LuaParser parser;
+        result.table = parser.parseOne(code, relative);
+        return result;
+    });
+    m_stats.parseNs = timer.nsecsElapsed();
+
+    // In Dateireihenfolge mergen: gleiche Ausgabe für jede Threadanzahl
+    timer.restart();
+    for (const FileResult& result : results) {
+        if (!result.ok) {
+            ++m_stats.failedFiles;
+            continue;
+        }
+        ++m_stats.files;
+        m_stats.bytes += result.bytes;
+        m_stats.lines += result.lines;
+        m_table.mergeFrom(result.table);
+    }
+    m_stats.mergeNs = timer.nsecsElapsed();
+
+    m_stats.symbols = static_cast<int>(m_table.symbols().size());
+    for (const QVector<Reference>& references : m_table.usages())
+        m_stats.references += static_cast<int>(references.size());
+
+    LOG_INFO(lcParser) << "Indexed" << m_stats.files << "files," << m_stats.symbols << "symbols with"
+                       << m_stats.threads << "threads";
+    return true;
+}
+
+bool WorkspaceIndex::write(QIODevice* out, Format format) const
+{
+    return format == Format::Json ? writeJson(out) : writeBinary(out);
+}
+
+bool WorkspaceIndex::writeJson(QIODevice* out) const
+{
+    QHash<QString, int> fileIndex;
+    QJsonArray files;
+    for (const QString& file : m_files) {
+        fileIndex.insert(file, static_cast<int>(files.size()));
+        files.append(file);
+    }
+
+    const QHash<QString, Symbol>& symbols = m_table.symbols();
+    QJsonArray symbolArray;
+    for (const QString& qname : sortedKeys(symbols)) {
+        const Symbol& symbol = symbols[qname];
+        QJsonObject entry;
+        entry[u"qname"_qs] = qname;
+        entry[u"kind"_qs] = kindName(symbol.kind);
+        entry[u"file"_qs] = fileIndex.value(symbol.filePath, -1);
+        entry[u"line"_qs] = symbol.pos.line;
+        entry[u"column"_qs] = symbol.pos.column;
+        if (!symbol.signature.isEmpty())
+            entry[u"signature"_qs] = symbol.signature;
+        symbolArray.append(entry);
+    }
+
+    // Referenzen kompakt: qname → [[file, line, column, isDefinition], ...]
+    const QHash<QString, QVector<Reference>>& usages = m_table.usages();
+    QJsonObject referenceObject;
+    for (const QString& qname : sortedKeys(usages)) {
+        QJsonArray list;
+        for (const Reference& reference : usages[qname]) {
+            list.append(QJsonArray{fileIndex.value(reference.filePath, -1), reference.pos.line,
+                                   reference.pos.column, reference.isDefinition ? 1 : 0});
+        }
+        referenceObject[qname] = list;
+    }
+
+    QJsonObject root;
+    root[u"version"_qs] = FORMAT_VERSION;
+    root[u"files"_qs] = files;
+    root[u"symbols"_qs] = symbolArray;
+    root[u"references"_qs] = referenceObject;
+    return out->write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+bool WorkspaceIndex::writeBinary(QIODevice* out) const
+{
+    // Aufbau: magic, version, Strings (UTF-8), Dateien, Symbole, Referenzen; alles über Indizes
+    StringTable strings;
+    QList<quint32> files;
+    for (const QString& file : m_files)
+        files.append(strings.add(file));
+
+    const QHash<QString, Symbol>& symbols = m_table.symbols();
+    const QStringList symbolNames = sortedKeys(symbols);
+    const QHash<QString, QVector<Reference>>& usages = m_table.usages();
+    const QStringList referenceNames = sortedKeys(usages);
+    for (const QString& qname : symbolNames) {
+        strings.add(qname);
+        strings.add(symbols[qname].signature);
+    }
+    for (const QString& qname : referenceNames)
+        strings.add(qname);
+
+    QDataStream stream(out);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << BINARY_MAGIC << FORMAT_VERSION;
+
+    stream << static_cast<quint32>(strings.strings().size());
+    for (const QString& text : strings.strings())
+        stream << text.toUtf8();
+    stream << files;
+
+    const QString* filesBegin = m_files.constData();
+    const QString* filesEnd = filesBegin + m_files.size();
+    auto fileId = [&](const QString& path) {
+        const QString* found = std::lower_bound(filesBegin, filesEnd, path);
+        return found != filesEnd && *found == path ? static_cast<qint32>(found - filesBegin) : qint32(-1);
+    };
+
+    stream << static_cast<quint32>(symbolNames.size());
+    for (const QString& qname : symbolNames) {
+        const Symbol& symbol = symbols[qname];
+        stream << strings.add(qname) << static_cast<quint8>(symbol.kind) << strings.add(symbol.signature)
+               << fileId(symbol.filePath) << static_cast<qint32>(symbol.pos.line)
+               << static_cast<qint32>(symbol.pos.column);
+    }
+
+    stream << static_cast<quint32>(referenceNames.size());
+    for (const QString& qname : referenceNames) {
+        const QVector<Reference>& references = usages[qname];
+        stream << strings.add(qname) << static_cast<quint32>(references.size());
+        for (const Reference& reference : references) {
+            stream << fileId(reference.filePath) << static_cast<qint32>(reference.pos.line)
+                   << static_cast<qint32>(reference.pos.column) << static_cast<quint8>(reference.isDefinition);
+        }
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+QString WorkspaceIndex::statsReport() const
+{
+    const Stats& s = m_stats;
+    QString report;
+    report += u"Indexed %1 files (%2 MiB, %3 lines) with %4 threads"_qs
+                  .arg(s.files)
+                  .arg(static_cast<double>(s.bytes) / (1024.0 * 1024.0), 0, 'f', 2)
+                  .arg(s.lines)
+                  .arg(s.threads);
+    if (s.failedFiles > 0)
+        report += u", %1 unreadable"_qs.arg(s.failedFiles);
+    report += u"\n  scan %1 ms, parse %2 ms, merge %3 ms"_qs
+                  .arg(static_cast<double>(s.scanNs) / 1e6, 0, 'f', 1)
+                  .arg(static_cast<double>(s.parseNs) / 1e6, 0, 'f', 1)
+                  .arg(static_cast<double>(s.mergeNs) / 1e6, 0, 'f', 1);
+    report += u"\n  throughput %1 MiB/s, %2 files/s"_qs
+                  .arg(s.megabytesPerSecond(), 0, 'f', 2)
+                  .arg(s.filesPerSecond(), 0, 'f', 1);
+    report += u"\n  %1 symbols, %2 references\n"_qs.arg(s.symbols).arg(s.references);
+    return report;
+}
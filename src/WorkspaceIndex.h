@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include "LuaParser.h"
+
+class QIODevice;
+
+/**
+ * Projektweiter Symbolindex ohne GUI (Headless-Modus "--index", CI, Benchmarks):
+ *  - sammelt alle *.lua unterhalb eines Wurzelverzeichnisses
+ *  - parst die Dateien parallel mit LuaParser::parseOne auf einem eigenen QThreadPool
+ *  - mergt in Dateireihenfolge, damit der Dump unabhängig von der Threadanzahl ist
+ *  - schreibt JSON oder ein kompaktes Binärformat (QDataStream, Pfad-/Namenstabellen)
+ */
+class WorkspaceIndex
+{
+public:
+    struct Options {
+        QString root;
+        int threads = 0;                                // 0 = QThread::idealThreadCount()
+        QStringList nameFilters{QStringLiteral("*.lua")};
+    };
+
+    struct Stats {
+        int files = 0;
+        int failedFiles = 0;  // nicht lesbar
+        qint64 bytes = 0;
+        qint64 lines = 0;
+        int symbols = 0;
+        int references = 0;
+        int threads = 0;
+        qint64 scanNs = 0;    // Dateisuche
+        qint64 parseNs = 0;   // Lesen + Parsen (parallel, Wanduhr)
+        qint64 mergeNs = 0;
+
+        [[nodiscard]] double megabytesPerSecond() const;
+        [[nodiscard]] double filesPerSecond() const;
+    };
+
+    enum class Format { Json, Binary };
+
+    static constexpr quint32 BINARY_MAGIC = 0x4C494458; // "LIDX"
+    static constexpr quint16 FORMAT_VERSION = 1;
+
+    bool build(const Options& options);
+
+    [[nodiscard]] const SymbolTable& symbolTable() const { return m_table; }
+    [[nodiscard]] const QStringList& files() const { return m_files; } // relativ zur Wurzel, sortiert
+    [[nodiscard]] const Stats& stats() const { return m_stats; }
+    [[nodiscard]] QString errorString() const { return m_error; }
+
+    bool write(QIODevice* out, Format format) const;
+    [[nodiscard]] QString statsReport() const; // mehrzeilig, für stderr
+
+private:
+    bool writeJson(QIODevice* out) const;
+    bool writeBinary(QIODevice* out) const;
+
+    SymbolTable m_table;
+    QStringList m_files;
+    Stats m_stats;
+    QString m_error;
+};
@@ -0,0 +1,145 @@
+#include "WorkspaceSearch.h"
+#include "Log.h"
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+    QRegularExpression compile(const TextQuery& query) {
+        QRegularExpression::PatternOptions options = QRegularExpression::MultilineOption;
+        if (!query.caseSensitive) options |= QRegularExpression::CaseInsensitiveOption;
+        return QRegularExpression(query.regex ? query.pattern : QRegularExpression::escape(query.pattern), options);
+    }
+}
+
+WorkspaceSearch::WorkspaceSearch(QObject* parent)
+    : QObject(parent)
+{
+}
+
+WorkspaceSearch::~WorkspaceSearch()
+{
+    cancel();
+}
+
+bool WorkspaceSearch::start(std::shared_ptr<const TrigramIndex> index, const TextQuery& query)
+{
+    TRACE_SCOPE("WorkspaceSearch::start");
+    cancel();
+    m_candidates = 0;
+    m_filesMatched = 0;
+    m_matches = 0;
+    m_error.clear();
+    m_root.clear();
+    m_indexedFiles = 0;
+
+    if (!index || query.pattern.isEmpty()) {
+        m_error = tr("Empty search");
+        return false;
+    }
+    if (const QRegularExpression regex = compile(query); !regex.isValid()) {
+        m_error = regex.errorString();
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QStringList candidates = index->candidates(query);
+    m_candidates = static_cast<int>(candidates.size());
+    m_root = index->root();
+    m_indexedFiles = index->stats().files;
+    LOG_DEBUG(lcFiles) << "Search" << query.pattern << ":" << m_candidates << "of" << m_indexedFiles
+                       << "files are candidates (" << timer.nsecsElapsed() / 1000 << "us )";
+
+    m_watcher = new QFutureWatcher<FileResult>(this);
+    connect(m_watcher, &QFutureWatcherBase::resultReadyAt, this, &WorkspaceSearch::onResultReady);
+    connect(m_watcher, &QFutureWatcherBase::finished, this, &WorkspaceSearch::onFinished);
+    m_watcher->setFuture(QtConcurrent::mapped(candidates, [query](const QString& path) {
+        return searchFile(path, query);
+    }));
+    return true;
+}
+
+void WorkspaceSearch::cancel()
+{
+    if (!m_watcher) return;
+    m_watcher->disconnect(this);
+    m_watcher->cancel();
+    // Laufende Worker halten nur Kopien; der Watcher räumt sich nach ihrem Ende selbst weg
+    if (m_watcher->isFinished())
+        m_watcher->deleteLater();
+    else
+        connect(m_watcher, &QFutureWatcherBase::finished, m_watcher, &QObject::deleteLater);
+    m_watcher = nullptr;
+}
+
+void WorkspaceSearch::onResultReady(int index)
+{
+    const FileResult result = m_watcher->resultAt(index);
+    if (result.matches.isEmpty()) return;
+    ++m_filesMatched;
+    m_matches += static_cast<int>(result.matches.size());
+    emit fileMatched(result);
+}
+
+void WorkspaceSearch::onFinished()
+{
+    QFutureWatcher<FileResult>* watcher = std::exchange(m_watcher, nullptr);
+    watcher->deleteLater();
+    emit finished(m_candidates, m_filesMatched, m_matches);
+}
+
+WorkspaceSearch::FileResult WorkspaceSearch::searchFile(const QString& path, const TextQuery& query)
+{
+    FileResult result;
+    result.path = path;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_INFO(lcFiles) << "Cannot read" << path << file.errorString();
+        return result;
+    }
+    const QString text = QString::fromUtf8(file.readAll());
+
+    // Zeilen nur bis zum jeweils nächsten Treffer durchzählen
+    int line = 1;
+    qsizetype lineStart = 0;
+    auto addMatch = [&](qsizetype offset, qsizetype length) {
+        for (qsizetype nl = text.indexOf(u'\n', lineStart); nl >= 0 && nl < offset; nl = text.indexOf(u'\n', lineStart)) {
+            lineStart = nl + 1;
+            ++line;
+        }
+        qsizetype lineEnd = text.indexOf(u'\n', lineStart);
+        if (lineEnd < 0) lineEnd = text.size();
+        const qsizetype shownEnd = lineEnd > lineStart && text.at(lineEnd - 1) == u'\r' ? lineEnd - 1 : lineEnd;
+
+        Match match;
+        match.line = line;
+        match.column = static_cast<int>(offset - lineStart) + 1;
+        match.length = static_cast<int>(std::min(length, lineEnd - offset));
+        match.text = text.mid(lineStart, shownEnd - lineStart);
+        result.matches.append(match);
+    };
+
+    if (!query.regex) {
+        const Qt::CaseSensitivity cs = query.caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+        for (qsizetype at = text.indexOf(query.pattern, 0, cs); at >= 0;
+             at = text.indexOf(query.pattern, at + query.pattern.size(), cs))
+            addMatch(at, query.pattern.size());
+        return result;
+    }
+
+    QRegularExpressionMatchIterator it = compile(query).globalMatch(text);
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        if (match.capturedLength() == 0) continue; // "^" o.ä. würde jede Zeile melden
+        addMatch(match.capturedStart(), match.capturedLength());
+    }
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <memory>
+
+#include "TrigramIndex.h"
+
+/**
+ * Volltextsuche im Workspace über einen TrigramIndex:
+ *  - start() holt die Kandidaten aus dem Index (kein Dateizugriff) und verifiziert sie
+ *    parallel per QtConcurrent::mapped; gelesen werden nur die Kandidaten
+ *  - Treffer kommen dateiweise über fileMatched(), sobald eine Datei geprüft ist
+ *  - ein neuer start() oder cancel() verwirft die laufende Suche, ihre Signale kommen nicht mehr an
+ *  - root() und indexedFiles() halten den Stand des Index beim Start fest; der Index selbst
+ *    darf danach ersetzt oder verworfen werden
+ *  - Regex wird mit MultilineOption auf den ganzen Dateitext angewandt ('^'/'$' je Zeile)
+ */
+class WorkspaceSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Match {
+        int line = 0;       // 1-basiert
+        int column = 0;     // 1-basiert (UTF-16)
+        int length = 0;     // höchstens bis zum Zeilenende
+        QString text;       // ganze Zeile ohne Zeilenumbruch
+    };
+
+    struct FileResult {
+        QString path;       // absolut
+        QList<Match> matches;
+    };
+
+    explicit WorkspaceSearch(QObject* parent = nullptr);
+    ~WorkspaceSearch() override;
+
+    // false bei leerem oder ungültigem Muster (errorString())
+    bool start(std::shared_ptr<const TrigramIndex> index, const TextQuery& query);
+    void cancel();
+
+    [[nodiscard]] bool isRunning() const { return m_watcher != nullptr && m_watcher->isRunning(); }
+    [[nodiscard]] int candidateCount() const { return m_candidates; }
+    [[nodiscard]] QString root() const { return m_root; }              // Wurzel des Index beim Start
+    [[nodiscard]] int indexedFiles() const { return m_indexedFiles; }  // Dateien im Index beim Start
+    [[nodiscard]] QString errorString() const { return m_error; }
+
+    // Eine Datei prüfen (läuft auf den Worker-Threads; auch für Tests)
+    [[nodiscard]] static FileResult searchFile(const QString& path, const TextQuery& query);
+
+signals:
+    void fileMatched(const WorkspaceSearch::FileResult& result);
+    void finished(int filesRead, int filesMatched, int matches);
+
+private:
+    void onResultReady(int index);
+    void onFinished();
+
+    QFutureWatcher<FileResult>* m_watcher{nullptr};
+    int m_candidates = 0;
+    QString m_root;
+    int m_indexedFiles = 0;
+    int m_filesMatched = 0;
+    int m_matches = 0;
+    QString m_error;
+};
@@ -1,17 +1,204 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
 #include <QStyleFactory>
 #include <QDir>
 #include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
 #include <QLocale>
 #include <QTranslator>
 #include <QMessageBox>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "MainWindow.h"
+#include "Log.h"
+#include "LspServer.h"
+#include "WorkspaceIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace {
+    // "--name" oder "--name=wert" irgendwo in argv
+    bool hasOption(int argc, char *argv[], const char *name)
+    {
+        const std::size_t length = std::strlen(name);
+        for (int i = 1; i < argc; ++i) {
+            if (std::strncmp(argv[i], name, length) == 0 && (argv[i][length] == '\0' || argv[i][length] == '='))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Headless-Indexer ohne Widgets (CI, Benchmarks auf echten Projekten):
+     *
+     *   LuaAutoCompleteQt6 --index scripts/ --threads 8 --format binary --output index.bin
+     *
+     * Der Dump geht nach --output (Standard: stdout), die Statistik immer nach stderr.
+     */
+    int runHeadlessIndex(int argc, char *argv[])
+    {
+        QCoreApplication app(argc, argv);
+        QCoreApplication::setApplicationName("LuaAutoCompleteQt6");
+        QCoreApplication::setApplicationVersion("1.0.0");
+
+        // Log-Ausgaben nicht in den Dump auf stdout mischen
+        Log::installRingBufferSink(Log::DEFAULT_RING_CAPACITY, false);
+
+        QCommandLineParser cli;
+        cli.setApplicationDescription("Headless Lua workspace indexer");
+        cli.addHelpOption();
+        cli.addVersionOption();
+
+        const QCommandLineOption indexOpt("index", "Workspace root to index.", "dir");
+        const QCommandLineOption threadsOpt("threads", "Parser threads (0 = all cores).", "n", "0");
+        const QCommandLineOption formatOpt("format", "Dump format: json or binary.", "format", "json");
+        const QCommandLineOption outputOpt("output", "Dump file ('-' = stdout).", "path", "-");
+        cli.addOptions({indexOpt, threadsOpt, formatOpt, outputOpt});
+        cli.process(app);
+
+        QTextStream err(stderr);
+        const QString format = cli.value(formatOpt);
+        if (format != u"json"_qs && format != u"binary"_qs) {
+            err << "Unknown format: " << format << Qt::endl;
+            return 2;
+        }
+
+        WorkspaceIndex::Options options;
+        options.root = cli.value(indexOpt);
+        options.threads = cli.value(threadsOpt).toInt();
+
+        WorkspaceIndex index;
+        if (!index.build(options)) {
+            err << index.errorString() << Qt::endl;
+            return 1;
+        }
+
+        QFile out;
+        const QString outPath = cli.value(outputOpt);
+        bool opened = false;
+        if (outPath == u"-"_qs) {
+            opened = out.open(stdout, QIODevice::WriteOnly);
+        } else {
+            out.setFileName(outPath);
+            opened = out.open(QIODevice::WriteOnly);
+        }
+        if (!opened) {
+            err << "Cannot write " << outPath << ": " << out.errorString() << Qt::endl;
+            return 1;
+        }
+        if (!index.write(&out, format == u"binary"_qs ? WorkspaceIndex::Format::Binary
+                                                      : WorkspaceIndex::Format::Json)) {
+            err << "Writing the index failed" << Qt::endl;
+            return 1;
+        }
+        out.close();
+
+        err << index.statsReport();
+        err.flush();
+        return index.stats().failedFiles > 0 ? 3 : 0;
+    }
+
+    /**
+     * Language Server über stdio (JSON-RPC, Content-Length-Framing):
+     *
+     *   LuaAutoCompleteQt6 --lsp
+     *
+     * Ein Lesethread liest Header und Body blockierend von stdin, LspServer analysiert in
+     * einem eigenen QThread, der Hauptthread schreibt nur die Antworten nach stdout.
+     */
+    int runLanguageServer(int argc, char *argv[])
+    {
+        QCoreApplication app(argc, argv);
+        QCoreApplication::setApplicationName("LuaAutoCompleteQt6");
+        QCoreApplication::setApplicationVersion("1.0.0");
+
+        // stdout gehört dem Protokoll
+        Log::installRingBufferSink(Log::DEFAULT_RING_CAPACITY, qEnvironmentVariableIsSet("LUAEDITOR_LOG_STDERR"));
+
+        QFile out;
+        if (!out.open(stdout, QIODevice::WriteOnly))
+            return 1;
+
+        QThread worker;
+        worker.setObjectName("lsp-worker");
+        auto *server = new LspServer;
+        server->moveToThread(&worker);
+        QObject::connect(&worker, &QThread::finished, server, &QObject::deleteLater);
+        QObject::connect(server, &LspServer::send, &app, [&out](const QByteArray& framed) {
+            out.write(framed);
+            out.flush();
+        });
+        QObject::connect(server, &LspServer::exitRequested, &app, [](int code) { QCoreApplication::exit(code); });
+        worker.start();
+
+        // Blockierendes Lesen im eigenen Thread; bei EOF (Client weg) beenden.
+        // fgets() lässt sich nicht abbrechen, der Thread ist daher losgelöst und kann
+        // app.exec() überleben. Er stellt nur unter dem Lock zu, solange closed nicht
+        // gesetzt ist; danach fasst er weder server noch die Application mehr an.
+        struct StdinBridge {
+            QMutex mutex;
+            bool closed = false;
+        };
+        auto bridge = std::make_shared<StdinBridge>();
+
+        std::thread([server, bridge] {
+            QByteArray header;
+            char line[1024];
+            while (std::fgets(line, sizeof line, stdin)) {
+                header += line;
+                if (std::strcmp(line, "\r\n") != 0 && std::strcmp(line, "\n") != 0)
+                    continue;
+                const qsizetype length = LspServer::contentLength(header);
+                QByteArray body(std::max<qsizetype>(length, 0), Qt::Uninitialized);
+                if (std::fread(body.data(), 1, static_cast<std::size_t>(body.size()), stdin) != static_cast<std::size_t>(body.size()))
+                    break;
+                QMutexLocker lock(&bridge->mutex);
+                if (bridge->closed) return;
+                QMetaObject::invokeMethod(server, [server, bytes = header + body] { server->receive(bytes); },
+                                          Qt::QueuedConnection);
+                header.clear();
+            }
+            QMutexLocker lock(&bridge->mutex);
+            if (!bridge->closed)
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [] { QCoreApplication::exit(0); }, Qt::QueuedConnection);
+        }).detach();
+
+        const int code = app.exec();
+        {
+            // Ab hier keine Zustellung mehr: server wird mit dem Worker gelöscht, app beim Return
+            QMutexLocker lock(&bridge->mutex);
+            bridge->closed = true;
+        }
+        worker.quit();
+        worker.wait();
+        return code;
+    }
+}
 
 int main(int argc, char *argv[])
 {
+    // Vor QApplication prüfen: Indexer und Language Server brauchen kein Display
+    if (hasOption(argc, argv, "--index"))
+        return runHeadlessIndex(argc, argv);
+    if (hasOption(argc, argv, "--lsp"))
+        return runLanguageServer(argc, argv);
+
     QApplication app(argc, argv);
 
+    // Diagnose-Meldungen im Speicher halten; Debug-Builds geben zusätzlich alles aus
+#ifdef NDEBUG
+    Log::installRingBufferSink(Log::DEFAULT_RING_CAPACITY, qEnvironmentVariableIsSet("LUAEDITOR_LOG_STDERR"));
+#else
+    Log::installRingBufferSink(Log::DEFAULT_RING_CAPACITY, true);
+#endif
+
     // Set application properties
     app.setApplicationName("LuaAutoCompleteQt6");
     app.setApplicationVersion("1.0.0");
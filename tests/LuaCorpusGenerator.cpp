@@ -0,0 +1,376 @@
+#include "LuaCorpusGenerator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+// SplitMix64: klein, schnell und auf allen Plattformen bitgleich.
+// Hinweis: pro Ausdruck höchstens ein Zufallsaufruf bzw. verkettete .arg()-Aufrufe,
+// da die Auswertungsreihenfolge von Funktionsargumenten nicht festgelegt ist.
+class Rng {
+public:
+    explicit Rng(quint64 seed) : m_state(seed) {}
+
+    quint64 next() {
+        quint64 z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    int below(int n) { return n <= 0 ? 0 : static_cast<int>(next() % static_cast<quint64>(n)); }
+    int range(int lo, int hi) { return lo + below(hi - lo + 1); }
+    bool chance(double p) { return static_cast<double>(next() >> 11) * 0x1.0p-53 < p; }
+
+private:
+    quint64 m_state;
+};
+
+constexpr const char* kWords[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+    "index", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa",
+    "quest", "romeo", "sierra", "tango", "uniform", "victor", "whiskey", "xray",
+    "end", "function", "local", "then", "return", "--", "[[", "]]"
+};
+constexpr int kWordCount = static_cast<int>(sizeof(kWords) / sizeof(kWords[0]));
+
+// Sammelt Ausgabe und zählt Zeilen
+class Emitter {
+public:
+    void line(const QString& text) {
+        m_out += text;
+        m_out += u'\n';
+        ++m_lines;
+    }
+    void blank() { line(QString()); }
+    [[nodiscard]] int lines() const { return m_lines; }
+    QString take() { return std::move(m_out); }
+
+private:
+    QString m_out;
+    int m_lines = 0;
+};
+
+QString indentOf(int level) { return QString(level * 4, u' '); }
+
+QString identifierFor(const QString& moduleName) {
+    QString id;
+    id.reserve(moduleName.size());
+    for (const QChar c : moduleName)
+        id += (c.isLetterOrNumber() ? c : u'_');
+    if (id.isEmpty() || id.at(0).isDigit()) id.prepend(u'M');
+    return id;
+}
+
+class FileBuilder {
+public:
+    FileBuilder(const CorpusOptions& options, Rng& rng, const QString& tag)
+        : m_opt(options), m_rng(rng), m_tag(tag) {}
+
+    Emitter& out() { return m_out; }
+
+    void section(int index) {
+        const int total = m_opt.classWeight + m_opt.dataWeight + m_opt.functionWeight
+                        + m_opt.longStringWeight + m_opt.minifiedWeight;
+        int pick = m_rng.below(qMax(1, total));
+        if ((pick -= m_opt.classWeight) < 0)       classHierarchy(index);
+        else if ((pick -= m_opt.dataWeight) < 0)   dataTable(index);
+        else if ((pick -= m_opt.functionWeight) < 0) freeFunctions(index);
+        else if ((pick -= m_opt.longStringWeight) < 0) longString(index);
+        else                                       minifiedLine(index);
+        m_out.blank();
+    }
+
+private:
+    int bodyLines() {
+        const double d = std::clamp(m_opt.symbolDensity, 0.01, 1.0);
+        const int base = static_cast<int>((1.0 - d) / d * 2.0 + 0.5);
+        return std::clamp(base + m_rng.below(3), 1, 80);
+    }
+
+    QString number() {
+        switch (m_rng.below(4)) {
+        case 0:  return QString::number(m_rng.below(1000));
+        case 1:  return QString::number(m_rng.below(100000)) + u".5"_qs;
+        case 2:  return u"0x"_qs + QString::number(m_rng.below(65536), 16).toUpper();
+        default: {
+            const int mantissa = m_rng.below(10);
+            return QString::number(mantissa) + u"e"_qs + QString::number(m_rng.below(8));
+        }
+        }
+    }
+
+    QString word() { return QString::fromLatin1(kWords[m_rng.below(kWordCount)]); }
+
+    void statement(int level, const QString& self, int methodCount) {
+        const QString ind = indentOf(level);
+        switch (m_rng.below(7)) {
+        case 0:
+            m_out.line(ind + u"local v%1 = a + %2"_qs.arg(m_rng.below(20)).arg(number()));
+            break;
+        case 1:
+            m_out.line(ind + u"%1.field%2 = b or %3"_qs.arg(self).arg(m_rng.below(12)).arg(number()));
+            break;
+        case 2:
+            if (level < 6) {
+                m_out.line(ind + u"if %1.field%2 then"_qs.arg(self).arg(m_rng.below(12)));
+                statement(level + 1, self, methodCount);
+                m_out.line(ind + u"end"_qs);
+                break;
+            }
+            [[fallthrough]];
+        case 3:
+            if (level < 6) {
+                m_out.line(ind + u"for i = 1, %1 do"_qs.arg(m_rng.range(2, 64)));
+                m_out.line(indentOf(level + 1) + u"table.insert(%1.items, i)"_qs.arg(self));
+                m_out.line(ind + u"end"_qs);
+                break;
+            }
+            [[fallthrough]];
+        case 4:
+            m_out.line(ind + u"print(string.format(\"%s %d\", \"%1\", %2))"_qs.arg(word()).arg(number()));
+            break;
+        case 5:
+            m_out.line(ind + u"%1:method%2(a, b)"_qs.arg(self).arg(m_rng.below(qMax(1, methodCount))));
+            break;
+        default:
+            m_out.line(ind + u"local s = \"%1 -- %2 \\\"quoted\\\"\""_qs.arg(word()).arg(word()));
+            break;
+        }
+    }
+
+    void classHierarchy(int index) {
+        const QString base = u"%1_Entity%2"_qs.arg(m_tag).arg(index);
+        m_out.line(u"-- Klassenhierarchie %1"_qs.arg(base));
+
+        QString parent;
+        for (int level = 0; level < qMax(1, m_opt.classDepth); ++level) {
+            const QString cls = base + u"_L"_qs + QString::number(level);
+            if (parent.isEmpty()) {
+                m_out.line(cls + u" = {}"_qs);
+            } else {
+                m_out.line(u"%1 = setmetatable({}, { __index = %2 })"_qs.arg(cls, parent));
+            }
+            m_out.line(u"%1.__index = %1"_qs.arg(cls));
+            m_out.blank();
+
+            m_out.line(u"function %1:new(name)"_qs.arg(cls));
+            m_out.line(u"    local o = setmetatable({}, self)"_qs);
+            m_out.line(u"    o.name = name"_qs);
+            m_out.line(u"    o.items = {}"_qs);
+            m_out.line(u"    return o"_qs);
+            m_out.line(u"end"_qs);
+            m_out.blank();
+
+            const int methods = m_rng.range(2, 6);
+            for (int m = 0; m < methods; ++m) {
+                m_out.line(u"function %1:method%2(a, b)"_qs.arg(cls).arg(m));
+                const int body = bodyLines();
+                for (int i = 0; i < body; ++i)
+                    statement(1, u"self"_qs, methods);
+                m_out.line(u"    return a"_qs);
+                m_out.line(u"end"_qs);
+                m_out.blank();
+            }
+            if (m_rng.chance(0.5)) {
+                m_out.line(u"%1.static%2 = function(x) return x * %3 end"_qs.arg(cls).arg(level).arg(number()));
+                m_out.blank();
+            }
+            parent = cls;
+        }
+    }
+
+    void dataEntries(int level, int count) {
+        const QString ind = indentOf(level);
+        for (int i = 0; i < count; ++i) {
+            const int kind = m_rng.below(level < m_opt.tableNesting ? 4 : 3);
+            switch (kind) {
+            case 0:
+                m_out.line(ind + u"key%1 = %2,"_qs.arg(i).arg(number()));
+                break;
+            case 1:
+                m_out.line(ind + u"\"%1_%2\","_qs.arg(word()).arg(i));
+                break;
+            case 2:
+                m_out.line(ind + u"[%1] = { x = %2, y = %3, tag = '%4' },"_qs
+                               .arg(i + 1).arg(number()).arg(number()).arg(word()));
+                break;
+            default:
+                m_out.line(ind + u"nested%1 = {"_qs.arg(i));
+                dataEntries(level + 1, m_rng.range(2, 12));
+                m_out.line(ind + u"},"_qs);
+                break;
+            }
+        }
+    }
+
+    void dataTable(int index) {
+        m_out.line(u"%1_Data%2 = {"_qs.arg(m_tag).arg(index));
+        dataEntries(1, m_rng.range(40, 300));
+        m_out.line(u"}"_qs);
+    }
+
+    void freeFunctions(int index) {
+        const QString util = u"%1_util%2"_qs.arg(m_tag).arg(index);
+        m_out.line(util + u" = {}"_qs);
+        const int count = m_rng.range(2, 8);
+        for (int f = 0; f < count; ++f) {
+            if (m_rng.chance(0.5)) {
+                m_out.line(u"local function helper%1_%2(x, y)"_qs.arg(index).arg(f));
+            } else {
+                m_out.line(u"function %1.fn%2(x, y)"_qs.arg(util).arg(f));
+            }
+            const int body = bodyLines();
+            for (int i = 0; i < body; ++i)
+                statement(1, util, count);
+            m_out.line(u"    return x"_qs);
+            m_out.line(u"end"_qs);
+        }
+    }
+
+    void longString(int index) {
+        const int level = m_rng.below(4);
+        const QString eq(level, u'=');
+        const bool comment = m_rng.chance(0.4);
+        if (comment)
+            m_out.line(u"--[%1["_qs.arg(eq));
+        else
+            m_out.line(u"local text%1 = [%2["_qs.arg(index).arg(eq));
+
+        const int lines = m_rng.range(10, 120);
+        for (int i = 0; i < lines; ++i) {
+            QString text;
+            const int words = m_rng.range(3, 14);
+            for (int w = 0; w < words; ++w) {
+                if (w) text += u' ';
+                const QString next = word();
+                text += (level == 0 && next == u"]]"_qs) ? u"]"_qs : next;
+            }
+            // Schließende Klammern anderer Level dürfen den String nicht beenden
+            if (level > 0 && m_rng.chance(0.1)) text += u" ]]"_qs;
+            m_out.line(text);
+        }
+        m_out.line(u"]%1]"_qs.arg(eq));
+    }
+
+    void minifiedLine(int index) {
+        const QString tbl = u"%1_min%2"_qs.arg(m_tag).arg(index);
+        QString text = tbl + u"={};"_qs;
+        int i = 0;
+        while (text.size() < m_opt.minifiedLineLength) {
+            switch (m_rng.below(4)) {
+            case 0:  text += u"local a%1=(%2+%3)*%4;"_qs.arg(i).arg(number()).arg(number()).arg(number()); break;
+            case 1:  text += u"%1.f%2=function(x)return x+%2 end;"_qs.arg(tbl).arg(i); break;
+            case 2:  text += u"if a%1 and a%1>%2 then a%1=0 end;"_qs.arg(i).arg(number()); break;
+            default: text += u"%1.s%2=\"%3\";"_qs.arg(tbl).arg(i).arg(word()); break;
+            }
+            ++i;
+        }
+        m_out.line(text);
+    }
+
+    const CorpusOptions& m_opt;
+    Rng& m_rng;
+    QString m_tag;
+    Emitter m_out;
+};
+
+} // namespace
+
+LuaCorpusGenerator::LuaCorpusGenerator(const CorpusOptions& options)
+    : m_options(options)
+{
+}
+
+quint64 LuaCorpusGenerator::stableHash(const QString& text)
+{
+    quint64 h = 0xCBF29CE484222325ull;
+    const QByteArray utf8 = text.toUtf8();
+    for (const char c : utf8) {
+        h ^= static_cast<quint8>(c);
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+QString LuaCorpusGenerator::generateFile(const QString& moduleName, const QStringList& requires) const
+{
+    Rng rng(m_options.seed ^ stableHash(moduleName));
+    const QString tag = identifierFor(moduleName.section(u'.', -1));
+    FileBuilder builder(m_options, rng, tag);
+    Emitter& out = builder.out();
+
+    out.line(u"-- Generated by lua_corpus_gen (seed %1) - module %2"_qs.arg(m_options.seed).arg(moduleName));
+    for (int i = 0; i < requires.size(); ++i)
+        out.line(u"local dep%1 = require(\"%2\")"_qs.arg(i).arg(requires.at(i)));
+    out.line(u"local M = {}"_qs);
+    out.blank();
+
+    int section = 0;
+    while (out.lines() < m_options.lines)
+        builder.section(section++);
+
+    for (int i = 0; i < requires.size(); ++i)
+        out.line(u"M.api%1 = function(...) return dep%1 end"_qs.arg(i));
+    out.line(u"return M"_qs);
+    return out.take();
+}
+
+QList<LuaCorpusGenerator::ModuleSpec> LuaCorpusGenerator::planWorkspace(const WorkspaceOptions& ws) const
+{
+    Rng rng(m_options.seed ^ 0x57A7E5ull);
+    QList<ModuleSpec> modules;
+    modules.reserve(ws.moduleCount);
+
+    for (int i = 0; i < ws.moduleCount; ++i) {
+        ModuleSpec spec;
+        spec.name = u"pkg_%1.mod_%2"_qs.arg(i % qMax(1, ws.packages)).arg(i, 4, 10, QChar(u'0'));
+        modules.append(spec);
+    }
+
+    for (int i = 0; i < ws.moduleCount; ++i) {
+        QSet<int> picked;
+        const int wanted = qMin(ws.requiresPerModule, i);
+        while (picked.size() < wanted)
+            picked.insert(rng.below(i)); // nur Vorgänger → DAG
+        if (i + 1 < ws.moduleCount && rng.chance(ws.cycleProbability))
+            picked.insert(rng.range(i + 1, ws.moduleCount - 1)); // Rückwärtskante → Zyklus möglich
+
+        QList<int> sorted(picked.begin(), picked.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (const int dep : sorted)
+            modules[i].requires.append(modules.at(dep).name);
+    }
+    return modules;
+}
+
+QStringList LuaCorpusGenerator::writeWorkspace(const QString& rootDir, const WorkspaceOptions& ws) const
+{
+    QStringList written;
+    const QList<ModuleSpec> modules = planWorkspace(ws);
+    const QDir root(rootDir);
+
+    auto writeFile = [&](const QString& relPath, const QString& content) {
+        const QString path = root.filePath(relPath);
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(content.toUtf8());
+            written.append(path);
+        }
+    };
+
+    QStringList entryRequires;
+    for (const ModuleSpec& spec : modules) {
+        const QString rel = QString(spec.name).replace(u'.', u'/') + u".lua"_qs;
+        writeFile(rel, generateFile(spec.name, spec.requires));
+    }
+    for (int i = qMax(0, static_cast<int>(modules.size()) - 10); i < modules.size(); ++i)
+        entryRequires.append(modules.at(i).name);
+    writeFile(u"main.lua"_qs, generateFile(u"main"_qs, entryRequires));
+
+    return written;
+}
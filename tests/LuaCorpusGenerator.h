@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+/**
+ * Deterministischer Generator für synthetische Lua-Korpora (Benchmarks, Soak-Tests):
+ *  - tiefe Klassenhierarchien mit "Class:method"-Definitionen
+ *  - große, verschachtelte Datentabellen
+ *  - lange Strings / Kommentare ([[ ]], [==[ ]==], --[[ ]])
+ *  - pathologisch lange, "minifizierte" Zeilen
+ *  - Multi-Modul-Workspaces mit require()-Graphen (gepunktete Modulnamen)
+ *
+ * Gleicher Seed + gleiche Optionen ergeben auf jeder Maschine byte-identische Ausgabe:
+ * eigener PRNG (SplitMix64), keine std::*_distribution, kein qHash (prozess-seeded).
+ */
+struct CorpusOptions {
+    quint64 seed = 1;
+    int lines = 10000;           // Zielzeilen pro Datei (Untergrenze)
+    double symbolDensity = 0.35; // Anteil Definitionszeilen (0..1), steuert Rumpflängen
+    int classDepth = 4;          // Länge der Vererbungsketten
+    int tableNesting = 3;        // Verschachtelungstiefe der Datentabellen
+    int minifiedLineLength = 4000; // Zeichen pro minifizierter Zeile
+
+    // Mischungsgewichte der Abschnittstypen
+    int classWeight = 40;
+    int dataWeight = 20;
+    int functionWeight = 25;
+    int longStringWeight = 10;
+    int minifiedWeight = 5;
+};
+
+struct WorkspaceOptions {
+    int moduleCount = 100;
+    int requiresPerModule = 4;
+    int packages = 8;            // Verzeichnisse pkg_N/
+    double cycleProbability = 0.02; // Anteil zusätzlicher Rückwärtskanten (Zyklen)
+};
+
+class LuaCorpusGenerator
+{
+public:
+    explicit LuaCorpusGenerator(const CorpusOptions& options = {});
+
+    // Einzelne Datei; requires werden als "local depN = require(...)" vorangestellt
+    [[nodiscard]] QString generateFile(const QString& moduleName, const QStringList& requires = {}) const;
+
+    // Modulnamen ("pkg_3.mod_0042") und ihre requires, ohne etwas zu schreiben
+    struct ModuleSpec {
+        QString name;
+        QStringList requires;
+    };
+    [[nodiscard]] QList<ModuleSpec> planWorkspace(const WorkspaceOptions& ws) const;
+
+    // Schreibt den Workspace unter rootDir; liefert die geschriebenen Dateipfade
+    QStringList writeWorkspace(const QString& rootDir, const WorkspaceOptions& ws) const;
+
+    // Stabiler String-Hash (FNV-1a über UTF-8) zum Ableiten von Teil-Seeds
+    [[nodiscard]] static quint64 stableHash(const QString& text);
+
+private:
+    CorpusOptions m_options;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QtTest/QtTest>
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QTemporaryDir>
+
+/**
+ * Gemeinsame Hilfen für die Tests mit Dateien auf der Platte:
+ *  - writeFile() legt fehlende Verzeichnisse an und schreibt den Inhalt
+ *  - Workspace ist ein temporäres Verzeichnis (beim Zerstören gelöscht), in das
+ *    Dateien relativ zur Wurzel geschrieben werden
+ */
+namespace TestUtil {
+
+inline void writeFile(const QString& path, const QByteArray& content = "return {}\n")
+{
+    QVERIFY(QDir().mkpath(QFileInfo(path).path()));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(content), content.size());
+}
+
+class Workspace
+{
+public:
+    [[nodiscard]] bool isValid() const { return m_dir.isValid(); }
+    [[nodiscard]] QString path() const { return m_dir.path(); }
+    [[nodiscard]] QString filePath(const QString& relativePath) const { return m_dir.filePath(relativePath); }
+
+    void write(const QString& relativePath, const QByteArray& content = "return {}\n") const
+    {
+        writeFile(filePath(relativePath), content);
+    }
+
+private:
+    QTemporaryDir m_dir;
+};
+
+} // namespace TestUtil
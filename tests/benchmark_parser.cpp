@@ -0,0 +1,514 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QString>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QSysInfo>
+#include <QUrl>
+#include <QTextBlock>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "LuaParser.h"
+#include "LuaEditor.h"
+#include "LuaHighlighter.h"
+#include "AutoCompleter.h"
+#include "LuaCorpusGenerator.h"
+#include "Utf8Ingest.h"
+#include "LspServer.h"
+#include "TestUtil.h"
+
+// ======================= Allokationszähler =======================
+//
+// Qt-Container allokieren über malloc, nicht über operator new. Unter glibc wird deshalb
+// malloc selbst interponiert (gilt dann auch für libQt6Core); mit AddressSanitizer oder
+// auf anderen Plattformen werden nur operator-new-Allokationen gezählt.
+
+namespace {
+    std::atomic<bool> g_countAllocations{false};
+    std::atomic<quint64> g_allocations{0};
+    std::atomic<quint64> g_allocatedBytes{0};
+
+    inline void countAllocation(std::size_t size) {
+        if (g_countAllocations.load(std::memory_order_relaxed)) {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+            g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+}
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+
+void* malloc(std::size_t size) {
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+void* calloc(std::size_t n, std::size_t size) {
+    countAllocation(n * size);
+    return __libc_calloc(n, size);
+}
+void* realloc(void* p, std::size_t size) {
+    countAllocation(size);
+    return __libc_realloc(p, size);
+}
+}
+#else
+void* operator new(std::size_t size) {
+    countAllocation(size);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+// ======================= Messung =======================
+
+struct BenchStats {
+    quint64 iterations = 0;
+    qint64 totalNs = 0;
+    quint64 allocations = 0;
+    quint64 bytes = 0;
+};
+
+// Misst genau einen Durchlauf des QBENCHMARK-Rumpfs (Zeit + Allokationen)
+class BenchProbe {
+public:
+    explicit BenchProbe(BenchStats& stats)
+        : m_stats(stats)
+        , m_allocStart(g_allocations.load())
+        , m_bytesStart(g_allocatedBytes.load())
+    {
+        g_countAllocations.store(true);
+        m_timer.start();
+    }
+    ~BenchProbe() {
+        const qint64 ns = m_timer.nsecsElapsed();
+        g_countAllocations.store(false);
+        m_stats.totalNs += ns;
+        m_stats.allocations += g_allocations.load() - m_allocStart;
+        m_stats.bytes += g_allocatedBytes.load() - m_bytesStart;
+        ++m_stats.iterations;
+    }
+
+private:
+    BenchStats& m_stats;
+    QElapsedTimer m_timer;
+    quint64 m_allocStart;
+    quint64 m_bytesStart;
+};
+
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// ======================= Benchmark-Suite =======================
+
+class ParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void parseOne_data();
+    void parseOne();
+    void mergeFrom_data();
+    void mergeFrom();
+    void getGlobals_data();
+    void getGlobals();
+    void getMembers_data();
+    void getMembers();
+    void buildCompletionItems_data();
+    void buildCompletionItems();
+    void performCompletion_data();
+    void performCompletion();
+    void editWithReferences_data();
+    void editWithReferences();
+    void rehighlight_data();
+    void rehighlight();
+    void ingestUtf8_data();
+    void ingestUtf8();
+    void lspCompletion_data();
+    void lspCompletion();
+
+private:
+    void addInputRows();
+    void report(const QString& dataset, const BenchStats& stats); // Eingabe aus m_inputs
+    void report(const QString& dataset, const BenchStats& stats, qint64 inputChars, qint64 inputLines);
+    void prepareEditor(const QString& code, const QString& typed);
+
+    QHash<QString, QString> m_inputs; // Datensatzname -> Lua-Code
+    QJsonArray m_results;
+
+    std::shared_ptr<LuaParser> m_editorParser;
+    std::unique_ptr<LuaEditor> m_editor;
+    std::unique_ptr<AutoCompleter> m_completer;
+};
+
+static QString readTestData(const QString& name)
+{
+    QFile file(QFINDTESTDATA("test_data/" + name));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return {};
+    return QString::fromUtf8(file.readAll());
+}
+
+// Synthetische Eingaben: fester Seed, damit Ergebnisse über Maschinen vergleichbar bleiben
+static QString syntheticInput(int lines)
+{
+    CorpusOptions options;
+    options.seed = 20240601;
+    options.lines = lines;
+    return LuaCorpusGenerator(options).generateFile(u"bench_%1"_qs.arg(lines));
+}
+
+void ParserBenchmark::initTestCase()
+{
+    const QString sample = readTestData(u"sample.lua"_qs);
+    const QString sample2 = readTestData(u"sample2.lua"_qs);
+    QVERIFY(!sample.isEmpty());
+    QVERIFY(!sample2.isEmpty());
+
+    m_inputs.insert(u"sample.lua"_qs, sample);
+    m_inputs.insert(u"sample2.lua"_qs, sample2);
+    m_inputs.insert(u"synthetic-10k"_qs, syntheticInput(10000));
+    m_inputs.insert(u"synthetic-100k"_qs, syntheticInput(100000));
+
+    m_editorParser = std::make_shared<LuaParser>();
+    m_editor = std::make_unique<LuaEditor>(m_editorParser);
+    m_completer = std::make_unique<AutoCompleter>();
+    m_completer->setWidget(m_editor.get());
+    m_editor->setCompleter(m_completer.get());
+}
+
+void ParserBenchmark::cleanupTestCase()
+{
+    m_editor.reset();
+    m_completer.reset();
+
+    QJsonObject root;
+    root.insert(u"suite"_qs, u"parser_completion"_qs);
+    root.insert(u"qt_version"_qs, QString::fromLatin1(qVersion()));
+    root.insert(u"cpu_arch"_qs, QSysInfo::currentCpuArchitecture());
+    root.insert(u"utf8_kernel"_qs, QString::fromLatin1(Utf8Ingest::kernelName(Utf8Ingest::bestKernel())));
+    root.insert(u"kernel"_qs, QSysInfo::kernelType() + u' ' + QSysInfo::kernelVersion());
+#ifdef NDEBUG
+    root.insert(u"build_type"_qs, u"release"_qs);
+#else
+    root.insert(u"build_type"_qs, u"debug"_qs);
+#endif
+    root.insert(u"timestamp"_qs, QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert(u"results"_qs, m_results);
+
+    const QString path = qEnvironmentVariable("LUAEDITOR_BENCH_JSON", u"benchmark_results.json"_qs);
+    QFile out(path);
+    QVERIFY2(out.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable(out.errorString()));
+    out.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    qInfo("Benchmark results written to %s", qPrintable(path));
+}
+
+void ParserBenchmark::addInputRows()
+{
+    QTest::addColumn<QString>("dataset");
+    QStringList names = m_inputs.keys();
+    names.sort();
+    for (const QString& name : names)
+        QTest::newRow(qPrintable(name)) << name;
+}
+
+void ParserBenchmark::report(const QString& dataset, const BenchStats& stats)
+{
+    const QString code = m_inputs.value(dataset);
+    report(dataset, stats, code.size(), code.count(u'\n') + 1);
+}
+
+void ParserBenchmark::report(const QString& dataset, const BenchStats& stats, qint64 inputChars, qint64 inputLines)
+{
+    if (stats.iterations == 0) return;
+
+    const double n = static_cast<double>(stats.iterations);
+
+    QJsonObject row;
+    row.insert(u"benchmark"_qs, QString::fromLatin1(QTest::currentTestFunction()));
+    row.insert(u"case"_qs, QString::fromLatin1(QTest::currentDataTag()));
+    row.insert(u"dataset"_qs, dataset);
+    row.insert(u"input_chars"_qs, inputChars);
+    row.insert(u"input_lines"_qs, inputLines);
+    row.insert(u"iterations"_qs, static_cast<qint64>(stats.iterations));
+    row.insert(u"ns_per_op"_qs, static_cast<double>(stats.totalNs) / n);
+    row.insert(u"allocs_per_op"_qs, static_cast<double>(stats.allocations) / n);
+    row.insert(u"bytes_per_op"_qs, static_cast<double>(stats.bytes) / n);
+    m_results.append(row);
+}
+
+void ParserBenchmark::prepareEditor(const QString& code, const QString& typed)
+{
+    m_editor->setPlainText(code + u'\n' + typed);
+    QTextCursor cursor = m_editor->textCursor();
+    cursor.movePosition(QTextCursor::End);
+    m_editor->setTextCursor(cursor);
+}
+
+// ----- LuaParser / SymbolTable -----
+
+void ParserBenchmark::parseOne_data() { addInputRows(); }
+
+void ParserBenchmark::parseOne()
+{
+    QFETCH(QString, dataset);
+    const QString code = m_inputs.value(dataset);
+    LuaParser parser;
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        SymbolTable table = parser.parseOne(code, dataset);
+        doNotOptimize(table);
+    }
+    report(dataset, stats);
+}
+
+void ParserBenchmark::mergeFrom_data() { addInputRows(); }
+
+void ParserBenchmark::mergeFrom()
+{
+    QFETCH(QString, dataset);
+    LuaParser parser;
+    const SymbolTable single = parser.parseOne(m_inputs.value(dataset), dataset);
+    BenchStats stats;
+
+    QBENCHMARK {
+        SymbolTable project;
+        BenchProbe probe(stats);
+        project.mergeFrom(single);
+        doNotOptimize(project);
+    }
+    report(dataset, stats);
+}
+
+void ParserBenchmark::getGlobals_data() { addInputRows(); }
+
+void ParserBenchmark::getGlobals()
+{
+    QFETCH(QString, dataset);
+    LuaParser parser;
+    parser.parseFile(m_inputs.value(dataset), dataset);
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        const QStringList globals = parser.getGlobals();
+        doNotOptimize(globals);
+    }
+    report(dataset, stats);
+}
+
+void ParserBenchmark::getMembers_data() { addInputRows(); }
+
+void ParserBenchmark::getMembers()
+{
+    QFETCH(QString, dataset);
+    LuaParser parser;
+    parser.parseFile(m_inputs.value(dataset), dataset);
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        const QStringList members = parser.getMembers(u"GameEngine"_qs);
+        doNotOptimize(members);
+    }
+    report(dataset, stats);
+}
+
+// ----- LuaEditor-Completion -----
+
+void ParserBenchmark::buildCompletionItems_data()
+{
+    QTest::addColumn<QString>("dataset");
+    QTest::addColumn<QString>("typed");
+    QStringList names = m_inputs.keys();
+    names.sort();
+    for (const QString& name : names) {
+        QTest::newRow(qPrintable(name + u"/global"_qs)) << name << u"ga"_qs;
+        QTest::newRow(qPrintable(name + u"/member"_qs)) << name << u"self."_qs;
+    }
+}
+
+void ParserBenchmark::buildCompletionItems()
+{
+    QFETCH(QString, dataset);
+    QFETCH(QString, typed);
+    prepareEditor(m_inputs.value(dataset), typed);
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        const QStringList items = m_editor->completionItemsForTesting();
+        doNotOptimize(items);
+    }
+    report(dataset, stats);
+}
+
+void ParserBenchmark::performCompletion_data() { buildCompletionItems_data(); }
+
+void ParserBenchmark::performCompletion()
+{
+    QFETCH(QString, dataset);
+    QFETCH(QString, typed);
+    prepareEditor(m_inputs.value(dataset), typed);
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        m_editor->performCompletion();
+    }
+    m_completer->hidePopup();
+    report(dataset, stats);
+}
+
+// Tippen am Dokumentanfang, nachdem der Referenzindex aufgebaut ist: misst, was jede
+// Fundstelle pro Edit kostet (früher ein QTextCursor, den das Dokument nachführen musste)
+void ParserBenchmark::editWithReferences_data() { addInputRows(); }
+
+void ParserBenchmark::editWithReferences()
+{
+    QFETCH(QString, dataset);
+    prepareEditor(m_inputs.value(dataset), QString());
+    m_editor->startIndexing();
+    m_editor->ensureIndexComplete();
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        QTextCursor cursor(m_editor->document());
+        cursor.insertText(u"x"_qs);
+        cursor.deletePreviousChar();
+    }
+    report(dataset, stats);
+}
+
+// ----- LuaHighlighter -----
+
+void ParserBenchmark::rehighlight_data() { addInputRows(); }
+
+void ParserBenchmark::rehighlight()
+{
+    QFETCH(QString, dataset);
+    QTextDocument document;
+    document.setPlainText(m_inputs.value(dataset));
+    LuaHighlighter highlighter(&document);
+    highlighter.setBlockBudget(0); // kompletter synchroner Durchlauf
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        highlighter.rehighlight();
+    }
+    report(dataset, stats);
+}
+
+// ----- Utf8Ingest + LuaLexer auf Bytes -----
+
+void ParserBenchmark::ingestUtf8_data() { addInputRows(); }
+
+void ParserBenchmark::ingestUtf8()
+{
+    QFETCH(QString, dataset);
+    const QByteArray bytes = m_inputs.value(dataset).toUtf8();
+    QList<LuaToken> tokens;
+    BenchStats stats;
+
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        const Utf8Ingest::Result ingest = Utf8Ingest::scan(bytes);
+        int state = LuaLexer::STATE_NORMAL;
+        for (qsizetype i = 0; i < ingest.lineCount(); ++i) {
+            tokens.clear();
+            state = LuaLexer::tokenizeUtf8Line(Utf8Ingest::line(bytes, ingest, i), state, tokens);
+        }
+        doNotOptimize(state);
+    }
+    report(dataset, stats);
+}
+
+// ----- LspServer-Completion über einen Workspace -----
+
+void ParserBenchmark::lspCompletion_data()
+{
+    QTest::addColumn<QString>("dataset");
+    QTest::addColumn<int>("character");
+    QTest::newRow("members") << u"workspace-400"_qs << 8;
+    QTest::newRow("globals") << u"workspace-400"_qs << 1;
+}
+
+void ParserBenchmark::lspCompletion()
+{
+    QFETCH(QString, dataset);
+    QFETCH(int, character);
+
+    // 400 Module mit je 25 Funktionen; im offenen Dokument wird "Mod123.f" getippt
+    TestUtil::Workspace workspace;
+    QVERIFY(workspace.isValid());
+    qint64 workspaceChars = 0;
+    qint64 workspaceLines = 0;
+    for (int f = 0; f < 400; ++f) {
+        QByteArray source = "Mod" + QByteArray::number(f) + " = {}\n";
+        for (int fn = 0; fn < 25; ++fn) {
+            source += "function Mod" + QByteArray::number(f) + ".fn" + QByteArray::number(fn) + "(a, b)\n"
+                      "    return Mod" + QByteArray::number(f) + ".fn0(a, b)\nend\n";
+        }
+        source += "function global_" + QByteArray::number(f) + "() end\n";
+        workspace.write(u"m%1.lua"_qs.arg(f), source);
+        workspaceChars += source.size(); // nur ASCII: Bytes == Zeichen
+        workspaceLines += source.count('\n');
+    }
+
+    auto message = [](const QJsonObject& body) {
+        QJsonObject framed = body;
+        framed.insert(u"jsonrpc"_qs, u"2.0"_qs);
+        return LspServer::encode(framed);
+    };
+    const QString uri = QUrl::fromLocalFile(workspace.filePath(u"m7.lua"_qs)).toString();
+
+    LspServer server;
+    QSignalSpy indexed(&server, &LspServer::workspaceIndexed);
+    server.receive(message({{u"id"_qs, 1}, {u"method"_qs, u"initialize"_qs},
+                            {u"params"_qs, QJsonObject{{u"rootUri"_qs, QUrl::fromLocalFile(workspace.path()).toString()}}}}));
+    QTRY_COMPARE_WITH_TIMEOUT(indexed.count(), 1, 60000);
+    server.receive(message({{u"method"_qs, u"initialized"_qs}, {u"params"_qs, QJsonObject{}}}));
+
+    QFile file(workspace.filePath(u"m7.lua"_qs));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QString text = QString::fromUtf8(file.readAll()) + u"Mod123.f"_qs;
+    server.receive(message({{u"method"_qs, u"textDocument/didOpen"_qs}, {u"params"_qs, QJsonObject{{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri}, {u"version"_qs, 1}, {u"text"_qs, text}}}}}}));
+
+    const QByteArray completion = message({{u"id"_qs, 2}, {u"method"_qs, u"textDocument/completion"_qs},
+        {u"params"_qs, QJsonObject{{u"textDocument"_qs, QJsonObject{{u"uri"_qs, uri}}},
+                                   {u"position"_qs, QJsonObject{{u"line"_qs, static_cast<int>(text.count(u'\n'))},
+                                                                {u"character"_qs, character}}}}}});
+    server.receive(completion); // erste Anfrage parst das geöffnete Dokument
+
+    BenchStats stats;
+    QBENCHMARK {
+        BenchProbe probe(stats);
+        server.receive(completion);
+    }
+    // Kein Eintrag in m_inputs: Größe des generierten Workspace melden
+    report(dataset, stats, workspaceChars, workspaceLines);
+}
+
+QTEST_MAIN(ParserBenchmark)
+#include "benchmark_parser.moc"
@@ -0,0 +1,89 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+
+#include "LuaCorpusGenerator.h"
+
+/**
+ * Kommandozeilen-Frontend für LuaCorpusGenerator.
+ *
+ *   lua_corpus_gen --lines 100000 --seed 7 --out big.lua
+ *   lua_corpus_gen --workspace 500 --requires 4 --lines 2000 --out ws/
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("lua_corpus_gen");
+
+    QCommandLineParser cli;
+    cli.setApplicationDescription("Deterministic synthetic Lua corpus generator");
+    cli.addHelpOption();
+
+    const QCommandLineOption seedOpt("seed", "PRNG seed.", "n", "1");
+    const QCommandLineOption linesOpt("lines", "Target lines per file.", "n", "10000");
+    const QCommandLineOption densityOpt("density", "Symbol density 0..1 (share of definition lines).", "d", "0.35");
+    const QCommandLineOption depthOpt("depth", "Class hierarchy depth.", "n", "4");
+    const QCommandLineOption nestingOpt("nesting", "Data table nesting depth.", "n", "3");
+    const QCommandLineOption minifiedOpt("minified-length", "Characters per minified line.", "n", "4000");
+    const QCommandLineOption weightsOpt("weights",
+        "Section weights class,data,function,longstring,minified.", "list", "40,20,25,10,5");
+    const QCommandLineOption workspaceOpt("workspace", "Emit a workspace with N modules instead of one file.", "n");
+    const QCommandLineOption requiresOpt("requires", "require() edges per module.", "n", "4");
+    const QCommandLineOption packagesOpt("packages", "Package directories in the workspace.", "n", "8");
+    const QCommandLineOption cyclesOpt("cycles", "Probability of an extra back edge per module.", "p", "0.02");
+    const QCommandLineOption outOpt("out", "Output file (single mode, '-' = stdout) or directory (workspace).", "path", "-");
+
+    cli.addOptions({seedOpt, linesOpt, densityOpt, depthOpt, nestingOpt, minifiedOpt, weightsOpt,
+                    workspaceOpt, requiresOpt, packagesOpt, cyclesOpt, outOpt});
+    cli.process(app);
+
+    CorpusOptions options;
+    options.seed = cli.value(seedOpt).toULongLong();
+    options.lines = cli.value(linesOpt).toInt();
+    options.symbolDensity = cli.value(densityOpt).toDouble();
+    options.classDepth = cli.value(depthOpt).toInt();
+    options.tableNesting = cli.value(nestingOpt).toInt();
+    options.minifiedLineLength = cli.value(minifiedOpt).toInt();
+
+    const QStringList weights = cli.value(weightsOpt).split(u',');
+    if (weights.size() == 5) {
+        options.classWeight = weights.at(0).toInt();
+        options.dataWeight = weights.at(1).toInt();
+        options.functionWeight = weights.at(2).toInt();
+        options.longStringWeight = weights.at(3).toInt();
+        options.minifiedWeight = weights.at(4).toInt();
+    }
+
+    const LuaCorpusGenerator generator(options);
+    QTextStream err(stderr);
+
+    if (cli.isSet(workspaceOpt)) {
+        WorkspaceOptions ws;
+        ws.moduleCount = cli.value(workspaceOpt).toInt();
+        ws.requiresPerModule = cli.value(requiresOpt).toInt();
+        ws.packages = cli.value(packagesOpt).toInt();
+        ws.cycleProbability = cli.value(cyclesOpt).toDouble();
+
+        const QString dir = cli.value(outOpt) == u"-"_qs ? u"workspace"_qs : cli.value(outOpt);
+        const QStringList files = generator.writeWorkspace(dir, ws);
+        err << "Wrote " << files.size() << " files to " << dir << Qt::endl;
+        return files.isEmpty() ? 1 : 0;
+    }
+
+    const QByteArray content = generator.generateFile(u"corpus"_qs).toUtf8();
+    const QString outPath = cli.value(outOpt);
+    QFile out;
+    bool ok = false;
+    if (outPath == u"-"_qs) {
+        ok = out.open(stdout, QIODevice::WriteOnly);
+    } else {
+        out.setFileName(outPath);
+        ok = out.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!ok || out.write(content) != content.size()) {
+        err << "Cannot write " << outPath << ": " << out.errorString() << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
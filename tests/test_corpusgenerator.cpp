@@ -0,0 +1,86 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QHash>
+#include <QRegularExpression>
+#include "LuaCorpusGenerator.h"
+#include "TestUtil.h"
+
+class TestCorpusGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testGlobalsUniquePerModule();
+    void testSameSeedSameOutput();
+
+private:
+    static QStringList globals(const QString& source);
+};
+
+QStringList TestCorpusGenerator::globals(const QString& source)
+{
+    // Globale Definitionen stehen immer am Zeilenanfang: "Name = ..." bzw. minifiziert "Name={};"
+    static const QRegularExpression assignment(u"^([A-Za-z_]\\w*)\\s*="_qs, QRegularExpression::MultilineOption);
+    QStringList names;
+    for (auto it = assignment.globalMatch(source); it.hasNext();)
+        names.append(it.next().captured(1));
+    names.removeDuplicates();
+    return names;
+}
+
+void TestCorpusGenerator::testGlobalsUniquePerModule()
+{
+    CorpusOptions options;
+    options.lines = 300;
+    const LuaCorpusGenerator generator(options);
+    WorkspaceOptions ws;
+    ws.moduleCount = 24;
+    ws.packages = 3; // mehrere Module je Paket: "pkg_0.mod_0000", "pkg_0.mod_0003", ...
+
+    QHash<QString, QString> owner;
+    for (const LuaCorpusGenerator::ModuleSpec& spec : generator.planWorkspace(ws)) {
+        const QStringList names = globals(generator.generateFile(spec.name, spec.requires));
+        QVERIFY2(!names.isEmpty(), qPrintable(spec.name));
+        for (const QString& name : names) {
+            QVERIFY2(!owner.contains(name),
+                     qPrintable(u"%1 defined in %2 and %3"_qs.arg(name, owner.value(name), spec.name)));
+            owner.insert(name, spec.name);
+        }
+    }
+}
+
+void TestCorpusGenerator::testSameSeedSameOutput()
+{
+    CorpusOptions options;
+    options.lines = 500;
+    options.seed = 42;
+    const QString first = LuaCorpusGenerator(options).generateFile(u"pkg_1.mod_0007"_qs, {u"pkg_0.mod_0003"_qs});
+    QCOMPARE(LuaCorpusGenerator(options).generateFile(u"pkg_1.mod_0007"_qs, {u"pkg_0.mod_0003"_qs}), first);
+
+    options.seed = 43;
+    QVERIFY(LuaCorpusGenerator(options).generateFile(u"pkg_1.mod_0007"_qs, {u"pkg_0.mod_0003"_qs}) != first);
+
+    // Ganze Workspaces: gleiche Dateien mit gleichem Inhalt
+    options.seed = 42;
+    options.lines = 100;
+    WorkspaceOptions ws;
+    ws.moduleCount = 12;
+    TestUtil::Workspace a;
+    TestUtil::Workspace b;
+    QVERIFY(a.isValid() && b.isValid());
+    const QStringList writtenA = LuaCorpusGenerator(options).writeWorkspace(a.path(), ws);
+    const QStringList writtenB = LuaCorpusGenerator(options).writeWorkspace(b.path(), ws);
+    QCOMPARE(writtenA.size(), ws.moduleCount + 1);
+    QCOMPARE(writtenB.size(), writtenA.size());
+    for (qsizetype i = 0; i < writtenA.size(); ++i) {
+        const QString relative = QDir(a.path()).relativeFilePath(writtenA.at(i));
+        QCOMPARE(QDir(b.path()).relativeFilePath(writtenB.at(i)), relative);
+        QFile fileA(writtenA.at(i));
+        QFile fileB(writtenB.at(i));
+        QVERIFY(fileA.open(QIODevice::ReadOnly) && fileB.open(QIODevice::ReadOnly));
+        QVERIFY2(fileA.readAll() == fileB.readAll(), qPrintable(relative));
+    }
+}
+
+QTEST_MAIN(TestCorpusGenerator)
+#include "test_corpusgenerator.moc"
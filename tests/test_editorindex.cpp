@@ -0,0 +1,49 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <memory>
+#include "LuaEditor.h"
+#include "LuaParser.h"
+
+class TestEditorIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSameLengthEditDropsRunningPass();
+
+};
+
+void TestEditorIndex::testSameLengthEditDropsRunningPass()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    QString text = u"-- header\nfunction first() end\n"_qs;
+    for (int i = 0; i < 50000; ++i)
+        text += u"local v%1 = 1\n"_qs.arg(i);
+    const int usage = static_cast<int>(text.size()) + 2;
+    text += u"first()\n"_qs;
+    editor.setPlainText(text);
+
+    // Erste Zeitscheibe hat die Definition schon erfasst, der Rest steht noch aus
+    QVERIFY(QMetaObject::invokeMethod(&editor, "startIndexing"));
+    QVERIFY(QMetaObject::invokeMethod(&editor, "indexSlice"));
+    QVERIFY(!editor.isIndexComplete());
+
+    // Gleich langer Ersatz, der den Zeilenumbruch verschiebt: "first" steht danach in Zeile 1 statt 2
+    QTextCursor cursor(editor.document());
+    cursor.setPosition(0);
+    cursor.setPosition(30, QTextCursor::KeepAnchor);
+    QCOMPARE(cursor.selectedText(), u"-- header\u2029function first() end"_qs);
+    cursor.insertText(u"function first() end\n-- header"_qs);
+    QVERIFY(editor.isIndexComplete());
+
+    // Neuer Durchlauf (wie nach dem Debounce) findet die Definition an der neuen Stelle
+    QVERIFY(QMetaObject::invokeMethod(&editor, "startIndexing"));
+    editor.ensureIndexComplete();
+    cursor.setPosition(usage);
+    editor.setTextCursor(cursor);
+    QVERIFY(QMetaObject::invokeMethod(&editor, "goToDefinition")); // private Slot hinter Ctrl+F12
+    QCOMPARE(editor.textCursor().position(), 9);
+}
+
+QTEST_MAIN(TestEditorIndex)
+#include "test_editorindex.moc"
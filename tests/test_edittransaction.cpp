@@ -0,0 +1,130 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QMimeData>
+#include <QSignalSpy>
+#include <memory>
+#include "LuaEditor.h"
+#include "LuaHighlighter.h"
+#include "LuaParser.h"
+
+// insertFromMimeData() ist protected; so lässt sich Einfügen ohne Zwischenablage auslösen
+class PasteEditor : public LuaEditor
+{
+public:
+    using LuaEditor::LuaEditor;
+    using LuaEditor::insertFromMimeData;
+};
+
+class TestEditTransaction : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSingleNotification();
+    void testNested();
+    void testEmptyTransaction();
+    void testAutoIndentIsOneStep();
+    void testPasteDefersHighlighting();
+};
+
+void TestEditTransaction::testSingleNotification()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    QSignalSpy textChanged(&editor, &QPlainTextEdit::textChanged);
+    QSignalSpy edited(&editor, &LuaEditor::documentEdited);
+
+    {
+        LuaEditor::EditTransaction transaction(&editor);
+        QVERIFY(editor.isInEditTransaction());
+        QTextCursor cursor = editor.textCursor();
+        cursor.insertText(u"local a = 1\n"_qs);
+        cursor.insertText(u"local b = 2\n"_qs);
+        cursor.insertText(u"local c = 3\n"_qs);
+        QCOMPARE(textChanged.count(), 0);
+    }
+    QVERIFY(!editor.isInEditTransaction());
+    QCOMPARE(textChanged.count(), 1);
+    QCOMPARE(edited.count(), 0);      // kommt erst über die Event-Loop
+    QTRY_COMPARE(edited.count(), 1);
+
+    // Ein Undo-Schritt für die ganze Transaktion
+    editor.undo();
+    QVERIFY(editor.toPlainText().isEmpty());
+}
+
+void TestEditTransaction::testNested()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    QSignalSpy edited(&editor, &LuaEditor::documentEdited);
+
+    editor.beginEditTransaction();
+    editor.insertPlainText(u"x = 1\n"_qs);
+    {
+        LuaEditor::EditTransaction inner(&editor);
+        editor.insertPlainText(u"y = 2\n"_qs);
+    }
+    QVERIFY(editor.isInEditTransaction());
+    editor.endEditTransaction();
+
+    QTRY_COMPARE(edited.count(), 1);
+    QTest::qWait(10);
+    QCOMPARE(edited.count(), 1);
+    QCOMPARE(editor.toPlainText(), u"x = 1\ny = 2\n"_qs);
+}
+
+void TestEditTransaction::testEmptyTransaction()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    QSignalSpy edited(&editor, &LuaEditor::documentEdited);
+    {
+        LuaEditor::EditTransaction transaction(&editor);
+    }
+    QTest::qWait(10);
+    QCOMPARE(edited.count(), 0);
+}
+
+void TestEditTransaction::testAutoIndentIsOneStep()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    editor.setPlainText(u"function f()"_qs);
+    editor.moveCursor(QTextCursor::End);
+
+    QSignalSpy textChanged(&editor, &QPlainTextEdit::textChanged);
+    QTest::keyClick(&editor, Qt::Key_Return);
+    QCOMPARE(editor.toPlainText(), u"function f()\n    \nend"_qs);
+    QCOMPARE(textChanged.count(), 1);
+    QCOMPARE(editor.textCursor().blockNumber(), 1);
+
+    editor.undo();
+    QCOMPARE(editor.toPlainText(), u"function f()"_qs);
+}
+
+void TestEditTransaction::testPasteDefersHighlighting()
+{
+    PasteEditor editor(std::make_shared<LuaParser>());
+    auto* highlighter = new LuaHighlighter(editor.document());
+    editor.setHighlighter(highlighter);
+
+    QString text;
+    for (int i = 0; i < 5000; ++i)
+        text += u"local value%1 = \"text\" -- comment\n"_qs.arg(i);
+    QMimeData mime;
+    mime.setText(text);
+
+    QSignalSpy edited(&editor, &LuaEditor::documentEdited);
+    editor.insertFromMimeData(&mime);
+    QCOMPARE(editor.blockCount(), 5001);
+
+    // Ohne Transaktion würde das Budget die ersten 1000 Blöcke synchron lexen
+    QVERIFY(highlighter->hasDeferredBlocks());
+    QVERIFY(!editor.document()->findBlockByNumber(500).userData());
+    QCOMPARE(edited.count(), 0);
+
+    QTRY_COMPARE(edited.count(), 1);
+    QTRY_VERIFY_WITH_TIMEOUT(!highlighter->hasDeferredBlocks(), 10000);
+    QVERIFY(editor.document()->findBlockByNumber(500).userData());
+    QCOMPARE(editor.document()->findBlockByNumber(4999).userState(), LuaLexer::STATE_NORMAL);
+}
+
+QTEST_MAIN(TestEditTransaction)
+#include "test_edittransaction.moc"
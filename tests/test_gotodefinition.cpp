@@ -0,0 +1,118 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <memory>
+#include "LuaEditor.h"
+#include "LuaParser.h"
+#include "ReferenceIndex.h"
+#include "TestUtil.h"
+
+class TestGoToDefinition : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testChainKey();
+    void testSelfField();
+    void testFallbackOrder();
+
+private:
+    // Cursor an position setzen und Ctrl+F12 auslösen
+    static void goToDefinition(LuaEditor& editor, int position);
+};
+
+void TestGoToDefinition::goToDefinition(LuaEditor& editor, int position)
+{
+    QTextCursor cursor(editor.document());
+    cursor.setPosition(position);
+    editor.setTextCursor(cursor);
+    QVERIFY(QMetaObject::invokeMethod(&editor, "goToDefinition")); // private Slot hinter Ctrl+F12
+}
+
+void TestGoToDefinition::testChainKey()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    const QString text = u"function c() end\n"
+                         "A = { b = {} }\n"
+                         "function A.b:c(x)\n"
+                         "    return x\n"
+                         "end\n"
+                         "local r = A.b:c(1)\n"_qs;
+    editor.setPlainText(text);
+    QVERIFY(QMetaObject::invokeMethod(&editor, "startIndexing"));
+
+    // "A.b:c" unter dem Cursor sucht "A.b.c" und landet auf dem letzten Namen, nicht auf "function c"
+    goToDefinition(editor, static_cast<int>(text.lastIndexOf(u"c(1)"_qs)) + 1);
+    QCOMPARE(editor.textCursor().position(), static_cast<int>(text.indexOf(u"c(x)"_qs)));
+}
+
+void TestGoToDefinition::testSelfField()
+{
+    LuaEditor editor(std::make_shared<LuaParser>());
+    const QString text = u"function heal() end\n"
+                         "Player = {}\n"
+                         "function Player.heal(self, n) end\n"
+                         "function Player:update()\n"
+                         "    self.heal(self, 1)\n"
+                         "end\n"_qs;
+    editor.setPlainText(text);
+    QVERIFY(QMetaObject::invokeMethod(&editor, "startIndexing"));
+
+    // "self.heal" in "function Player:update" meint "Player.heal"
+    goToDefinition(editor, static_cast<int>(text.indexOf(u"heal(self, 1)"_qs)) + 2);
+    QCOMPARE(editor.textCursor().position(), static_cast<int>(text.indexOf(u"heal(self, n)"_qs)));
+}
+
+void TestGoToDefinition::testFallbackOrder()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"remote.lua"_qs, "Remote = {}\nfunction Remote.fn() end\nShared = {}\nTwice = {}\n");
+    auto index = std::make_shared<ReferenceIndex>();
+    QVERIFY(index->build(dir.path()));
+
+    auto parser = std::make_shared<LuaParser>();
+    const QString currentPath = dir.filePath(u"current.lua"_qs);
+    const QString parsedPath = dir.filePath(u"parsed.lua"_qs);
+    const QString text = u"function Twice() end\n"
+                         "Twice()\n"
+                         "Config = {}\n"
+                         "print(Config, Shared, Remote.fn)\n"_qs;
+    parser->parseFile(u"Twice = 1\nShared = {}\n"_qs, parsedPath);
+    parser->parseFile(text, currentPath);
+
+    LuaEditor editor(parser);
+    editor.setFilePath(currentPath);
+    editor.setProjectIndex(index);
+    editor.setPlainText(text);
+    QVERIFY(QMetaObject::invokeMethod(&editor, "startIndexing"));
+    QSignalSpy opened(&editor, &LuaEditor::openLocationRequested);
+    const int usage = static_cast<int>(text.lastIndexOf(u"print("_qs));
+
+    // 1. Dokumentindex vor Symboltabelle und Projektindex
+    goToDefinition(editor, static_cast<int>(text.indexOf(u"Twice()"_qs)) + 1);
+    QCOMPARE(editor.textCursor().position(), 9);
+    QVERIFY(opened.isEmpty());
+
+    // 2. Symboltabelle, Definition in derselben Datei: Sprung im Editor
+    goToDefinition(editor, static_cast<int>(text.indexOf(u"Config,"_qs, usage)) + 1);
+    QCOMPARE(editor.textCursor().position(), static_cast<int>(text.indexOf(u"Config = {}"_qs)));
+    QVERIFY(opened.isEmpty());
+
+    // ... in einer anderen Datei: openLocationRequested, auch wenn der Projektindex sie ebenfalls kennt
+    goToDefinition(editor, static_cast<int>(text.indexOf(u"Shared"_qs, usage)) + 1);
+    QCOMPARE(opened.size(), 1);
+    QCOMPARE(opened.at(0).at(0).toString(), parsedPath);
+    QCOMPARE(opened.at(0).at(1).toInt(), 2);
+    QCOMPARE(opened.at(0).at(2).toInt(), 1);
+
+    // 3. Nur im Projektindex
+    goToDefinition(editor, static_cast<int>(text.indexOf(u"fn)"_qs, usage)) + 1);
+    QCOMPARE(opened.size(), 2);
+    QCOMPARE(opened.at(1).at(0).toString(), QDir::cleanPath(dir.filePath(u"remote.lua"_qs)));
+    QCOMPARE(opened.at(1).at(1).toInt(), 2);
+    QCOMPARE(opened.at(1).at(2).toInt(), 10);
+}
+
+QTEST_MAIN(TestGoToDefinition)
+#include "test_gotodefinition.moc"
@@ -0,0 +1,111 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTemporaryFile>
+#include <QTextDocument>
+#include "LargeFileLoader.h"
+
+class TestLargeFileLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testChunkedLoad();
+    void testNoTrailingNewline();
+    void testCancel();
+    void testMissingFile();
+
+private:
+    static QByteArray sampleBytes(int lines);
+};
+
+QByteArray TestLargeFileLoader::sampleBytes(int lines)
+{
+    // CRLF-Zeilenenden und Mehrbyte-Zeichen, damit beides über Chunkgrenzen fällt
+    QByteArray bytes;
+    for (int i = 0; i < lines; ++i)
+        bytes += "local s" + QByteArray::number(i) + " = \"Größe ✓ 😀\"\r\n";
+    return bytes;
+}
+
+void TestLargeFileLoader::testChunkedLoad()
+{
+    const QByteArray bytes = sampleBytes(200);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(bytes);
+    file.flush();
+
+    QTextDocument document;
+    LargeFileLoader loader;
+    loader.setChunkSize(7); // teilt Zeilen, CRLF-Paare und UTF-8-Sequenzen
+    QSignalSpy finished(&loader, &LargeFileLoader::finished);
+    QSignalSpy progress(&loader, &LargeFileLoader::progressChanged);
+
+    QVERIFY(loader.start(file.fileName(), &document));
+    QVERIFY(loader.isRunning());
+    QVERIFY(!document.isUndoRedoEnabled());
+
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(finished.first().first().toBool(), true);
+    QCOMPARE(progress.last().first().toInt(), 100);
+    QVERIFY(!loader.hadDecodingErrors());
+    QVERIFY(document.isUndoRedoEnabled());
+
+    QString expected = QString::fromUtf8(bytes);
+    expected.replace(u"\r\n"_qs, u"\n"_qs);
+    QCOMPARE(document.toPlainText(), expected);
+}
+
+void TestLargeFileLoader::testNoTrailingNewline()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write("print(1)\r\nprint(\"äöü\")");
+    file.flush();
+
+    QTextDocument document;
+    LargeFileLoader loader;
+    loader.setChunkSize(3);
+    QSignalSpy finished(&loader, &LargeFileLoader::finished);
+    QVERIFY(loader.start(file.fileName(), &document));
+
+    QTRY_COMPARE(finished.count(), 1);
+    QCOMPARE(document.toPlainText(), u"print(1)\nprint(\"äöü\")"_qs);
+}
+
+void TestLargeFileLoader::testCancel()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(sampleBytes(5000));
+    file.flush();
+
+    QTextDocument document;
+    LargeFileLoader loader;
+    loader.setChunkSize(1);
+    QSignalSpy finished(&loader, &LargeFileLoader::finished);
+    QVERIFY(loader.start(file.fileName(), &document));
+
+    loader.cancel();
+    QVERIFY(!loader.isRunning());
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.first().first().toBool(), false);
+    QVERIFY(loader.errorString().isEmpty());
+    QVERIFY(document.isUndoRedoEnabled());
+}
+
+void TestLargeFileLoader::testMissingFile()
+{
+    QTextDocument document;
+    document.setPlainText(u"unverändert"_qs);
+
+    LargeFileLoader loader;
+    QVERIFY(!loader.start(u"does/not/exist.lua"_qs, &document));
+    QVERIFY(!loader.errorString().isEmpty());
+    QVERIFY(!loader.isRunning());
+    QCOMPARE(document.toPlainText(), u"unverändert"_qs);
+}
+
+QTEST_MAIN(TestLargeFileLoader)
+#include "test_largefile.moc"
@@ -0,0 +1,400 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QString>
+#include "LuaLexer.h"
+#include "LuaBuiltins.h"
+#include "LuaHighlighter.h"
+#include "LuaBlockData.h"
+#include "Utf8Ingest.h"
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QTextLayout>
+
+class TestLuaLexer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPerfectHash();
+    void testKeywordsInsideStrings();
+    void testDottedBuiltins();
+    void testFunctionNames();
+    void testNumbersAndOperators();
+    void testLongComments();
+    void testLongStrings();
+    void testLongBracketLevels();
+    void testBoundedPropagation();
+    void testViewportFirst();
+    void testBlockTokenCache();
+    void testUtf8IngestKernels();
+    void testUtf8Validation();
+    void testUtf8Tokenize();
+
+private:
+    static QList<LuaToken> lex(const QString& line, int startState = LuaLexer::STATE_NORMAL,
+                               int* endState = nullptr);
+    static QString text(const QString& line, const LuaToken& token);
+};
+
+QList<LuaToken> TestLuaLexer::lex(const QString& line, int startState, int* endState)
+{
+    QList<LuaToken> tokens;
+    const int state = LuaLexer::tokenizeLine(line, startState, tokens);
+    if (endState) *endState = state;
+    return tokens;
+}
+
+QString TestLuaLexer::text(const QString& line, const LuaToken& token)
+{
+    return line.mid(token.start, token.length);
+}
+
+void TestLuaLexer::testPerfectHash()
+{
+    static_assert(LuaBuiltins::lookup("function")->kind == LuaBuiltins::WordKind::Keyword);
+    static_assert(LuaBuiltins::lookup("string.format")->kind == LuaBuiltins::WordKind::Builtin);
+    static_assert(LuaBuiltins::lookup("GameEngine") == nullptr);
+
+    for (const auto& entry : LuaBuiltins::ENTRIES)
+        QCOMPARE(LuaBuiltins::lookup(entry.name), &entry);
+
+    const QString utf16 = u"tostring"_qs;
+    QVERIFY(LuaBuiltins::lookup(utf16.utf16(), utf16.size()) != nullptr);
+    QVERIFY(LuaBuiltins::lookup("tostrin") == nullptr);
+
+    // Art, Bibliothek und Signatur hängen am selben Eintrag
+    static_assert(LuaBuiltins::lookup("string")->kind == LuaBuiltins::WordKind::Library);
+    static_assert(LuaBuiltins::lookup("string.format")->library() == "string");
+    static_assert(LuaBuiltins::lookup("string.format")->member() == "format");
+    static_assert(LuaBuiltins::lookup("string.format")->signature == "(formatstring, ...)");
+    static_assert(!LuaBuiltins::lookup("math.pi")->isFunction());
+    static_assert(LuaBuiltins::lookup("print")->library().empty());
+
+    for (const auto& entry : LuaBuiltins::ENTRIES) {
+        if (entry.library().empty()) continue;
+        const LuaBuiltins::Entry* library = LuaBuiltins::lookup(entry.library());
+        QVERIFY2(library && library->kind == LuaBuiltins::WordKind::Library, entry.name.data());
+    }
+}
+
+void TestLuaLexer::testKeywordsInsideStrings()
+{
+    const QString line = uR"(local s = "if then end" .. 'while')"_qs;
+    const QList<LuaToken> tokens = lex(line);
+
+    QCOMPARE(tokens.size(), 6);
+    QCOMPARE(tokens[0].kind, LuaTokenKind::Keyword);
+    QCOMPARE(tokens[3].kind, LuaTokenKind::String);
+    QCOMPARE(text(line, tokens[3]), uR"("if then end")"_qs);
+    QCOMPARE(tokens[5].kind, LuaTokenKind::String);
+}
+
+void TestLuaLexer::testDottedBuiltins()
+{
+    const QString line = u"print(string.format(x), string.custom, mystring.format)"_qs;
+    const QList<LuaToken> tokens = lex(line);
+
+    QCOMPARE(tokens[0].kind, LuaTokenKind::Builtin);
+    QCOMPARE(text(line, tokens[2]), u"string.format"_qs);
+    QCOMPARE(tokens[2].kind, LuaTokenKind::Builtin);
+
+    // "string.custom" ist kein Built-in → "string" bleibt ein normaler Bezeichner
+    QCOMPARE(text(line, tokens[7]), u"string"_qs);
+    QCOMPARE(tokens[7].kind, LuaTokenKind::Identifier);
+    QCOMPARE(text(line, tokens[11]), u"mystring"_qs);
+    QCOMPARE(tokens[11].kind, LuaTokenKind::Identifier);
+}
+
+void TestLuaLexer::testFunctionNames()
+{
+    const QString line = u"function Player.Stats:update(dt) helper(dt) end"_qs;
+    const QList<LuaToken> tokens = lex(line);
+
+    QCOMPARE(tokens[1].kind, LuaTokenKind::FunctionName);
+    QCOMPARE(tokens[3].kind, LuaTokenKind::FunctionName);
+    QCOMPARE(text(line, tokens[5]), u"update"_qs);
+    QCOMPARE(tokens[5].kind, LuaTokenKind::FunctionName);
+    QCOMPARE(tokens[7].kind, LuaTokenKind::Identifier); // Parameter dt
+
+    QCOMPARE(text(line, tokens[9]), u"helper"_qs);
+    QCOMPARE(tokens[9].kind, LuaTokenKind::FunctionCall);
+}
+
+void TestLuaLexer::testNumbersAndOperators()
+{
+    const QString line = u"x = 0x1F + 3.5e-2 // .5 ~= y"_qs;
+    const QList<LuaToken> tokens = lex(line);
+
+    QCOMPARE(tokens.size(), 9);
+    QCOMPARE(text(line, tokens[2]), u"0x1F"_qs);
+    QCOMPARE(tokens[2].kind, LuaTokenKind::Number);
+    QCOMPARE(text(line, tokens[4]), u"3.5e-2"_qs);
+    QCOMPARE(text(line, tokens[5]), u"//"_qs);
+    QCOMPARE(tokens[5].kind, LuaTokenKind::Operator);
+    QCOMPARE(text(line, tokens[6]), u".5"_qs);
+    QCOMPARE(text(line, tokens[7]), u"~="_qs);
+}
+
+void TestLuaLexer::testLongComments()
+{
+    int state = -1;
+    QList<LuaToken> tokens = lex(u"x = 1 --[[ open"_qs, LuaLexer::STATE_NORMAL, &state);
+    const int commentState = LuaLexer::longBracketState(LuaLexer::LongBracketKind::Comment, 0);
+    QCOMPARE(state, commentState);
+    QCOMPARE(tokens.last().kind, LuaTokenKind::LongComment);
+
+    tokens = lex(u"local inside = true"_qs, state, &state);
+    QCOMPARE(state, commentState);
+    QCOMPARE(tokens.size(), 1);
+    QCOMPARE(tokens[0].kind, LuaTokenKind::LongComment);
+
+    const QString closing = u"still ]] print(1)"_qs;
+    tokens = lex(closing, state, &state);
+    QCOMPARE(state, LuaLexer::STATE_NORMAL);
+    QCOMPARE(text(closing, tokens[0]), u"still ]]"_qs);
+    QCOMPARE(tokens[1].kind, LuaTokenKind::Builtin);
+
+    // Einzeilige Kommentare laufen bis zum Zeilenende
+    tokens = lex(u"y = 2 -- if then"_qs, LuaLexer::STATE_NORMAL, &state);
+    QCOMPARE(state, LuaLexer::STATE_NORMAL);
+    QCOMPARE(tokens.last().kind, LuaTokenKind::Comment);
+}
+
+void TestLuaLexer::testLongStrings()
+{
+    const QString line = u"t = { [[a]], [==[b]]c]==], t[i] }"_qs;
+    const QList<LuaToken> tokens = lex(line);
+
+    QCOMPARE(text(line, tokens[3]), u"[[a]]"_qs);
+    QCOMPARE(tokens[3].kind, LuaTokenKind::LongString);
+    QCOMPARE(text(line, tokens[5]), u"[==[b]]c]==]"_qs);
+    QCOMPARE(tokens[5].kind, LuaTokenKind::LongString);
+
+    // Indexzugriff ist keine lange Klammer
+    QCOMPARE(text(line, tokens[8]), u"["_qs);
+    QCOMPARE(tokens[8].kind, LuaTokenKind::Punctuation);
+}
+
+void TestLuaLexer::testLongBracketLevels()
+{
+    using Kind = LuaLexer::LongBracketKind;
+    int state = -1;
+
+    // Mehrzeiliger String mit Level 2 wird nicht von "]]" beendet
+    lex(u"local s = [==[ first"_qs, LuaLexer::STATE_NORMAL, &state);
+    QCOMPARE(LuaLexer::longBracketKind(state), Kind::String);
+    QCOMPARE(LuaLexer::longBracketLevel(state), 2);
+
+    QList<LuaToken> tokens = lex(u"second ]] still string"_qs, state, &state);
+    QCOMPARE(LuaLexer::longBracketKind(state), Kind::String);
+    QCOMPARE(tokens.size(), 1);
+    QCOMPARE(tokens[0].kind, LuaTokenKind::LongString);
+
+    tokens = lex(u"end ]==] x = 1"_qs, state, &state);
+    QCOMPARE(state, LuaLexer::STATE_NORMAL);
+    QCOMPARE(tokens.size(), 4);
+
+    // --[=[ ... ]=] und mehrzeilige [[ ... ]]
+    lex(u"--[=[ comment"_qs, LuaLexer::STATE_NORMAL, &state);
+    QCOMPARE(LuaLexer::longBracketKind(state), Kind::Comment);
+    QCOMPARE(LuaLexer::longBracketLevel(state), 1);
+    lex(u"]] ]=]"_qs, state, &state);
+    QCOMPARE(state, LuaLexer::STATE_NORMAL);
+
+    lex(u"x = [["_qs, LuaLexer::STATE_NORMAL, &state);
+    QCOMPARE(state, LuaLexer::longBracketState(Kind::String, 0));
+}
+
+void TestLuaLexer::testBoundedPropagation()
+{
+    constexpr int lines = 5000;
+    constexpr int budget = 100;
+
+    QStringList code;
+    for (int i = 0; i < lines; ++i)
+        code << u"x = %1"_qs.arg(i);
+
+    QTextDocument document;
+    document.setPlainText(code.join(u'\n'));
+    LuaHighlighter highlighter(&document);
+    highlighter.setBlockBudget(budget);
+
+    // Erstes Hervorheben läuft in Häppchen über die Event-Loop
+    QTRY_COMPARE(document.lastBlock().userState(), LuaLexer::STATE_NORMAL);
+    QVERIFY(!highlighter.hasDeferredBlocks());
+
+    // "--[[" am Anfang: synchron nur das Budget, der Rest wird nachgezogen
+    QTextCursor cursor(&document);
+    cursor.insertText(u"--[[ "_qs);
+
+    const int commentState = LuaLexer::longBracketState(LuaLexer::LongBracketKind::Comment, 0);
+    QCOMPARE(document.findBlockByNumber(budget / 2).userState(), commentState);
+    QCOMPARE(document.findBlockByNumber(budget * 3).userState(), LuaLexer::STATE_NORMAL);
+    QVERIFY(highlighter.hasDeferredBlocks());
+
+    QTRY_VERIFY(!highlighter.hasDeferredBlocks());
+    QCOMPARE(document.lastBlock().userState(), commentState);
+
+    // Schließen: Zustände konvergieren wieder zu STATE_NORMAL
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(u" ]]"_qs);
+    QCOMPARE(document.lastBlock().userState(), LuaLexer::STATE_NORMAL);
+    cursor.setPosition(0);
+    cursor.deleteChar();
+    QTRY_VERIFY(!highlighter.hasDeferredBlocks());
+    QCOMPARE(document.findBlockByNumber(lines / 2).userState(), LuaLexer::STATE_NORMAL);
+}
+
+void TestLuaLexer::testViewportFirst()
+{
+    constexpr int lines = 20000;
+
+    QStringList code;
+    for (int i = 0; i < lines; ++i)
+        code << u"local v%1 = { %1 }"_qs.arg(i);
+
+    QTextDocument document;
+    LuaHighlighter highlighter(&document);
+    highlighter.setBlockBudget(50);
+
+    // Laden: synchron nur das Budget, der Rest ist zurückgestellt
+    document.setPlainText(code.join(u'\n'));
+    QVERIFY(highlighter.hasDeferredBlocks());
+    QCOMPARE(document.findBlockByNumber(10).userState(), LuaLexer::STATE_NORMAL);
+    QCOMPARE(document.findBlockByNumber(15000).userState(), -1);
+
+    // Sprung ans Ende: Ausschnitt sofort korrekt, Zustände davor nur gescannt
+    QTextCursor cursor(document.findBlockByNumber(100));
+    cursor.insertText(u"--[==[ "_qs);
+    highlighter.highlightBlocksNow(15000, 15040);
+
+    const int commentState = LuaLexer::longBracketState(LuaLexer::LongBracketKind::Comment, 2);
+    QCOMPARE(document.findBlockByNumber(14999).userState(), commentState);
+    QCOMPARE(document.findBlockByNumber(15020).userState(), commentState);
+    QVERIFY(!document.findBlockByNumber(15020).layout()->formats().isEmpty());
+
+    QTRY_VERIFY(!highlighter.hasDeferredBlocks());
+    QCOMPARE(document.lastBlock().userState(), commentState);
+    QVERIFY(!document.findBlockByNumber(5000).layout()->formats().isEmpty());
+}
+
+void TestLuaLexer::testBlockTokenCache()
+{
+    QTextDocument document;
+    document.setPlainText(u"local s = \"text\" -- note\nx = [[\nlong\n]] y = 1"_qs);
+    LuaHighlighter highlighter(&document);
+    highlighter.rehighlight();
+
+    // Highlighter hat den Cache gefüllt; ensure() lext nicht erneut
+    const QTextBlock first = document.firstBlock();
+    const auto* cached = static_cast<LuaBlockData*>(first.userData());
+    QVERIFY(cached != nullptr);
+    QCOMPARE(LuaBlockData::ensure(first), cached);
+    QCOMPARE(cached->tokens.size(), 5);
+
+    // Nach einer Änderung passt die Revision nicht mehr → neu gelext
+    QTextCursor cursor(first);
+    cursor.movePosition(QTextCursor::EndOfBlock);
+    cursor.insertText(u" more"_qs);
+    const LuaBlockData* updated = LuaBlockData::ensure(document.firstBlock());
+    QCOMPARE(updated->revision, document.firstBlock().revision());
+    QCOMPARE(updated->tokens.last().kind, LuaTokenKind::Comment);
+
+    const auto cursorAt = [&](int blockNumber, int column) {
+        QTextCursor c(document.findBlockByNumber(blockNumber));
+        c.setPosition(c.position() + column);
+        return c;
+    };
+    QVERIFY(!LuaBlockData::isInStringOrComment(cursorAt(0, 3)));  // "loc|al"
+    QVERIFY(LuaBlockData::isInStringOrComment(cursorAt(0, 12)));  // im String
+    QVERIFY(!LuaBlockData::isInStringOrComment(cursorAt(0, 16))); // direkt hinter dem String
+    QVERIFY(LuaBlockData::isInStringOrComment(cursorAt(0, 21)));  // im Kommentar
+    QVERIFY(LuaBlockData::isInStringOrComment(cursorAt(2, 0)));   // mehrzeiliger String
+    QVERIFY(LuaBlockData::isInStringOrComment(cursorAt(2, 4)));
+    QVERIFY(!LuaBlockData::isInStringOrComment(cursorAt(3, 4)));  // hinter "]]"
+}
+
+void TestLuaLexer::testUtf8IngestKernels()
+{
+    // Länge so gewählt, dass Mehrbyte-Sequenzen und "\r\n" über 16/32-Byte-Blöcke fallen
+    QByteArray bytes;
+    for (int i = 0; i < 300; ++i) {
+        bytes += "local v" + QByteArray::number(i) + " = 1";
+        if (i % 7 == 0) bytes += " -- Größe ✓ 😀";
+        bytes += (i % 3 == 0) ? "\r\n" : "\n";
+    }
+    bytes += "return v1";
+
+    const Utf8Ingest::Result scalar = Utf8Ingest::scan(bytes, Utf8Ingest::Kernel::Scalar);
+    QVERIFY(scalar.isValid());
+    QVERIFY(!scalar.ascii);
+    QCOMPARE(scalar.lineCount(), 301);
+
+    const QStringList lines = QString::fromUtf8(bytes).split(u'\n');
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        QString expected = lines.at(i);
+        if (expected.endsWith(u'\r')) expected.chop(1);
+        QCOMPARE(QString::fromUtf8(Utf8Ingest::line(bytes, scalar, i)), expected);
+    }
+
+    for (const auto kernel : {Utf8Ingest::Kernel::Sse2, Utf8Ingest::Kernel::Avx2}) {
+        if (!Utf8Ingest::isSupported(kernel)) continue;
+        const Utf8Ingest::Result vectorized = Utf8Ingest::scan(bytes, kernel);
+        QCOMPARE(vectorized.lineStarts, scalar.lineStarts);
+        QCOMPARE(vectorized.ascii, scalar.ascii);
+        QCOMPARE(vectorized.errorOffset, scalar.errorOffset);
+    }
+
+    QVERIFY(Utf8Ingest::scan("print(1)\n").ascii);
+    QCOMPARE(Utf8Ingest::scan(QByteArrayView()).lineCount(), 1);
+}
+
+void TestLuaLexer::testUtf8Validation()
+{
+    const QByteArray padding(40, 'x'); // Fehler hinter dem ersten Vektorblock
+    const struct { QByteArray bytes; qsizetype error; } cases[] = {
+        {"a\xC3\xA4" "b", -1},              // ä
+        {"a\xF0\x9F\x98\x80", -1},          // U+1F600
+        {"a\xC0\xAF", 1},                    // überlang
+        {"ab\xED\xA0\x80", 2},               // Surrogat
+        {"\xF4\x90\x80\x80", 0},             // > U+10FFFF
+        {"abc\xE2\x82", 3},                  // abgeschnitten
+        {"\x80", 0},                          // einzelnes Folgebyte
+        {padding + "\xFF" + padding, 40},
+    };
+
+    for (const auto& c : cases) {
+        for (const auto kernel : {Utf8Ingest::Kernel::Scalar, Utf8Ingest::Kernel::Sse2,
+                                  Utf8Ingest::Kernel::Avx2}) {
+            QCOMPARE(Utf8Ingest::scan(c.bytes, kernel).errorOffset, c.error);
+        }
+    }
+}
+
+void TestLuaLexer::testUtf8Tokenize()
+{
+    const QString line = uR"(local s = "äöü" .. string.format("%d", n) -- ✓ ok)"_qs;
+    const QByteArray utf8 = line.toUtf8();
+
+    QList<LuaToken> bytesTokens;
+    QCOMPARE(LuaLexer::tokenizeUtf8Line(utf8, LuaLexer::STATE_NORMAL, bytesTokens), LuaLexer::STATE_NORMAL);
+    const QList<LuaToken> tokens = lex(line);
+
+    // Gleiche Tokens, nur Offsets in Bytes statt UTF-16-Einheiten
+    QCOMPARE(bytesTokens.size(), tokens.size());
+    for (qsizetype i = 0; i < tokens.size(); ++i) {
+        QCOMPARE(bytesTokens[i].kind, tokens[i].kind);
+        QCOMPARE(QString::fromUtf8(utf8.mid(bytesTokens[i].start, bytesTokens[i].length)),
+                 text(line, tokens[i]));
+    }
+
+    const QByteArray open = "x = [==[ Größe";
+    QCOMPARE(LuaLexer::scanUtf8LineState(open, LuaLexer::STATE_NORMAL),
+             LuaLexer::longBracketState(LuaLexer::LongBracketKind::String, 2));
+    QCOMPARE(LuaLexer::scanUtf8LineState("]==] .. y", LuaLexer::scanUtf8LineState(open, 0)),
+             LuaLexer::STATE_NORMAL);
+}
+
+QTEST_MAIN(TestLuaLexer)
+#include "test_lexer.moc"
@@ -0,0 +1,64 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QBuffer>
+#include "Log.h"
+
+class TestLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRingKeepsRecentMessages();
+    void testLineFormat();
+    void testWriteRecentMessages();
+};
+
+void TestLog::testRingKeepsRecentMessages()
+{
+    Log::installRingBufferSink(3);
+    for (int i = 0; i < 5; ++i)
+        qCInfo(lcParser).noquote() << u"message %1"_qs.arg(i);
+
+    const QStringList messages = Log::recentMessages();
+    QCOMPARE(messages.size(), 3);
+    QVERIFY(messages.at(0).endsWith(u"message 2"_qs));
+    QVERIFY(messages.at(2).endsWith(u"message 4"_qs));
+
+    // Abgeschaltete Debug-Ausgaben landen nicht im Puffer
+    qCDebug(lcParser) << "hidden";
+    QCOMPARE(Log::recentMessages(), messages);
+}
+
+void TestLog::testLineFormat()
+{
+    Log::installRingBufferSink(8);
+    qCInfo(lcFiles).noquote() << u"opened a.lua"_qs;
+
+    // "<ISO-Zeitstempel> info luaeditor.files: opened a.lua"
+    const QStringList parts = Log::recentMessages().value(0).split(u' ');
+    QCOMPARE(parts.size(), 5);
+    QVERIFY(QDateTime::fromString(parts.at(0), Qt::ISODateWithMs).isValid());
+    QCOMPARE(parts.at(1), u"info"_qs);
+    QCOMPARE(parts.at(2), u"luaeditor.files:"_qs);
+    QCOMPARE(parts.at(4), u"a.lua"_qs);
+}
+
+void TestLog::testWriteRecentMessages()
+{
+    Log::installRingBufferSink(8);
+    qCInfo(lcLsp).noquote() << u"first"_qs;
+    qCInfo(lcLsp).noquote() << u"second"_qs;
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(Log::writeRecentMessages(&buffer));
+    const QList<QByteArray> lines = buffer.data().trimmed().split('\n');
+    QCOMPARE(lines.size(), 2);
+    QVERIFY(lines.at(0).endsWith("first"));
+    QVERIFY(lines.at(1).endsWith("second"));
+
+    QVERIFY(!Log::writeRecentMessages(nullptr));
+}
+
+QTEST_MAIN(TestLog)
+#include "test_log.moc"
@@ -0,0 +1,401 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QThread>
+#include <QUrl>
+#include "LspServer.h"
+#include "TestUtil.h"
+
+class TestLsp : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testFraming();
+    void testProtocolErrors();
+    void testDefinitionAndReferences();
+    void testIncrementalChange();
+    void testDiagnostics();
+    void testOpenCloseWorkspaceFile();
+    void testCompletionOnLargeWorkspace();
+    void testScriptedClientOnWorkerThread();
+
+private:
+    static QString uri(const QString& path) { return QUrl::fromLocalFile(path).toString(); }
+    static QByteArray request(int id, const QString& method, const QJsonObject& params = {});
+    static QByteArray notification(const QString& method, const QJsonObject& params = {});
+    static QJsonObject decode(const QByteArray& framed);
+    static QJsonObject textPosition(const QString& path, int line, int character);
+
+    // Schickt eine Anfrage und liefert die Antwort mit passender id
+    static QJsonObject call(LspServer& server, QSignalSpy& sent, int id, const QString& method, const QJsonObject& params);
+    void initializeWorkspace(LspServer& server, QSignalSpy& sent, const QString& root);
+
+    TestUtil::Workspace m_dir;
+};
+
+QByteArray TestLsp::request(int id, const QString& method, const QJsonObject& params)
+{
+    return LspServer::encode({{u"jsonrpc"_qs, u"2.0"_qs}, {u"id"_qs, id}, {u"method"_qs, method}, {u"params"_qs, params}});
+}
+
+QByteArray TestLsp::notification(const QString& method, const QJsonObject& params)
+{
+    return LspServer::encode({{u"jsonrpc"_qs, u"2.0"_qs}, {u"method"_qs, method}, {u"params"_qs, params}});
+}
+
+QJsonObject TestLsp::decode(const QByteArray& framed)
+{
+    const qsizetype headerEnd = framed.indexOf("\r\n\r\n");
+    if (headerEnd < 0) return {};
+    const QByteArray body = framed.mid(headerEnd + 4);
+    if (LspServer::contentLength(framed.left(headerEnd)) != body.size()) return {};
+    return QJsonDocument::fromJson(body).object();
+}
+
+QJsonObject TestLsp::textPosition(const QString& path, int line, int character)
+{
+    return {{u"textDocument"_qs, QJsonObject{{u"uri"_qs, uri(path)}}},
+            {u"position"_qs, QJsonObject{{u"line"_qs, line}, {u"character"_qs, character}}}};
+}
+
+QJsonObject TestLsp::call(LspServer& server, QSignalSpy& sent, int id, const QString& method, const QJsonObject& params)
+{
+    server.receive(request(id, method, params));
+    for (const QList<QVariant>& arguments : std::as_const(sent)) {
+        const QJsonObject message = decode(arguments.at(0).toByteArray());
+        if (message.value(u"id"_qs).toInt(-1) == id) return message;
+    }
+    return {};
+}
+
+void TestLsp::initializeWorkspace(LspServer& server, QSignalSpy& sent, const QString& root)
+{
+    QSignalSpy indexed(&server, &LspServer::workspaceIndexed);
+    const QJsonObject response = call(server, sent, 1, u"initialize"_qs, {{u"rootUri"_qs, uri(root)}});
+    QVERIFY(response.contains(u"result"_qs));
+    QTRY_COMPARE_WITH_TIMEOUT(indexed.count(), 1, 20000);
+    server.receive(notification(u"initialized"_qs));
+}
+
+void TestLsp::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_dir.write(u"ws/lib/util.lua"_qs,
+              "Util = {}\n"
+              "function Util.clamp(x, lo, hi)\n"
+              "    return math.max(lo, math.min(hi, x))\n"
+              "end\n");
+    m_dir.write(u"ws/main.lua"_qs,
+              "local Player = {}\n"
+              "function Player:new(name) return name end\n"
+              "print(Util.clamp(5, 0, 1))\n");
+
+    // Größerer Workspace: Completion über viele Dateien
+    for (int f = 0; f < 400; ++f) {
+        QByteArray source = "Mod" + QByteArray::number(f) + " = {}\n";
+        for (int fn = 0; fn < 25; ++fn) {
+            source += "function Mod" + QByteArray::number(f) + ".fn" + QByteArray::number(fn) + "(a, b)\n"
+                      "    return Mod" + QByteArray::number(f) + ".fn0(a, b)\nend\n";
+        }
+        source += "function global_" + QByteArray::number(f) + "() end\n";
+        m_dir.write(u"big/m%1.lua"_qs.arg(f), source);
+    }
+}
+
+void TestLsp::testFraming()
+{
+    const QByteArray framed = LspServer::encode({{u"a"_qs, u"ü"_qs}});
+    QVERIFY(framed.startsWith("Content-Length: "));
+    QCOMPARE(decode(framed).value(u"a"_qs).toString(), u"ü"_qs);
+    QCOMPARE(LspServer::contentLength("Content-Type: x\r\ncontent-length: 42"), 42);
+    QCOMPARE(LspServer::contentLength("Content-Type: x"), -1);
+
+    LspServer server;
+    QSignalSpy sent(&server, &LspServer::send);
+
+    // Byteweise gestückelt: erst mit dem letzten Byte kommt die Antwort
+    const QByteArray init = request(1, u"initialize"_qs, {{u"rootUri"_qs, QJsonValue::Null}});
+    for (qsizetype i = 0; i < init.size() - 1; ++i)
+        server.receive(init.mid(i, 1));
+    QCOMPARE(sent.count(), 0);
+    server.receive(init.right(1));
+    QCOMPARE(sent.count(), 1);
+
+    const QJsonObject capabilities =
+        decode(sent.first().at(0).toByteArray()).value(u"result"_qs).toObject().value(u"capabilities"_qs).toObject();
+    QCOMPARE(capabilities.value(u"textDocumentSync"_qs).toObject().value(u"change"_qs).toInt(), 2);
+    QVERIFY(capabilities.value(u"definitionProvider"_qs).toBool());
+    QVERIFY(capabilities.value(u"completionProvider"_qs).isObject());
+
+    // Zwei Nachrichten in einem Block; exit selbst wird nicht beantwortet
+    QSignalSpy exitSpy(&server, &LspServer::exitRequested);
+    server.receive(request(2, u"shutdown"_qs) + notification(u"exit"_qs));
+    QCOMPARE(sent.count(), 2);
+    QVERIFY(decode(sent.at(1).at(0).toByteArray()).contains(u"result"_qs));
+    QCOMPARE(exitSpy.count(), 1);
+    QCOMPARE(exitSpy.first().at(0).toInt(), 0);
+}
+
+void TestLsp::testProtocolErrors()
+{
+    LspServer server;
+    QSignalSpy sent(&server, &LspServer::send);
+
+    server.receive("Content-Length: 5\r\n\r\n{oops");
+    QCOMPARE(sent.count(), 1);
+    const QJsonObject parseError = decode(sent.takeFirst().at(0).toByteArray());
+    QCOMPARE(parseError.value(u"error"_qs).toObject().value(u"code"_qs).toInt(), -32700);
+    QVERIFY(parseError.value(u"id"_qs).isNull());
+
+    const QJsonObject unknown = call(server, sent, 7, u"workspace/executeCommand"_qs, {});
+    QCOMPARE(unknown.value(u"error"_qs).toObject().value(u"code"_qs).toInt(), -32601);
+
+    // Unbekannte Notifications bleiben unbeantwortet
+    sent.clear();
+    server.receive(notification(u"$/cancelRequest"_qs, {{u"id"_qs, 7}}));
+    QCOMPARE(sent.count(), 0);
+}
+
+void TestLsp::testDefinitionAndReferences()
+{
+    LspServer server;
+    QSignalSpy sent(&server, &LspServer::send);
+    initializeWorkspace(server, sent, m_dir.filePath(u"ws"_qs));
+    QCOMPARE(server.workspaceFileCount(), 2);
+
+    const QString mainPath = QDir::cleanPath(m_dir.filePath(u"ws/main.lua"_qs));
+    const QString utilPath = QDir::cleanPath(m_dir.filePath(u"ws/lib/util.lua"_qs));
+    QFile mainFile(mainPath);
+    QVERIFY(mainFile.open(QIODevice::ReadOnly));
+    server.receive(notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri(mainPath)}, {u"languageId"_qs, u"lua"_qs}, {u"version"_qs, 1},
+        {u"text"_qs, QString::fromUtf8(mainFile.readAll())}}}}));
+
+    // "print(Util.clamp(...))": Cursor auf "clamp" → Definition in lib/util.lua
+    const QJsonObject definition = call(server, sent, 2, u"textDocument/definition"_qs, textPosition(mainPath, 2, 12));
+    const QJsonObject location = definition.value(u"result"_qs).toObject();
+    QCOMPARE(location.value(u"uri"_qs).toString(), uri(utilPath));
+    QCOMPARE(location.value(u"range"_qs).toObject().value(u"start"_qs).toObject().value(u"line"_qs).toInt(), 1);
+
+    QJsonObject referenceParams = textPosition(mainPath, 2, 12);
+    referenceParams[u"context"_qs] = QJsonObject{{u"includeDeclaration"_qs, true}};
+    const QJsonArray references = call(server, sent, 3, u"textDocument/references"_qs, referenceParams)
+                                      .value(u"result"_qs).toArray();
+    QSet<QString> files;
+    for (const QJsonValue& value : references)
+        files.insert(value.toObject().value(u"uri"_qs).toString());
+    QCOMPARE(files, (QSet<QString>{uri(mainPath), uri(utilPath)}));
+
+    referenceParams[u"context"_qs] = QJsonObject{{u"includeDeclaration"_qs, false}};
+    const QJsonArray usesOnly = call(server, sent, 4, u"textDocument/references"_qs, referenceParams)
+                                    .value(u"result"_qs).toArray();
+    QCOMPARE(usesOnly.size(), references.size() - 1);
+
+    const QJsonArray symbols = call(server, sent, 5, u"textDocument/documentSymbol"_qs,
+                                    {{u"textDocument"_qs, QJsonObject{{u"uri"_qs, uri(mainPath)}}}})
+                                   .value(u"result"_qs).toArray();
+    QStringList names;
+    for (const QJsonValue& value : symbols)
+        names.append(value.toObject().value(u"name"_qs).toString());
+    QVERIFY(names.contains(u"Player"_qs));
+    QVERIFY(names.contains(u"new"_qs));
+}
+
+void TestLsp::testIncrementalChange()
+{
+    LspServer server;
+    QSignalSpy sent(&server, &LspServer::send);
+    call(server, sent, 1, u"initialize"_qs, {});
+
+    const QString path = QDir::cleanPath(m_dir.filePath(u"scratch.lua"_qs));
+    server.receive(notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri(path)}, {u"version"_qs, 1}, {u"text"_qs, u"local x = 1\nprint(x)\n"_qs}}}}));
+    QCOMPARE(server.openDocumentCount(), 1);
+
+    // Zeile 1 einfügen, dann "print" durch "Game.print" ersetzen (zwei Änderungen in einer Nachricht)
+    auto rangeAt = [](int line, int from, int to) {
+        return QJsonObject{{u"start"_qs, QJsonObject{{u"line"_qs, line}, {u"character"_qs, from}}},
+                           {u"end"_qs, QJsonObject{{u"line"_qs, line}, {u"character"_qs, to}}}};
+    };
+    server.receive(notification(u"textDocument/didChange"_qs, {
+        {u"textDocument"_qs, QJsonObject{{u"uri"_qs, uri(path)}, {u"version"_qs, 2}}},
+        {u"contentChanges"_qs, QJsonArray{
+            QJsonObject{{u"range"_qs, rangeAt(1, 0, 0)}, {u"text"_qs, u"Game = {}\nfunction Game.spawn(kind) end\n"_qs}},
+            QJsonObject{{u"range"_qs, rangeAt(3, 0, 5)}, {u"text"_qs, u"Game.sp"_qs}},
+        }}}));
+
+    // Cursor hinter "Game.sp" in Zeile 3
+    const QJsonObject members = call(server, sent, 2, u"textDocument/completion"_qs, textPosition(path, 3, 7))
+                                    .value(u"result"_qs).toObject();
+    QStringList labels;
+    for (const QJsonValue& value : members.value(u"items"_qs).toArray())
+        labels.append(value.toObject().value(u"label"_qs).toString());
+    QCOMPARE(labels, QStringList{u"spawn"_qs});
+
+    const QJsonObject globals = call(server, sent, 3, u"textDocument/completion"_qs, textPosition(path, 1, 2))
+                                    .value(u"result"_qs).toObject();
+    labels.clear();
+    for (const QJsonValue& value : globals.value(u"items"_qs).toArray())
+        labels.append(value.toObject().value(u"label"_qs).toString());
+    QVERIFY(labels.contains(u"Game"_qs));
+    QVERIFY(!labels.contains(u"x"_qs)); // Präfix "Ga"
+}
+
+void TestLsp::testDiagnostics()
+{
+    LspServer server;
+    server.setDiagnosticsDelay(0);
+    QSignalSpy sent(&server, &LspServer::send);
+    call(server, sent, 1, u"initialize"_qs, {});
+    sent.clear();
+
+    auto lastDiagnostics = [&sent]() {
+        QJsonObject found;
+        for (const QList<QVariant>& arguments : std::as_const(sent)) {
+            const QJsonObject message = decode(arguments.at(0).toByteArray());
+            if (message.value(u"method"_qs).toString() == u"textDocument/publishDiagnostics"_qs)
+                found = message.value(u"params"_qs).toObject();
+        }
+        return found;
+    };
+
+    const QString path = QDir::cleanPath(m_dir.filePath(u"broken.lua"_qs));
+    server.receive(notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri(path)}, {u"version"_qs, 1}, {u"text"_qs, u"local a = 1\nlocal b = 2 +* 3\n"_qs}}}}));
+    QTRY_VERIFY(!lastDiagnostics().isEmpty());
+
+    QJsonObject params = lastDiagnostics();
+    QCOMPARE(params.value(u"uri"_qs).toString(), uri(path));
+    QCOMPARE(params.value(u"version"_qs).toInt(), 1);
+    const QJsonArray diagnostics = params.value(u"diagnostics"_qs).toArray();
+    QCOMPARE(diagnostics.size(), 1);
+    const QJsonObject start = diagnostics.first().toObject().value(u"range"_qs).toObject().value(u"start"_qs).toObject();
+    QCOMPARE(start.value(u"line"_qs).toInt(), 1);
+    QCOMPARE(start.value(u"character"_qs).toInt(), 13); // near '*'
+
+    // Vollständiger Text ohne range: Fehler behoben → leere Liste
+    sent.clear();
+    server.receive(notification(u"textDocument/didChange"_qs, {
+        {u"textDocument"_qs, QJsonObject{{u"uri"_qs, uri(path)}, {u"version"_qs, 2}}},
+        {u"contentChanges"_qs, QJsonArray{QJsonObject{{u"text"_qs, u"local a = 1\nlocal b = 2\n"_qs}}}}}));
+    QTRY_VERIFY(!lastDiagnostics().isEmpty());
+    params = lastDiagnostics();
+    QCOMPARE(params.value(u"version"_qs).toInt(), 2);
+    QVERIFY(params.value(u"diagnostics"_qs).toArray().isEmpty());
+}
+
+void TestLsp::testOpenCloseWorkspaceFile()
+{
+    LspServer server;
+    QSignalSpy sent(&server, &LspServer::send);
+    initializeWorkspace(server, sent, m_dir.filePath(u"ws"_qs));
+
+    const QString mainPath = QDir::cleanPath(m_dir.filePath(u"ws/main.lua"_qs));
+    const QString utilPath = QDir::cleanPath(m_dir.filePath(u"ws/lib/util.lua"_qs));
+    QFile mainFile(mainPath);
+    QVERIFY(mainFile.open(QIODevice::ReadOnly));
+    server.receive(notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri(mainPath)}, {u"version"_qs, 1}, {u"text"_qs, QString::fromUtf8(mainFile.readAll())}}}}));
+    QVERIFY(call(server, sent, 2, u"textDocument/definition"_qs, textPosition(mainPath, 2, 12))
+                .value(u"result"_qs).isObject());
+
+    // Geöffnet gilt der Editor-Stand: clamp ist umbenannt, der Stand auf der Platte zählt nicht mehr
+    server.receive(notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri(utilPath)}, {u"version"_qs, 1}, {u"text"_qs, u"Util = {}\nfunction Util.limit(x) end\n"_qs}}}}));
+    QVERIFY(call(server, sent, 3, u"textDocument/definition"_qs, textPosition(mainPath, 2, 12))
+                .value(u"result"_qs).isNull());
+
+    // Geschlossen: wieder der Stand auf der Platte
+    server.receive(notification(u"textDocument/didClose"_qs, {{u"textDocument"_qs, QJsonObject{{u"uri"_qs, uri(utilPath)}}}}));
+    const QJsonObject location = call(server, sent, 4, u"textDocument/definition"_qs, textPosition(mainPath, 2, 12))
+                                     .value(u"result"_qs).toObject();
+    QCOMPARE(location.value(u"uri"_qs).toString(), uri(utilPath));
+    QCOMPARE(location.value(u"range"_qs).toObject().value(u"start"_qs).toObject().value(u"line"_qs).toInt(), 1);
+}
+
+void TestLsp::testCompletionOnLargeWorkspace()
+{
+    LspServer server;
+    QSignalSpy sent(&server, &LspServer::send);
+    initializeWorkspace(server, sent, m_dir.filePath(u"big"_qs));
+    QCOMPARE(server.workspaceFileCount(), 400);
+
+    const QString path = QDir::cleanPath(m_dir.filePath(u"big/m7.lua"_qs));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QString text = QString::fromUtf8(file.readAll()) + u"Mod123.f"_qs;
+    server.receive(notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+        {u"uri"_qs, uri(path)}, {u"version"_qs, 1}, {u"text"_qs, text}}}}));
+    const int lastLine = static_cast<int>(text.count(u'\n'));
+
+    // Laufzeiten misst benchmark_parser (lspCompletion)
+    const QJsonObject members = call(server, sent, 2, u"textDocument/completion"_qs, textPosition(path, lastLine, 8))
+                                    .value(u"result"_qs).toObject();
+    const QJsonObject globals = call(server, sent, 3, u"textDocument/completion"_qs, textPosition(path, lastLine, 1))
+                                    .value(u"result"_qs).toObject();
+    QCOMPARE(members.value(u"items"_qs).toArray().size(), 25);
+    QVERIFY(globals.value(u"items"_qs).toArray().size() > 0);
+}
+
+void TestLsp::testScriptedClientOnWorkerThread()
+{
+    // Wie im --lsp-Modus: Server im eigenen Thread, Bytes und Antworten über Queued Connections
+    QThread worker;
+    auto* server = new LspServer;
+    server->moveToThread(&worker);
+    connect(&worker, &QThread::finished, server, &QObject::deleteLater);
+
+    QByteArray stream;
+    QList<int> exitCodes;
+    connect(server, &LspServer::send, this, [&stream](const QByteArray& framed) { stream += framed; });
+    connect(server, &LspServer::exitRequested, this, [&exitCodes](int code) { exitCodes.append(code); });
+    worker.start();
+
+    const QString path = QDir::cleanPath(m_dir.filePath(u"ws/main.lua"_qs));
+    const QByteArray script =
+        request(1, u"initialize"_qs, {{u"rootUri"_qs, uri(m_dir.filePath(u"ws"_qs))}})
+        + notification(u"initialized"_qs)
+        + notification(u"textDocument/didOpen"_qs, {{u"textDocument"_qs, QJsonObject{
+              {u"uri"_qs, uri(path)}, {u"version"_qs, 1}, {u"text"_qs, u"Player = {}\nPl"_qs}}}})
+        + request(2, u"textDocument/completion"_qs, textPosition(path, 1, 2))
+        + request(3, u"shutdown"_qs)
+        + notification(u"exit"_qs);
+    // In unregelmäßigen Stücken schicken, wie eine Pipe sie liefern würde
+    for (qsizetype i = 0; i < script.size(); i += 37) {
+        const QByteArray chunk = script.mid(i, 37);
+        QMetaObject::invokeMethod(server, [server, chunk] { server->receive(chunk); }, Qt::QueuedConnection);
+    }
+
+    QTRY_COMPARE(exitCodes, QList<int>{0});
+
+    QList<int> ids;
+    QStringList completions;
+    while (!stream.isEmpty()) {
+        const qsizetype headerEnd = stream.indexOf("\r\n\r\n");
+        QVERIFY(headerEnd > 0);
+        const qsizetype length = LspServer::contentLength(stream.left(headerEnd));
+        const QJsonObject message = QJsonDocument::fromJson(stream.mid(headerEnd + 4, length)).object();
+        stream.remove(0, headerEnd + 4 + length);
+        if (!message.contains(u"id"_qs)) continue;
+        ids.append(message.value(u"id"_qs).toInt());
+        if (ids.last() == 2) {
+            for (const QJsonValue& item : message.value(u"result"_qs).toObject().value(u"items"_qs).toArray())
+                completions.append(item.toObject().value(u"label"_qs).toString());
+        }
+    }
+    QCOMPARE(ids, (QList<int>{1, 2, 3}));
+    QVERIFY(completions.contains(u"Player"_qs));
+
+    worker.quit();
+    QVERIFY(worker.wait(5000));
+}
+
+QTEST_MAIN(TestLsp)
+#include "test_lsp.moc"
@@ -0,0 +1,51 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include "MainWindow.h"
+#include "TestUtil.h"
+
+class TestMainWindow : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testSwitchingFilesDropsOldSymbols();
+};
+
+void TestMainWindow::testSwitchingFilesDropsOldSymbols()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"a.lua"_qs, "function alpha() end\nShared = {}\n");
+    dir.write(u"b.lua"_qs, "function beta() end\n");
+
+    MainWindow window;
+    auto* editor = window.findChild<LuaEditor*>();
+    QVERIFY(editor);
+    const SymbolTable& symbols = window.symbolTableForTesting();
+
+    // Ungespeicherter Entwurf läuft unter "untitled.lua"
+    editor->setPlainText(u"function draft() end\n"_qs);
+    QVERIFY(symbols.symbols().contains(u"draft"_qs));
+
+    window.openFile(dir.filePath(u"a.lua"_qs));
+    QVERIFY(!symbols.symbols().contains(u"draft"_qs));
+    QVERIFY(symbols.symbols().contains(u"alpha"_qs));
+    QCOMPARE(symbols.symbols().value(u"alpha"_qs).filePath, dir.filePath(u"a.lua"_qs));
+
+    // Weder die Definitionen von a.lua noch die des Entwurfs kommen als Ersatz zurück
+    window.openFile(dir.filePath(u"b.lua"_qs));
+    QVERIFY(symbols.symbols().contains(u"beta"_qs));
+    QVERIFY(!symbols.symbols().contains(u"alpha"_qs));
+    QVERIFY(!symbols.symbols().contains(u"Shared"_qs));
+    QVERIFY(!symbols.symbols().contains(u"draft"_qs));
+    QCOMPARE(symbols.globals(), (QSet<QString>{u"beta"_qs}));
+
+    // Die neue Datei im Editor bearbeiten: alpha taucht auch danach nicht wieder auf
+    editor->setPlainText(u"function gamma() end\n"_qs);
+    QVERIFY(symbols.symbols().contains(u"gamma"_qs));
+    QVERIFY(!symbols.symbols().contains(u"beta"_qs));
+    QVERIFY(!symbols.symbols().contains(u"alpha"_qs));
+}
+
+QTEST_MAIN(TestMainWindow)
+#include "test_mainwindow.moc"
@@ -0,0 +1,245 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QFile>
+#include <QSignalSpy>
+#include "ModuleGraph.h"
+#include "ModuleResolver.h"
+#include "TestUtil.h"
+
+class TestModules : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testTemplatesAndDottedNames();
+    void testPackagePath();
+    void testCachedLookups();
+    void testNegativeCacheInvalidation();
+    void testScanSource();
+    void testTransitiveGraph();
+    void testChangedModuleRescan();
+    void testFailedScanRetried();
+};
+
+void TestModules::testTemplatesAndDottedNames()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"utils.lua"_qs);
+    dir.write(u"modules/net/http.lua"_qs);
+    dir.write(u"game/init.lua"_qs);
+    dir.write(u"lib/plain"_qs);
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+
+    QCOMPARE(resolver.resolve(u"utils"_qs), dir.filePath(u"utils.lua"_qs));
+    QCOMPARE(resolver.resolve(u"utils.lua"_qs), dir.filePath(u"utils.lua"_qs));
+    QCOMPARE(resolver.resolve(u"net.http"_qs), dir.filePath(u"modules/net/http.lua"_qs));
+    QCOMPARE(resolver.resolve(u"game"_qs), dir.filePath(u"game/init.lua"_qs));
+    QCOMPARE(resolver.resolve(u"plain"_qs), dir.filePath(u"lib/plain"_qs));
+    QVERIFY(resolver.resolve(u"missing"_qs).isEmpty());
+    QVERIFY(resolver.resolve(QString()).isEmpty());
+}
+
+void TestModules::testPackagePath()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"vendor/json.lua"_qs);
+    dir.write(u"utils.lua"_qs);
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+    resolver.setPackagePath(u"./vendor/?.lua"_qs);
+    QCOMPARE(resolver.templates(), QStringList{u"./vendor/?.lua"_qs});
+    QCOMPARE(resolver.resolve(u"json"_qs), dir.filePath(u"vendor/json.lua"_qs));
+    QVERIFY(resolver.resolve(u"utils"_qs).isEmpty());
+
+    // ";;" hängt die Standardvorlagen an
+    resolver.setPackagePath(u"./vendor/?.lua;;"_qs);
+    QCOMPARE(resolver.templates().first(), u"./vendor/?.lua"_qs);
+    QCOMPARE(resolver.templates().mid(1), ModuleResolver::defaultTemplates());
+    QCOMPARE(resolver.resolve(u"utils"_qs), dir.filePath(u"utils.lua"_qs));
+
+    // ... auch in der Mitte und am Anfang, ersetzt wird nur das erste
+    resolver.setPackagePath(u"./a/?.lua;;./b/?.lua"_qs);
+    QCOMPARE(resolver.templates(), QStringList{u"./a/?.lua"_qs} + ModuleResolver::defaultTemplates()
+                                       + QStringList{u"./b/?.lua"_qs});
+    resolver.setPackagePath(u";;./a/?.lua"_qs);
+    QCOMPARE(resolver.templates(), ModuleResolver::defaultTemplates() + QStringList{u"./a/?.lua"_qs});
+    resolver.setPackagePath(u"./a/?.lua;;./b/?.lua;;"_qs);
+    QCOMPARE(resolver.templates(), QStringList{u"./a/?.lua"_qs} + ModuleResolver::defaultTemplates()
+                                       + QStringList{u"./b/?.lua"_qs});
+
+    resolver.setPackagePath(QString());
+    QCOMPARE(resolver.templates(), ModuleResolver::defaultTemplates());
+}
+
+void TestModules::testCachedLookups()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"scripts/a.lua"_qs);
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+
+    QVERIFY(!resolver.resolve(u"a"_qs).isEmpty());
+    QVERIFY(resolver.resolve(u"nope"_qs).isEmpty());
+    const int listings = resolver.directoryListings();
+    QVERIFY(listings > 0);
+
+    // Wiederholte Auflösung (auch von Fehlschlägen) liest kein Verzeichnis mehr
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(!resolver.resolve(u"a"_qs).isEmpty());
+        QVERIFY(resolver.resolve(u"nope"_qs).isEmpty());
+    }
+    QCOMPARE(resolver.directoryListings(), listings);
+
+    // Neue Namen im selben Verzeichnis nutzen die vorhandene Liste
+    QVERIFY(resolver.resolve(u"b"_qs).isEmpty());
+    QCOMPARE(resolver.directoryListings(), listings);
+}
+
+void TestModules::testNegativeCacheInvalidation()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+    QSignalSpy changed(&resolver, &ModuleResolver::modulesChanged);
+
+    QVERIFY(resolver.resolve(u"later"_qs).isEmpty());
+    QVERIFY(resolver.resolve(u"deep"_qs).isEmpty());
+
+    // Datei im Basisverzeichnis und in einem noch nicht existierenden Suchverzeichnis anlegen
+    dir.write(u"later.lua"_qs);
+    QTRY_VERIFY(changed.count() > 0);
+    QCOMPARE(resolver.resolve(u"later"_qs), dir.filePath(u"later.lua"_qs));
+
+    // "./lib" fehlte beim ersten Versuch; beobachtet wurde deshalb das Basisverzeichnis
+    dir.write(u"lib/deep.lua"_qs);
+    QTRY_COMPARE(resolver.resolve(u"deep"_qs), dir.filePath(u"lib/deep.lua"_qs));
+}
+
+void TestModules::testScanSource()
+{
+    const QByteArray source =
+        "local json = require(\"vendor.json\")\n"
+        "require \"globals\"\n"
+        "local M = {}\n"
+        "function M.helper() end\n"
+        "M.run = function() end\n"
+        "local function hidden() end\n"
+        "function shout(text) end\n"
+        "-- require(\"commented\")\n"
+        "local s = \"require('inString')\"\n"
+        "return { exported = hidden }\n";
+
+    const ModuleScan scan = ModuleGraph::scanSource(source);
+    QVERIFY(scan.ok);
+
+    const QList<ModuleRequire> expected{{u"json"_qs, u"vendor.json"_qs}, {QString(), u"globals"_qs}};
+    QCOMPARE(scan.imports, expected);
+    QVERIFY(scan.functions.contains(u"run"_qs));
+    QVERIFY(scan.functions.contains(u"hidden"_qs));
+    QVERIFY(scan.functions.contains(u"shout"_qs));
+    QVERIFY(scan.functions.contains(u"exported"_qs));
+    QCOMPARE(scan.globals, QStringList{u"shout"_qs});
+}
+
+void TestModules::testTransitiveGraph()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    // a → b → a (Zyklus), a → c → net.d; "missing" ist nicht auflösbar
+    dir.write(u"a.lua"_qs, "local b = require(\"b\")\nrequire(\"c\")\nfunction fromA() end\n");
+    dir.write(u"b.lua"_qs, "local a = require(\"a\")\nlocal M = {}\nM.fromB = function() end\nreturn M\n");
+    dir.write(u"c.lua"_qs, "require(\"net.d\")\nrequire(\"missing\")\n");
+    dir.write(u"modules/net/d.lua"_qs, "function fromD() end\n");
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+    ModuleGraph graph(&resolver);
+
+    graph.setRoots({{u"a"_qs, u"a"_qs}});
+    QVERIFY(graph.isLoading());
+    QTRY_VERIFY(!graph.isLoading());
+
+    const QString a = dir.filePath(u"a.lua"_qs);
+    const QString b = dir.filePath(u"b.lua"_qs);
+    const QString c = dir.filePath(u"c.lua"_qs);
+    const QString d = dir.filePath(u"modules/net/d.lua"_qs);
+    QCOMPARE(graph.reachableModules(), (QStringList{a, b, c, d}));
+    QCOMPARE(graph.scanCount(), 4);
+
+    QCOMPARE(graph.cycles(), QList<QStringList>{(QStringList{a, b})});
+    QCOMPARE(graph.whyLoaded(d), (QStringList{u"a"_qs, u"c"_qs, u"net.d"_qs}));
+    QCOMPARE(graph.whyLoaded(a), QStringList{u"a"_qs});
+    QVERIFY(graph.whyLoaded(dir.filePath(u"nope.lua"_qs)).isEmpty());
+
+    QCOMPARE(graph.functions(b), QStringList{u"fromB"_qs});
+    QCOMPARE(graph.reachableGlobals(), (QStringList{u"fromA"_qs, u"fromD"_qs}));
+
+    // Neue Wurzeln ohne I/O: alles bereits gescannt
+    graph.setRoots({{QString(), u"c"_qs}});
+    QVERIFY(!graph.isLoading());
+    QCOMPARE(graph.reachableModules(), (QStringList{c, d}));
+    QVERIFY(graph.cycles().isEmpty());
+    QCOMPARE(graph.scanCount(), 4);
+}
+
+void TestModules::testChangedModuleRescan()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"a.lua"_qs, "require(\"b\")\n");
+    dir.write(u"b.lua"_qs, "require(\"c\")\n");
+    dir.write(u"c.lua"_qs, "function fromC() end\n");
+    dir.write(u"d.lua"_qs, "function fromD() end\n");
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+    ModuleGraph graph(&resolver);
+    graph.setRoots({{QString(), u"a"_qs}});
+    QTRY_VERIFY(!graph.isLoading());
+    QCOMPARE(graph.scanCount(), 3);
+
+    // b hängt jetzt von d statt c ab: neu gescannt werden nur b und d
+    dir.write(u"b.lua"_qs, "require(\"d\")\n");
+    const QString d = dir.filePath(u"d.lua"_qs);
+    QTRY_VERIFY(graph.reachableModules().contains(d));
+    QTRY_VERIFY(!graph.isLoading());
+    QVERIFY(!graph.reachableModules().contains(dir.filePath(u"c.lua"_qs)));
+    QCOMPARE(graph.reachableGlobals(), QStringList{u"fromD"_qs});
+    QCOMPARE(graph.scanCount(), 5);
+}
+
+void TestModules::testFailedScanRetried()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"a.lua"_qs, "function fromA() end\n");
+
+    ModuleResolver resolver;
+    resolver.setBaseDirectory(dir.path());
+    const QString a = resolver.resolve(u"a"_qs);
+    QCOMPARE(a, dir.filePath(u"a.lua"_qs));
+
+    // Der Resolver kennt die Datei noch aus seinem Cache, der Scan schlägt fehl
+    QVERIFY(QFile::remove(a));
+    ModuleGraph graph(&resolver);
+    graph.setRoots({{QString(), u"a"_qs}});
+    QTRY_VERIFY(!graph.isLoading());
+    QVERIFY(graph.reachableModules().isEmpty());
+
+    // Fehlschläge werden nicht gecacht: nach dem Neuanlegen wird wieder gescannt
+    dir.write(u"a.lua"_qs, "function fromA() end\n");
+    QTRY_COMPARE(graph.functions(a), QStringList{u"fromA"_qs});
+    QCOMPARE(graph.reachableModules(), QStringList{a});
+}
+
+QTEST_MAIN(TestModules)
+#include "test_modules.moc"
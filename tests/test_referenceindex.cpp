@@ -0,0 +1,239 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDir>
+#include <QFile>
+#include <algorithm>
+#include <tuple>
+#include "ReferenceIndex.h"
+#include "ReferenceListModel.h"
+#include "TestUtil.h"
+
+class TestReferenceIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testBuildAndQuery();
+    void testPagingMatchesFullDecode();
+    void testCompactEncoding();
+    void testModelFetchMore();
+    void testUpdateFile();
+    void testDefinition();
+    void testDefinitionsRevision();
+    void testFindProjectRoot();
+
+private:
+    static QList<ReferenceIndex::Location> all(const ReferenceIndex& index, const QString& name);
+
+    static constexpr int GENERATED_FILES = 3000;
+    static constexpr int CALLS_PER_FILE = 2;
+    static constexpr quint32 TOTAL = 1 + 3 + GENERATED_FILES * CALLS_PER_FILE; // Definition + b.lua + gen/
+
+    TestUtil::Workspace m_dir;
+    std::shared_ptr<ReferenceIndex> m_index;
+};
+
+QList<ReferenceIndex::Location> TestReferenceIndex::all(const ReferenceIndex& index, const QString& name)
+{
+    ReferenceIndex::Cursor cursor = index.query(name);
+    return cursor.next(static_cast<int>(cursor.total()));
+}
+
+void TestReferenceIndex::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_dir.write(u"a.lua"_qs,
+              "Util = {}\n"
+              "function Util.clamp(x) return x end\n");
+    m_dir.write(u"b.lua"_qs,
+              "local v = Util.clamp(1)\n"
+              "local w = Util.clamp(2) + Util.clamp(3)\n");
+    for (int i = 0; i < GENERATED_FILES; ++i) {
+        m_dir.write(u"gen/g%1.lua"_qs.arg(i, 4, 10, QChar(u'0')),
+                  "local M = {}\n"
+                  "function M.run" + QByteArray::number(i) + "(a)\n"
+                  "    return Util.clamp(a) + Util.clamp(-a)\n"
+                  "end\n"
+                  "return M\n");
+    }
+
+    m_index = std::make_shared<ReferenceIndex>();
+    QVERIFY(m_index->build(m_dir.path(), 4));
+}
+
+void TestReferenceIndex::testBuildAndQuery()
+{
+    QCOMPARE(m_index->stats().files, GENERATED_FILES + 2);
+    QCOMPARE(m_index->files().first(), u"a.lua"_qs);
+    QCOMPARE(m_index->count(u"Util.clamp"_qs), TOTAL);
+    QCOMPARE(m_index->count(u"Nope.missing"_qs), 0u);
+    QVERIFY(m_index->contains(u"M.run42"_qs));
+
+    const QList<ReferenceIndex::Location> locations = all(*m_index, u"Util.clamp"_qs);
+    QCOMPARE(locations.size(), qsizetype(TOTAL));
+
+    // Definition und Verwendung an derselben Stelle ergeben einen Eintrag mit Flag
+    QCOMPARE(locations.at(0), (ReferenceIndex::Location{0, 2, 10, true}));
+    QCOMPARE(locations.at(1), (ReferenceIndex::Location{1, 1, 11, false}));
+    QCOMPARE(locations.at(2), (ReferenceIndex::Location{1, 2, 11, false}));
+    QCOMPARE(locations.at(3), (ReferenceIndex::Location{1, 2, 27, false}));
+    QCOMPARE(m_index->filePath(1), QDir::cleanPath(m_dir.filePath(u"b.lua"_qs)));
+
+    QVERIFY(std::is_sorted(locations.begin(), locations.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.file, a.line, a.column) < std::tie(b.file, b.line, b.column);
+    }));
+}
+
+void TestReferenceIndex::testPagingMatchesFullDecode()
+{
+    const QList<ReferenceIndex::Location> expected = all(*m_index, u"Util.clamp"_qs);
+
+    ReferenceIndex::Cursor cursor = m_index->query(u"Util.clamp"_qs);
+    QList<ReferenceIndex::Location> paged;
+    while (!cursor.atEnd()) {
+        const QList<ReferenceIndex::Location> page = cursor.next(7);
+        QVERIFY(!page.isEmpty() && page.size() <= 7);
+        paged += page;
+    }
+    QCOMPARE(paged, expected);
+    QCOMPARE(cursor.remaining(), 0u);
+    QVERIFY(cursor.next(10).isEmpty());
+
+    ReferenceIndex::Cursor empty = m_index->query(u"Nope.missing"_qs);
+    QVERIFY(empty.atEnd());
+    QVERIFY(empty.next(10).isEmpty());
+}
+
+void TestReferenceIndex::testCompactEncoding()
+{
+    const ReferenceIndex::Stats stats = m_index->stats();
+    QVERIFY(stats.postings > 0);
+    const double bytesPerReference = static_cast<double>(stats.encodedBytes) / static_cast<double>(stats.postings);
+    QVERIFY(bytesPerReference < 4.0);
+}
+
+void TestReferenceIndex::testModelFetchMore()
+{
+    ReferenceListModel model;
+    model.setQuery(m_index, u"Util.clamp"_qs);
+    QCOMPARE(model.totalCount(), TOTAL);
+    QCOMPARE(model.rowCount(), ReferenceListModel::PAGE_SIZE);
+    QVERIFY(model.canFetchMore({}));
+
+    const QModelIndex first = model.index(0);
+    QCOMPARE(first.data().toString(), u"a.lua:2:10  (definition)"_qs);
+    QCOMPARE(first.data(ReferenceListModel::FilePathRole).toString(), QDir::cleanPath(m_dir.filePath(u"a.lua"_qs)));
+    QCOMPARE(first.data(ReferenceListModel::LineRole).toInt(), 2);
+    QVERIFY(first.data(ReferenceListModel::IsDefinitionRole).toBool());
+
+    int fetches = 0;
+    while (model.canFetchMore({})) {
+        model.fetchMore({});
+        ++fetches;
+    }
+    QCOMPARE(model.rowCount(), int(TOTAL));
+    QCOMPARE(fetches, int((TOTAL + ReferenceListModel::PAGE_SIZE - 1) / ReferenceListModel::PAGE_SIZE) - 1);
+    QCOMPARE(model.index(int(TOTAL) - 1).data(ReferenceListModel::FilePathRole).toString(),
+             QDir::cleanPath(m_dir.filePath(u"gen/g%1.lua"_qs.arg(GENERATED_FILES - 1, 4, 10, QChar(u'0')))));
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(!model.canFetchMore({}));
+}
+
+void TestReferenceIndex::testUpdateFile()
+{
+    ReferenceIndex index = *m_index;
+    ReferenceIndex::Cursor before = index.query(u"Util.clamp"_qs);
+
+    // b.lua verliert alle drei Aufrufe
+    index.updateFile(m_dir.filePath(u"b.lua"_qs), u"print(1)\n"_qs);
+    QCOMPARE(index.count(u"Util.clamp"_qs), TOTAL - 3);
+    QVERIFY(index.contains(u"print"_qs));
+
+    // Neue Datei wird hinten angehängt
+    const QString added = QDir::cleanPath(m_dir.filePath(u"c.lua"_qs));
+    index.updateFile(added, u"\nlocal z = Util.clamp(9)\n"_qs);
+    QCOMPARE(index.count(u"Util.clamp"_qs), TOTAL - 2);
+    const QList<ReferenceIndex::Location> locations = all(index, u"Util.clamp"_qs);
+    QCOMPARE(index.filePath(locations.last().file), added);
+    QCOMPARE(locations.last().line, 2);
+
+    // Definition entfernt
+    index.removeFile(m_dir.filePath(u"a.lua"_qs));
+    QCOMPARE(index.count(u"Util.clamp"_qs), TOTAL - 3);
+    QVERIFY(!all(index, u"Util.clamp"_qs).first().isDefinition);
+    QCOMPARE(index.stats().files, GENERATED_FILES + 2);
+    index.removeFile(m_dir.filePath(u"a.lua"_qs));
+    QCOMPARE(index.stats().files, GENERATED_FILES + 2);
+
+    // Wieder aufgenommen: alte ID, kein zweiter Eintrag in files()
+    index.updateFile(m_dir.filePath(u"a.lua"_qs), u"Util = {}\nfunction Util.clamp(x) return x end\n"_qs);
+    QCOMPARE(index.files().size(), qsizetype(GENERATED_FILES + 3));
+    QCOMPARE(index.stats().files, GENERATED_FILES + 3);
+    QCOMPARE(*index.definition(u"Util.clamp"_qs), (ReferenceIndex::Location{0, 2, 10, true}));
+
+    // Ein vorher geöffneter Cursor sieht weiterhin den alten Stand, ebenso der Ausgangsindex
+    QCOMPARE(before.next(int(TOTAL) + 10).size(), qsizetype(TOTAL));
+    QCOMPARE(m_index->count(u"Util.clamp"_qs), TOTAL);
+}
+
+void TestReferenceIndex::testDefinition()
+{
+    const auto clamp = m_index->definition(u"Util.clamp"_qs);
+    QVERIFY(clamp.has_value());
+    QCOMPARE(*clamp, (ReferenceIndex::Location{0, 2, 10, true}));
+    QCOMPARE(m_index->filePath(clamp->file), QDir::cleanPath(m_dir.filePath(u"a.lua"_qs)));
+
+    const auto run = m_index->definition(u"M.run42"_qs);
+    QVERIFY(run.has_value());
+    QCOMPARE(m_index->files().at(run->file), u"gen/g0042.lua"_qs);
+    QCOMPARE(run->line, 2);
+    QCOMPARE(run->column, 10);
+
+    // Nur verwendet, nie definiert
+    QVERIFY(!m_index->definition(u"print"_qs).has_value());
+    QVERIFY(!m_index->definition(u"Nope.missing"_qs).has_value());
+
+    // Updates verschieben bzw. entfernen die Definition
+    ReferenceIndex index = *m_index;
+    index.updateFile(m_dir.filePath(u"a.lua"_qs), u"Util = {}\n\n\nfunction Util:clamp(x) return x end\n"_qs);
+    QCOMPARE(index.definition(u"Util.clamp"_qs)->line, 4);
+    index.updateFile(m_dir.filePath(u"a.lua"_qs), u"Util = {}\n"_qs);
+    QVERIFY(!index.definition(u"Util.clamp"_qs).has_value());
+    QVERIFY(index.definition(u"Util"_qs).has_value());
+}
+
+void TestReferenceIndex::testDefinitionsRevision()
+{
+    ReferenceIndex index = *m_index;
+    const quint64 initial = index.definitionsRevision();
+
+    // Nur Verwendungen geändert: Definitionen bleiben, keine neue Revision
+    index.updateFile(m_dir.filePath(u"b.lua"_qs), u"local v = Util.clamp(1)\nlocal w = Util.clamp(2)\n"_qs);
+    QCOMPARE(index.definitionsRevision(), initial);
+
+    index.updateFile(m_dir.filePath(u"b.lua"_qs), u"function Util.wrap(x) return x end\n"_qs);
+    QVERIFY(index.definitionsRevision() != initial);
+}
+
+void TestReferenceIndex::testFindProjectRoot()
+{
+    TestUtil::Workspace workspace;
+    QVERIFY(workspace.isValid());
+    workspace.write(u".luarc.json"_qs, "{}\n");
+    workspace.write(u"src/deep/a.lua"_qs);
+    workspace.write(u"vendor/lib/b.lua"_qs);
+    QVERIFY(QDir().mkpath(workspace.filePath(u"vendor/lib/.git"_qs)));
+
+    const QString root = QFileInfo(workspace.path()).absoluteFilePath();
+    QCOMPARE(ReferenceIndex::findProjectRoot(workspace.filePath(u"src/deep/a.lua"_qs)), root);
+    QCOMPARE(ReferenceIndex::findProjectRoot(workspace.filePath(u"src"_qs)), root);
+    // Der nächste Marker gewinnt
+    QCOMPARE(ReferenceIndex::findProjectRoot(workspace.filePath(u"vendor/lib/b.lua"_qs)),
+             QFileInfo(workspace.filePath(u"vendor/lib"_qs)).absoluteFilePath());
+}
+
+QTEST_MAIN(TestReferenceIndex)
+#include "test_referenceindex.moc"
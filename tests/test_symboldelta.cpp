@@ -0,0 +1,144 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QString>
+#include "LuaParser.h"
+
+class TestSymbolDelta : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testFirstParseAddsEverything();
+    void testReparseUnchangedIsEmpty();
+    void testAddRemoveMove();
+    void testReferencesChanged();
+    void testStaleSymbolsDisappear();
+    void testOtherFileTakesOver();
+    void testRemoveFileAndReset();
+    void testListeners();
+
+private:
+    static QStringList names(const QList<Symbol>& symbols);
+};
+
+QStringList TestSymbolDelta::names(const QList<Symbol>& symbols)
+{
+    QStringList out;
+    for (const Symbol& symbol : symbols)
+        out.append(SymbolTable::qualifiedName(symbol.parent, symbol.name));
+    out.sort();
+    return out;
+}
+
+void TestSymbolDelta::testFirstParseAddsEverything()
+{
+    LuaParser parser;
+    const SymbolDelta delta = parser.parseFile(u"Util = {}\nfunction Util.clamp(x) return x end\nfunction helper() end\n"_qs,
+                                               u"a.lua"_qs);
+    QCOMPARE(delta.filePath, u"a.lua"_qs);
+    QCOMPARE(names(delta.added), (QStringList{u"Util"_qs, u"Util.clamp"_qs, u"helper"_qs}));
+    QVERIFY(delta.removed.isEmpty());
+    QVERIFY(delta.changed.isEmpty());
+}
+
+void TestSymbolDelta::testReparseUnchangedIsEmpty()
+{
+    LuaParser parser;
+    const QString code = u"Util = {}\nfunction Util.clamp(x) return x end\nlocal v = Util.clamp(1)\n"_qs;
+    parser.parseFile(code, u"a.lua"_qs);
+    QVERIFY(parser.parseFile(code, u"a.lua"_qs).isEmpty());
+    // Verwendungen werden nicht doppelt gezählt
+    QCOMPARE(parser.findUsages(u"clamp"_qs, u"Util"_qs).size(),
+             LuaParser().parseOne(code, u"a.lua"_qs).findUsages(u"clamp"_qs, u"Util"_qs).size());
+}
+
+void TestSymbolDelta::testAddRemoveMove()
+{
+    LuaParser parser;
+    parser.parseFile(u"function a() end\nfunction b() end\nfunction c(x) end\n"_qs, u"f.lua"_qs);
+
+    // b entfällt, c rutscht eine Zeile nach oben und bekommt eine neue Signatur, d kommt dazu
+    const SymbolDelta delta = parser.parseFile(u"function a() end\nfunction c(x, y) end\nfunction d() end\n"_qs,
+                                               u"f.lua"_qs);
+    QCOMPARE(names(delta.added), (QStringList{u"d"_qs}));
+    QCOMPARE(names(delta.removed), (QStringList{u"b"_qs}));
+    QCOMPARE(names(delta.changed), (QStringList{u"c"_qs}));
+    QCOMPARE(delta.changed.first().pos.line, 2);
+    QCOMPARE(delta.changed.first().signature, u"(x, y)"_qs);
+    QCOMPARE(delta.removed.first().pos.line, 2); // alter Stand
+}
+
+void TestSymbolDelta::testReferencesChanged()
+{
+    LuaParser parser;
+    parser.parseFile(u"function f() end\nf()\n"_qs, u"r.lua"_qs);
+    const SymbolDelta delta = parser.parseFile(u"function f() end\nf()\nf()\n"_qs, u"r.lua"_qs);
+    QVERIFY(delta.added.isEmpty() && delta.removed.isEmpty() && delta.changed.isEmpty());
+    QCOMPARE(delta.referencesChanged, (QStringList{u"f"_qs}));
+}
+
+void TestSymbolDelta::testStaleSymbolsDisappear()
+{
+    LuaParser parser;
+    parser.parseFile(u"oldName = 1\n"_qs, u"s.lua"_qs);
+    parser.parseFile(u"newName = 1\n"_qs, u"s.lua"_qs);
+    QCOMPARE(parser.getGlobals(), (QStringList{u"newName"_qs}));
+    QVERIFY(!parser.findDefinition(u"oldName"_qs).has_value());
+}
+
+void TestSymbolDelta::testOtherFileTakesOver()
+{
+    LuaParser parser;
+    parser.parseFile(u"function shared() end\n"_qs, u"a.lua"_qs);
+    parser.parseFile(u"\n\nfunction shared() end\n"_qs, u"b.lua"_qs);
+    QCOMPARE(parser.findDefinition(u"shared"_qs)->filePath, u"b.lua"_qs);
+
+    // b.lua verliert die Definition: die aus a.lua gilt wieder, gemeldet als Änderung
+    const SymbolDelta delta = parser.parseFile(u"print(1)\n"_qs, u"b.lua"_qs);
+    QCOMPARE(names(delta.changed), (QStringList{u"shared"_qs}));
+    QCOMPARE(delta.changed.first().filePath, u"a.lua"_qs);
+    QVERIFY(delta.removed.isEmpty());
+    QCOMPARE(parser.findDefinition(u"shared"_qs)->pos.line, 1);
+}
+
+void TestSymbolDelta::testRemoveFileAndReset()
+{
+    LuaParser parser;
+    parser.parseFile(u"function a() end\n"_qs, u"a.lua"_qs);
+    parser.parseFile(u"function b() end\nb()\n"_qs, u"b.lua"_qs);
+
+    const SymbolDelta removed = parser.removeFile(u"b.lua"_qs);
+    QCOMPARE(names(removed.removed), (QStringList{u"b"_qs}));
+    QVERIFY(parser.findUsages(u"b"_qs).isEmpty());
+    QCOMPARE(parser.getGlobals(), (QStringList{u"a"_qs}));
+    QCOMPARE(parser.symbolTable().globals(), (QSet<QString>{u"a"_qs}));
+
+    SymbolDelta last;
+    parser.addDeltaListener([&](const SymbolDelta& delta) { last = delta; });
+    parser.resetProject();
+    QCOMPARE(names(last.removed), (QStringList{u"a"_qs}));
+    QVERIFY(parser.getGlobals().isEmpty());
+}
+
+void TestSymbolDelta::testListeners()
+{
+    LuaParser parser;
+    int calls = 0;
+    QStringList added;
+    const int id = parser.addDeltaListener([&](const SymbolDelta& delta) {
+        ++calls;
+        added += names(delta.added);
+    });
+
+    parser.parseFile(u"x = 1\n"_qs, u"l.lua"_qs);
+    parser.parseFile(u"x = 1\n"_qs, u"l.lua"_qs);   // keine Änderung → keine Meldung
+    QCOMPARE(calls, 1);
+    QCOMPARE(added, (QStringList{u"x"_qs}));
+
+    parser.removeDeltaListener(id);
+    parser.parseFile(u"y = 2\n"_qs, u"l.lua"_qs);
+    QCOMPARE(calls, 1);
+}
+
+QTEST_MAIN(TestSymbolDelta)
+#include "test_symboldelta.moc"
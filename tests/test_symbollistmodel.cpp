@@ -0,0 +1,148 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QAbstractItemModelTester>
+#include <QSignalSpy>
+#include <algorithm>
+#include "SymbolListModel.h"
+
+class TestSymbolListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testInitialFill();
+    void testUnchangedEmitsNothing();
+    void testInsertRemoveChange();
+    void testApplyDelta();
+    void testLargeListSingleEdit();
+
+private:
+    static QStringList names(const SymbolListModel& model);
+    static QList<SymbolListModel::Entry> generated(int count);
+};
+
+QStringList TestSymbolListModel::names(const SymbolListModel& model)
+{
+    QStringList out;
+    for (int row = 1; row < model.rowCount(); ++row)
+        out.append(model.index(row).data(SymbolListModel::NameRole).toString());
+    return out;
+}
+
+QList<SymbolListModel::Entry> TestSymbolListModel::generated(int count)
+{
+    QList<SymbolListModel::Entry> entries;
+    for (int i = 0; i < count; ++i)
+        entries.append({u"global%1"_qs.arg(i, 5, 10, QChar(u'0')), QString(), i + 1});
+    return entries;
+}
+
+void TestSymbolListModel::testInitialFill()
+{
+    SymbolListModel model(u"Functions"_qs);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.index(0).data().toString(), u"Functions"_qs);
+    QCOMPARE(model.flags(model.index(0)), Qt::ItemFlags(Qt::NoItemFlags));
+
+    model.setEntries({{u"update"_qs, u"(dt)"_qs, 3}, {u"Init"_qs, u"()"_qs, 1}, {u"draw"_qs, QString(), 7}});
+    QCOMPARE(model.count(), 3);
+    QCOMPARE(names(model), (QStringList{u"draw"_qs, u"Init"_qs, u"update"_qs}));
+    QCOMPARE(model.index(3).data().toString(), u"update (dt)"_qs);
+    QCOMPARE(model.index(3).data(SymbolListModel::LineRole).toInt(), 3);
+    QVERIFY(model.flags(model.index(1)) & Qt::ItemIsSelectable);
+}
+
+void TestSymbolListModel::testUnchangedEmitsNothing()
+{
+    SymbolListModel model(u"Globals"_qs);
+    model.setEntries(generated(50));
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QList<SymbolListModel::Entry> shuffled = generated(50);
+    std::reverse(shuffled.begin(), shuffled.end());
+    model.setEntries(shuffled);
+    QCOMPARE(inserted.count(), 0);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(reset.count(), 0);
+}
+
+void TestSymbolListModel::testInsertRemoveChange()
+{
+    SymbolListModel model(u"Globals"_qs);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setEntries({{u"a"_qs, {}, 1}, {u"b"_qs, {}, 2}, {u"c"_qs, {}, 3}, {u"d"_qs, {}, 4}, {u"e"_qs, {}, 5}});
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    // b, c weg (ein Block), d mit neuer Zeile, f und g angehängt (ein Block)
+    model.setEntries({{u"a"_qs, {}, 1}, {u"d"_qs, {}, 9}, {u"e"_qs, {}, 5}, {u"f"_qs, {}, 6}, {u"g"_qs, {}, 7}});
+    QCOMPARE(names(model), (QStringList{u"a"_qs, u"d"_qs, u"e"_qs, u"f"_qs, u"g"_qs}));
+
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.first().at(1).toInt(), 2);  // Zeile 0 ist die Überschrift
+    QCOMPARE(removed.first().at(2).toInt(), 3);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), 4);
+    QCOMPARE(inserted.first().at(2).toInt(), 5);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.first().at(0).value<QModelIndex>().row(), 2);
+    QCOMPARE(model.index(2).data(SymbolListModel::LineRole).toInt(), 9);
+
+    // Einfügen zwischen bestehenden Zeilen
+    model.setEntries({{u"a"_qs, {}, 1}, {u"c"_qs, {}, 3}, {u"d"_qs, {}, 9}, {u"e"_qs, {}, 5}, {u"f"_qs, {}, 6},
+                      {u"g"_qs, {}, 7}});
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(inserted.last().at(1).toInt(), 2);
+    QCOMPARE(names(model), (QStringList{u"a"_qs, u"c"_qs, u"d"_qs, u"e"_qs, u"f"_qs, u"g"_qs}));
+
+    model.setEntries({});
+    QCOMPARE(model.rowCount(), 1);
+}
+
+void TestSymbolListModel::testApplyDelta()
+{
+    SymbolListModel model(u"Tables"_qs);
+    QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+    model.setEntries({{u"Camera"_qs, {}, 1}, {u"Player"_qs, {}, 5}});
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    model.applyDelta({u"Camera"_qs, u"Unknown"_qs}, {{u"enemy"_qs, {}, 8}, {u"Player"_qs, {}, 6}, {u"Zone"_qs, {}, 9}});
+
+    QCOMPARE(names(model), (QStringList{u"enemy"_qs, u"Player"_qs, u"Zone"_qs}));
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(inserted.count(), 2);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(model.index(2).data(SymbolListModel::LineRole).toInt(), 6);
+}
+
+void TestSymbolListModel::testLargeListSingleEdit()
+{
+    SymbolListModel model(u"Globals"_qs);
+    QList<SymbolListModel::Entry> entries = generated(20000);
+    model.setEntries(entries);
+
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    // Ein Tastendruck benennt einen Namen um: genau eine Zeile raus, eine rein
+    entries[12345].name += u'x';
+    model.setEntries(entries);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(removed.first().at(1).toInt(), removed.first().at(2).toInt());
+    QCOMPARE(model.count(), 20000);
+}
+
+QTEST_MAIN(TestSymbolListModel)
+#include "test_symbollistmodel.moc"
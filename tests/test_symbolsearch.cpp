@@ -0,0 +1,212 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+#include "ReferenceIndex.h"
+#include "SymbolSearch.h"
+
+class TestSymbolSearch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testScore();
+    void testRanking();
+    void testLimitAndOrder();
+    void testThreadCountIndependent();
+    void testNarrowing();
+    void testNoMatch();
+    void testBuildFromReferenceIndex();
+    void testMillionSymbols();
+
+private:
+    static void fill(SymbolSearch& search, int count);
+    static QList<QString> names(const SymbolSearch& search, const SymbolSearch::Result& result);
+
+    static constexpr int GENERATED = 100000;
+    static constexpr int LARGE = 1000000;
+
+    std::unique_ptr<SymbolSearch> m_search;
+};
+
+// Engine-Bindings nachgebildet: Namespace.KlasseN.verbNomen
+void TestSymbolSearch::fill(SymbolSearch& search, int count)
+{
+    static const char* const spaces[] = {"Engine", "Render", "Physics", "Audio", "Net", "UI", "Game"};
+    static const char* const classes[] = {"Player", "Camera", "Mesh", "Texture", "Body", "Socket", "Widget",
+                                          "Sound", "Light", "Scene", "Input", "Timer", "Shader"};
+    static const char* const verbs[] = {"get", "set", "update", "create", "destroy", "load", "apply",
+                                        "reset", "find", "compute", "draw"};
+    static const char* const nouns[] = {"Position", "Velocity", "Color", "Size", "State", "Name", "Parent",
+                                        "Child", "Bounds", "Volume", "Speed", "Mass", "Handle", "Layer",
+                                        "Target", "Depth", "Flags"};
+    search.reserve(count, qsizetype{count} * 32);
+    for (int i = 0; i < count; ++i) {
+        QByteArray name = spaces[i % 7];
+        name += '.';
+        name += classes[(i / 7) % 13];
+        name += QByteArray::number(i / 91);
+        name += '.';
+        name += verbs[i % 11];
+        name += nouns[(i / 11) % 17];
+        search.addSymbol(name, u"gen/f%1.lua"_qs.arg(i / 1000), i % 1000 + 1, 1);
+    }
+}
+
+QList<QString> TestSymbolSearch::names(const SymbolSearch& search, const SymbolSearch::Result& result)
+{
+    QList<QString> out;
+    for (const SymbolSearch::Hit& hit : result.hits)
+        out.append(search.name(hit.symbol));
+    return out;
+}
+
+void TestSymbolSearch::initTestCase()
+{
+    m_search = std::make_unique<SymbolSearch>(4);
+    fill(*m_search, GENERATED);
+    QCOMPARE(m_search->size(), GENERATED);
+}
+
+void TestSymbolSearch::testScore()
+{
+    // Wortanfang und zusammenhängende Treffer schlagen verstreute Zeichen
+    const int updateAll = SymbolSearch::score("updateAll", "upd");
+    const int playerUpdate = SymbolSearch::score("Player.update", "upd");
+    const int unpaid = SymbolSearch::score("unpaid", "upd");
+    const int utilPad = SymbolSearch::score("Util.pad", "upd");
+    QVERIFY(updateAll > unpaid);
+    QVERIFY(playerUpdate > unpaid);
+    QVERIFY(unpaid > utilPad);
+    QVERIFY(utilPad > 0);
+
+    // CamelCase-Grenzen zählen
+    QVERIFY(SymbolSearch::score("getPlayerName", "gpn") > SymbolSearch::score("gappingnote", "gpn"));
+
+    // Groß-/Kleinschreibung egal, Reihenfolge nicht
+    QVERIFY(SymbolSearch::score("Player.Update", "upd") > 0);
+    QCOMPARE(SymbolSearch::score("Util.pad", "dpu"), -1);
+    QCOMPARE(SymbolSearch::score("pad", "padding"), -1);
+    QCOMPARE(SymbolSearch::score("pad", ""), 0);
+}
+
+void TestSymbolSearch::testRanking()
+{
+    SymbolSearch search(2);
+    search.addSymbol("calcLamp", u"a.lua"_qs, 1, 1);
+    search.addSymbol("Util.clampVector", u"a.lua"_qs, 2, 1);
+    search.addSymbol("Player.update", u"b.lua"_qs, 3, 1);
+    search.addSymbol("Util.clamp", u"a.lua"_qs, 4, 10);
+
+    const SymbolSearch::Result result = search.search(u"clamp"_qs, 10);
+    QCOMPARE(names(search, result), (QList<QString>{u"Util.clamp"_qs, u"Util.clampVector"_qs, u"calcLamp"_qs}));
+    QCOMPARE(result.matches, (QList<quint32>{0, 1, 3}));
+
+    const quint32 best = result.hits.first().symbol;
+    QCOMPARE(search.filePath(best), u"a.lua"_qs);
+    QCOMPARE(search.line(best), 4);
+    QCOMPARE(search.column(best), 10);
+
+    // Leerzeichen werden ignoriert
+    QCOMPARE(names(search, search.search(u"util clamp"_qs, 1)), (QList<QString>{u"Util.clamp"_qs}));
+}
+
+void TestSymbolSearch::testLimitAndOrder()
+{
+    const SymbolSearch::Result result = m_search->search(u"plupd"_qs, 25);
+    QCOMPARE(result.hits.size(), 25);
+    QVERIFY(result.matches.size() > 25);
+    QVERIFY(std::is_sorted(result.matches.begin(), result.matches.end()));
+    for (qsizetype i = 1; i < result.hits.size(); ++i)
+        QVERIFY(result.hits.at(i - 1).score >= result.hits.at(i).score);
+    // Bester Treffer: Player<n>.update… (Grenzen an P und u)
+    QVERIFY(m_search->name(result.hits.first().symbol).contains(u".update"_qs));
+    QVERIFY(m_search->name(result.hits.first().symbol).contains(u".Player"_qs));
+}
+
+void TestSymbolSearch::testThreadCountIndependent()
+{
+    SymbolSearch single(1);
+    fill(single, GENERATED);
+    for (const QString& query : {u"plupd"_qs, u"cam"_qs, u"texsetcol"_qs, u"e"_qs}) {
+        const SymbolSearch::Result a = single.search(query, 50);
+        const SymbolSearch::Result b = m_search->search(query, 50);
+        QCOMPARE(a.matches, b.matches);
+        QCOMPARE(a.hits.size(), b.hits.size());
+        for (qsizetype i = 0; i < a.hits.size(); ++i) {
+            QCOMPARE(a.hits.at(i).symbol, b.hits.at(i).symbol);
+            QCOMPARE(a.hits.at(i).score, b.hits.at(i).score);
+        }
+    }
+}
+
+void TestSymbolSearch::testNarrowing()
+{
+    const SymbolSearch::Result first = m_search->search(u"ph"_qs, 20);
+    const SymbolSearch::Result narrowed = m_search->search(u"phbodyvel"_qs, 20, &first.matches);
+    const SymbolSearch::Result full = m_search->search(u"phbodyvel"_qs, 20);
+    QVERIFY(!full.matches.isEmpty());
+    QVERIFY(full.matches.size() < first.matches.size());
+    QCOMPARE(narrowed.matches, full.matches);
+    QCOMPARE(names(*m_search, narrowed), names(*m_search, full));
+}
+
+void TestSymbolSearch::testNoMatch()
+{
+    QVERIFY(m_search->search(u"xyzzy"_qs, 10).matches.isEmpty());
+    QVERIFY(m_search->search(u"   "_qs, 10).hits.isEmpty());
+    QVERIFY(m_search->search(u"Spielerä"_qs, 10).hits.isEmpty());
+    QVERIFY(m_search->search(u"player"_qs, 0).hits.isEmpty());
+}
+
+void TestSymbolSearch::testBuildFromReferenceIndex()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto write = [&](const QString& name, const QByteArray& content) {
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    };
+    write(u"a.lua"_qs, "Util = {}\nfunction Util.clamp(x) return x end\n");
+    write(u"b.lua"_qs, "local v = Util.clamp(1)\nfunction helper() end\n");
+
+    ReferenceIndex index;
+    QVERIFY(index.build(dir.path(), 2));
+    SymbolSearch search;
+    search.build(index);
+    QCOMPARE(search.size(), index.definitions().size());
+
+    const SymbolSearch::Result result = search.search(u"clamp"_qs, 5);
+    QCOMPARE(names(search, result), (QList<QString>{u"Util.clamp"_qs}));
+    const quint32 clamp = result.hits.first().symbol;
+    QCOMPARE(search.filePath(clamp), QDir::cleanPath(dir.filePath(u"a.lua"_qs)));
+    QCOMPARE(search.line(clamp), 2);
+    QCOMPARE(search.column(clamp), 10);
+
+    QCOMPARE(names(search, search.search(u"help"_qs, 5)), (QList<QString>{u"helper"_qs}));
+}
+
+void TestSymbolSearch::testMillionSymbols()
+{
+    SymbolSearch search;
+    fill(search, LARGE);
+
+    // Tippen nachgestellt: erste Abfrage über alles, danach nur noch unter den vorigen Treffern
+    SymbolSearch::Result result = search.search(u"p"_qs, 100);
+    QString typed = u"p"_qs;
+    for (const QChar c : u"hysbodyset"_qs) {
+        typed += c;
+        result = search.search(typed, 100, &result.matches);
+    }
+
+    QVERIFY(!result.hits.isEmpty());
+    QVERIFY(search.name(result.hits.first().symbol).startsWith(u"Physics.Body"_qs));
+    QCOMPARE(result.matches, search.search(typed, 100).matches);
+}
+
+QTEST_MAIN(TestSymbolSearch)
+#include "test_symbolsearch.moc"
@@ -0,0 +1,121 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include "LuaSyntaxChecker.h"
+
+class TestSyntaxChecker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testValidSource();
+    void testSyntaxErrors_data();
+    void testSyntaxErrors();
+    void testBinaryChunkRejected();
+    void testParallelChecks();
+    void testAsyncLatestOnly();
+};
+
+void TestSyntaxChecker::testValidSource()
+{
+    const QByteArray source =
+        "local M = {}\n"
+        "function M.greet(name)\n"
+        "    return \"Grüße, \" .. name\n"
+        "end\n"
+        "local t = { [[long\nstring]], 0x1F, 1e3 }\n"
+        "return M\n";
+    QVERIFY(LuaSyntaxChecker::check(source).isEmpty());
+    QVERIFY(LuaSyntaxChecker::check(QByteArrayView()).isEmpty());
+}
+
+void TestSyntaxChecker::testSyntaxErrors_data()
+{
+    QTest::addColumn<QByteArray>("source");
+    QTest::addColumn<int>("line");
+    QTest::addColumn<QString>("messagePart");
+    QTest::addColumn<QString>("nearToken");
+
+    QTest::newRow("unexpected symbol")
+        << QByteArray("local a = 1\nlocal b = = 2\n") << 2 << u"unexpected symbol"_qs << u"="_qs;
+    QTest::newRow("unfinished string")
+        << QByteArray("local s = \"open\nprint(s)\n") << 1 << u"unfinished string"_qs << u"\"open"_qs;
+    QTest::newRow("missing end")
+        << QByteArray("function f()\n    return 1\n") << 2 << u"'end' expected"_qs << QString();
+}
+
+void TestSyntaxChecker::testSyntaxErrors()
+{
+    QFETCH(QByteArray, source);
+    QFETCH(int, line);
+    QFETCH(QString, messagePart);
+    QFETCH(QString, nearToken);
+
+    const QList<LuaSyntaxError> errors = LuaSyntaxChecker::check(source);
+    QCOMPARE(errors.size(), 1);
+    QVERIFY(errors.first().line >= line);
+    QVERIFY2(errors.first().message.contains(messagePart), qPrintable(errors.first().message));
+    QVERIFY(!errors.first().message.startsWith(u"document:"_qs));
+    QCOMPARE(errors.first().nearToken, nearToken);
+}
+
+void TestSyntaxChecker::testBinaryChunkRejected()
+{
+    // Vorkompilierter Bytecode wird nicht geladen (Modus "t")
+    const QList<LuaSyntaxError> errors = LuaSyntaxChecker::check("\x1bLua\x54\x00");
+    QCOMPARE(errors.size(), 1);
+    QCOMPARE(errors.first().line, 0);
+}
+
+void TestSyntaxChecker::testParallelChecks()
+{
+    QList<QByteArray> sources;
+    for (int i = 0; i < 256; ++i) {
+        QByteArray source;
+        for (int l = 0; l < 50; ++l)
+            source += "local v" + QByteArray::number(l) + " = " + QByteArray::number(i * l) + "\n";
+        if (i % 2)
+            source += "if v1 then\n"; // fehlendes end
+        sources.append(source);
+    }
+
+    const QList<QList<LuaSyntaxError>> results = QtConcurrent::blockingMapped(sources, [](const QByteArray& source) {
+        return LuaSyntaxChecker::check(source);
+    });
+    QCOMPARE(results.size(), sources.size());
+    for (qsizetype i = 0; i < results.size(); ++i)
+        QCOMPARE(results.at(i).size(), i % 2);
+
+    // States werden wiederverwendet: höchstens einer pro gleichzeitig prüfendem Thread
+    QVERIFY(LuaSyntaxChecker::statesCreated() <= QThread::idealThreadCount() + 1);
+}
+
+void TestSyntaxChecker::testAsyncLatestOnly()
+{
+    LuaSyntaxChecker checker;
+    QSignalSpy checked(&checker, &LuaSyntaxChecker::checked);
+
+    checker.request("local = 1\n", 1);
+    QVERIFY(checker.isBusy());
+    checker.request("local ok = 1\n", 2);
+    checker.request("x = = 3\n", 3);
+
+    // Zwischenstände werden übersprungen, gemeldet wird nur der neueste
+    QTRY_VERIFY(!checker.isBusy());
+    QCOMPARE(checked.count(), 1);
+    const QList<QVariant> arguments = checked.takeFirst();
+    QCOMPARE(arguments.at(0).toInt(), 3);
+    const auto errors = arguments.at(1).value<QList<LuaSyntaxError>>();
+    QCOMPARE(errors.size(), 1);
+    QCOMPARE(errors.first().line, 1);
+
+    checker.request("local ok = 1\n", 4);
+    QTRY_COMPARE(checked.count(), 1);
+    QCOMPARE(checked.first().at(0).toInt(), 4);
+    QVERIFY(checked.first().at(1).value<QList<LuaSyntaxError>>().isEmpty());
+}
+
+QTEST_MAIN(TestSyntaxChecker)
+#include "test_syntaxchecker.moc"
@@ -0,0 +1,129 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "Trace.h"
+
+class TestTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testDisabledRecordsNothing();
+    void testRevisionOnlyEvaluatedWhenEnabled();
+    void testNestedScopes();
+    void testRingOverwritesOldest();
+    void testChromeTrace();
+
+private:
+    static int countedRevision(int* calls);
+};
+
+int TestTrace::countedRevision(int* calls)
+{
+    ++*calls;
+    return 42;
+}
+
+void TestTrace::init()
+{
+    Trace::clear();
+}
+
+void TestTrace::cleanup()
+{
+    Trace::setEnabled(false);
+    Trace::clear();
+}
+
+void TestTrace::testDisabledRecordsNothing()
+{
+    Trace::setEnabled(false);
+    {
+        TRACE_SCOPE("disabled");
+    }
+    QVERIFY(Trace::snapshot().isEmpty());
+}
+
+void TestTrace::testRevisionOnlyEvaluatedWhenEnabled()
+{
+    int calls = 0;
+    Trace::setEnabled(false);
+    {
+        TRACE_SCOPE_REV("rev", countedRevision(&calls));
+    }
+    QCOMPARE(calls, 0);
+
+    Trace::setEnabled(true);
+    {
+        TRACE_SCOPE_REV("rev", countedRevision(&calls));
+    }
+    QCOMPARE(calls, 1);
+    const QVector<Trace::Event> events = Trace::snapshot();
+    QCOMPARE(events.size(), 1);
+    QCOMPARE(events.first().revision, 42);
+}
+
+void TestTrace::testNestedScopes()
+{
+    Trace::setEnabled(true);
+    {
+        TRACE_SCOPE("outer");
+        {
+            TRACE_SCOPE("inner");
+        }
+    }
+
+    // Aufgezeichnet wird beim Verlassen: inner vor outer, outer umschließt inner
+    const QVector<Trace::Event> events = Trace::snapshot();
+    QCOMPARE(events.size(), 2);
+    QCOMPARE(QByteArray(events.at(0).name), QByteArray("inner"));
+    QCOMPARE(QByteArray(events.at(1).name), QByteArray("outer"));
+    QCOMPARE(events.at(0).revision, -1);
+    QVERIFY(events.at(1).startNs <= events.at(0).startNs);
+    QVERIFY(events.at(1).startNs + events.at(1).durationNs >= events.at(0).startNs + events.at(0).durationNs);
+    QCOMPARE(events.at(0).threadId, events.at(1).threadId);
+}
+
+void TestTrace::testRingOverwritesOldest()
+{
+    Trace::setEnabled(true);
+    for (int i = 0; i < Trace::RING_CAPACITY + 10; ++i)
+        Trace::record("event", i, i + 1, i);
+
+    const QVector<Trace::Event> events = Trace::snapshot();
+    QCOMPARE(events.size(), Trace::RING_CAPACITY);
+    QCOMPARE(events.first().revision, 10);
+    QCOMPARE(events.last().revision, Trace::RING_CAPACITY + 9);
+}
+
+void TestTrace::testChromeTrace()
+{
+    Trace::setEnabled(true);
+    Trace::record("parse", 2000, 5500, 7);
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(Trace::writeChromeTrace(&buffer));
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(buffer.data(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    const QJsonArray events = document.object().value(u"traceEvents"_qs).toArray();
+    QCOMPARE(events.size(), 1);
+    const QJsonObject event = events.first().toObject();
+    QCOMPARE(event.value(u"name"_qs).toString(), u"parse"_qs);
+    QCOMPARE(event.value(u"ph"_qs).toString(), u"X"_qs);
+    QCOMPARE(event.value(u"ts"_qs).toDouble(), 2.0);
+    QCOMPARE(event.value(u"dur"_qs).toDouble(), 3.5);
+    QCOMPARE(event.value(u"args"_qs).toObject().value(u"revision"_qs).toInt(), 7);
+
+    QVERIFY(!Trace::writeChromeTrace(nullptr));
+}
+
+QTEST_MAIN(TestTrace)
+#include "test_trace.moc"
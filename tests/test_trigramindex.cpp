@@ -0,0 +1,309 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include "TrigramIndex.h"
+#include "WorkspaceSearch.h"
+#include "TestUtil.h"
+
+class TestTrigramIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testTrigrams();
+    void testRequiredLiterals_data();
+    void testRequiredLiterals();
+    void testLiteralCandidates();
+    void testRegexCandidates();
+    void testUpdateAndRemove();
+    void testCacheRoundTrip();
+    void testRebuildInPlace();
+    void testSearchFile();
+    void testStreamingSearch();
+    void testInvalidRegex();
+
+private:
+    QStringList relative(const QStringList& paths) const;
+
+    static constexpr int FILLER_FILES = 200;
+
+    TestUtil::Workspace m_dir;
+    std::shared_ptr<TrigramIndex> m_index;
+};
+
+QStringList TestTrigramIndex::relative(const QStringList& paths) const
+{
+    QStringList result;
+    for (const QString& path : paths)
+        result.append(QDir(m_dir.path()).relativeFilePath(path));
+    return result;
+}
+
+void TestTrigramIndex::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_dir.write(u"player.lua"_qs,
+              "local Player = {}\n"
+              "function Player:takeDamage(amount)\n"
+              "    self.health = self.health - amount\n"
+              "end\n");
+    m_dir.write(u"enemy.lua"_qs,
+              "Enemy = {}\r\n"
+              "function Enemy.spawn(x, y) return TakeDamage end\r\n");
+    m_dir.write(u"ui/hud.lua"_qs,
+              "-- Lebensanzeige: grün/gelb/rot\n"
+              "HUD = { color = \"grün\" }\n");
+    for (int i = 0; i < FILLER_FILES; ++i) {
+        m_dir.write(u"gen/f%1.lua"_qs.arg(i, 3, 10, QChar(u'0')),
+                  "local M = {}\n"
+                  "function M.value" + QByteArray::number(i) + "() return " + QByteArray::number(i * 7) + " end\n"
+                  "return M\n");
+    }
+
+    m_index = std::make_shared<TrigramIndex>();
+    QVERIFY(m_index->build(m_dir.path(), 4));
+    QCOMPARE(m_index->stats().files, FILLER_FILES + 3);
+    QCOMPARE(m_index->stats().indexedFiles, FILLER_FILES + 3);
+}
+
+void TestTrigramIndex::testTrigrams()
+{
+    const QList<quint32> t = TrigramIndex::trigrams("AbcAbc");
+    // abc, bca, cab – ASCII gefaltet, sortiert, eindeutig
+    QCOMPARE(t, (QList<quint32>{0x616263, 0x626361, 0x636162}));
+    QVERIFY(TrigramIndex::trigrams("ab").isEmpty());
+
+    const QByteArray umlaut = QString(u"grün"_qs).toUtf8(); // 5 Bytes
+    QCOMPARE(TrigramIndex::trigrams(umlaut).size(), 3);
+    QCOMPARE(TrigramIndex::trigrams(umlaut, false).size(), 0);
+}
+
+void TestTrigramIndex::testRequiredLiterals_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QList<QList<QByteArray>>>("expected");
+
+    using L = QList<QList<QByteArray>>;
+    QTest::newRow("plain") << u"takeDamage"_qs << L{{"takeDamage"}};
+    QTest::newRow("dot splits") << u"self.health"_qs << L{{"self", "health"}};
+    QTest::newRow("escaped dot") << uR"(self\.health)"_qs << L{{"self.health"}};
+    QTest::newRow("optional char") << u"colou?r"_qs << L{{"colo"}};
+    QTest::newRow("star and class") << u"Enemy[0-9]*spawn"_qs << L{{"Enemy", "spawn"}};
+    QTest::newRow("group skipped") << u"function (Player|Enemy)[.:]spawn"_qs << L{{"function ", "spawn"}};
+    QTest::newRow("alternation") << u"health|spawn"_qs << L{{"health"}, {"spawn"}};
+    QTest::newRow("word class") << uR"(\bM\.value\d+)"_qs << L{{"M.value"}};
+    QTest::newRow("repeat") << u"ab{2}cdef"_qs << L{{"cdef"}};
+    QTest::newRow("short only") << u"a.b"_qs << L{};
+    QTest::newRow("open branch") << u"health|x"_qs << L{};
+    QTest::newRow("hex escape") << uR"(\x41bc)"_qs << L{};
+    QTest::newRow("extended") << u"(?x) take Damage"_qs << L{};
+    QTest::newRow("unbalanced") << u"spawn)"_qs << L{};
+}
+
+void TestTrigramIndex::testRequiredLiterals()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QList<QList<QByteArray>>, expected);
+    QCOMPARE(TrigramIndex::requiredLiterals({pattern, true, false}), expected);
+}
+
+void TestTrigramIndex::testLiteralCandidates()
+{
+    QCOMPARE(relative(m_index->candidates({u"self.health"_qs, false, true})), QStringList{u"player.lua"_qs});
+    // Trigramme sind gefaltet: Kandidaten ignorieren die Schreibweise, erst die Prüfung nicht
+    QCOMPARE(relative(m_index->candidates({u"takeDamage"_qs, false, true})),
+             (QStringList{u"enemy.lua"_qs, u"player.lua"_qs}));
+    QCOMPARE(relative(m_index->candidates({u"value42()"_qs, false, false})), QStringList{u"gen/f042.lua"_qs});
+    QVERIFY(m_index->candidates({u"nowhere_to_be_found"_qs, false, false}).isEmpty());
+
+    // Nicht-ASCII: mit Groß-/Kleinschreibung über die Bytes, ohne nur über ASCII-Trigramme
+    QCOMPARE(relative(m_index->candidates({u"grün"_qs, false, true})), QStringList{u"ui/hud.lua"_qs});
+    QCOMPARE(relative(m_index->candidates({u"\"GRÜN\""_qs, false, false})), QStringList{u"ui/hud.lua"_qs});
+
+    // Zu kurz zum Einschränken: alle Dateien
+    QCOMPARE(m_index->candidates({u"M."_qs, false, false}).size(), FILLER_FILES + 3);
+}
+
+void TestTrigramIndex::testRegexCandidates()
+{
+    QCOMPARE(relative(m_index->candidates({uR"(function \w+[.:]spawn)"_qs, true, false})),
+             QStringList{u"enemy.lua"_qs});
+    QCOMPARE(relative(m_index->candidates({u"health|spawn"_qs, true, false})),
+             (QStringList{u"enemy.lua"_qs, u"player.lua"_qs}));
+    // "value1" steht in f001, f010-f019 und f100-f199
+    QCOMPARE(m_index->candidates({uR"(value1[0-9]\()"_qs, true, false}).size(), 111);
+    QCOMPARE(m_index->candidates({uR"(^\w+$)"_qs, true, false}).size(), FILLER_FILES + 3);
+}
+
+void TestTrigramIndex::testUpdateAndRemove()
+{
+    TrigramIndex index = *m_index;
+    const QString path = m_dir.filePath(u"player.lua"_qs);
+
+    index.updateFile(path, "function Player:heal(amount) end\n");
+    QVERIFY(index.candidates({u"self.health"_qs, false, true}).isEmpty());
+    QCOMPARE(relative(index.candidates({u"heal("_qs, false, true})), QStringList{u"player.lua"_qs});
+
+    index.updateFile(m_dir.filePath(u"new.lua"_qs), "-- heal(\n");
+    QCOMPARE(relative(index.candidates({u"heal("_qs, false, true})),
+             (QStringList{u"new.lua"_qs, u"player.lua"_qs}));
+    QCOMPARE(index.stats().files, FILLER_FILES + 4);
+
+    index.removeFile(path);
+    QCOMPARE(relative(index.candidates({u"heal("_qs, false, true})), QStringList{u"new.lua"_qs});
+    QCOMPARE(index.stats().files, FILLER_FILES + 3);
+
+    // Die Kopie ist unabhängig
+    QCOMPARE(relative(m_index->candidates({u"self.health"_qs, false, true})), QStringList{u"player.lua"_qs});
+}
+
+void TestTrigramIndex::testCacheRoundTrip()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(m_index->save(&buffer));
+    buffer.close();
+
+    TrigramIndex loaded;
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(loaded.load(&buffer));
+    buffer.close();
+    QCOMPARE(loaded.root(), m_index->root());
+    QCOMPARE(loaded.stats().files, m_index->stats().files);
+    QCOMPARE(loaded.stats().trigrams, m_index->stats().trigrams);
+    QCOMPARE(loaded.candidates({u"value42()"_qs, false, false}), m_index->candidates({u"value42()"_qs, false, false}));
+
+    // Nach dem Laden liest build() nur die geänderte und die neue Datei
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"a.lua"_qs, "alpha = 1\n");
+    dir.write(u"b.lua"_qs, "beta = 2\n");
+    dir.write(u"c.lua"_qs, "gamma = 3\n");
+    TrigramIndex first;
+    QVERIFY(first.build(dir.path()));
+    QBuffer cache;
+    QVERIFY(cache.open(QIODevice::WriteOnly));
+    QVERIFY(first.save(&cache));
+    cache.close();
+
+    dir.write(u"b.lua"_qs, "betamax = 2.5\n"); // andere Größe
+    dir.write(u"d.lua"_qs, "delta = 4\n");
+    QVERIFY(QFile::remove(dir.filePath(u"c.lua"_qs)));
+
+    TrigramIndex second;
+    QVERIFY(cache.open(QIODevice::ReadOnly));
+    QVERIFY(second.load(&cache));
+    QVERIFY(second.build(dir.path()));
+    QCOMPARE(second.stats().files, 3);
+    QCOMPARE(second.stats().indexedFiles, 2);
+    QCOMPARE(second.stats().reusedFiles, 1);
+    QCOMPARE(second.candidates({u"betamax"_qs, false, false}).size(), 1);
+    QVERIFY(second.candidates({u"gamma"_qs, false, false}).isEmpty());
+    QCOMPARE(second.candidates({u"delta"_qs, false, false}).size(), 1);
+
+    // Fremdes Format wird abgelehnt
+    QBuffer garbage;
+    garbage.setData("not a cache");
+    QVERIFY(garbage.open(QIODevice::ReadOnly));
+    TrigramIndex rejected;
+    QVERIFY(!rejected.load(&garbage));
+    QCOMPARE(rejected.stats().files, 0);
+}
+
+void TestTrigramIndex::testRebuildInPlace()
+{
+    // Erneutes build() auf demselben Index zieht externe Änderungen nach (so vor jeder Suche)
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"a.lua"_qs, "alpha = 1\n");
+    dir.write(u"b.lua"_qs, "beta = 2\n");
+    TrigramIndex index;
+    QVERIFY(index.build(dir.path()));
+
+    QVERIFY(index.build(dir.path()));
+    QCOMPARE(index.stats().indexedFiles, 0);
+    QCOMPARE(index.stats().reusedFiles, 2);
+
+    dir.write(u"a.lua"_qs, "alphabet = 1\n");
+    dir.write(u"c.lua"_qs, "gamma = 3\n");
+    QVERIFY(QFile::remove(dir.filePath(u"b.lua"_qs)));
+    QVERIFY(index.build(dir.path()));
+    QCOMPARE(index.stats().files, 2);
+    QCOMPARE(index.stats().indexedFiles, 2);
+    QCOMPARE(index.candidates({u"alphabet"_qs, false, false}).size(), 1);
+    QCOMPARE(index.candidates({u"gamma"_qs, false, false}).size(), 1);
+    QVERIFY(index.candidates({u"beta"_qs, false, false}).isEmpty());
+}
+
+void TestTrigramIndex::testSearchFile()
+{
+    const WorkspaceSearch::FileResult literal =
+        WorkspaceSearch::searchFile(m_dir.filePath(u"player.lua"_qs), {u"HEALTH"_qs, false, false});
+    QCOMPARE(literal.matches.size(), 2);
+    QCOMPARE(literal.matches.at(0).line, 3);
+    QCOMPARE(literal.matches.at(0).column, 10);
+    QCOMPARE(literal.matches.at(1).column, 24);
+    QCOMPARE(literal.matches.at(0).text, u"    self.health = self.health - amount"_qs);
+
+    QVERIFY(WorkspaceSearch::searchFile(m_dir.filePath(u"player.lua"_qs), {u"HEALTH"_qs, false, true})
+                .matches.isEmpty());
+
+    // CRLF: Zeilentext ohne '\r', Regex mit '^' je Zeile
+    const WorkspaceSearch::FileResult regex =
+        WorkspaceSearch::searchFile(m_dir.filePath(u"enemy.lua"_qs), {uR"(^function \w+\.(\w+))"_qs, true, true});
+    QCOMPARE(regex.matches.size(), 1);
+    QCOMPARE(regex.matches.at(0).line, 2);
+    QCOMPARE(regex.matches.at(0).column, 1);
+    QCOMPARE(regex.matches.at(0).length, 20);
+    QCOMPARE(regex.matches.at(0).text, u"function Enemy.spawn(x, y) return TakeDamage end"_qs);
+}
+
+void TestTrigramIndex::testStreamingSearch()
+{
+    WorkspaceSearch search;
+    QSignalSpy matched(&search, &WorkspaceSearch::fileMatched);
+    QSignalSpy finished(&search, &WorkspaceSearch::finished);
+
+    QVERIFY(search.start(m_index, {uR"(value1[0-9]\(\))"_qs, true, true}));
+    QCOMPARE(search.candidateCount(), 111);
+    QVERIFY(finished.wait(5000));
+
+    // Gelesen werden nur die Kandidaten, passen nur f010-f019 ("value1" + Ziffer + "()")
+    QCOMPARE(finished.first().at(0).toInt(), 111);
+    QCOMPARE(finished.first().at(1).toInt(), 10);
+    QCOMPARE(matched.size(), 10);
+    QSet<QString> files;
+    for (const QList<QVariant>& args : std::as_const(matched)) {
+        const auto result = args.at(0).value<WorkspaceSearch::FileResult>();
+        QCOMPARE(result.matches.size(), 1);
+        files.insert(QFileInfo(result.path).fileName());
+    }
+    QVERIFY(files.contains(u"f010.lua"_qs) && files.contains(u"f019.lua"_qs));
+
+    // Ein neuer Start verwirft die laufende Suche
+    QVERIFY(search.start(m_index, {u"return"_qs, false, false}));
+    QVERIFY(search.start(m_index, {u"takeDamage"_qs, false, true}));
+    finished.clear();
+    matched.clear();
+    QVERIFY(finished.wait(5000));
+    QCOMPARE(search.candidateCount(), 2);
+    QCOMPARE(finished.size(), 1);
+    QCOMPARE(finished.first().at(2).toInt(), 1);
+    QCOMPARE(matched.size(), 1);
+}
+
+void TestTrigramIndex::testInvalidRegex()
+{
+    WorkspaceSearch search;
+    QVERIFY(!search.start(m_index, {u"(unclosed"_qs, true, false}));
+    QVERIFY(!search.errorString().isEmpty());
+    QVERIFY(!search.start(m_index, {QString(), false, false}));
+    QVERIFY(!search.isRunning());
+}
+
+QTEST_MAIN(TestTrigramIndex)
+#include "test_trigramindex.moc"
@@ -0,0 +1,183 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QBuffer>
+#include <QDataStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "WorkspaceIndex.h"
+#include "TestUtil.h"
+
+class TestWorkspaceIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testBuild();
+    void testDeterministicAcrossThreads();
+    void testJsonDump();
+    void testBinaryHeader();
+    void testMissingRoot();
+    void testBomAndCrlf();
+
+private:
+    static QByteArray dump(const WorkspaceIndex& index, WorkspaceIndex::Format format);
+
+    TestUtil::Workspace m_dir;
+};
+
+QByteArray TestWorkspaceIndex::dump(const WorkspaceIndex& index, WorkspaceIndex::Format format)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!index.write(&buffer, format)) return {};
+    return buffer.data();
+}
+
+void TestWorkspaceIndex::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_dir.write(u"main.lua"_qs,
+              "local Player = {}\n"
+              "function Player:new(name)\n"
+              "    return setmetatable({ name = name }, { __index = Player })\n"
+              "end\n"
+              "function update(dt) end\n");
+    m_dir.write(u"lib/util.lua"_qs,
+              "Util = {}\n"
+              "function Util.clamp(x, lo, hi) return x end\n");
+    for (int i = 0; i < 40; ++i) {
+        m_dir.write(u"gen/m%1.lua"_qs.arg(i),
+                  "M" + QByteArray::number(i) + " = {}\n"
+                  "function M" + QByteArray::number(i) + ".run(a) return Util.clamp(a, 0, 1) end");
+    }
+    m_dir.write(u"notes.txt"_qs, "function ignored() end\n");
+}
+
+void TestWorkspaceIndex::testBuild()
+{
+    WorkspaceIndex index;
+    QVERIFY(index.build({m_dir.path(), 2}));
+
+    QCOMPARE(index.files().size(), 42);
+    QCOMPARE(index.files().first(), u"gen/m0.lua"_qs);
+    QVERIFY(index.files().contains(u"lib/util.lua"_qs));
+    QVERIFY(!index.files().contains(u"notes.txt"_qs));
+
+    const WorkspaceIndex::Stats& stats = index.stats();
+    QCOMPARE(stats.files, 42);
+    QCOMPARE(stats.failedFiles, 0);
+    QCOMPARE(stats.threads, 2);
+    QCOMPARE(stats.lines, 5 + 2 + 40 * 2);
+    QVERIFY(stats.bytes > 0);
+    QVERIFY(stats.symbols > 0);
+    QVERIFY(index.statsReport().contains(u"42 files"_qs));
+
+    const auto clamp = index.symbolTable().findDefinition(u"clamp"_qs, u"Util"_qs);
+    QVERIFY(clamp.has_value());
+    QCOMPARE(clamp->filePath, u"lib/util.lua"_qs);
+    QCOMPARE(clamp->pos.line, 2);
+    QVERIFY(index.symbolTable().getGlobals().contains(u"update"_qs));
+}
+
+void TestWorkspaceIndex::testDeterministicAcrossThreads()
+{
+    WorkspaceIndex single;
+    WorkspaceIndex parallel;
+    QVERIFY(single.build({m_dir.path(), 1}));
+    QVERIFY(parallel.build({m_dir.path(), 8}));
+
+    QCOMPARE(dump(single, WorkspaceIndex::Format::Json), dump(parallel, WorkspaceIndex::Format::Json));
+    QCOMPARE(dump(single, WorkspaceIndex::Format::Binary), dump(parallel, WorkspaceIndex::Format::Binary));
+}
+
+void TestWorkspaceIndex::testJsonDump()
+{
+    WorkspaceIndex index;
+    QVERIFY(index.build({m_dir.path()}));
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(dump(index, WorkspaceIndex::Format::Json), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QJsonObject root = document.object();
+    QCOMPARE(root.value(u"version"_qs).toInt(), int(WorkspaceIndex::FORMAT_VERSION));
+    const QJsonArray files = root.value(u"files"_qs).toArray();
+    QCOMPARE(files.size(), 42);
+
+    bool foundClamp = false;
+    for (const QJsonValue& value : root.value(u"symbols"_qs).toArray()) {
+        const QJsonObject symbol = value.toObject();
+        if (symbol.value(u"qname"_qs).toString() != u"Util.clamp"_qs) continue;
+        foundClamp = true;
+        QCOMPARE(files.at(symbol.value(u"file"_qs).toInt()).toString(), u"lib/util.lua"_qs);
+        QCOMPARE(symbol.value(u"line"_qs).toInt(), 2);
+    }
+    QVERIFY(foundClamp);
+    QVERIFY(!root.value(u"references"_qs).toObject().isEmpty());
+}
+
+void TestWorkspaceIndex::testBinaryHeader()
+{
+    WorkspaceIndex index;
+    QVERIFY(index.build({m_dir.path()}));
+
+    const QByteArray bytes = dump(index, WorkspaceIndex::Format::Binary);
+    QVERIFY(!bytes.isEmpty());
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 stringCount = 0;
+    stream >> magic >> version >> stringCount;
+    QCOMPARE(magic, WorkspaceIndex::BINARY_MAGIC);
+    QCOMPARE(version, WorkspaceIndex::FORMAT_VERSION);
+
+    QStringList strings;
+    for (quint32 i = 0; i < stringCount; ++i) {
+        QByteArray text;
+        stream >> text;
+        strings.append(QString::fromUtf8(text));
+    }
+    QList<quint32> files;
+    stream >> files;
+    QCOMPARE(files.size(), 42);
+    QCOMPARE(strings.at(files.first()), u"gen/m0.lua"_qs);
+    QCOMPARE(stream.status(), QDataStream::Ok);
+
+    // Binär ist kompakter als JSON
+    QVERIFY(bytes.size() < dump(index, WorkspaceIndex::Format::Json).size());
+}
+
+void TestWorkspaceIndex::testMissingRoot()
+{
+    WorkspaceIndex index;
+    QVERIFY(!index.build({m_dir.filePath(u"does-not-exist"_qs)}));
+    QVERIFY(!index.errorString().isEmpty());
+    QVERIFY(index.files().isEmpty());
+}
+
+void TestWorkspaceIndex::testBomAndCrlf()
+{
+    TestUtil::Workspace dir;
+    QVERIFY(dir.isValid());
+    dir.write(u"bom.lua"_qs, "\xEF\xBB\xBF" "Bom = {}\r\nfunction Bom.run(a)\r\n    return a\r\nend\r\n");
+    dir.write(u"tail.lua"_qs, "Tail = {}\nTail.name = \"\xC3\xA4\"");
+
+    WorkspaceIndex index;
+    QVERIFY(index.build({dir.path(), 1}));
+    QCOMPARE(index.stats().lines, 4 + 2);
+
+    // Ohne BOM und '\r' im Namen: "Bom" ist global, Positionen wie im Editor
+    QVERIFY(index.symbolTable().getGlobals().contains(u"Bom"_qs));
+    const auto run = index.symbolTable().findDefinition(u"run"_qs, u"Bom"_qs);
+    QVERIFY(run.has_value());
+    QCOMPARE(run->pos.line, 2);
+    QCOMPARE(run->pos.column, 10);
+    QVERIFY(index.symbolTable().findDefinition(u"name"_qs, u"Tail"_qs).has_value());
+}
+
+QTEST_MAIN(TestWorkspaceIndex)
+#include "test_workspaceindex.moc"